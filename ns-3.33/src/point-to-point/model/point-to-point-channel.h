@@ -152,9 +152,11 @@ private:
   Time          m_delay;    //!< Propagation delay
   std::size_t        m_nDevices; //!< Devices of this channel
 
+protected:
   /**
    * The trace source for the packet transmission animation events that the 
-   * device can fire.
+   * device can fire. Protected so that subclasses which deliver packets
+   * themselves can still fire it.
    * Arguments to the callback are the packet, transmitting
    * net device, receiving net device, transmission time and 
    * packet receipt time.
@@ -170,6 +172,7 @@ private:
                  Time                   // Last bit receive time (relative to now)
                  > m_txrxPointToPoint;
 
+private:
   /** \brief Wire states
    *
    */
@@ -0,0 +1,249 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Downlink of a SAR satellite to a polar ground station with adaptive
+ * coding and modulation. The satellite device rate follows the
+ * elevation-dependent link budget over each pass; the per-pass rate
+ * profile and the delivered volume are reported. Run with --fixed=1
+ * to compare against a fixed-rate link, and with --errors=1 to lose
+ * packets according to the link budget.
+ */
+
+#include <algorithm>
+#include <iomanip>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/sar-orbit-mobility-model.h"
+#include "ns3/orbit-point-to-point-helper.h"
+#include "ns3/orbit-point-to-point-channel.h"
+#include "ns3/contact-plan.h"
+#include "ns3/adaptive-rate-controller.h"
+#include "ns3/link-budget-error-model.h"
+#include "ns3/sar-payload-application.h"
+
+using namespace ns3;
+
+static Ptr<AdaptiveRateController> g_controller;
+static Ptr<MobilityModel> g_satellite;
+static Ptr<MobilityModel> g_station;
+static bool g_verbose = true;
+static uint32_t g_pass = 0;
+static Time g_passStart;
+static uint64_t g_passBytes = 0;
+static uint64_t g_delivered = 0;
+static uint64_t g_passLost = 0;
+static uint64_t g_lost = 0;
+static double g_minRate = 0;
+static double g_maxRate = 0;
+static double g_worstRatio = 0;
+
+static void
+RateChange (DataRate rate, double esN0, int32_t modcod)
+{
+  double bps = rate.GetBitRate ();
+  if (modcod >= 0)
+    {
+      g_minRate = g_minRate == 0 ? bps : std::min (g_minRate, bps);
+      g_maxRate = std::max (g_maxRate, bps);
+    }
+  if (!g_verbose)
+    {
+      return;
+    }
+  Vector station = g_station->GetPosition ();
+  Vector satellite = g_satellite->GetPosition ();
+  std::cout << std::fixed << std::setprecision (1)
+            << "  t=" << Simulator::Now ().GetSeconds () << "s el="
+            << ContactPlan::GetElevation (station, satellite) << "deg range="
+            << CalculateDistance (station, satellite) / 1000 << "km Es/N0="
+            << std::setprecision (2) << esN0 << "dB "
+            << (modcod < 0 ? std::string ("outage")
+                           : g_controller->GetModcodTable ().Get (modcod).name)
+            << " " << bps / 1e6 << "Mbps" << std::endl;
+}
+
+static void
+LinkState (bool up)
+{
+  if (up)
+    {
+      g_passStart = Simulator::Now ();
+      g_passBytes = 0;
+      g_passLost = 0;
+      g_minRate = 0;
+      g_maxRate = 0;
+      std::cout << std::fixed << std::setprecision (1) << "pass " << ++g_pass << " at " << g_passStart.GetSeconds () << "s" << std::endl;
+      return;
+    }
+  double length = (Simulator::Now () - g_passStart).GetSeconds ();
+  std::cout << std::fixed << std::setprecision (2) << "  " << length << "s, " << g_passBytes / 1e9
+            << " GB, mean " << g_passBytes * 8 / length / 1e6 << "Mbps, "
+            << g_passLost << " packets lost";
+  if (g_minRate > 0)
+    {
+      std::cout << ", rate " << g_minRate / 1e6 << "-" << g_maxRate / 1e6 << "Mbps ("
+                << g_maxRate / g_minRate << "x)";
+      g_worstRatio = g_worstRatio == 0 ? g_maxRate / g_minRate
+                                        : std::min (g_worstRatio, g_maxRate / g_minRate);
+    }
+  std::cout << std::endl;
+}
+
+static void
+Received (Ptr<const Packet> packet, const Address &from)
+{
+  g_passBytes += packet->GetSize ();
+  g_delivered += packet->GetSize ();
+}
+
+static void
+Lost (Ptr<const Packet> packet)
+{
+  g_passLost++;
+  g_lost++;
+}
+
+int main (int argc, char *argv[])
+{
+  double hours = 6.0;
+  bool fixed = false;
+  bool errors = false;
+  std::string rate = "520Mbps";
+  double minElevation = 5.0;
+  uint32_t packetSize = 60000;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("hours", "Simulated time in hours", hours);
+  cmd.AddValue ("fixed", "Use a fixed rate instead of adaptive coding and modulation", fixed);
+  cmd.AddValue ("rate", "Data rate of the fixed link", rate);
+  cmd.AddValue ("errors", "Lose packets according to the link budget", errors);
+  cmd.AddValue ("minElevation", "Elevation mask of the ground station in degrees", minElevation);
+  cmd.AddValue ("packetSize", "Downlink packet size in bytes", packetSize);
+  cmd.AddValue ("verbose", "Print every rate change", g_verbose);
+  cmd.Parse (argc, argv);
+
+  NodeContainer satellite;
+  satellite.Create (1);
+  NodeContainer station;
+  station.Create (1);
+
+  MobilityHelper satelliteMobility;
+  satelliteMobility.SetMobilityModel ("ns3::SarOrbitMobilityModel",
+                                      "EvaluationMode", StringValue ("Lazy"));
+  satelliteMobility.Install (satellite);
+  MobilityHelper stationMobility;
+  stationMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  stationMobility.Install (station);
+  g_satellite = satellite.Get (0)->GetObject<MobilityModel> ();
+  g_station = station.Get (0)->GetObject<MobilityModel> ();
+  g_station->SetPosition (Vector (0.0, 0.0, 6371000.0));
+
+  Time stop = Seconds (hours * 3600);
+  Ptr<ContactPlan> plan = CreateObject<ContactPlan> ();
+  plan->AddSatellite (satellite.Get (0)->GetObject<OrbitMobilityModel> ());
+  plan->AddGroundStation (g_station, minElevation);
+  plan->Compute (Seconds (0), stop);
+
+  InternetStackHelper stack;
+  stack.Install (satellite);
+  stack.Install (station);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+
+  OrbitPointToPointHelper downlink;
+  downlink.SetDeviceAttribute ("DataRate", StringValue (rate));
+  downlink.SetDeviceAttribute ("Mtu", UintegerValue (std::min<uint32_t> (packetSize + 28, 65535)));
+  NetDeviceContainer devices = downlink.Install (station.Get (0), satellite.Get (0));
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+  Ptr<OrbitPointToPointChannel> channel = devices.Get (0)->GetChannel ()->GetObject<OrbitPointToPointChannel> ();
+  plan->ScheduleLinkEvents (0, 0, channel);
+  channel->TraceConnectWithoutContext ("LinkState", MakeCallback (&LinkState));
+  if (channel->IsLinkUp ())
+    {
+      Simulator::ScheduleNow (&LinkState, true);
+    }
+
+  if (!fixed)
+    {
+      g_controller = CreateObject<AdaptiveRateController> ();
+      g_controller->TraceConnectWithoutContext ("RateChange", MakeCallback (&RateChange));
+      g_controller->Install (DynamicCast<PointToPointNetDevice> (devices.Get (1)));
+    }
+
+  if (errors)
+    {
+      Ptr<LinkBudgetErrorModel> em = CreateObject<LinkBudgetErrorModel> ();
+      if (fixed)
+        {
+          /* The fixed link uses the most efficient scheme not faster than its rate */
+          ModcodTable table = ModcodTable::GetDvbS2 ();
+          uint32_t modcod = 0;
+          double symbolRate = 150e6;
+          while (modcod + 1 < table.GetN ()
+                 && symbolRate * table.Get (modcod + 1).efficiency <= DataRate (rate).GetBitRate ())
+            {
+              modcod++;
+            }
+          em->SetAttribute ("Modcod", UintegerValue (modcod));
+          em->SetAttribute ("SymbolRate", DoubleValue (symbolRate));
+          std::cout << "fixed link uses " << table.Get (modcod).name << std::endl;
+        }
+      else
+        {
+          em->SetAttribute ("RateController", PointerValue (g_controller));
+        }
+      em->Install (devices.Get (0));
+      devices.Get (0)->TraceConnectWithoutContext ("PhyRxDrop", MakeCallback (&Lost));
+    }
+
+  /* A full memory and no acquisitions: the downlink is always backlogged */
+  Ptr<OnboardStorage> storage = CreateObject<OnboardStorage> ();
+  storage->SetAttribute ("Capacity", UintegerValue (1000000000000ULL));
+  storage->Write (0, 0, 1000000000000ULL);
+  Ptr<SarPayloadApplication> payload = CreateObject<SarPayloadApplication> ();
+  payload->SetAttribute ("Storage", PointerValue (storage));
+  payload->SetAttribute ("PacketSize", UintegerValue (packetSize));
+  payload->SetAttribute ("AcquisitionDuration", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
+  payload->SetAttribute ("AcquisitionGap", StringValue ("ns3::ConstantRandomVariable[Constant=1e9]"));
+  payload->AddDownlink (devices.Get (1), InetSocketAddress (interfaces.GetAddress (0), 9000));
+  satellite.Get (0)->AddApplication (payload);
+
+  PacketSinkHelper sink ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 9000));
+  ApplicationContainer apps = sink.Install (station.Get (0));
+  apps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&Received));
+
+  Simulator::Stop (stop);
+  Simulator::Run ();
+
+  std::cout << (fixed ? "fixed " + rate : std::string ("adaptive")) << ": delivered "
+            << g_delivered / 1e9 << " GB in " << g_pass << " passes, " << g_lost << " packets lost";
+  if (!fixed)
+    {
+      std::cout << ", smallest per-pass rate ratio " << g_worstRatio << "x";
+    }
+  std::cout << std::endl;
+  g_controller = 0;
+  g_satellite = 0;
+  g_station = 0;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Builds a Walker constellation with inter-satellite links and two
+ * ground stations on the rotating Earth, echoes UDP packets between the
+ * stations, and reports how many shortest-path trees the incremental
+ * updates recomputed compared to a full recomputation per link change.
+ * At the end the incremental routes are checked against a full one.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/constellation-propagator.h"
+#include "ns3/ground-station-mobility-model.h"
+#include "ns3/constellation-topology-helper.h"
+
+using namespace ns3;
+
+static uint32_t g_changes = 0;
+static uint64_t g_trees = 0;
+static uint32_t g_replies = 0;
+
+static void
+Update (uint32_t link, bool up, uint32_t trees)
+{
+  g_changes++;
+  g_trees += trees;
+}
+
+static void
+Reply (Ptr<const Packet> packet)
+{
+  g_replies++;
+}
+
+static void
+PrintRoute (Ptr<ConstellationRouteManager> manager, uint32_t from, uint32_t to, Time interval)
+{
+  std::cout << Simulator::Now ().GetSeconds () << "s route "
+            << manager->GetHopCount (from, to) << " hops" << std::endl;
+  Simulator::Schedule (interval, &PrintRoute, manager, from, to, interval);
+}
+
+static void
+Verify (Ptr<ConstellationRouteManager> manager, NodeContainer nodes)
+{
+  std::vector<int32_t> hops;
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      for (uint32_t j = 0; j < nodes.GetN (); ++j)
+        {
+          hops.push_back (manager->GetHopCount (nodes.Get (i)->GetId (), nodes.Get (j)->GetId ()));
+        }
+    }
+  manager->Compute ();
+  uint32_t mismatches = 0;
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      for (uint32_t j = 0; j < nodes.GetN (); ++j)
+        {
+          mismatches += hops[i * nodes.GetN () + j]
+            != manager->GetHopCount (nodes.Get (i)->GetId (), nodes.Get (j)->GetId ());
+        }
+    }
+  std::cout << "incremental routes differ from a full computation for "
+            << mismatches << " node pairs" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t planes = 6;
+  uint32_t perPlane = 11;
+  double altitude = 780000.0;
+  double inclination = 86.4;
+  double hours = 2.0;
+  double polarLimit = 75.0;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("planes", "Number of orbital planes", planes);
+  cmd.AddValue ("perPlane", "Number of satellites per plane", perPlane);
+  cmd.AddValue ("altitude", "Orbit altitude in m", altitude);
+  cmd.AddValue ("inclination", "Orbit inclination in degrees", inclination);
+  cmd.AddValue ("hours", "Simulated time in hours", hours);
+  cmd.AddValue ("polarLimit", "Latitude above which inter-plane links are down", polarLimit);
+  cmd.Parse (argc, argv);
+
+  NodeContainer satellites;
+  satellites.Create (planes * perPlane);
+  Ptr<ConstellationPropagator> constellation = CreateObject<ConstellationPropagator> ();
+  constellation->AddWalkerDelta (planes * perPlane, planes, 1, altitude, inclination);
+  constellation->Install (satellites);
+
+  /* Toulouse and Sydney */
+  NodeContainer stations;
+  stations.Create (2);
+  double coordinates[2][2] = { { 43.6, 1.44 }, { -33.87, 151.21 } };
+  for (uint32_t i = 0; i < stations.GetN (); ++i)
+    {
+      Ptr<GroundStationMobilityModel> mobility = CreateObject<GroundStationMobilityModel> ();
+      mobility->SetAttribute ("EvaluationMode", StringValue ("Lazy"));
+      mobility->SetGeographicPosition (coordinates[i][0], coordinates[i][1]);
+      stations.Get (i)->AggregateObject (mobility);
+    }
+
+  Time stop = Seconds (hours * 3600);
+  ConstellationTopologyHelper topology;
+  topology.GetIslHelper ().SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  topology.GetGroundLinkHelper ().SetDeviceAttribute ("DataRate", StringValue ("50Mbps"));
+  topology.SetPolarLimit (polarLimit, Seconds (10));
+  topology.Install (satellites, planes, stations, stop);
+
+  Ptr<ConstellationRouteManager> manager = topology.GetRouteManager ();
+  manager->TraceConnectWithoutContext ("Update", MakeCallback (&Update));
+  std::cout << manager->GetNNodes () << " nodes, " << topology.GetNIsls ()
+            << " inter-satellite links, " << manager->GetNLinks () << " links in total" << std::endl;
+
+  UdpEchoServerHelper server (9);
+  ApplicationContainer serverApps = server.Install (stations.Get (1));
+  serverApps.Start (Seconds (0));
+  UdpEchoClientHelper client (topology.GetStationAddress (1), 9);
+  client.SetAttribute ("MaxPackets", UintegerValue (std::numeric_limits<uint32_t>::max ()));
+  client.SetAttribute ("Interval", TimeValue (Seconds (10)));
+  client.SetAttribute ("PacketSize", UintegerValue (512));
+  ApplicationContainer clientApps = client.Install (stations.Get (0));
+  clientApps.Start (Seconds (1));
+  clientApps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&Reply));
+
+  Simulator::Schedule (Seconds (0), &PrintRoute, manager,
+                       stations.Get (0)->GetId (), stations.Get (1)->GetId (), Seconds (600));
+  NodeContainer all (satellites, stations);
+  Simulator::Schedule (stop - NanoSeconds (1), &Verify, manager, all);
+  Simulator::Stop (stop);
+  Simulator::Run ();
+
+  uint32_t n = manager->GetNNodes ();
+  std::cout << g_changes << " link changes recomputed " << g_trees << " trees instead of "
+            << uint64_t (g_changes) * n << " (" << 100.0 * g_trees / std::max<uint64_t> (1, uint64_t (g_changes) * n)
+            << "%)" << std::endl;
+  std::cout << g_replies << " echo replies for " << uint32_t ((stop.GetSeconds () - 1) / 10) + 1
+            << " requests" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Propagates a Walker delta constellation of SAR satellites with a single
+ * ConstellationPropagator and counts the batched course changes.
+ */
+
+#include <ctime>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/constellation-propagator.h"
+#include "ns3/constellation-mobility-model.h"
+
+using namespace ns3;
+
+static uint64_t g_courseChanges = 0;
+
+static void
+CourseChange (Ptr<const MobilityModel> mobility)
+{
+  g_courseChanges++;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t satellites = 540;
+  uint32_t planes = 18;
+  uint32_t phasing = 1;
+  double altitude = 693000.0;
+  double inclination = 97.9;
+  double hours = 24.0;
+  std::string interval = "10s";
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("satellites", "Total number of satellites", satellites);
+  cmd.AddValue ("planes", "Number of orbital planes", planes);
+  cmd.AddValue ("phasing", "Walker phasing factor", phasing);
+  cmd.AddValue ("altitude", "Orbit altitude in m", altitude);
+  cmd.AddValue ("inclination", "Orbit inclination in degrees", inclination);
+  cmd.AddValue ("hours", "Simulated time in hours", hours);
+  cmd.AddValue ("interval", "Batched notification interval", interval);
+  cmd.Parse (argc, argv);
+
+  NodeContainer nodes;
+  nodes.Create (satellites);
+
+  Ptr<ConstellationPropagator> propagator = CreateObject<ConstellationPropagator> ();
+  propagator->SetAttribute ("NotificationInterval", StringValue (interval));
+  propagator->AddWalkerDelta (satellites, planes, phasing, altitude, inclination);
+  propagator->Install (nodes);
+
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      nodes.Get (i)->GetObject<MobilityModel> ()->TraceConnectWithoutContext ("CourseChange", MakeCallback (&CourseChange));
+    }
+
+  std::clock_t begin = std::clock ();
+  Simulator::Stop (Seconds (hours * 3600));
+  Simulator::Run ();
+  double elapsed = double (std::clock () - begin) / CLOCKS_PER_SEC;
+
+  Vector pos = nodes.Get (0)->GetObject<MobilityModel> ()->GetPosition ();
+  std::cout << satellites << " satellites, " << g_courseChanges << " course changes, "
+            << Simulator::GetEventCount () << " events, " << elapsed << "s CPU" << std::endl;
+  std::cout << "satellite 0 at x=" << pos.x << ", y=" << pos.y << ", z=" << pos.z << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
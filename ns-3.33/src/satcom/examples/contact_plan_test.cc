@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Computes the visibility windows between the SAR satellite and a few
+ * ground stations before the simulation starts, then lets the plan drive
+ * the state of the links during the run.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/sar-orbit-mobility-model.h"
+#include "ns3/ground-station-mobility-model.h"
+#include "ns3/orbit-point-to-point-helper.h"
+#include "ns3/orbit-point-to-point-channel.h"
+#include "ns3/contact-plan.h"
+
+using namespace ns3;
+
+static void
+LinkState (std::string context, bool up)
+{
+  std::cout << Simulator::Now ().GetSeconds () << "s " << context
+            << (up ? " up" : " down") << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  double mask = 10.0;
+  double days = 1.0;
+  bool rotate = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("mask", "Elevation mask of the ground stations in degrees", mask);
+  cmd.AddValue ("days", "Planning horizon in days", days);
+  cmd.AddValue ("rotate", "Model the Earth rotation under an inertial orbit", rotate);
+  cmd.Parse (argc, argv);
+
+  NodeContainer satellite;
+  satellite.Create (1);
+  NodeContainer stations;
+  stations.Create (3);
+
+  MobilityHelper satelliteMobility;
+  satelliteMobility.SetMobilityModel ("ns3::SarOrbitMobilityModel",
+                                      "EvaluationMode", StringValue ("Lazy"),
+                                      "Inertial", BooleanValue (rotate));
+  satelliteMobility.Install (satellite);
+
+  /* North Pole, South Pole and a station on the equator */
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0.0, 0.0, 6371000.0));
+  positions->Add (Vector (0.0, 0.0, -6371000.0));
+  positions->Add (Vector (6371000.0, 0.0, 0.0));
+  MobilityHelper stationMobility;
+  stationMobility.SetPositionAllocator (positions);
+  if (rotate)
+    {
+      stationMobility.SetMobilityModel ("ns3::GroundStationMobilityModel",
+                                        "EvaluationMode", StringValue ("Lazy"));
+    }
+  else
+    {
+      stationMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+    }
+  stationMobility.Install (stations);
+
+  Ptr<ContactPlan> plan = CreateObject<ContactPlan> ();
+  uint32_t sat = plan->AddSatellite (satellite.Get (0)->GetObject<OrbitMobilityModel> ());
+  for (uint32_t i = 0; i < stations.GetN (); ++i)
+    {
+      plan->AddGroundStation (stations.Get (i)->GetObject<MobilityModel> (), mask);
+    }
+
+  Time stop = Seconds (days * 86400);
+  plan->Compute (Seconds (0), stop);
+
+  const std::vector<ContactWindow> &windows = plan->GetWindows ();
+  for (std::vector<ContactWindow>::const_iterator it = windows.begin (); it != windows.end (); ++it)
+    {
+      std::cout << *it << std::endl;
+    }
+
+  /* Link state is driven by two events per window, no polling */
+  OrbitPointToPointHelper link;
+  for (uint32_t i = 0; i < stations.GetN (); ++i)
+    {
+      NetDeviceContainer devices = link.Install (stations.Get (i), satellite.Get (0));
+      Ptr<OrbitPointToPointChannel> channel = devices.Get (0)->GetChannel ()->GetObject<OrbitPointToPointChannel> ();
+      std::ostringstream context;
+      context << "station " << i;
+      channel->TraceConnect ("LinkState", context.str (), MakeCallback (&LinkState));
+      plan->ScheduleLinkEvents (sat, i, channel);
+    }
+
+  Simulator::Stop (stop);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return 0;
+}
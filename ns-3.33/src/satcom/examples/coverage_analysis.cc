@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Geometry-only SAR planning: imaging coverage and revisit of a global
+ * grid and the contacts of four polar ground stations, for the SAR
+ * satellite over 30 days, computed by CoverageAnalysis without running
+ * a simulation. With --check the contacts are compared against a
+ * ContactPlan of the same stations.
+ */
+
+#include <ctime>
+#include <map>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/coverage-analysis.h"
+#include "ns3/contact-plan.h"
+#include "ns3/sar-orbit-mobility-model.h"
+#include "ns3/satcom-constants.h"
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  double days = 30;
+  double step = 10;
+  double resolution = 1;
+  double minElevation = 30;
+  double maxElevation = 70;
+  double mask = 5;
+  uint32_t threads = 0;
+  bool check = false;
+  std::string grid = "";
+  std::string contacts = "";
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("days", "Analysis period in days", days);
+  cmd.AddValue ("step", "Sampling period in s", step);
+  cmd.AddValue ("resolution", "Grid cell size in degrees", resolution);
+  cmd.AddValue ("minElevation", "Lowest imaging elevation in degrees", minElevation);
+  cmd.AddValue ("maxElevation", "Highest imaging elevation in degrees", maxElevation);
+  cmd.AddValue ("mask", "Ground station elevation mask in degrees", mask);
+  cmd.AddValue ("threads", "Number of threads, 0 for one per core", threads);
+  cmd.AddValue ("check", "Compare the contacts against a ContactPlan", check);
+  cmd.AddValue ("grid", "CSV file for the grid statistics", grid);
+  cmd.AddValue ("contacts", "CSV file for the contact windows", contacts);
+  cmd.Parse (argc, argv);
+
+  const char *names[] = { "north", "south", "inuvik", "kiruna" };
+  const double stations[][2] = { { 90, 0 }, { -90, 0 }, { 68.3, -133.5 }, { 67.9, 21.1 } };
+  const uint32_t nStations = sizeof (stations) / sizeof (stations[0]);
+
+  Ptr<SarOrbitMobilityModel> sar = CreateObject<SarOrbitMobilityModel> ();
+  Ptr<CoverageAnalysis> analysis = CreateObjectWithAttributes<CoverageAnalysis> (
+    "Stop", TimeValue (Days (days)),
+    "Step", TimeValue (Seconds (step)),
+    "MinElevation", DoubleValue (minElevation),
+    "MaxElevation", DoubleValue (maxElevation),
+    "Threads", UintegerValue (threads));
+  analysis->AddSatellite (sar);
+  for (uint32_t i = 0; i < nStations; ++i)
+    {
+      analysis->AddGroundStation (stations[i][0], stations[i][1], 0, mask);
+    }
+  analysis->SetGrid (-90, 90, -180, 180, resolution);
+
+  clock_t begin = clock ();
+  time_t wall = time (0);
+  analysis->Run ();
+  std::cout << days << " days at " << step << " s on a " << resolution << " degree grid: "
+            << double (clock () - begin) / CLOCKS_PER_SEC << " s cpu, "
+            << difftime (time (0), wall) << " s wall" << std::endl;
+
+  uint32_t covered = 0;
+  double sumRevisit = 0;
+  Time maxRevisit;
+  for (uint32_t i = 0; i < analysis->GetNCells (); ++i)
+    {
+      CoverageAnalysis::Cell cell = analysis->GetCell (i);
+      if (cell.accesses > 0)
+        {
+          covered++;
+          sumRevisit += cell.meanRevisit.GetHours ();
+          maxRevisit = Max (maxRevisit, cell.maxRevisit);
+        }
+    }
+  std::cout << "imaged " << covered << " of " << analysis->GetNCells () << " cells, mean revisit "
+            << (covered > 0 ? sumRevisit / covered : 0) << " h, longest " << maxRevisit.GetHours ()
+            << " h" << std::endl;
+
+  std::map<uint32_t, std::vector<ContactWindow> > byStation;
+  const std::vector<ContactWindow> &windows = analysis->GetContacts ();
+  for (std::vector<ContactWindow>::const_iterator it = windows.begin (); it != windows.end (); ++it)
+    {
+      byStation[it->station].push_back (*it);
+    }
+  for (uint32_t i = 0; i < nStations; ++i)
+    {
+      const std::vector<ContactWindow> &w = byStation[i];
+      Time total;
+      Time longestGap;
+      for (uint32_t j = 0; j < w.size (); ++j)
+        {
+          total += w[j].GetDuration ();
+          if (j > 0)
+            {
+              longestGap = Max (longestGap, w[j].start - w[j - 1].end);
+            }
+        }
+      std::cout << names[i] << ": " << w.size () << " contacts, "
+                << (w.empty () ? 0 : total.GetMinutes () / w.size ()) << " min mean, "
+                << total.GetHours () << " h total, longest gap " << longestGap.GetHours () << " h"
+                << std::endl;
+    }
+
+  if (check)
+    {
+      // The default SAR orbit is Earth-fixed, so are the stations
+      Ptr<ContactPlan> plan = CreateObject<ContactPlan> ();
+      plan->AddSatellite (sar);
+      for (uint32_t i = 0; i < nStations; ++i)
+        {
+          double lat = stations[i][0] * M_PI / 180;
+          double lon = stations[i][1] * M_PI / 180;
+          Ptr<ConstantPositionMobilityModel> station = CreateObject<ConstantPositionMobilityModel> ();
+          station->SetPosition (Vector (satcom::EARTH_RADIUS * std::cos (lat) * std::cos (lon),
+                                        satcom::EARTH_RADIUS * std::cos (lat) * std::sin (lon),
+                                        satcom::EARTH_RADIUS * std::sin (lat)));
+          plan->AddGroundStation (station, mask);
+        }
+      begin = clock ();
+      plan->Compute (Seconds (0), Days (days));
+      std::cout << "ContactPlan: " << double (clock () - begin) / CLOCKS_PER_SEC << " s cpu" << std::endl;
+      for (uint32_t i = 0; i < nStations; ++i)
+        {
+          std::vector<ContactWindow> reference = plan->GetWindows (0, i);
+          const std::vector<ContactWindow> &w = byStation[i];
+          Time error;
+          for (uint32_t j = 0; j < std::min (w.size (), reference.size ()); ++j)
+            {
+              error = Max (error, Max (Abs (w[j].start - reference[j].start),
+                                       Abs (w[j].end - reference[j].end)));
+            }
+          std::cout << names[i] << ": " << w.size () << " contacts against " << reference.size ()
+                    << ", largest edge difference " << error.GetSeconds () << " s" << std::endl;
+        }
+    }
+
+  if (!grid.empty ())
+    {
+      analysis->WriteGrid (grid);
+    }
+  if (!contacts.empty ())
+    {
+      analysis->WriteContacts (contacts);
+    }
+  return 0;
+}
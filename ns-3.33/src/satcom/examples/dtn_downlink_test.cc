@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * The SAR satellite stores its imagery onboard and downlinks it in
+ * bundles during the passes over two polar ground stations. The
+ * destination is the north station; the south station relays over a
+ * terrestrial link. Contact graph routing picks the earliest pass for
+ * each bundle and books its volume, and the data delivered during each
+ * pass is compared to the capacity of the pass.
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/sar-orbit-mobility-model.h"
+#include "ns3/orbit-point-to-point-helper.h"
+#include "ns3/orbit-point-to-point-channel.h"
+#include "ns3/contact-plan.h"
+#include "ns3/contact-graph.h"
+#include "ns3/bundle-agent.h"
+
+using namespace ns3;
+
+static std::vector<std::pair<Time, uint32_t> > g_delivered;
+
+static void
+Deliver (Ptr<const Packet> payload, const BundleHeader &header)
+{
+  g_delivered.push_back (std::make_pair (Simulator::Now (), payload->GetSize ()));
+}
+
+static void
+Acquire (Ptr<BundleAgent> agent, uint32_t destination, uint64_t bytes, Time interval)
+{
+  agent->Send (destination, bytes);
+  Simulator::Schedule (interval, &Acquire, agent, destination, bytes, interval);
+}
+
+int main (int argc, char *argv[])
+{
+  double hours = 6.0;
+  std::string rate = "2Mbps";
+  uint64_t imageBytes = 20000000;
+  double imageInterval = 600;
+  double mask = 10.0;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("hours", "Simulated time in hours", hours);
+  cmd.AddValue ("rate", "Downlink data rate", rate);
+  cmd.AddValue ("imageBytes", "Bytes of imagery acquired per image", imageBytes);
+  cmd.AddValue ("imageInterval", "Seconds between images", imageInterval);
+  cmd.AddValue ("mask", "Elevation mask of the ground stations in degrees", mask);
+  cmd.Parse (argc, argv);
+
+  NodeContainer satellite;
+  satellite.Create (1);
+  NodeContainer stations;
+  stations.Create (2);
+
+  MobilityHelper satelliteMobility;
+  satelliteMobility.SetMobilityModel ("ns3::SarOrbitMobilityModel",
+                                      "EvaluationMode", StringValue ("Lazy"));
+  satelliteMobility.Install (satellite);
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0.0, 0.0, 6371000.0));
+  positions->Add (Vector (0.0, 0.0, -6371000.0));
+  MobilityHelper stationMobility;
+  stationMobility.SetPositionAllocator (positions);
+  stationMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  stationMobility.Install (stations);
+
+  Time stop = Seconds (hours * 3600);
+  Ptr<ContactPlan> plan = CreateObject<ContactPlan> ();
+  plan->AddSatellite (satellite.Get (0)->GetObject<OrbitMobilityModel> ());
+  for (uint32_t i = 0; i < stations.GetN (); ++i)
+    {
+      plan->AddGroundStation (stations.Get (i)->GetObject<MobilityModel> (), mask);
+    }
+  plan->Compute (Seconds (0), stop);
+
+  InternetStackHelper stack;
+  stack.Install (satellite);
+  stack.Install (stations);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+
+  OrbitPointToPointHelper downlink;
+  downlink.SetDeviceAttribute ("DataRate", StringValue (rate));
+  std::vector<NetDeviceContainer> ground;
+  std::vector<Ipv4InterfaceContainer> groundInterfaces;
+  for (uint32_t i = 0; i < stations.GetN (); ++i)
+    {
+      ground.push_back (downlink.Install (stations.Get (i), satellite.Get (0)));
+      groundInterfaces.push_back (address.Assign (ground.back ()));
+      address.NewNetwork ();
+      plan->ScheduleLinkEvents (0, i, ground.back ().Get (0)->GetChannel ()->GetObject<OrbitPointToPointChannel> ());
+    }
+  PointToPointHelper terrestrial;
+  terrestrial.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  terrestrial.SetChannelAttribute ("Delay", StringValue ("50ms"));
+  NetDeviceContainer backhaul = terrestrial.Install (stations.Get (1), stations.Get (0));
+  Ipv4InterfaceContainer backhaulInterfaces = address.Assign (backhaul);
+
+  uint32_t satId = satellite.Get (0)->GetId ();
+  std::vector<uint32_t> satIds (1, satId);
+  std::vector<uint32_t> stationIds;
+  stationIds.push_back (stations.Get (0)->GetId ());
+  stationIds.push_back (stations.Get (1)->GetId ());
+  Ptr<ContactGraph> graph = CreateObject<ContactGraph> ();
+  graph->AddContactPlan (plan, satIds, stationIds, DataRate (rate), MilliSeconds (5));
+  graph->AddContact (stationIds[1], stationIds[0], Seconds (0), Time::Max (), DataRate ("1Gbps"), MilliSeconds (50));
+  graph->AddContact (stationIds[0], stationIds[1], Seconds (0), Time::Max (), DataRate ("1Gbps"), MilliSeconds (50));
+
+  Ptr<BundleAgent> agents[3];
+  NodeContainer all (satellite, stations);
+  for (uint32_t i = 0; i < all.GetN (); ++i)
+    {
+      agents[i] = CreateObject<BundleAgent> ();
+      agents[i]->SetContactGraph (graph);
+      all.Get (i)->AddApplication (agents[i]);
+      agents[i]->SetStartTime (Seconds (0));
+    }
+  for (uint32_t i = 0; i < stations.GetN (); ++i)
+    {
+      agents[0]->AddNeighbor (ground[i].Get (1), groundInterfaces[i].GetAddress (0), stationIds[i]);
+      agents[1 + i]->AddNeighbor (ground[i].Get (0), groundInterfaces[i].GetAddress (1), satId);
+    }
+  agents[2]->AddNeighbor (backhaul.Get (0), backhaulInterfaces.GetAddress (1), stationIds[0]);
+  agents[1]->AddNeighbor (backhaul.Get (1), backhaulInterfaces.GetAddress (0), stationIds[1]);
+  agents[1]->TraceConnectWithoutContext ("Deliver", MakeCallback (&Deliver));
+
+  Simulator::Schedule (Seconds (1), &Acquire, agents[0], stationIds[0], imageBytes, Seconds (imageInterval));
+  Simulator::Stop (stop);
+  Simulator::Run ();
+
+  /* Attribute each delivery to the last pass started before it */
+  const std::vector<ContactWindow> &windows = plan->GetWindows ();
+  uint64_t total = 0;
+  for (uint32_t w = 0; w < windows.size (); ++w)
+    {
+      Time next = w + 1 < windows.size () ? windows[w + 1].start : Time::Max ();
+      uint64_t bytes = 0;
+      for (uint32_t k = 0; k < g_delivered.size (); ++k)
+        {
+          if (g_delivered[k].first >= windows[w].start && g_delivered[k].first < next)
+            {
+              bytes += g_delivered[k].second;
+            }
+        }
+      total += bytes;
+      double capacity = windows[w].GetDuration ().GetSeconds () * DataRate (rate).GetBitRate () / 8;
+      std::cout << "pass " << w << " station " << windows[w].station << " at "
+                << windows[w].start.GetSeconds () << "s, " << windows[w].GetDuration ().GetSeconds ()
+                << "s: " << bytes << " bytes delivered, " << 100.0 * bytes / capacity
+                << "% of the pass capacity" << std::endl;
+    }
+  std::cout << total << " bytes delivered, " << agents[0]->GetStoredBytes ()
+            << " bytes still onboard" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,238 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Delivery of SAR image products from a polar-orbiting satellite to a
+ * polar ground station over its visibility windows. A product of
+ * productSize bytes is acquired every interval and handed to a
+ * FileDeliverySender; lost segments are recovered by NAK and a product
+ * started in one pass completes in a later one. The fixed-rate link
+ * loses packets according to the link budget with --errors=1. Every
+ * pass and every product delivered is reported, with the share of the
+ * contact capacity that carried new data. Run with --tcp=1 to send the
+ * same products over one TCP connection instead.
+ */
+
+#include <iomanip>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/sar-orbit-mobility-model.h"
+#include "ns3/orbit-point-to-point-helper.h"
+#include "ns3/orbit-point-to-point-channel.h"
+#include "ns3/contact-plan.h"
+#include "ns3/link-budget-error-model.h"
+#include "ns3/file-delivery-sender.h"
+#include "ns3/file-delivery-receiver.h"
+
+using namespace ns3;
+
+static Ptr<FileDeliverySender> g_sender;
+static uint64_t g_productSize = 0;
+static uint32_t g_products = 0;
+static uint32_t g_pass = 0;
+static Time g_passStart;
+static Time g_contact;
+static uint64_t g_passBytes = 0;
+static uint64_t g_delivered = 0;
+static uint64_t g_lost = 0;
+static uint32_t g_completed = 0;
+static Time g_latency;
+static Time g_maxLatency;
+
+static void
+Acquire (Time interval)
+{
+  g_products++;
+  if (g_sender != 0)
+    {
+      g_sender->AddFile (g_productSize);
+    }
+  Simulator::Schedule (interval, &Acquire, interval);
+}
+
+static void
+LinkState (bool up)
+{
+  if (up)
+    {
+      g_passStart = Simulator::Now ();
+      g_passBytes = 0;
+      std::cout << std::fixed << std::setprecision (1) << "pass " << ++g_pass << " at "
+                << g_passStart.GetSeconds () << "s" << std::endl;
+      return;
+    }
+  Time length = Simulator::Now () - g_passStart;
+  g_contact += length;
+  std::cout << std::fixed << std::setprecision (2) << "  " << length.GetSeconds () << "s, "
+            << g_passBytes / 1e9 << " GB new data";
+  if (g_sender != 0)
+    {
+      std::cout << ", " << g_sender->GetNPending () << " products pending";
+    }
+  std::cout << std::endl;
+}
+
+static void
+Received (Ptr<const Packet> packet, const Address &from)
+{
+  g_passBytes += packet->GetSize ();
+  g_delivered += packet->GetSize ();
+}
+
+static void
+Complete (uint32_t transaction, uint64_t bytes, Time latency)
+{
+  g_completed++;
+  g_latency += latency;
+  g_maxLatency = std::max (g_maxLatency, latency);
+  std::cout << std::fixed << std::setprecision (1) << "  product " << transaction << " delivered at "
+            << Simulator::Now ().GetSeconds () << "s, " << latency.GetMinutes () << " min after acquisition"
+            << std::endl;
+}
+
+static void
+Lost (Ptr<const Packet> packet)
+{
+  g_lost++;
+}
+
+int main (int argc, char *argv[])
+{
+  double hours = 6.0;
+  double productSize = 4e9;
+  double interval = 30.0;
+  std::string rate = "334Mbps";
+  uint32_t modcod = 12;
+  bool errors = true;
+  double minElevation = 5.0;
+  uint32_t segmentSize = 60000;
+  bool tcp = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("hours", "Simulated time in hours", hours);
+  cmd.AddValue ("productSize", "Size of an image product in bytes", productSize);
+  cmd.AddValue ("interval", "Minutes between acquisitions", interval);
+  cmd.AddValue ("rate", "Data rate of the downlink", rate);
+  cmd.AddValue ("errors", "Lose packets according to the link budget", errors);
+  cmd.AddValue ("modcod", "DVB-S2 scheme index of the link budget", modcod);
+  cmd.AddValue ("minElevation", "Elevation mask of the ground station in degrees", minElevation);
+  cmd.AddValue ("segmentSize", "File data bytes per packet", segmentSize);
+  cmd.AddValue ("tcp", "Send the products over TCP instead", tcp);
+  cmd.Parse (argc, argv);
+  g_productSize = productSize;
+
+  NodeContainer satellite;
+  satellite.Create (1);
+  NodeContainer station;
+  station.Create (1);
+
+  MobilityHelper satelliteMobility;
+  satelliteMobility.SetMobilityModel ("ns3::SarOrbitMobilityModel",
+                                      "EvaluationMode", StringValue ("Lazy"));
+  satelliteMobility.Install (satellite);
+  MobilityHelper stationMobility;
+  stationMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  stationMobility.Install (station);
+  station.Get (0)->GetObject<MobilityModel> ()->SetPosition (Vector (0.0, 0.0, 6371000.0));
+
+  Time stop = Seconds (hours * 3600);
+  Ptr<ContactPlan> plan = CreateObject<ContactPlan> ();
+  plan->AddSatellite (satellite.Get (0)->GetObject<OrbitMobilityModel> ());
+  plan->AddGroundStation (station.Get (0)->GetObject<MobilityModel> (), minElevation);
+  plan->Compute (Seconds (0), stop);
+
+  InternetStackHelper stack;
+  stack.Install (satellite);
+  stack.Install (station);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+
+  OrbitPointToPointHelper downlink;
+  downlink.SetDeviceAttribute ("DataRate", StringValue (rate));
+  downlink.SetDeviceAttribute ("Mtu", UintegerValue (std::min<uint32_t> (segmentSize + 25 + 28, 65535)));
+  NetDeviceContainer devices = downlink.Install (station.Get (0), satellite.Get (0));
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+  Ptr<OrbitPointToPointChannel> channel = devices.Get (0)->GetChannel ()->GetObject<OrbitPointToPointChannel> ();
+  plan->ScheduleLinkEvents (0, 0, channel);
+  channel->TraceConnectWithoutContext ("LinkState", MakeCallback (&LinkState));
+  if (channel->IsLinkUp ())
+    {
+      Simulator::ScheduleNow (&LinkState, true);
+    }
+
+  if (errors)
+    {
+      Ptr<LinkBudgetErrorModel> em = CreateObject<LinkBudgetErrorModel> ();
+      em->SetAttribute ("Modcod", UintegerValue (modcod));
+      em->Install (devices.Get (0));
+      devices.Get (0)->TraceConnectWithoutContext ("PhyRxDrop", MakeCallback (&Lost));
+    }
+
+  if (tcp)
+    {
+      /* One connection carries the volume of every product from the start */
+      Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (segmentSize));
+      Config::SetDefault ("ns3::TcpSocket::SndBufSize", UintegerValue (1 << 26));
+      Config::SetDefault ("ns3::TcpSocket::RcvBufSize", UintegerValue (1 << 26));
+      BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (interfaces.GetAddress (0), 9200));
+      source.SetAttribute ("SendSize", UintegerValue (segmentSize));
+      source.SetAttribute ("MaxBytes", UintegerValue (uint64_t (productSize) * (uint64_t (hours * 60 / interval) + 1)));
+      source.Install (satellite.Get (0));
+      PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 9200));
+      ApplicationContainer apps = sink.Install (station.Get (0));
+      apps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&Received));
+    }
+  else
+    {
+      g_sender = CreateObject<FileDeliverySender> ();
+      g_sender->SetAttribute ("Remote", AddressValue (InetSocketAddress (interfaces.GetAddress (0), 9200)));
+      g_sender->SetAttribute ("SegmentSize", UintegerValue (segmentSize));
+      g_sender->SetDownlink (devices.Get (1));
+      g_sender->TraceConnectWithoutContext ("Complete", MakeCallback (&Complete));
+      satellite.Get (0)->AddApplication (g_sender);
+      Ptr<FileDeliveryReceiver> receiver = CreateObject<FileDeliveryReceiver> ();
+      receiver->TraceConnectWithoutContext ("Rx", MakeCallback (&Received));
+      station.Get (0)->AddApplication (receiver);
+    }
+  Simulator::ScheduleNow (&Acquire, Minutes (interval));
+
+  Simulator::Stop (stop);
+  Simulator::Run ();
+
+  double capacity = g_contact.GetSeconds () * DataRate (rate).GetBitRate () / 8;
+  std::cout << std::fixed << std::setprecision (2) << (tcp ? "tcp" : "file delivery") << ": "
+            << g_products << " products acquired, " << g_delivered / 1e9 << " GB new data in "
+            << g_pass << " passes, " << g_lost << " packets lost, "
+            << 100.0 * g_delivered / std::max (capacity, 1.0) << "% of the contact capacity" << std::endl;
+  if (!tcp)
+    {
+      std::cout << std::setprecision (1) << g_completed << " products delivered";
+      if (g_completed > 0)
+        {
+          std::cout << ", latency mean " << g_latency.GetMinutes () / g_completed
+                    << " min, max " << g_maxLatency.GetMinutes () << " min";
+        }
+      std::cout << ", " << g_sender->GetSentSegments () << " segments sent, "
+                << g_sender->GetRetransmittedSegments () << " retransmitted" << std::endl;
+    }
+  g_sender = 0;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,256 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Downlink from SAR satellites on a sun-synchronous orbit to a mission
+ * control center behind five high-latitude ground stations, with three
+ * ways of choosing the station a satellite sends through:
+ *
+ *  - static: routes computed once by global routing, so a satellite only
+ *    delivers while the station its route goes through is visible;
+ *  - break: a HandoverManager switching stations when the serving link
+ *    drops, losing what is queued on it;
+ *  - mbb: a HandoverManager with the ContactPlan, switching "Lead" before
+ *    the window closes while the old link drains (make before break).
+ *
+ * The program prints the data delivered per orbit against what the
+ * contact windows allow, the number of handovers and the packets sent on
+ * a dropped link while another station was visible.
+ */
+
+#include <algorithm>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/orbit-point-to-point-helper.h"
+#include "ns3/orbit-point-to-point-channel.h"
+#include "ns3/ground-station-mobility-model.h"
+#include "ns3/j2-orbit-mobility-model.h"
+#include "ns3/contact-plan.h"
+#include "ns3/handover-manager.h"
+
+using namespace ns3;
+
+static uint64_t g_lost = 0;
+static std::vector<std::vector<Ptr<OrbitPointToPointChannel> > > g_access;
+
+/* Packets a satellite sends on a dropped link while another one is up */
+static void
+Dropped (uint32_t satellite, Ptr<const Packet> packet)
+{
+  for (uint32_t j = 0; j < g_access[satellite].size (); ++j)
+    {
+      if (g_access[satellite][j]->IsLinkUp ())
+        {
+          g_lost++;
+          return;
+        }
+    }
+}
+
+static void
+Handover (uint32_t satellite, int32_t from, int32_t to)
+{
+  std::cout << Simulator::Now ().As (Time::S) << " satellite " << satellite
+            << " station " << from << " -> " << to << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  double hours = 3.3;
+  uint32_t nSatellites = 1;
+  std::string mode = "mbb";
+  std::string policy = "Elevation";
+  std::string rate = "20Mbps";
+  std::string load = "2Mbps";
+  double mask = 5;
+  double lead = 1;
+  bool verbose = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("hours", "Simulated time in hours", hours);
+  cmd.AddValue ("satellites", "Number of satellites, evenly spaced on the orbit", nSatellites);
+  cmd.AddValue ("mode", "Station choice: static, break or mbb", mode);
+  cmd.AddValue ("policy", "Handover policy: Elevation or Load", policy);
+  cmd.AddValue ("rate", "Data rate of the access links", rate);
+  cmd.AddValue ("load", "Downlink traffic of each satellite", load);
+  cmd.AddValue ("mask", "Elevation mask of the stations in degrees", mask);
+  cmd.AddValue ("lead", "Make before break lead time in s", lead);
+  cmd.AddValue ("verbose", "Print every handover", verbose);
+  cmd.Parse (argc, argv);
+  NS_ABORT_MSG_IF (mode != "static" && mode != "break" && mode != "mbb", "unknown mode " << mode);
+
+  NodeContainer satellites;
+  satellites.Create (nSatellites);
+  for (uint32_t i = 0; i < nSatellites; ++i)
+    {
+      Ptr<J2OrbitMobilityModel> orbit = CreateObject<J2OrbitMobilityModel> ();
+      orbit->SetAttribute ("EvaluationMode", StringValue ("Lazy"));
+      orbit->SetAttribute ("SunSynchronous", BooleanValue (true));
+      orbit->SetAttribute ("RepeatOrbits", UintegerValue (175));
+      orbit->SetAttribute ("RepeatDays", UintegerValue (12));
+      orbit->SetAttribute ("MeanAnomaly", DoubleValue (360.0 * i / nSatellites));
+      satellites.Get (i)->AggregateObject (orbit);
+    }
+
+  /* Svalbard, Kiruna, Inuvik, Fairbanks and Troll */
+  NodeContainer stations;
+  stations.Create (5);
+  double coordinates[5][2] = { { 78.23, 15.41 }, { 67.86, 20.96 }, { 68.32, -133.55 },
+                               { 64.86, -147.85 }, { -72.01, 2.54 } };
+  for (uint32_t i = 0; i < stations.GetN (); ++i)
+    {
+      Ptr<GroundStationMobilityModel> mobility = CreateObject<GroundStationMobilityModel> ();
+      mobility->SetAttribute ("EvaluationMode", StringValue ("Lazy"));
+      mobility->SetGeographicPosition (coordinates[i][0], coordinates[i][1]);
+      stations.Get (i)->AggregateObject (mobility);
+    }
+  Ptr<Node> control = CreateObject<Node> ();
+
+  InternetStackHelper stack;
+  stack.Install (satellites);
+  stack.Install (stations);
+  stack.Install (control);
+
+  /* Terrestrial backhaul from every station to the control center */
+  PointToPointHelper backhaul;
+  backhaul.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  backhaul.SetChannelAttribute ("Delay", StringValue ("20ms"));
+  Ipv4AddressHelper address;
+  address.SetBase ("10.2.0.0", "255.255.255.0");
+  for (uint32_t i = 0; i < stations.GetN (); ++i)
+    {
+      address.Assign (backhaul.Install (stations.Get (i), control));
+      address.NewNetwork ();
+    }
+
+  Time stop = Seconds (hours * 3600);
+  Ptr<ContactPlan> plan = CreateObject<ContactPlan> ();
+  for (uint32_t i = 0; i < nSatellites; ++i)
+    {
+      plan->AddSatellite (satellites.Get (i)->GetObject<OrbitMobilityModel> ());
+    }
+  for (uint32_t i = 0; i < stations.GetN (); ++i)
+    {
+      plan->AddGroundStation (stations.Get (i)->GetObject<MobilityModel> (), mask);
+    }
+  plan->Compute (Seconds (0), stop);
+
+  OrbitPointToPointHelper access;
+  access.SetDeviceAttribute ("DataRate", StringValue (rate));
+  address.SetBase ("10.1.0.0", "255.255.255.0");
+  g_access.resize (nSatellites);
+  for (uint32_t i = 0; i < nSatellites; ++i)
+    {
+      for (uint32_t j = 0; j < stations.GetN (); ++j)
+        {
+          NetDeviceContainer devices = access.Install (stations.Get (j), satellites.Get (i));
+          address.Assign (devices);
+          address.NewNetwork ();
+          devices.Get (1)->TraceConnectWithoutContext ("PhyTxDrop", MakeCallback (&Dropped).Bind (i));
+          Ptr<OrbitPointToPointChannel> channel = devices.Get (0)->GetChannel ()->GetObject<OrbitPointToPointChannel> ();
+          plan->ScheduleLinkEvents (i, j, channel);
+          g_access[i].push_back (channel);
+        }
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  Ptr<HandoverManager> manager;
+  if (mode != "static")
+    {
+      manager = CreateObject<HandoverManager> ();
+      manager->SetAttribute ("Policy", StringValue (policy));
+      manager->SetAttribute ("Lead", TimeValue (Seconds (lead)));
+      if (mode == "mbb")
+        {
+          manager->SetContactPlan (plan);
+        }
+      for (uint32_t i = 0; i < nSatellites; ++i)
+        {
+          manager->AddSatellite (satellites.Get (i), i);
+        }
+      for (uint32_t j = 0; j < stations.GetN (); ++j)
+        {
+          manager->AddGroundStation (stations.Get (j), j);
+        }
+      for (uint32_t i = 0; i < nSatellites; ++i)
+        {
+          for (uint32_t j = 0; j < g_access[i].size (); ++j)
+            {
+              manager->AddAccessLink (g_access[i][j]);
+            }
+        }
+      manager->Install (control);
+      if (verbose)
+        {
+          manager->TraceConnectWithoutContext ("Handover", MakeCallback (&Handover));
+        }
+    }
+
+  uint16_t port = 9000;
+  Ipv4Address controlAddress = control->GetObject<Ipv4> ()->GetAddress (1, 0).GetLocal ();
+  PacketSinkHelper sinkHelper ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sinkHelper.Install (control);
+  OnOffHelper source ("ns3::UdpSocketFactory", InetSocketAddress (controlAddress, port));
+  source.SetConstantRate (DataRate (load), 1400);
+  ApplicationContainer sources = source.Install (satellites);
+  sources.Stop (stop);
+
+  Simulator::Stop (stop + Seconds (1));
+  Simulator::Run ();
+
+  /* Time at least one station sees each satellite */
+  double visible = 0;
+  for (uint32_t i = 0; i < nSatellites; ++i)
+    {
+      std::vector<std::pair<Time, Time> > windows;
+      for (uint32_t j = 0; j < stations.GetN (); ++j)
+        {
+          std::vector<ContactWindow> pair = plan->GetWindows (i, j);
+          for (std::vector<ContactWindow>::const_iterator it = pair.begin (); it != pair.end (); ++it)
+            {
+              windows.push_back (std::make_pair (it->start, it->end));
+            }
+        }
+      std::sort (windows.begin (), windows.end ());
+      Time end = Seconds (0);
+      for (std::vector<std::pair<Time, Time> >::const_iterator it = windows.begin (); it != windows.end (); ++it)
+        {
+          visible += std::max (0.0, (it->second - Max (it->first, end)).GetSeconds ());
+          end = Max (end, it->second);
+        }
+    }
+
+  double orbits = stop.GetSeconds () / satellites.Get (0)->GetObject<J2OrbitMobilityModel> ()->GetNodalPeriod ();
+  uint64_t received = DynamicCast<PacketSink> (sinkApps.Get (0))->GetTotalRx ();
+  double possible = visible * DataRate (load).GetBitRate () / 8;
+  std::cout << "mode " << mode << ": " << received / 1e6 / orbits / nSatellites << " MB per orbit and satellite, "
+            << 100.0 * received / possible << "% of the " << visible << " s of visibility" << std::endl;
+  if (manager != 0)
+    {
+      std::cout << manager->GetNHandovers () << " handovers, " << manager->GetNBreaks ()
+                << " on a dropped link" << std::endl;
+    }
+  std::cout << g_lost << " packets lost on dropped links while another station was visible" << std::endl;
+  g_access.clear ();
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Compares J2OrbitMobilityModel with SarOrbitMobilityModel over several
+ * weeks. The J2 orbit is a sun-synchronous SAR orbit repeating its ground
+ * track after 175 orbits in 12 days; the program prints its derived
+ * elements, the measured node drift, the largest velocity step between
+ * two samples for both models (the SAR model turns its orbital plane in
+ * one step every orbit), the ground track repeat error and the cost of a
+ * position query early and late in the run.
+ */
+
+#include <ctime>
+#include <cmath>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/j2-orbit-mobility-model.h"
+#include "ns3/sar-orbit-mobility-model.h"
+
+using namespace ns3;
+
+/**
+ * \param model an orbit model
+ * \param days the span to sample
+ * \param step the sampling period in s
+ * \param velocityError set to the largest difference between the reported
+ * velocity and the central difference of the positions, in m/s
+ * \returns the largest velocity change between two samples, in m/s
+ */
+static double
+GetLargestVelocityStep (Ptr<OrbitMobilityModel> model, double days, double step, double &velocityError)
+{
+  double largest = 0;
+  velocityError = 0;
+  Vector previous = model->GetVelocityAt (Seconds (0));
+  for (double t = step; t < days * 86400; t += step)
+    {
+      Vector velocity = model->GetVelocityAt (Seconds (t));
+      largest = std::max (largest, CalculateDistance (velocity, previous));
+      previous = velocity;
+      Vector before = model->GetPositionAt (Seconds (t - 0.5));
+      Vector after = model->GetPositionAt (Seconds (t + 0.5));
+      Vector difference (after.x - before.x, after.y - before.y, after.z - before.z);
+      velocityError = std::max (velocityError, CalculateDistance (difference, velocity));
+    }
+  return largest;
+}
+
+/**
+ * \param model an inertial orbit model
+ * \param t an absolute time
+ * \returns the right ascension of the ascending node at that time, in degrees
+ */
+static double
+GetNode (Ptr<OrbitMobilityModel> model, Time t)
+{
+  Vector r = model->GetPositionAt (t);
+  Vector v = model->GetVelocityAt (t);
+  Vector h (r.y * v.z - r.z * v.y, r.z * v.x - r.x * v.z, r.x * v.y - r.y * v.x);
+  return std::atan2 (h.x, -h.y) * 180.0 / M_PI;
+}
+
+/**
+ * \param model an orbit model
+ * \param from the first query time in s
+ * \param queries the number of queries, one per minute
+ * \returns the mean cost of a position query in ns
+ */
+static double
+GetQueryCost (Ptr<OrbitMobilityModel> model, double from, uint32_t queries)
+{
+  double sum = 0;
+  std::clock_t start = std::clock ();
+  for (uint32_t i = 0; i < queries; i++)
+    {
+      sum += model->GetPositionAt (Seconds (from + 60.0 * i)).z;
+    }
+  double seconds = double (std::clock () - start) / CLOCKS_PER_SEC;
+  NS_ASSERT (!std::isnan (sum));
+  return seconds * 1e9 / queries;
+}
+
+int main (int argc, char *argv[])
+{
+  double days = 28;
+  double step = 10;
+  uint32_t orbits = 175;
+  uint32_t cycle = 12;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("days", "Span to compare in days", days);
+  cmd.AddValue ("step", "Sampling period in s", step);
+  cmd.AddValue ("orbits", "Orbits per ground track repeat cycle", orbits);
+  cmd.AddValue ("cycle", "Days per ground track repeat cycle", cycle);
+  cmd.Parse (argc, argv);
+
+  Ptr<J2OrbitMobilityModel> j2 = CreateObject<J2OrbitMobilityModel> ();
+  j2->SetAttribute ("SunSynchronous", BooleanValue (true));
+  j2->SetAttribute ("RepeatOrbits", UintegerValue (orbits));
+  j2->SetAttribute ("RepeatDays", UintegerValue (cycle));
+  j2->SetAttribute ("EarthFixed", BooleanValue (true));
+  Ptr<J2OrbitMobilityModel> inertial = CreateObject<J2OrbitMobilityModel> ();
+  inertial->SetAttribute ("SunSynchronous", BooleanValue (true));
+  inertial->SetAttribute ("RepeatOrbits", UintegerValue (orbits));
+  inertial->SetAttribute ("RepeatDays", UintegerValue (cycle));
+  Ptr<SarOrbitMobilityModel> sar = CreateObject<SarOrbitMobilityModel> ();
+
+  std::cout << "J2 orbit: altitude " << (j2->GetSemiMajorAxis () - 6371000.0) / 1000 << " km"
+            << ", inclination " << j2->GetInclination () << " deg"
+            << ", nodal period " << j2->GetNodalPeriod () << " s" << std::endl;
+
+  double drift = GetNode (inertial, Seconds (days * 86400)) - GetNode (inertial, Seconds (0));
+  drift = std::fmod (drift + 360.0, 360.0);
+  std::cout << "Node drift: " << j2->GetRaanRate () * 86400 * 180 / M_PI << " deg/day expected, "
+            << drift / days << " deg/day measured over " << days << " days"
+            << " (sun-synchronous: " << 360 / 365.2422 << ")" << std::endl;
+
+  double error;
+  double j2Step = GetLargestVelocityStep (j2, days, step, error);
+  std::cout << "J2 orbit: largest velocity step " << j2Step << " m/s in " << step << " s"
+            << ", velocity error " << error << " m/s" << std::endl;
+  double sarStep = GetLargestVelocityStep (sar, days, step, error);
+  std::cout << "SAR orbit: largest velocity step " << sarStep << " m/s in " << step << " s"
+            << ", velocity error " << error << " m/s" << std::endl;
+
+  double repeat = 0;
+  for (double t = 0; t < 86400; t += step)
+    {
+      repeat = std::max (repeat, CalculateDistance (j2->GetPositionAt (Seconds (t)),
+                                                    j2->GetPositionAt (Seconds (t + cycle * 86400.0))));
+    }
+  std::cout << "Ground track repeat error after " << cycle << " days: " << repeat << " m" << std::endl;
+
+  std::cout << "Query cost: " << GetQueryCost (j2, 0, 100000) << " ns in the first days, "
+            << GetQueryCost (j2, 10 * 365 * 86400.0, 100000) << " ns after 10 years" << std::endl;
+  return 0;
+}
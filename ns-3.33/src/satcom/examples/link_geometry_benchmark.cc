@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Times the batch link geometry kernel against the per-pair scalar
+ * path (CalculateDistance and ContactPlan::GetElevation) for one
+ * satellite over many ground points, and reports the largest
+ * difference between the two.
+ */
+
+#include <ctime>
+
+#include "ns3/core-module.h"
+#include "ns3/calculatedistance.h"
+#include "ns3/contact-plan.h"
+#include "ns3/satcom-constants.h"
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  uint32_t points = 100000;
+  uint32_t rounds = 20;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("points", "Number of ground points", points);
+  cmd.AddValue ("rounds", "Number of satellite positions", rounds);
+  cmd.Parse (argc, argv);
+
+  std::vector<double> x (points);
+  std::vector<double> y (points);
+  std::vector<double> z (points);
+  std::vector<Vector> ground (points);
+  Ptr<UniformRandomVariable> u = CreateObject<UniformRandomVariable> ();
+  for (uint32_t i = 0; i < points; ++i)
+    {
+      double h = u->GetValue (-1.0, 1.0);
+      double phi = u->GetValue (0.0, 2 * M_PI);
+      double rho = std::sqrt (1 - h * h);
+      ground[i] = Vector (satcom::EARTH_RADIUS * rho * std::cos (phi),
+                          satcom::EARTH_RADIUS * rho * std::sin (phi),
+                          satcom::EARTH_RADIUS * h);
+      x[i] = ground[i].x;
+      y[i] = ground[i].y;
+      z[i] = ground[i].z;
+    }
+
+  std::vector<double> distance (points);
+  std::vector<double> elevation (points);
+  std::vector<double> delay (points);
+  std::vector<double> refDistance (points);
+  std::vector<double> refElevation (points);
+  std::vector<double> refDelay (points);
+  std::vector<double> cutDistance (points);
+  double batch = 0;
+  double scalar = 0;
+  double maxDistanceError = 0;
+  double maxElevationError = 0;
+  double maxDelayError = 0;
+  uint32_t cutoffMismatches = 0;
+  for (uint32_t r = 0; r < rounds; ++r)
+    {
+      double rs = satcom::EARTH_RADIUS + 693000.0;
+      double h = u->GetValue (-1.0, 1.0);
+      double phi = u->GetValue (0.0, 2 * M_PI);
+      double rho = std::sqrt (1 - h * h);
+      Vector satellite (rs * rho * std::cos (phi), rs * rho * std::sin (phi), rs * h);
+
+      std::clock_t begin = std::clock ();
+      CalculateLinkGeometry (&x[0], &y[0], &z[0], points, satellite,
+                             &distance[0], &elevation[0], &delay[0]);
+      batch += std::clock () - begin;
+      CalculateDistances (&x[0], &y[0], &z[0], points, satellite, &cutDistance[0]);
+
+      begin = std::clock ();
+      for (uint32_t i = 0; i < points; ++i)
+        {
+          refDistance[i] = CalculateDistance (ground[i], satellite);
+          refElevation[i] = ContactPlan::GetElevation (ground[i], satellite);
+          refDelay[i] = refDistance[i] / satcom::SPEED_OF_LIGHT;
+        }
+      scalar += std::clock () - begin;
+
+      for (uint32_t i = 0; i < points; ++i)
+        {
+          // The scalar distance is infinite beyond the radio horizon
+          if (!std::isinf (refDistance[i]))
+            {
+              maxDistanceError = std::max (maxDistanceError, std::abs (distance[i] - refDistance[i]));
+              maxDelayError = std::max (maxDelayError, std::abs (delay[i] - refDelay[i]));
+            }
+          maxElevationError = std::max (maxElevationError, std::abs (elevation[i] - refElevation[i]));
+          if (std::isinf (cutDistance[i]) != std::isinf (refDistance[i]))
+            {
+              cutoffMismatches++;
+            }
+        }
+    }
+
+  std::cout << rounds << " x " << points << " link geometries, "
+            << (IsLinkGeometryVectorized () ? "AVX2" : "scalar") << " kernel" << std::endl;
+  std::cout << "batch " << batch / CLOCKS_PER_SEC << "s, scalar "
+            << scalar / CLOCKS_PER_SEC << "s" << std::endl;
+  std::cout << "max difference: distance " << maxDistanceError << " m, elevation "
+            << maxElevationError << " deg, delay " << maxDelayError << " s, "
+            << cutoffMismatches << " horizon cutoff mismatches" << std::endl;
+  return maxElevationError < 1e-9 && maxDistanceError < 1e-6 && cutoffMismatches == 0 ? 0 : 1;
+}
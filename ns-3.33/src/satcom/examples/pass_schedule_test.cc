@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Assigns the passes of a fleet of sun-synchronous SAR satellites over a
+ * few high-latitude ground stations with PassScheduler. Every satellite
+ * starts with a backlog and keeps producing data; each station tracks
+ * one satellite at a time. The program prints how many windows compete
+ * for a station, the volume planned by the greedy step and after the
+ * local search, and the solver time. Run with --print=1 for the
+ * schedule itself; examples/scenarios/sar-fleet.scn executes such a
+ * schedule in a packet simulation.
+ */
+
+#include <cmath>
+#include <iomanip>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/satcom-constants.h"
+#include "ns3/j2-orbit-mobility-model.h"
+#include "ns3/contact-plan.h"
+#include "ns3/pass-scheduler.h"
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  uint32_t satellites = 8;
+  uint32_t planes = 2;
+  uint32_t stations = 3;
+  double hours = 24.0;
+  double backlog = 20e9;
+  std::string generation = "60Mbps";
+  std::string rate = "334Mbps";
+  double minElevation = 5.0;
+  uint32_t rounds = 20;
+  bool print = false;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("satellites", "Number of satellites", satellites);
+  cmd.AddValue ("planes", "Number of orbital planes", planes);
+  cmd.AddValue ("stations", "Number of ground stations, up to 4", stations);
+  cmd.AddValue ("hours", "Planning horizon in hours", hours);
+  cmd.AddValue ("backlog", "Data each satellite holds at the start, in bytes", backlog);
+  cmd.AddValue ("generation", "Mean data rate each satellite produces", generation);
+  cmd.AddValue ("rate", "Downlink rate", rate);
+  cmd.AddValue ("minElevation", "Elevation mask of the ground stations in degrees", minElevation);
+  cmd.AddValue ("rounds", "Local search rounds", rounds);
+  cmd.AddValue ("print", "Print the schedule", print);
+  cmd.Parse (argc, argv);
+
+  /* Svalbard, Troll, Inuvik and Kiruna */
+  const double sites[][2] = { { 78.2, 15.4 }, { -72.0, 2.5 }, { 68.3, -133.5 }, { 67.9, 21.1 } };
+  stations = std::min<uint32_t> (stations, 4);
+  planes = std::max<uint32_t> (std::min (planes, satellites), 1);
+
+  Ptr<ContactPlan> plan = CreateObject<ContactPlan> ();
+  uint32_t perPlane = (satellites + planes - 1) / planes;
+  for (uint32_t i = 0; i < satellites; ++i)
+    {
+      Ptr<J2OrbitMobilityModel> orbit = CreateObject<J2OrbitMobilityModel> ();
+      orbit->SetAttribute ("SunSynchronous", BooleanValue (true));
+      orbit->SetAttribute ("RepeatOrbits", UintegerValue (175));
+      orbit->SetAttribute ("RepeatDays", UintegerValue (12));
+      orbit->SetAttribute ("EarthFixed", BooleanValue (true));
+      orbit->SetAttribute ("Raan", DoubleValue (180.0 / planes * (i % planes)));
+      orbit->SetAttribute ("MeanAnomaly", DoubleValue (360.0 / perPlane * (i / planes)));
+      plan->AddSatellite (orbit);
+    }
+  for (uint32_t i = 0; i < stations; ++i)
+    {
+      double lat = sites[i][0] * M_PI / 180;
+      double lon = sites[i][1] * M_PI / 180;
+      Ptr<ConstantPositionMobilityModel> station = CreateObject<ConstantPositionMobilityModel> ();
+      station->SetPosition (Vector (satcom::EARTH_RADIUS * std::cos (lat) * std::cos (lon),
+                                    satcom::EARTH_RADIUS * std::cos (lat) * std::sin (lon),
+                                    satcom::EARTH_RADIUS * std::sin (lat)));
+      plan->AddGroundStation (station, minElevation);
+    }
+  plan->Compute (Seconds (0), Hours (hours));
+
+  /* Windows whose station is busy with another satellite at some point */
+  const std::vector<ContactWindow> &windows = plan->GetWindows ();
+  uint32_t contended = 0;
+  double capacity = 0;
+  for (uint32_t i = 0; i < windows.size (); ++i)
+    {
+      capacity += DataRate (rate).GetBitRate () * windows[i].GetDuration ().GetSeconds () / 8;
+      for (uint32_t j = 0; j < windows.size (); ++j)
+        {
+          if (i != j && windows[i].station == windows[j].station
+              && windows[j].start < windows[i].end && windows[i].start < windows[j].end)
+            {
+              contended++;
+              break;
+            }
+        }
+    }
+  double demand = satellites * (backlog + DataRate (generation).GetBitRate () * hours * 3600 / 8);
+
+  Ptr<PassScheduler> scheduler = CreateObject<PassScheduler> ();
+  scheduler->SetAttribute ("DataRate", DataRateValue (DataRate (rate)));
+  scheduler->SetAttribute ("MaxRounds", UintegerValue (rounds));
+  scheduler->SetContactPlan (plan);
+  for (uint32_t i = 0; i < satellites; ++i)
+    {
+      scheduler->SetBacklog (i, static_cast<uint64_t> (backlog));
+      scheduler->SetGenerationRate (i, DataRate (generation));
+    }
+  SystemWallClockMs clock;
+  clock.Start ();
+  scheduler->Solve ();
+  int64_t ms = clock.End ();
+
+  if (print)
+    {
+      scheduler->Print (std::cout);
+    }
+  std::cout << std::fixed << std::setprecision (1)
+            << satellites << " satellites, " << stations << " stations, " << hours << " h: "
+            << windows.size () << " windows, " << contended << " contended, "
+            << capacity / 1e9 << " GB if every window were usable, demand " << demand / 1e9 << " GB" << std::endl
+            << "greedy " << scheduler->GetGreedyBytes () / 1e9 << " GB, local search "
+            << scheduler->GetPlannedBytes () / 1e9 << " GB (+"
+            << 100.0 * (scheduler->GetPlannedBytes () - double (scheduler->GetGreedyBytes ()))
+               / std::max<double> (scheduler->GetGreedyBytes (), 1)
+            << "%) with " << scheduler->GetNExchanges () << " exchanges, "
+            << scheduler->GetSchedule ().size () << " passes, solved in " << ms << " ms" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
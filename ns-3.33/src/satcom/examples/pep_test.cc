@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Bulk TCP from a client behind one ground station to a server behind
+ * another, through a satellite relaying between them:
+ *
+ *   client ---- gateway A ~~~~ satellite ~~~~ gateway B ---- server
+ *
+ * The geometry is frozen, the satellite above the equator at "altitude"
+ * (geostationary by default) and the gateways "latitude" degrees north
+ * and south of it. The transfer runs once end to end and once per space
+ * transport with a split-TCP PepApplication on each gateway, the space
+ * legs using that transport, and the program prints the goodput of each
+ * run and its gain over the end-to-end one. "loss" adds random packet
+ * errors on the space links.
+ */
+
+#include <cmath>
+#include <sstream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/orbit-point-to-point-helper.h"
+#include "ns3/satcom-constants.h"
+#include "ns3/pep-application.h"
+
+using namespace ns3;
+
+/* Bytes the server received over the run */
+static uint64_t
+RunTransfer (std::string transport, double altitude, double latitude, std::string rate,
+             double loss, double seconds)
+{
+  NodeContainer nodes;
+  nodes.Create (5);
+  Ptr<Node> client = nodes.Get (0);
+  Ptr<Node> gatewayA = nodes.Get (1);
+  Ptr<Node> satellite = nodes.Get (2);
+  Ptr<Node> gatewayB = nodes.Get (3);
+  Ptr<Node> server = nodes.Get (4);
+
+  double phi = latitude * M_PI / 180.0;
+  Vector positions[5] = {
+    Vector (satcom::EARTH_RADIUS * std::cos (phi), 0, satcom::EARTH_RADIUS * std::sin (phi)),
+    Vector (satcom::EARTH_RADIUS * std::cos (phi), 0, satcom::EARTH_RADIUS * std::sin (phi)),
+    Vector (satcom::EARTH_RADIUS + altitude, 0, 0),
+    Vector (satcom::EARTH_RADIUS * std::cos (phi), 0, -satcom::EARTH_RADIUS * std::sin (phi)),
+    Vector (satcom::EARTH_RADIUS * std::cos (phi), 0, -satcom::EARTH_RADIUS * std::sin (phi))
+  };
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (positions[i]);
+      nodes.Get (i)->AggregateObject (mobility);
+    }
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.0.0", "255.255.255.0");
+
+  PointToPointHelper terrestrial;
+  terrestrial.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  terrestrial.SetChannelAttribute ("Delay", StringValue ("5ms"));
+  address.Assign (terrestrial.Install (client, gatewayA));
+  address.NewNetwork ();
+
+  OrbitPointToPointHelper space;
+  space.SetDeviceAttribute ("DataRate", StringValue (rate));
+  Ptr<Node> ends[2] = { gatewayA, gatewayB };
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      NetDeviceContainer devices = space.Install (ends[i], satellite);
+      if (loss > 0)
+        {
+          for (uint32_t j = 0; j < devices.GetN (); ++j)
+            {
+              Ptr<RateErrorModel> errors = CreateObject<RateErrorModel> ();
+              errors->SetAttribute ("ErrorUnit", StringValue ("ERROR_UNIT_PACKET"));
+              errors->SetAttribute ("ErrorRate", DoubleValue (loss));
+              devices.Get (j)->SetAttribute ("ReceiveErrorModel", PointerValue (errors));
+            }
+        }
+      address.NewNetwork ();
+      address.Assign (devices);
+    }
+  address.NewNetwork ();
+  Ipv4InterfaceContainer serverInterfaces = address.Assign (terrestrial.Install (gatewayB, server));
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  uint16_t port = 618;
+  Address remote = InetSocketAddress (serverInterfaces.GetAddress (1), port);
+  PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sinkHelper.Install (server);
+  if (!transport.empty ())
+    {
+      /* The gateway B proxy accepts the space leg, the gateway A one opens it */
+      Ptr<PepApplication> peps[2];
+      for (uint32_t i = 0; i < 2; ++i)
+        {
+          peps[i] = CreateObject<PepApplication> ();
+          peps[i]->SetAttribute ("Port", UintegerValue (port + 1000));
+          peps[i]->SetAttribute ("SpaceCongestionControl", StringValue (transport));
+          ends[i]->AddApplication (peps[i]);
+        }
+      peps[1]->SetAttribute ("SpaceLeg", StringValue ("Accepted"));
+      peps[1]->SetAttribute ("Remote", AddressValue (remote));
+      Ptr<Ipv4> ipv4 = gatewayB->GetObject<Ipv4> ();
+      remote = InetSocketAddress (ipv4->GetAddress (1, 0).GetLocal (), port + 1000);
+      peps[0]->SetAttribute ("SpaceLeg", StringValue ("Connected"));
+      peps[0]->SetAttribute ("Remote", AddressValue (remote));
+      ipv4 = gatewayA->GetObject<Ipv4> ();
+      remote = InetSocketAddress (ipv4->GetAddress (1, 0).GetLocal (), port + 1000);
+    }
+  BulkSendHelper source ("ns3::TcpSocketFactory", remote);
+  source.SetAttribute ("SendSize", UintegerValue (1448));
+  ApplicationContainer sources = source.Install (client);
+  sources.Start (Seconds (1));
+
+  Simulator::Stop (Seconds (1 + seconds));
+  Simulator::Run ();
+  uint64_t received = DynamicCast<PacketSink> (sinkApps.Get (0))->GetTotalRx ();
+  Simulator::Destroy ();
+  return received;
+}
+
+int main (int argc, char *argv[])
+{
+  double altitude = 35786e3;
+  double latitude = 30;
+  std::string rate = "50Mbps";
+  double loss = 0;
+  double seconds = 20;
+  std::string transports = "ns3::TcpHybla;ns3::TcpFixedRate[Rate=48Mbps]";
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("altitude", "Altitude of the satellite in m", altitude);
+  cmd.AddValue ("latitude", "Latitude of the gateways in degrees, north and south", latitude);
+  cmd.AddValue ("rate", "Data rate of the space links", rate);
+  cmd.AddValue ("loss", "Packet error rate of the space links", loss);
+  cmd.AddValue ("seconds", "Length of the transfer in s", seconds);
+  cmd.AddValue ("transports", "Space leg congestion controls to compare, separated by ';'", transports);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1448));
+
+  uint64_t direct = RunTransfer ("", altitude, latitude, rate, loss, seconds);
+  std::cout << "end to end: " << direct * 8 / seconds / 1e6 << " Mbps" << std::endl;
+  std::istringstream is (transports);
+  std::string transport;
+  while (std::getline (is, transport, ';'))
+    {
+      uint64_t split = RunTransfer (transport, altitude, latitude, rate, loss, seconds);
+      std::cout << "split, " << transport << ": " << split * 8 / seconds / 1e6 << " Mbps, "
+                << (direct > 0 ? 1.0 * split / direct : 0.0) << "x" << std::endl;
+    }
+  return 0;
+}
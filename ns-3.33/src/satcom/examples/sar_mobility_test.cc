@@ -43,7 +43,10 @@ CourseChange (std::string foo, Ptr<const MobilityModel> mobility)
 
 int main (int argc, char *argv[])
 {
+  bool lazy = false;
+
   CommandLine cmd (__FILE__);
+  cmd.AddValue ("lazy", "Evaluate the orbit on demand instead of every time step", lazy);
   cmd.Parse (argc, argv);
 
   NodeContainer c;
@@ -57,7 +60,17 @@ int main (int argc, char *argv[])
                                           "Z", StringValue("ns3::UniformRandomVariable[Min=7064000|Max=7064000]"));
 
   /* Set time step to display position and velocity every quarter of an orbit around the earth */
-  mobility.SetMobilityModel ("ns3::SarOrbitMobilityModel", "Timestep", StringValue("1481.1425s"));
+  if (lazy)
+    {
+      /* Same output, but without any periodic update event */
+      mobility.SetMobilityModel ("ns3::SarOrbitMobilityModel",
+                                 "EvaluationMode", StringValue ("Lazy"),
+                                 "NotificationInterval", StringValue ("1481.1425s"));
+    }
+  else
+    {
+      mobility.SetMobilityModel ("ns3::SarOrbitMobilityModel", "Timestep", StringValue("1481.1425s"));
+    }
   mobility.InstallAll();
 
   Config::Connect ("/NodeList/*/$ns3::MobilityModel/CourseChange",
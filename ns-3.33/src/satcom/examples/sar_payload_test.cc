@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * The SAR satellite acquires bursts of imagery into its onboard memory
+ * and downlinks them to the polar ground stations during the passes.
+ * Reports per priority class how much was acquired, delivered and
+ * lost, and how old the delivered data was.
+ */
+
+#include <ctime>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/sar-orbit-mobility-model.h"
+#include "ns3/orbit-point-to-point-helper.h"
+#include "ns3/orbit-point-to-point-channel.h"
+#include "ns3/contact-plan.h"
+#include "ns3/sar-payload-application.h"
+#include "ns3/sar-data-tag.h"
+
+using namespace ns3;
+
+static uint64_t g_acquired[256];
+static uint64_t g_delivered[256];
+static uint64_t g_lost[256];
+static double g_age[256];
+
+static void
+Acquisition (uint32_t acquisition, uint8_t priority, uint64_t bytes)
+{
+  g_acquired[priority] += bytes;
+}
+
+static void
+Lost (uint8_t priority, uint64_t bytes)
+{
+  g_lost[priority] += bytes;
+}
+
+static void
+Received (Ptr<const Packet> packet, const Address &from)
+{
+  SarDataTag tag;
+  if (packet->PeekPacketTag (tag))
+    {
+      g_delivered[tag.GetPriority ()] += packet->GetSize ();
+      g_age[tag.GetPriority ()] += (Simulator::Now () - tag.GetAcquired ()).GetSeconds () * packet->GetSize ();
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  double hours = 3.0;
+  std::string rate = "520Mbps";
+  uint32_t packetSize = 60000;
+  uint64_t capacity = 16000000000ULL;
+  double gap = 120;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("hours", "Simulated time in hours", hours);
+  cmd.AddValue ("rate", "Downlink data rate", rate);
+  cmd.AddValue ("packetSize", "Downlink packet size in bytes", packetSize);
+  cmd.AddValue ("capacity", "Onboard memory in bytes", capacity);
+  cmd.AddValue ("gap", "Mean gap between acquisitions in seconds", gap);
+  cmd.Parse (argc, argv);
+
+  NodeContainer satellite;
+  satellite.Create (1);
+  NodeContainer stations;
+  stations.Create (2);
+
+  MobilityHelper satelliteMobility;
+  satelliteMobility.SetMobilityModel ("ns3::SarOrbitMobilityModel",
+                                      "EvaluationMode", StringValue ("Lazy"));
+  satelliteMobility.Install (satellite);
+  Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator> ();
+  positions->Add (Vector (0.0, 0.0, 6371000.0));
+  positions->Add (Vector (0.0, 0.0, -6371000.0));
+  MobilityHelper stationMobility;
+  stationMobility.SetPositionAllocator (positions);
+  stationMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  stationMobility.Install (stations);
+
+  Time stop = Seconds (hours * 3600);
+  Ptr<ContactPlan> plan = CreateObject<ContactPlan> ();
+  plan->AddSatellite (satellite.Get (0)->GetObject<OrbitMobilityModel> ());
+  for (uint32_t i = 0; i < stations.GetN (); ++i)
+    {
+      plan->AddGroundStation (stations.Get (i)->GetObject<MobilityModel> (), 10.0);
+    }
+  plan->Compute (Seconds (0), stop);
+
+  InternetStackHelper stack;
+  stack.Install (satellite);
+  stack.Install (stations);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+
+  /* Jumbo frames keep the packet count of a 520Mbps pass manageable */
+  OrbitPointToPointHelper downlink;
+  downlink.SetDeviceAttribute ("DataRate", StringValue (rate));
+  downlink.SetDeviceAttribute ("Mtu", UintegerValue (std::min<uint32_t> (packetSize + 28, 65535)));
+
+  Ptr<SarPayloadApplication> payload = CreateObject<SarPayloadApplication> ();
+  Ptr<OnboardStorage> storage = CreateObject<OnboardStorage> ();
+  storage->SetAttribute ("Capacity", UintegerValue (capacity));
+  payload->SetAttribute ("Storage", PointerValue (storage));
+  payload->SetAttribute ("PacketSize", UintegerValue (packetSize));
+  std::ostringstream gapRv;
+  gapRv << "ns3::ExponentialRandomVariable[Mean=" << gap << "]";
+  payload->SetAttribute ("AcquisitionGap", StringValue (gapRv.str ()));
+  satellite.Get (0)->AddApplication (payload);
+
+  PacketSinkHelper sink ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 9000));
+  for (uint32_t i = 0; i < stations.GetN (); ++i)
+    {
+      NetDeviceContainer devices = downlink.Install (stations.Get (i), satellite.Get (0));
+      Ipv4InterfaceContainer interfaces = address.Assign (devices);
+      address.NewNetwork ();
+      plan->ScheduleLinkEvents (0, i, devices.Get (0)->GetChannel ()->GetObject<OrbitPointToPointChannel> ());
+      payload->AddDownlink (devices.Get (1), InetSocketAddress (interfaces.GetAddress (0), 9000));
+      ApplicationContainer apps = sink.Install (stations.Get (i));
+      apps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&Received));
+    }
+
+  payload->TraceConnectWithoutContext ("Acquisition", MakeCallback (&Acquisition));
+  storage->TraceConnectWithoutContext ("Drop", MakeCallback (&Lost));
+
+  Simulator::Stop (stop);
+  std::clock_t begin = std::clock ();
+  Simulator::Run ();
+  double cpu = double (std::clock () - begin) / CLOCKS_PER_SEC;
+
+  for (uint8_t c = 0; c < storage->GetNClasses (); ++c)
+    {
+      std::cout << "class " << +c << ": acquired " << g_acquired[c] / 1e9 << " GB, delivered "
+                << g_delivered[c] / 1e9 << " GB, lost " << g_lost[c] / 1e9 << " GB, onboard "
+                << storage->GetUsed (c) / 1e9 << " GB, mean age "
+                << (g_delivered[c] ? g_age[c] / g_delivered[c] : 0) << "s" << std::endl;
+    }
+  std::cout << "simulated " << hours << "h in " << cpu << "s of CPU" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,287 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Benchmarks the satcom scenario engine: runs the bulk, echo and HTTP
+ * benchmark scenarios (examples/benchmarks) over a grid of ground
+ * station and satellite counts, one run at a time so that timings do
+ * not compete for cores, and writes benchmark.csv with the wall time,
+ * event rate, peak memory and bytes written by the pcap, NetAnim and
+ * FlowMonitor probes of every run. Given the benchmark.csv of another
+ * commit as baseline, it reports the changes beyond a tolerance and
+ * fails on a regression:
+ *
+ *   ./waf --run "satcom-benchmark --label=$(git rev-parse --short HEAD)"
+ *   ./waf --run "satcom-benchmark --baseline=old/benchmark.csv --tolerance=0.1"
+ */
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/satcom-sweep-helper.h"
+
+using namespace ns3;
+
+/// A CSV table: column names and rows of values
+struct Table
+{
+  std::vector<std::string> columns;                //!< Header
+  std::vector<std::vector<std::string> > rows;     //!< Rows
+
+  /**
+   * \param name a column name
+   * \return its index, or -1 if there is no such column
+   */
+  int Find (std::string name) const
+  {
+    for (uint32_t i = 0; i < columns.size (); ++i)
+      {
+        if (columns[i] == name)
+          {
+            return i;
+          }
+      }
+    return -1;
+  }
+};
+
+/**
+ * \param line a CSV line without quoting
+ * \return its fields
+ */
+static std::vector<std::string>
+Split (std::string line)
+{
+  std::vector<std::string> fields;
+  std::istringstream is (line);
+  std::string field;
+  while (std::getline (is, field, ','))
+    {
+      fields.push_back (field);
+    }
+  return fields;
+}
+
+/**
+ * \param filename a CSV file with a header line
+ * \return its contents, empty if it cannot be read
+ */
+static Table
+ReadTable (std::string filename)
+{
+  Table table;
+  std::ifstream is (filename.c_str ());
+  std::string line;
+  if (std::getline (is, line))
+    {
+      table.columns = Split (line);
+    }
+  while (std::getline (is, line))
+    {
+      if (!line.empty ())
+        {
+          table.rows.push_back (Split (line));
+        }
+    }
+  return table;
+}
+
+/// The columns benchmark.csv takes from cost.csv
+static const char *g_costColumns[] = {
+  "buildSeconds", "runSeconds", "simulatedSeconds", "events", "eventsPerSecond",
+  "pcapBytes", "asciiBytes", "netanimBytes", "flowmonBytes", "geometryBytes"
+};
+
+/// A compared metric and whether larger values are better
+struct Metric
+{
+  const char *name;     //!< Column
+  bool higherIsBetter;  //!< Direction of an improvement
+};
+
+/// The metrics compared against the baseline
+static const Metric g_metrics[] = {
+  { "wallSeconds", false },
+  { "eventsPerSecond", true },
+  { "maxRssKb", false },
+};
+
+/**
+ * \brief Compare two benchmark results run by run
+ * \param current this build's benchmark.csv
+ * \param baseline a previous benchmark.csv
+ * \param tolerance the relative change to ignore
+ * \return the number of regressions
+ */
+static uint32_t
+Compare (const Table &current, const Table &baseline, double tolerance)
+{
+  // Runs are matched on every column up to "status" but the label
+  int status = current.Find ("status");
+  NS_ABORT_MSG_IF (status < 0 || baseline.Find ("status") != status,
+                   "Benchmark results have different parameters");
+  std::map<std::string, const std::vector<std::string> *> base;
+  for (uint32_t i = 0; i < baseline.rows.size (); ++i)
+    {
+      std::string key;
+      for (int c = 1; c < status; ++c)
+        {
+          key += baseline.rows[i][c] + " ";
+        }
+      base[key] = &baseline.rows[i];
+    }
+
+  uint32_t regressions = 0;
+  for (uint32_t i = 0; i < current.rows.size (); ++i)
+    {
+      const std::vector<std::string> &row = current.rows[i];
+      std::string key;
+      for (int c = 1; c < status; ++c)
+        {
+          key += row[c] + " ";
+        }
+      std::map<std::string, const std::vector<std::string> *>::const_iterator it = base.find (key);
+      if (it == base.end ())
+        {
+          std::cout << key << ": not in baseline" << std::endl;
+          continue;
+        }
+      for (uint32_t m = 0; m < sizeof (g_metrics) / sizeof (g_metrics[0]); ++m)
+        {
+          int c = current.Find (g_metrics[m].name);
+          int b = baseline.Find (g_metrics[m].name);
+          if (c < 0 || b < 0 || row.size () <= (uint32_t) c || it->second->size () <= (uint32_t) b)
+            {
+              continue;
+            }
+          double now = std::atof (row[c].c_str ());
+          double before = std::atof ((*it->second)[b].c_str ());
+          if (before <= 0)
+            {
+              continue;
+            }
+          double change = (now - before) / before;
+          if (std::fabs (change) <= tolerance)
+            {
+              continue;
+            }
+          bool worse = g_metrics[m].higherIsBetter ? change < 0 : change > 0;
+          regressions += worse ? 1 : 0;
+          std::cout << key << g_metrics[m].name << " " << before << " -> " << now << " ("
+                    << (change > 0 ? "+" : "") << 100 * change << "%) "
+                    << (worse ? "REGRESSION" : "improvement") << std::endl;
+        }
+    }
+  return regressions;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string directory = "src/satcom/examples/benchmarks";
+  std::string scenarios = "bulk,echo,http";
+  std::string grid = "stations=2,8;satellites=24,48";
+  std::string output = "satcom-benchmark";
+  std::string label = "current";
+  std::string baseline = "";
+  double tolerance = 0.1;
+  uint32_t jobs = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("directory", "Directory of the benchmark scenarios", directory);
+  cmd.AddValue ("scenarios", "Comma-separated benchmark scenarios to run", scenarios);
+  cmd.AddValue ("grid", "Parameter grid, such as \"stations=2,8;satellites=24,48\"", grid);
+  cmd.AddValue ("output", "Output directory", output);
+  cmd.AddValue ("label", "Label of the results, such as the commit", label);
+  cmd.AddValue ("baseline", "benchmark.csv to compare against", baseline);
+  cmd.AddValue ("tolerance", "Relative change that is not reported", tolerance);
+  cmd.AddValue ("jobs", "Concurrent runs; more than 1 skews the timings", jobs);
+  cmd.Parse (argc, argv);
+
+  std::vector<std::string> names = Split (scenarios);
+  uint32_t failed = 0;
+  std::ofstream csv;
+  for (uint32_t s = 0; s < names.size (); ++s)
+    {
+      std::string runDirectory = output + "/" + names[s];
+      SatcomSweepHelper sweep;
+      sweep.SetScenario (directory + "/" + names[s] + ".scn");
+      sweep.AddGrid (grid);
+      sweep.SetJobs (jobs);
+      sweep.SetOutputDirectory (runDirectory);
+      SystemPath::MakeDirectories (runDirectory);
+      failed += sweep.Run ();
+
+      // runs.csv is "index,<parameters>,status,seconds,maxRssKb,directory" and
+      // cost.csv "index,<parameters>,<cost columns>"
+      Table runs = ReadTable (runDirectory + "/runs.csv");
+      Table cost = ReadTable (runDirectory + "/cost.csv");
+      int status = runs.Find ("status");
+      NS_ABORT_MSG_IF (status < 0, "No runs in " << runDirectory);
+      if (s == 0)
+        {
+          csv.open ((output + "/benchmark.csv").c_str ());
+          csv << "label,scenario";
+          for (int c = 1; c < status; ++c)
+            {
+              csv << "," << runs.columns[c];
+            }
+          csv << ",status,wallSeconds,maxRssKb";
+          for (uint32_t c = 0; c < sizeof (g_costColumns) / sizeof (g_costColumns[0]); ++c)
+            {
+              csv << "," << g_costColumns[c];
+            }
+          csv << std::endl;
+        }
+      std::map<std::string, const std::vector<std::string> *> costs;
+      for (uint32_t i = 0; i < cost.rows.size (); ++i)
+        {
+          costs[cost.rows[i][0]] = &cost.rows[i];
+        }
+      for (uint32_t i = 0; i < runs.rows.size (); ++i)
+        {
+          const std::vector<std::string> &row = runs.rows[i];
+          csv << label << "," << names[s];
+          for (int c = 1; c < status; ++c)
+            {
+              csv << "," << row[c];
+            }
+          csv << "," << row[status] << "," << row[runs.Find ("seconds")] << ","
+              << row[runs.Find ("maxRssKb")];
+          std::map<std::string, const std::vector<std::string> *>::const_iterator it = costs.find (row[0]);
+          for (uint32_t c = 0; c < sizeof (g_costColumns) / sizeof (g_costColumns[0]); ++c)
+            {
+              int k = cost.Find (g_costColumns[c]);
+              csv << "," << (it != costs.end () && k >= 0 ? (*it->second)[k] : "");
+            }
+          csv << std::endl;
+        }
+    }
+  csv.close ();
+  std::cout << "Results in " << output << "/benchmark.csv" << std::endl;
+
+  if (baseline.empty ())
+    {
+      return failed == 0 ? 0 : 1;
+    }
+  uint32_t regressions = Compare (ReadTable (output + "/benchmark.csv"), ReadTable (baseline), tolerance);
+  std::cout << regressions << " regressions beyond " << 100 * tolerance << "% against " << baseline << std::endl;
+  return failed == 0 && regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Reads a link geometry file written by LinkGeometryTrace (scenario
+ * "probe type=geometry") and prints a summary per link, or writes the
+ * samples of all or one link as CSV:
+ *
+ *   ./waf --run "satcom-geometry --file=geometry.bin --csv=geometry.csv --link=0"
+ */
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+
+#include "ns3/core-module.h"
+#include "ns3/link-geometry-trace.h"
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string file = "geometry.bin";
+  std::string csv = "";
+  int32_t only = -1;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("file", "Link geometry file to read", file);
+  cmd.AddValue ("csv", "CSV file to write the samples to, none for a summary", csv);
+  cmd.AddValue ("link", "Link to keep, -1 for all", only);
+  cmd.Parse (argc, argv);
+
+  LinkGeometryTraceReader reader;
+  if (!reader.Open (file))
+    {
+      std::cerr << "cannot read " << file << std::endl;
+      return 1;
+    }
+  uint32_t links = reader.GetNLinks ();
+  uint64_t samples = reader.GetNSamples ();
+  std::cout << file << ": " << links << " links, " << samples << " samples every "
+            << reader.GetInterval () << " s from " << reader.GetStart () << " s, Doppler at "
+            << reader.GetFrequency () / 1e9 << " GHz" << std::endl;
+
+  const double *range = reader.GetRange ();
+  const double *delay = reader.GetDelay ();
+  const float *elevation = reader.GetElevation ();
+  const float *doppler = reader.GetDoppler ();
+  const uint8_t *state = reader.GetState ();
+
+  if (!csv.empty ())
+    {
+      std::ofstream os (csv.c_str ());
+      os << std::setprecision (12)
+         << "time,link,from,to,range,elevation,doppler,delay,state" << std::endl;
+      for (uint64_t k = 0; k < samples; ++k)
+        {
+          double t = reader.GetStart () + k * reader.GetInterval ();
+          for (uint32_t l = 0; l < links; ++l)
+            {
+              if (only >= 0 && l != static_cast<uint32_t> (only))
+                {
+                  continue;
+                }
+              uint64_t i = k * links + l;
+              os << t << "," << l << "," << reader.GetNode (l, 0) << "," << reader.GetNode (l, 1) << ","
+                 << range[i] << "," << elevation[i] << "," << doppler[i] << ","
+                 << delay[i] << "," << uint32_t (state[i]) << std::endl;
+            }
+        }
+      return 0;
+    }
+
+  std::cout << "link,from,to,upFraction,minRange,maxElevation,maxDoppler,minDelay" << std::endl;
+  for (uint32_t l = 0; l < links; ++l)
+    {
+      if (only >= 0 && l != static_cast<uint32_t> (only))
+        {
+          continue;
+        }
+      uint64_t up = 0;
+      double minRange = std::numeric_limits<double>::infinity ();
+      double maxElevation = -90;
+      double maxDoppler = 0;
+      double minDelay = std::numeric_limits<double>::infinity ();
+      for (uint64_t i = l; i < samples * links; i += links)
+        {
+          up += state[i];
+          minRange = std::min (minRange, range[i]);
+          maxElevation = std::max (maxElevation, double (elevation[i]));
+          maxDoppler = std::max (maxDoppler, std::fabs (double (doppler[i])));
+          minDelay = std::min (minDelay, delay[i]);
+        }
+      std::cout << l << "," << reader.GetNode (l, 0) << "," << reader.GetNode (l, 1) << ","
+                << (samples > 0 ? double (up) / samples : 0) << "," << minRange << ","
+                << maxElevation << "," << maxDoppler << "," << minDelay << std::endl;
+    }
+  return 0;
+}
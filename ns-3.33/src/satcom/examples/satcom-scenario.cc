@@ -0,0 +1,46 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Runs a satcom scenario file, see SatcomScenarioHelper for the format.
+ * Parameters of the scenario can be overridden without recompiling:
+ *
+ *   ./waf --run "satcom-scenario --scenario=src/satcom/examples/scenarios/bulk.scn
+ *                                --set=stations=3,rate=100Mbps"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/satcom-scenario-helper.h"
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string scenario = "src/satcom/examples/scenarios/echo.scn";
+  std::string parameters;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("scenario", "Scenario file to run", scenario);
+  cmd.AddValue ("set", "Comma-separated name=value parameter overrides", parameters);
+  cmd.Parse (argc, argv);
+
+  SatcomScenarioHelper helper;
+  helper.SetParameters (parameters);
+  helper.Load (scenario);
+  helper.Build ();
+  helper.Run ();
+  return 0;
+}
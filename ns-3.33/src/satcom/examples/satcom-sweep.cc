@@ -0,0 +1,51 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Runs a satcom scenario over a parameter grid, one process per run on
+ * all local cores, and merges the results into runs.csv, flows.csv,
+ * cost.csv and rx.csv, see SatcomSweepHelper:
+ *
+ *   ./waf --run "satcom-sweep --scenario=src/satcom/examples/scenarios/relay.scn
+ *                             --grid=stations=1:4;rate=10Mbps,50Mbps;run=1:3"
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/satcom-sweep-helper.h"
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string scenario = "src/satcom/examples/scenarios/relay.scn";
+  std::string grid = "stations=1:4;rate=10Mbps,50Mbps;run=1:3";
+  std::string output = "satcom-sweep";
+  uint32_t jobs = 0;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("scenario", "Scenario file to run", scenario);
+  cmd.AddValue ("grid", "Parameter grid, such as \"rate=10Mbps,50Mbps;run=1:10\"", grid);
+  cmd.AddValue ("jobs", "Concurrent runs, 0 for one per core", jobs);
+  cmd.AddValue ("output", "Output directory", output);
+  cmd.Parse (argc, argv);
+
+  SatcomSweepHelper sweep;
+  sweep.SetScenario (scenario);
+  sweep.AddGrid (grid);
+  sweep.SetJobs (jobs);
+  sweep.SetOutputDirectory (output);
+  return sweep.Run () == 0 ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Flies a SAR satellite from its two-line elements, prints its position
+ * every quarter of an orbit and reports how far the interpolated
+ * ephemeris strays from direct SGP4 propagation.
+ *
+ * Run it twice with --cache=<file> to see the second run map the
+ * ephemeris instead of propagating it.
+ */
+
+#include <ctime>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/tle-mobility-model.h"
+#include "ns3/sgp4-propagator.h"
+
+using namespace ns3;
+
+static void
+CourseChange (std::string foo, Ptr<const MobilityModel> mobility)
+{
+  /* Prints current position and velocity */
+  Vector pos = mobility->GetPosition ();
+  Vector vel = mobility->GetVelocity ();
+  std::cout << Simulator::Now () << ", POS: x=" << pos.x << ", y=" << pos.y
+            << ", z=" << pos.z << "; VEL: x=" << vel.x << ", y=" << vel.y
+            << ", z=" << vel.z << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  /* Sentinel-1A like elements */
+  std::string line1 = "1 39634U 14016A   21100.50000000  .00000045  00000-0  19519-4 0  9990";
+  std::string line2 = "2 39634  98.1817 107.4163 0001314  83.5460 276.5887 14.59198711370012";
+  std::string cache = "";
+  std::string step = "30s";
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("line1", "First TLE line", line1);
+  cmd.AddValue ("line2", "Second TLE line", line2);
+  cmd.AddValue ("cache", "Ephemeris cache file", cache);
+  cmd.AddValue ("step", "Ephemeris step", step);
+  cmd.Parse (argc, argv);
+
+  NodeContainer c;
+  c.Create (1);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::TleMobilityModel",
+                             "Line1", StringValue (line1),
+                             "Line2", StringValue (line2),
+                             "EphemerisStep", StringValue (step),
+                             "CacheFile", StringValue (cache),
+                             "EvaluationMode", StringValue ("Lazy"),
+                             "NotificationInterval", StringValue ("1480s"));
+  mobility.Install (c);
+
+  Ptr<TleMobilityModel> model = c.Get (0)->GetObject<TleMobilityModel> ();
+  std::clock_t begin = std::clock ();
+  model->Prepare ();
+  std::cout << "ephemeris ready after " << double (std::clock () - begin) / CLOCKS_PER_SEC
+            << "s CPU" << std::endl;
+
+  /* Interpolation error against direct propagation over the day */
+  Sgp4Propagator sgp4;
+  sgp4.Initialize (TwoLineElements::Parse (line1, line2));
+  double worst = 0;
+  for (double t = 0; t < 86400; t += 7.3)
+    {
+      Vector exact;
+      Vector velocity;
+      sgp4.Propagate (t / 60.0, exact, velocity);
+      Vector interpolated = model->GetPositionAt (Seconds (t));
+      double dx = exact.x - interpolated.x;
+      double dy = exact.y - interpolated.y;
+      double dz = exact.z - interpolated.z;
+      worst = std::max (worst, std::sqrt (dx * dx + dy * dy + dz * dz));
+    }
+  std::cout << "worst interpolation error " << worst << "m" << std::endl;
+
+  Config::Connect ("/NodeList/*/$ns3::MobilityModel/CourseChange",
+                   MakeCallback (&CourseChange));
+
+  Simulator::Stop (Seconds (12000));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Scatters ground terminals over the globe and compares the spatial
+ * index against visiting every terminal, for every satellite of a
+ * constellation over one orbit.
+ */
+
+#include <ctime>
+
+#include "ns3/core-module.h"
+#include "ns3/ground-station-index.h"
+#include "ns3/constellation-propagator.h"
+#include "ns3/satcom-constants.h"
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  uint32_t terminals = 5000;
+  uint32_t satellites = 60;
+  uint32_t planes = 6;
+  double mask = 10.0;
+  double cellSize = 2.0;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("terminals", "Number of ground terminals", terminals);
+  cmd.AddValue ("satellites", "Number of satellites", satellites);
+  cmd.AddValue ("planes", "Number of orbital planes", planes);
+  cmd.AddValue ("mask", "Elevation mask in degrees", mask);
+  cmd.AddValue ("cellSize", "Index cell size in degrees", cellSize);
+  cmd.Parse (argc, argv);
+
+  Ptr<GroundStationIndex> index = CreateObject<GroundStationIndex> ();
+  index->SetAttribute ("CellSize", DoubleValue (cellSize));
+  Ptr<UniformRandomVariable> u = CreateObject<UniformRandomVariable> ();
+  for (uint32_t i = 0; i < terminals; ++i)
+    {
+      double z = u->GetValue (-1.0, 1.0);
+      double phi = u->GetValue (0.0, 2 * M_PI);
+      double rho = std::sqrt (1 - z * z);
+      index->Add (Vector (satcom::EARTH_RADIUS * rho * std::cos (phi),
+                          satcom::EARTH_RADIUS * rho * std::sin (phi),
+                          satcom::EARTH_RADIUS * z), mask);
+    }
+
+  Ptr<ConstellationPropagator> constellation = CreateObject<ConstellationPropagator> ();
+  constellation->AddWalkerDelta (satellites, planes, 1, 693000.0, 97.9);
+
+  std::vector<Vector> positions;
+  for (double t = 0; t < 5940; t += 10)
+    {
+      for (uint32_t s = 0; s < satellites; ++s)
+        {
+          Vector position;
+          Vector velocity;
+          constellation->GetStateAt (s, t, position, velocity);
+          positions.push_back (position);
+        }
+    }
+
+  std::vector<uint32_t> fast;
+  std::vector<uint32_t> slow;
+  uint64_t found = 0;
+  uint32_t mismatches = 0;
+  double indexed = 0;
+  double brute = 0;
+  for (std::vector<Vector>::const_iterator it = positions.begin (); it != positions.end (); ++it)
+    {
+      std::clock_t begin = std::clock ();
+      index->Query (*it, fast);
+      indexed += std::clock () - begin;
+      begin = std::clock ();
+      index->QueryAll (*it, slow);
+      brute += std::clock () - begin;
+      found += fast.size ();
+      mismatches += fast != slow;
+    }
+
+  std::cout << positions.size () << " queries over " << terminals << " terminals, "
+            << double (found) / positions.size () << " visible on average" << std::endl;
+  std::cout << "index " << indexed / CLOCKS_PER_SEC << "s, brute force "
+            << brute / CLOCKS_PER_SEC << "s, " << mismatches << " mismatches" << std::endl;
+  return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,296 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * Link availability from a multi-year weather record. The program writes
+ * a synthetic record of zenith rain and cloud attenuation for a dry
+ * polar site and a wet mid-latitude site (or uses an existing file with
+ * --generate=0), then sweeps every sample of a fixed-elevation link
+ * budget through WeatherAttenuation lookups to report the outage time,
+ * the mean adaptive rate and the lookup cost. Last, a SAR downlink with
+ * adaptive coding and modulation and link budget errors runs over the
+ * wettest stretch of the record, with --weather=0 for clear sky.
+ */
+
+#include <cmath>
+#include <iomanip>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/sar-orbit-mobility-model.h"
+#include "ns3/orbit-point-to-point-helper.h"
+#include "ns3/orbit-point-to-point-channel.h"
+#include "ns3/contact-plan.h"
+#include "ns3/link-budget.h"
+#include "ns3/weather-attenuation.h"
+#include "ns3/adaptive-rate-controller.h"
+#include "ns3/link-budget-error-model.h"
+#include "ns3/sar-payload-application.h"
+
+using namespace ns3;
+
+static uint64_t g_delivered = 0;
+static uint64_t g_lost = 0;
+
+/**
+ * \brief Write a synthetic weather record
+ *
+ * Rain comes in events of exponential length whose peak attenuation is
+ * log-normal, cloud attenuation is a clamped first-order autoregressive
+ * process that rises during rain.
+ *
+ * \param filename the file to write
+ * \param samples the number of samples per station
+ * \param interval the sampling interval in s
+ * \return true if the file was written
+ */
+static bool
+Generate (std::string filename, uint64_t samples, double interval)
+{
+  /* Fraction of time raining, mean event length in s, median and spread of the peak in dB */
+  const double climates[][4] = { { 0.01, 1800, 0.5, 0.8 }, { 0.06, 3600, 1.5, 1.0 } };
+  WeatherAttenuationWriter writer;
+  if (!writer.Open (filename, 2, samples, 0, interval, 8.2e9))
+    {
+      return false;
+    }
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  Ptr<NormalRandomVariable> normal = CreateObject<NormalRandomVariable> ();
+  Ptr<ExponentialRandomVariable> length = CreateObject<ExponentialRandomVariable> ();
+  for (uint32_t s = 0; s < 2; ++s)
+    {
+      float *rain = writer.GetRain (s);
+      float *cloud = writer.GetCloud (s);
+      double start = climates[s][0] * interval / climates[s][1];
+      uint64_t eventStart = 0;
+      uint64_t eventLength = 0;
+      double peak = 0;
+      double c = 0.2;
+      for (uint64_t i = 0; i < samples; ++i)
+        {
+          if (i >= eventStart + eventLength && uniform->GetValue () < start)
+            {
+              eventStart = i;
+              eventLength = std::max (1.0, length->GetValue (climates[s][1], 0) / interval);
+              peak = std::min (20.0, climates[s][2] * std::exp (climates[s][3] * normal->GetValue ()));
+            }
+          bool raining = i < eventStart + eventLength;
+          rain[i] = raining ? peak * std::sin (M_PI * (i - eventStart + 0.5) / eventLength) : 0;
+          double mean = raining ? 0.8 : 0.2;
+          c = std::max (0.0, mean + 0.98 * (c - mean) + 0.03 * normal->GetValue ());
+          cloud[i] = c;
+        }
+    }
+  return true;
+}
+
+static void
+Received (Ptr<const Packet> packet, const Address &from)
+{
+  g_delivered += packet->GetSize ();
+}
+
+static void
+Lost (Ptr<const Packet> packet)
+{
+  g_lost++;
+}
+
+/**
+ * \brief Sweep a fixed-elevation link budget over the whole weather record
+ *
+ * \param record the weather record
+ * \param elevation the elevation in degrees
+ * \param station the station whose wettest time is wanted
+ * \param wettest the time of the strongest rain at that station
+ */
+static void
+Sweep (Ptr<WeatherAttenuation> record, double elevation, uint32_t station, Time *wettest)
+{
+  uint64_t samples = record->GetNSamples ();
+  double span = samples * record->GetInterval ();
+
+  Ptr<LinkBudget> budget = CreateObject<LinkBudget> ();
+  ModcodTable table = ModcodTable::GetDvbS2 ();
+  double symbolRate = 150e6;
+  double margin = 1.0;
+  double range = 1500e3;
+  double clear = budget->GetEsN0 (range, elevation, symbolRate);
+  double cosecant = 1 / std::sin (elevation * M_PI / 180);
+  double peak = 0;
+  for (uint32_t s = 0; s < record->GetNStations (); ++s)
+    {
+      SystemWallClockMs clock;
+      clock.Start ();
+      double sum = 0;
+      for (uint64_t i = 0; i < samples; ++i)
+        {
+          sum += record->GetAttenuation (s, Seconds (record->GetStart () + (i + 0.5) * record->GetInterval ()));
+        }
+      int64_t ms = clock.End ();
+      uint64_t outage = 0;
+      uint64_t degraded = 0;
+      double rate = 0;
+      double worst = 0;
+      int32_t clearModcod = table.Select (clear - margin);
+      for (uint64_t i = 0; i < samples; ++i)
+        {
+          Time t = Seconds (record->GetStart () + i * record->GetInterval ());
+          double attenuation = record->GetAttenuation (s, t);
+          int32_t modcod = table.Select (clear - attenuation * cosecant - margin);
+          outage += modcod < 0;
+          degraded += modcod < clearModcod;
+          rate += modcod < 0 ? 0 : symbolRate * table.Get (modcod).efficiency;
+          worst = std::max (worst, attenuation);
+          if (s == station && record->GetRain (s, t) > peak)
+            {
+              peak = record->GetRain (s, t);
+              *wettest = t;
+            }
+        }
+      std::cout << std::fixed << std::setprecision (3) << "station " << s << ": "
+                << span / 86400 / 365.25 << " years at " << elevation << " deg, outage "
+                << 100.0 * outage / samples << "%, below the clear sky scheme " << 100.0 * degraded / samples
+                << "%, mean rate " << std::setprecision (1) << rate / samples / 1e6 << " Mbps, worst "
+                << worst << " dB at zenith (mean " << sum / samples << " dB), " << std::setprecision (0)
+                << samples / std::max<double> (ms / 1000.0, 1e-3) << " lookups/s" << std::endl;
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  std::string filename = "weather.bin";
+  bool generate = true;
+  double years = 2.0;
+  double interval = 60.0;
+  double elevation = 20.0;
+  uint32_t station = 1;
+  double hours = 6.0;
+  bool weather = true;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("file", "Weather record", filename);
+  cmd.AddValue ("generate", "Write a synthetic record first", generate);
+  cmd.AddValue ("years", "Length of the synthetic record in years", years);
+  cmd.AddValue ("interval", "Sampling interval of the synthetic record in s", interval);
+  cmd.AddValue ("elevation", "Elevation of the availability sweep in degrees", elevation);
+  cmd.AddValue ("station", "Record index of the downlink station", station);
+  cmd.AddValue ("hours", "Length of the downlink simulation in hours, 0 for none", hours);
+  cmd.AddValue ("weather", "Apply the weather to the downlink", weather);
+  cmd.Parse (argc, argv);
+
+  if (generate)
+    {
+      SystemWallClockMs clock;
+      clock.Start ();
+      uint64_t samples = static_cast<uint64_t> (years * 365.25 * 86400 / interval);
+      if (!Generate (filename, samples, interval))
+        {
+          std::cerr << "cannot write " << filename << std::endl;
+          return 1;
+        }
+      std::cout << "wrote " << samples << " samples per station to " << filename
+                << " in " << clock.End () << " ms" << std::endl;
+    }
+
+  Ptr<WeatherAttenuation> record = CreateObject<WeatherAttenuation> ();
+  if (!record->Open (filename))
+    {
+      std::cerr << "cannot read " << filename << std::endl;
+      return 1;
+    }
+  /* Times built before the simulator runs are tracked for resolution changes, keep that out of the sweep */
+  Time wettest;
+  Simulator::ScheduleNow (&Sweep, record, elevation, station, &wettest);
+  Simulator::Run ();
+  if (hours <= 0 || station >= record->GetNStations ())
+    {
+      Simulator::Destroy ();
+      return 0;
+    }
+
+  /* SAR downlink over the wettest stretch of the record */
+  NodeContainer satellite;
+  satellite.Create (1);
+  NodeContainer ground;
+  ground.Create (1);
+  MobilityHelper satelliteMobility;
+  satelliteMobility.SetMobilityModel ("ns3::SarOrbitMobilityModel",
+                                      "EvaluationMode", StringValue ("Lazy"));
+  satelliteMobility.Install (satellite);
+  MobilityHelper stationMobility;
+  stationMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  stationMobility.Install (ground);
+  ground.Get (0)->GetObject<MobilityModel> ()->SetPosition (Vector (0.0, 0.0, 6371000.0));
+
+  Time stop = Seconds (hours * 3600);
+  Time offset = std::max (Seconds (0), wettest - stop / 2);
+  record->SetAttribute ("Offset", TimeValue (offset));
+  Ptr<ContactPlan> plan = CreateObject<ContactPlan> ();
+  plan->AddSatellite (satellite.Get (0)->GetObject<OrbitMobilityModel> ());
+  plan->AddGroundStation (ground.Get (0)->GetObject<MobilityModel> (), 5.0);
+  plan->Compute (Seconds (0), stop);
+
+  InternetStackHelper stack;
+  stack.Install (satellite);
+  stack.Install (ground);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.1.0", "255.255.255.0");
+  OrbitPointToPointHelper downlink;
+  downlink.SetDeviceAttribute ("Mtu", UintegerValue (60028));
+  NetDeviceContainer devices = downlink.Install (ground.Get (0), satellite.Get (0));
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+  plan->ScheduleLinkEvents (0, 0, devices.Get (0)->GetChannel ()->GetObject<OrbitPointToPointChannel> ());
+
+  Ptr<AdaptiveRateController> controller = CreateObject<AdaptiveRateController> ();
+  controller->Install (DynamicCast<PointToPointNetDevice> (devices.Get (1)));
+  if (weather)
+    {
+      controller->GetLinkBudget ()->SetAttribute ("Weather", PointerValue (record));
+      controller->GetLinkBudget ()->SetAttribute ("WeatherStation", UintegerValue (station));
+    }
+  Ptr<LinkBudgetErrorModel> em = CreateObject<LinkBudgetErrorModel> ();
+  em->SetAttribute ("RateController", PointerValue (controller));
+  em->Install (devices.Get (0));
+  devices.Get (0)->TraceConnectWithoutContext ("PhyRxDrop", MakeCallback (&Lost));
+
+  /* A full memory: the downlink is always backlogged */
+  Ptr<OnboardStorage> storage = CreateObject<OnboardStorage> ();
+  storage->SetAttribute ("Capacity", UintegerValue (1000000000000ULL));
+  storage->Write (0, 0, 1000000000000ULL);
+  Ptr<SarPayloadApplication> payload = CreateObject<SarPayloadApplication> ();
+  payload->SetAttribute ("Storage", PointerValue (storage));
+  payload->SetAttribute ("PacketSize", UintegerValue (60000));
+  payload->SetAttribute ("AcquisitionDuration", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
+  payload->SetAttribute ("AcquisitionGap", StringValue ("ns3::ConstantRandomVariable[Constant=1e9]"));
+  payload->AddDownlink (devices.Get (1), InetSocketAddress (interfaces.GetAddress (0), 9000));
+  satellite.Get (0)->AddApplication (payload);
+  PacketSinkHelper sink ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), 9000));
+  ApplicationContainer apps = sink.Install (ground.Get (0));
+  apps.Get (0)->TraceConnectWithoutContext ("Rx", MakeCallback (&Received));
+
+  Simulator::Stop (stop);
+  Simulator::Run ();
+  std::cout << std::fixed << std::setprecision (2) << "downlink to station " << station << " from day "
+            << offset.GetDays () << (weather ? " with" : " without") << " weather: " << g_delivered / 1e9 << " GB delivered, " << g_lost
+            << " packets lost" << std::endl;
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+
+#include "constellation-topology-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-list-routing-helper.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-constellation-routing-helper.h"
+#include "ns3/orbit-mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ConstellationTopologyHelper");
+
+ConstellationTopologyHelper::ConstellationTopologyHelper ()
+  : m_mask (10.0),
+    m_polarLimit (75.0),
+    m_polarInterval (Seconds (10)),
+    m_base ("10.0.0.0"),
+    m_nIsls (0)
+{
+}
+
+OrbitPointToPointHelper &
+ConstellationTopologyHelper::GetIslHelper (void)
+{
+  return m_islHelper;
+}
+
+OrbitPointToPointHelper &
+ConstellationTopologyHelper::GetGroundLinkHelper (void)
+{
+  return m_groundHelper;
+}
+
+void
+ConstellationTopologyHelper::SetElevationMask (double mask)
+{
+  m_mask = mask;
+}
+
+void
+ConstellationTopologyHelper::SetPolarLimit (double latitude, Time interval)
+{
+  NS_ASSERT (interval.IsStrictlyPositive ());
+  m_polarLimit = latitude;
+  m_polarInterval = interval;
+}
+
+void
+ConstellationTopologyHelper::SetBase (Ipv4Address network)
+{
+  m_base = network;
+}
+
+Ptr<ConstellationRouteManager>
+ConstellationTopologyHelper::GetRouteManager (void) const
+{
+  return m_manager;
+}
+
+Ptr<ContactPlan>
+ConstellationTopologyHelper::GetContactPlan (void) const
+{
+  return m_plan;
+}
+
+Ipv4Address
+ConstellationTopologyHelper::GetStationAddress (uint32_t station) const
+{
+  NS_ASSERT (station < m_stationAddresses.size ());
+  return m_stationAddresses[station];
+}
+
+uint32_t
+ConstellationTopologyHelper::GetNIsls (void) const
+{
+  return m_nIsls;
+}
+
+Ptr<OrbitPointToPointChannel>
+ConstellationTopologyHelper::Connect (OrbitPointToPointHelper &helper, Ptr<Node> a, Ptr<Node> b)
+{
+  NetDeviceContainer devices = helper.Install (a, b);
+  m_devices.Add (devices);
+  return devices.Get (0)->GetChannel ()->GetObject<OrbitPointToPointChannel> ();
+}
+
+void
+ConstellationTopologyHelper::Install (NodeContainer satellites, uint32_t planes, NodeContainer stations, Time stop)
+{
+  NS_LOG_FUNCTION (this << satellites.GetN () << planes << stations.GetN () << stop);
+  NS_ASSERT_MSG (planes > 0 && satellites.GetN () % planes == 0,
+                 "The number of satellites must be a multiple of the number of planes");
+  uint32_t perPlane = satellites.GetN () / planes;
+
+  m_devices = NetDeviceContainer ();
+  m_manager = CreateObject<ConstellationRouteManager> ();
+  Ipv4StaticRoutingHelper staticRouting;
+  Ipv4ConstellationRoutingHelper constellationRouting (m_manager);
+  Ipv4ListRoutingHelper list;
+  list.Add (staticRouting, 0);
+  list.Add (constellationRouting, 10);
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (list);
+  stack.Install (satellites);
+  stack.Install (stations);
+
+  std::vector<Ptr<OrbitPointToPointChannel> > channels;
+  std::vector<PolarLink> polar;
+  for (uint32_t p = 0; p < planes; ++p)
+    {
+      for (uint32_t s = 0; s < perPlane; ++s)
+        {
+          Ptr<Node> node = satellites.Get (p * perPlane + s);
+          if (perPlane > 2 || (perPlane == 2 && s == 0))
+            {
+              channels.push_back (Connect (m_islHelper, node, satellites.Get (p * perPlane + (s + 1) % perPlane)));
+            }
+          if (p + 1 < planes)
+            {
+              Ptr<Node> next = satellites.Get ((p + 1) * perPlane + s);
+              channels.push_back (Connect (m_islHelper, node, next));
+              PolarLink link;
+              link.channel = channels.back ();
+              link.a = node->GetObject<MobilityModel> ();
+              link.b = next->GetObject<MobilityModel> ();
+              polar.push_back (link);
+            }
+        }
+    }
+  m_nIsls = channels.size ();
+
+  m_plan = CreateObject<ContactPlan> ();
+  for (uint32_t i = 0; i < satellites.GetN (); ++i)
+    {
+      Ptr<OrbitMobilityModel> orbit = satellites.Get (i)->GetObject<OrbitMobilityModel> ();
+      NS_ASSERT_MSG (orbit != 0, "Satellites need an OrbitMobilityModel");
+      m_plan->AddSatellite (orbit);
+    }
+  for (uint32_t j = 0; j < stations.GetN (); ++j)
+    {
+      m_plan->AddGroundStation (stations.Get (j)->GetObject<MobilityModel> (), m_mask);
+    }
+  Time now = Simulator::Now ();
+  m_plan->Compute (now, stop);
+  for (uint32_t j = 0; j < stations.GetN (); ++j)
+    {
+      for (uint32_t i = 0; i < satellites.GetN (); ++i)
+        {
+          channels.push_back (Connect (m_groundHelper, stations.Get (j), satellites.Get (i)));
+          m_plan->ScheduleLinkEvents (i, j, channels.back ());
+        }
+    }
+
+  Ipv4AddressHelper address;
+  address.SetBase (m_base, "255.255.255.252");
+  m_stationAddresses.clear ();
+  for (uint32_t k = 0; k < channels.size (); ++k)
+    {
+      NetDeviceContainer devices;
+      devices.Add (m_devices.Get (2 * k));
+      devices.Add (m_devices.Get (2 * k + 1));
+      Ipv4InterfaceContainer interfaces = address.Assign (devices);
+      address.NewNetwork ();
+      if (k >= m_nIsls && (k - m_nIsls) % satellites.GetN () == 0)
+        {
+          m_stationAddresses.push_back (interfaces.GetAddress (0));
+        }
+      m_manager->AddLink (channels[k]);
+    }
+
+  if (m_polarLimit < 90.0 && !polar.empty ())
+    {
+      CheckPolarLinks (polar, m_polarLimit, m_polarInterval);
+    }
+}
+
+void
+ConstellationTopologyHelper::CheckPolarLinks (std::vector<PolarLink> links, double limit, Time interval)
+{
+  double sinLimit = std::sin (limit * M_PI / 180.0);
+  for (std::vector<PolarLink>::const_iterator it = links.begin (); it != links.end (); ++it)
+    {
+      Vector a = it->a->GetPosition ();
+      Vector b = it->b->GetPosition ();
+      bool polarA = std::abs (a.z) > sinLimit * std::sqrt (a.x * a.x + a.y * a.y + a.z * a.z);
+      bool polarB = std::abs (b.z) > sinLimit * std::sqrt (b.x * b.x + b.y * b.y + b.z * b.z);
+      it->channel->SetLinkUp (!polarA && !polarB);
+    }
+  Simulator::Schedule (interval, &ConstellationTopologyHelper::CheckPolarLinks, links, limit, interval);
+}
+
+} // namespace ns3
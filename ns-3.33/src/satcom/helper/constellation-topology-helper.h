@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CONSTELLATION_TOPOLOGY_HELPER_H
+#define CONSTELLATION_TOPOLOGY_HELPER_H
+
+#include <vector>
+
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+#include "ns3/orbit-point-to-point-helper.h"
+#include "ns3/orbit-point-to-point-channel.h"
+#include "ns3/constellation-route-manager.h"
+#include "ns3/contact-plan.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Wire a constellation into a routed network.
+ *
+ * Satellites are expected plane by plane, as ConstellationPropagator
+ * lays out a Walker constellation. Each satellite gets two intra-plane
+ * links to its neighbours in the plane and an inter-plane link to the
+ * satellite with the same slot in the next plane (no link across the
+ * seam between the last and the first plane). Inter-plane links are
+ * switched off while either end is above the polar latitude, where the
+ * planes cross. Every ground station gets a link to every satellite,
+ * which a ContactPlan keeps up during the visibility windows only.
+ *
+ * The helper installs the internet stack with Ipv4ConstellationRouting
+ * (behind static routing), gives each link its own /30 subnet, and
+ * registers every link with one ConstellationRouteManager so that each
+ * toggle only updates the routes it affects. The nodes must not have
+ * an internet stack yet.
+ */
+class ConstellationTopologyHelper
+{
+public:
+  ConstellationTopologyHelper ();
+
+  /**
+   * \return the helper creating the inter-satellite links, to set their attributes
+   */
+  OrbitPointToPointHelper &GetIslHelper (void);
+
+  /**
+   * \return the helper creating the ground links, to set their attributes
+   */
+  OrbitPointToPointHelper &GetGroundLinkHelper (void);
+
+  /**
+   * \param mask elevation mask of the ground stations in degrees
+   */
+  void SetElevationMask (double mask);
+
+  /**
+   * \param latitude inter-plane links are down above this absolute
+   *        latitude in degrees; 90 keeps them up
+   * \param interval how often the latitudes are checked
+   */
+  void SetPolarLimit (double latitude, Time interval);
+
+  /**
+   * \param network the first subnet to allocate /30 link subnets from
+   */
+  void SetBase (Ipv4Address network);
+
+  /**
+   * Build the network.
+   * \param satellites satellites with an OrbitMobilityModel, plane by plane
+   * \param planes the number of orbital planes
+   * \param stations ground stations with a MobilityModel
+   * \param stop end of the contact plan horizon, which starts now
+   */
+  void Install (NodeContainer satellites, uint32_t planes, NodeContainer stations, Time stop);
+
+  /// \return the route manager of the network
+  Ptr<ConstellationRouteManager> GetRouteManager (void) const;
+
+  /// \return the contact plan driving the ground links
+  Ptr<ContactPlan> GetContactPlan (void) const;
+
+  /**
+   * \param station a ground station index
+   * \return the address of the station on its link to the first satellite
+   */
+  Ipv4Address GetStationAddress (uint32_t station) const;
+
+  /// \return the number of inter-satellite links
+  uint32_t GetNIsls (void) const;
+
+private:
+  /// An inter-plane link and its ends
+  struct PolarLink
+  {
+    Ptr<OrbitPointToPointChannel> channel;  //!< The link
+    Ptr<MobilityModel> a;                   //!< Mobility of one end
+    Ptr<MobilityModel> b;                   //!< Mobility of the other end
+  };
+
+  /// Toggle the inter-plane links by latitude and reschedule
+  static void CheckPolarLinks (std::vector<PolarLink> links, double limit, Time interval);
+
+  /// Connect two nodes and register the link
+  Ptr<OrbitPointToPointChannel> Connect (OrbitPointToPointHelper &helper, Ptr<Node> a, Ptr<Node> b);
+
+  OrbitPointToPointHelper m_islHelper;     //!< Inter-satellite links
+  OrbitPointToPointHelper m_groundHelper;  //!< Ground links
+  double m_mask;                           //!< Elevation mask, degrees
+  double m_polarLimit;                     //!< Inter-plane latitude limit, degrees
+  Time m_polarInterval;                    //!< Latitude check period
+  Ipv4Address m_base;                      //!< First link subnet
+  NetDeviceContainer m_devices;            //!< Devices of every link, in link order
+  std::vector<Ipv4Address> m_stationAddresses; //!< Address of each station
+  uint32_t m_nIsls;                        //!< Number of inter-satellite links
+  Ptr<ConstellationRouteManager> m_manager; //!< Route manager
+  Ptr<ContactPlan> m_plan;                 //!< Contact plan
+};
+
+} // namespace ns3
+
+#endif /* CONSTELLATION_TOPOLOGY_HELPER_H */
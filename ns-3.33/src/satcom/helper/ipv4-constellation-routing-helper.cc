@@ -0,0 +1,42 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv4-constellation-routing-helper.h"
+#include "ns3/ipv4-constellation-routing.h"
+
+namespace ns3 {
+
+Ipv4ConstellationRoutingHelper::Ipv4ConstellationRoutingHelper (Ptr<ConstellationRouteManager> manager)
+  : m_manager (manager)
+{
+}
+
+Ipv4ConstellationRoutingHelper*
+Ipv4ConstellationRoutingHelper::Copy (void) const
+{
+  return new Ipv4ConstellationRoutingHelper (*this);
+}
+
+Ptr<Ipv4RoutingProtocol>
+Ipv4ConstellationRoutingHelper::Create (Ptr<Node> node) const
+{
+  m_manager->AddNode (node);
+  Ptr<Ipv4ConstellationRouting> routing = CreateObject<Ipv4ConstellationRouting> ();
+  routing->SetRouteManager (m_manager);
+  return routing;
+}
+
+} // namespace ns3
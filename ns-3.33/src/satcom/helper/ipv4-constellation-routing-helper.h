@@ -0,0 +1,58 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_CONSTELLATION_ROUTING_HELPER_H
+#define IPV4_CONSTELLATION_ROUTING_HELPER_H
+
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/constellation-route-manager.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Create Ipv4ConstellationRouting protocols bound to one
+ * ConstellationRouteManager, for use with InternetStackHelper.
+ *
+ * Every node the helper creates a protocol for is added to the manager.
+ */
+class Ipv4ConstellationRoutingHelper : public Ipv4RoutingHelper
+{
+public:
+  /**
+   * \param manager the manager the protocols follow
+   */
+  Ipv4ConstellationRoutingHelper (Ptr<ConstellationRouteManager> manager);
+
+  /**
+   * \returns pointer to clone of this Ipv4ConstellationRoutingHelper
+   */
+  virtual Ipv4ConstellationRoutingHelper* Copy (void) const;
+
+  /**
+   * \param node the node on which the routing protocol will run
+   * \returns a newly-created routing protocol
+   */
+  virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const;
+
+private:
+  Ptr<ConstellationRouteManager> m_manager;  //!< The shared route manager
+};
+
+} // namespace ns3
+
+#endif /* IPV4_CONSTELLATION_ROUTING_HELPER_H */
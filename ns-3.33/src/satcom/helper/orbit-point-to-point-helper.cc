@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/queue.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/mac48-address.h"
+#include "ns3/orbit-point-to-point-channel.h"
+#include "orbit-point-to-point-helper.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("OrbitPointToPointHelper");
+
+OrbitPointToPointHelper::OrbitPointToPointHelper ()
+{
+  m_queueFactory.SetTypeId ("ns3::DropTailQueue<Packet>");
+  m_deviceFactory.SetTypeId ("ns3::PointToPointNetDevice");
+  m_channelFactory.SetTypeId ("ns3::OrbitPointToPointChannel");
+}
+
+void
+OrbitPointToPointHelper::SetQueue (std::string type,
+                                   std::string n1, const AttributeValue &v1,
+                                   std::string n2, const AttributeValue &v2,
+                                   std::string n3, const AttributeValue &v3,
+                                   std::string n4, const AttributeValue &v4)
+{
+  QueueBase::AppendItemTypeIfNotPresent (type, "Packet");
+
+  m_queueFactory.SetTypeId (type);
+  m_queueFactory.Set (n1, v1);
+  m_queueFactory.Set (n2, v2);
+  m_queueFactory.Set (n3, v3);
+  m_queueFactory.Set (n4, v4);
+}
+
+void
+OrbitPointToPointHelper::SetDeviceAttribute (std::string n1, const AttributeValue &v1)
+{
+  m_deviceFactory.Set (n1, v1);
+}
+
+void
+OrbitPointToPointHelper::SetChannelAttribute (std::string n1, const AttributeValue &v1)
+{
+  m_channelFactory.Set (n1, v1);
+}
+
+void
+OrbitPointToPointHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename)
+{
+  m_traceHelper.EnablePcap (prefix, nd, promiscuous, explicitFilename);
+}
+
+void
+OrbitPointToPointHelper::EnableAsciiInternal (
+  Ptr<OutputStreamWrapper> stream,
+  std::string prefix,
+  Ptr<NetDevice> nd,
+  bool explicitFilename)
+{
+  if (stream == 0)
+    {
+      m_traceHelper.EnableAscii (prefix, nd, explicitFilename);
+    }
+  else
+    {
+      m_traceHelper.EnableAscii (stream, nd);
+    }
+}
+
+NetDeviceContainer
+OrbitPointToPointHelper::Install (NodeContainer c)
+{
+  NS_ASSERT (c.GetN () == 2);
+  return Install (c.Get (0), c.Get (1));
+}
+
+NetDeviceContainer
+OrbitPointToPointHelper::Install (Ptr<Node> a, Ptr<Node> b)
+{
+  NetDeviceContainer container;
+
+  Ptr<PointToPointNetDevice> devA = m_deviceFactory.Create<PointToPointNetDevice> ();
+  devA->SetAddress (Mac48Address::Allocate ());
+  a->AddDevice (devA);
+  Ptr<Queue<Packet> > queueA = m_queueFactory.Create<Queue<Packet> > ();
+  devA->SetQueue (queueA);
+  Ptr<PointToPointNetDevice> devB = m_deviceFactory.Create<PointToPointNetDevice> ();
+  devB->SetAddress (Mac48Address::Allocate ());
+  b->AddDevice (devB);
+  Ptr<Queue<Packet> > queueB = m_queueFactory.Create<Queue<Packet> > ();
+  devB->SetQueue (queueB);
+  // Aggregate NetDeviceQueueInterface objects
+  Ptr<NetDeviceQueueInterface> ndqiA = CreateObject<NetDeviceQueueInterface> ();
+  ndqiA->GetTxQueue (0)->ConnectQueueTraces (queueA);
+  devA->AggregateObject (ndqiA);
+  Ptr<NetDeviceQueueInterface> ndqiB = CreateObject<NetDeviceQueueInterface> ();
+  ndqiB->GetTxQueue (0)->ConnectQueueTraces (queueB);
+  devB->AggregateObject (ndqiB);
+
+  Ptr<OrbitPointToPointChannel> channel = m_channelFactory.Create<OrbitPointToPointChannel> ();
+
+  devA->Attach (channel);
+  devB->Attach (channel);
+  container.Add (devA);
+  container.Add (devB);
+
+  return container;
+}
+
+} // namespace ns3
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ORBIT_POINT_TO_POINT_HELPER_H
+#define ORBIT_POINT_TO_POINT_HELPER_H
+
+#include <string>
+
+#include "ns3/object-factory.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+#include "ns3/trace-helper.h"
+#include "ns3/point-to-point-helper.h"
+
+namespace ns3 {
+
+class NetDevice;
+class Node;
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Build a set of PointToPointNetDevice objects connected by an
+ * OrbitPointToPointChannel.
+ *
+ * The API mirrors PointToPointHelper so that the satcom scenarios can
+ * switch helpers without other changes.  Pcap and ascii tracing are
+ * forwarded to a PointToPointHelper since the devices are plain
+ * PointToPointNetDevice objects.
+ */
+class OrbitPointToPointHelper : public PcapHelperForDevice,
+                                public AsciiTraceHelperForDevice
+{
+public:
+  OrbitPointToPointHelper ();
+  virtual ~OrbitPointToPointHelper () {}
+
+  /**
+   * Each point to point net device must have a queue to pass packets through.
+   * This method allows one to set the type of the queue that is automatically
+   * created when the device is created and attached to a node.
+   *
+   * \param type the type of queue
+   * \param n1 the name of the attribute to set on the queue
+   * \param v1 the value of the attribute to set on the queue
+   * \param n2 the name of the attribute to set on the queue
+   * \param v2 the value of the attribute to set on the queue
+   * \param n3 the name of the attribute to set on the queue
+   * \param v3 the value of the attribute to set on the queue
+   * \param n4 the name of the attribute to set on the queue
+   * \param v4 the value of the attribute to set on the queue
+   */
+  void SetQueue (std::string type,
+                 std::string n1 = "", const AttributeValue &v1 = EmptyAttributeValue (),
+                 std::string n2 = "", const AttributeValue &v2 = EmptyAttributeValue (),
+                 std::string n3 = "", const AttributeValue &v3 = EmptyAttributeValue (),
+                 std::string n4 = "", const AttributeValue &v4 = EmptyAttributeValue ());
+
+  /**
+   * Set an attribute value to be propagated to each NetDevice created by the
+   * helper.
+   *
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set
+   */
+  void SetDeviceAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * Set an attribute value to be propagated to each Channel created by the
+   * helper.
+   *
+   * \param name the name of the attribute to set
+   * \param value the value of the attribute to set
+   */
+  void SetChannelAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * \param c a set of nodes
+   * \return a NetDeviceContainer for nodes
+   */
+  NetDeviceContainer Install (NodeContainer c);
+
+  /**
+   * \param a first node
+   * \param b second node
+   * \return a NetDeviceContainer for nodes
+   */
+  NetDeviceContainer Install (Ptr<Node> a, Ptr<Node> b);
+
+private:
+  virtual void EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool promiscuous, bool explicitFilename);
+
+  virtual void EnableAsciiInternal (
+    Ptr<OutputStreamWrapper> stream,
+    std::string prefix,
+    Ptr<NetDevice> nd,
+    bool explicitFilename);
+
+  ObjectFactory m_queueFactory;         //!< Queue Factory
+  ObjectFactory m_channelFactory;       //!< Channel Factory
+  ObjectFactory m_deviceFactory;        //!< Device Factory
+  PointToPointHelper m_traceHelper;     //!< Handles pcap and ascii tracing
+};
+
+} // namespace ns3
+
+#endif /* ORBIT_POINT_TO_POINT_HELPER_H */
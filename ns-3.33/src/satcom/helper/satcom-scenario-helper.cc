@@ -0,0 +1,1574 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "satcom-scenario-helper.h"
+#include "ns3/config.h"
+#include "ns3/log.h"
+#include "ns3/pointer.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/enum.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/on-off-helper.h"
+#include "ns3/udp-echo-helper.h"
+#include "ns3/three-gpp-http-helper.h"
+#include "ns3/three-gpp-http-variables.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/netanim-module.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/satcom-constants.h"
+#include "ns3/orbit-mobility-model.h"
+#include "ns3/ground-station-mobility-model.h"
+#include "ns3/constellation-propagator.h"
+#include "ns3/orbit-point-to-point-channel.h"
+#include "ns3/contact-plan.h"
+#include "ns3/pass-scheduler.h"
+#include "ns3/adaptive-rate-controller.h"
+#include "ns3/link-budget-error-model.h"
+#include "ns3/fluid-flow-model.h"
+#include "ns3/link-geometry-trace.h"
+#include "ns3/weather-attenuation.h"
+#include "ns3/sar-payload-application.h"
+#include "ns3/pep-application.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SatcomScenarioHelper");
+
+SatcomScenarioHelper::SatcomScenarioHelper ()
+  : m_built (false),
+    m_stop (Seconds (100)),
+    m_constellation (false),
+    m_planes (0),
+    m_subnet (0),
+    m_fluid (false),
+    m_anim (0),
+    m_reportRx (false),
+    m_buildSeconds (0)
+{
+}
+
+SatcomScenarioHelper::~SatcomScenarioHelper ()
+{
+  delete m_anim;
+}
+
+void
+SatcomScenarioHelper::SetParameter (std::string name, std::string value)
+{
+  NS_LOG_FUNCTION (this << name << value);
+  m_parameters[name] = value;
+}
+
+void
+SatcomScenarioHelper::SetParameters (std::string assignments)
+{
+  std::istringstream is (assignments);
+  std::string assignment;
+  while (std::getline (is, assignment, ','))
+    {
+      if (assignment.empty ())
+        {
+          continue;
+        }
+      std::string::size_type eq = assignment.find ('=');
+      if (eq == std::string::npos || eq == 0)
+        {
+          NS_FATAL_ERROR ("Parameter assignment \"" << assignment << "\" is not name=value");
+        }
+      SetParameter (assignment.substr (0, eq), assignment.substr (eq + 1));
+    }
+}
+
+void
+SatcomScenarioHelper::Load (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ifstream is (filename.c_str ());
+  if (!is)
+    {
+      NS_FATAL_ERROR ("Cannot open scenario file " << filename);
+    }
+  Parse (is, filename);
+}
+
+void
+SatcomScenarioHelper::Parse (std::istream &is, std::string origin)
+{
+  NS_LOG_FUNCTION (this << origin);
+  std::string line;
+  uint32_t number = 0;
+  while (std::getline (is, line))
+    {
+      number++;
+      std::ostringstream where;
+      where << origin << ":" << number;
+
+      std::vector<std::string> tokens;
+      std::string token;
+      bool quoted = false;
+      bool inToken = false;
+      for (std::string::const_iterator c = line.begin (); c != line.end (); ++c)
+        {
+          if (*c == '"')
+            {
+              quoted = !quoted;
+              inToken = true;
+            }
+          else if (!quoted && *c == '#')
+            {
+              break;
+            }
+          else if (!quoted && std::isspace (static_cast<unsigned char> (*c)))
+            {
+              if (inToken)
+                {
+                  tokens.push_back (token);
+                  token.clear ();
+                  inToken = false;
+                }
+            }
+          else
+            {
+              token += *c;
+              inToken = true;
+            }
+        }
+      if (quoted)
+        {
+          NS_FATAL_ERROR (where.str () << ": unterminated quote");
+        }
+      if (inToken)
+        {
+          tokens.push_back (token);
+        }
+      if (tokens.empty ())
+        {
+          continue;
+        }
+
+      if (tokens[0] == "param")
+        {
+          if (tokens.size () != 3)
+            {
+              NS_FATAL_ERROR (where.str () << ": expected \"param name value\"");
+            }
+          if (m_parameters.find (tokens[1]) == m_parameters.end ())
+            {
+              m_parameters[tokens[1]] = Substitute (tokens[2], where.str ());
+            }
+          continue;
+        }
+
+      Directive d;
+      d.kind = tokens[0];
+      d.origin = where.str ();
+      for (uint32_t i = 1; i < tokens.size (); ++i)
+        {
+          std::string::size_type eq = tokens[i].find ('=');
+          if (eq == std::string::npos || eq == 0)
+            {
+              NS_FATAL_ERROR (d.origin << ": \"" << tokens[i] << "\" is not key=value");
+            }
+          d.args.push_back (std::make_pair (tokens[i].substr (0, eq),
+                                            Substitute (tokens[i].substr (eq + 1), d.origin)));
+        }
+      if (ToBool (d, "if", Take (d, "if", "true")))
+        {
+          m_directives.push_back (d);
+        }
+    }
+}
+
+std::string
+SatcomScenarioHelper::Substitute (std::string value, std::string origin) const
+{
+  std::string result;
+  std::string::size_type i = 0;
+  while (i < value.size ())
+    {
+      if (value[i] != '$')
+        {
+          result += value[i++];
+          continue;
+        }
+      std::string name;
+      if (i + 1 < value.size () && value[i + 1] == '{')
+        {
+          std::string::size_type end = value.find ('}', i + 2);
+          if (end == std::string::npos)
+            {
+              NS_FATAL_ERROR (origin << ": unterminated ${ in \"" << value << "\"");
+            }
+          name = value.substr (i + 2, end - i - 2);
+          i = end + 1;
+        }
+      else
+        {
+          std::string::size_type end = i + 1;
+          while (end < value.size ()
+                 && (std::isalnum (static_cast<unsigned char> (value[end])) || value[end] == '_'))
+            {
+              end++;
+            }
+          name = value.substr (i + 1, end - i - 1);
+          i = end;
+        }
+      std::map<std::string, std::string>::const_iterator it = m_parameters.find (name);
+      if (it == m_parameters.end ())
+        {
+          NS_FATAL_ERROR (origin << ": undefined parameter \"" << name << "\"");
+        }
+      result += it->second;
+    }
+  return result;
+}
+
+std::string
+SatcomScenarioHelper::Take (Directive &d, std::string key, std::string value)
+{
+  for (std::vector<std::pair<std::string, std::string> >::iterator it = d.args.begin ();
+       it != d.args.end (); ++it)
+    {
+      if (it->first == key)
+        {
+          value = it->second;
+          d.args.erase (it);
+          break;
+        }
+    }
+  return value;
+}
+
+std::string
+SatcomScenarioHelper::Require (Directive &d, std::string key)
+{
+  for (std::vector<std::pair<std::string, std::string> >::iterator it = d.args.begin ();
+       it != d.args.end (); ++it)
+    {
+      if (it->first == key)
+        {
+          std::string value = it->second;
+          d.args.erase (it);
+          return value;
+        }
+    }
+  NS_FATAL_ERROR (d.origin << ": " << d.kind << " needs " << key << "=");
+  return "";
+}
+
+std::vector<std::pair<std::string, std::string> >
+SatcomScenarioHelper::TakePrefix (Directive &d, std::string prefix)
+{
+  std::vector<std::pair<std::string, std::string> > taken;
+  std::vector<std::pair<std::string, std::string> >::iterator it = d.args.begin ();
+  while (it != d.args.end ())
+    {
+      if (it->first.compare (0, prefix.size (), prefix) == 0)
+        {
+          taken.push_back (std::make_pair (it->first.substr (prefix.size ()), it->second));
+          it = d.args.erase (it);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+  return taken;
+}
+
+bool
+SatcomScenarioHelper::ToBool (const Directive &d, std::string key, std::string value)
+{
+  if (value == "true" || value == "1")
+    {
+      return true;
+    }
+  if (value == "false" || value == "0")
+    {
+      return false;
+    }
+  NS_FATAL_ERROR (d.origin << ": " << key << " must be true or false, not \"" << value << "\"");
+  return false;
+}
+
+double
+SatcomScenarioHelper::ToDouble (const Directive &d, std::string value)
+{
+  char *end;
+  double result = std::strtod (value.c_str (), &end);
+  if (value.empty () || *end != '\0')
+    {
+      NS_FATAL_ERROR (d.origin << ": \"" << value << "\" is not a number");
+    }
+  return result;
+}
+
+bool
+SatcomScenarioHelper::HasAttribute (TypeId tid, std::string name)
+{
+  struct TypeId::AttributeInformation info;
+  return tid.LookupAttributeByName (name, &info);
+}
+
+void
+SatcomScenarioHelper::SetAttributes (const Directive &d, Ptr<Object> object,
+                                     const std::vector<std::pair<std::string, std::string> > &args)
+{
+  TypeId tid = object->GetInstanceTypeId ();
+  for (std::vector<std::pair<std::string, std::string> >::const_iterator it = args.begin ();
+       it != args.end (); ++it)
+    {
+      if (!HasAttribute (tid, it->first))
+        {
+          NS_FATAL_ERROR (d.origin << ": " << tid.GetName () << " has no attribute " << it->first);
+        }
+      if (!object->SetAttributeFailSafe (it->first, StringValue (it->second)))
+        {
+          NS_FATAL_ERROR (d.origin << ": invalid value \"" << it->second << "\" for "
+                          << tid.GetName () << "::" << it->first);
+        }
+    }
+}
+
+void
+SatcomScenarioHelper::Build (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (!m_built, "Scenario already built");
+  m_built = true;
+  SystemWallClockMs clock;
+  clock.Start ();
+
+  // Globals come first so that defaults apply to every object created
+  for (std::vector<Directive>::const_iterator it = m_directives.begin (); it != m_directives.end (); ++it)
+    {
+      const std::string &k = it->kind;
+      if (k == "simulation" || k == "default" || k == "global" || k == "log")
+        {
+          BuildGlobal (*it);
+        }
+      else if (k != "satellite" && k != "constellation" && k != "station"
+               && k != "link" && k != "schedule" && k != "traffic" && k != "probe")
+        {
+          NS_FATAL_ERROR (it->origin << ": unknown directive \"" << k << "\"");
+        }
+    }
+  for (std::vector<Directive>::const_iterator it = m_directives.begin (); it != m_directives.end (); ++it)
+    {
+      if (it->kind == "satellite")
+        {
+          BuildSatellite (*it);
+        }
+      else if (it->kind == "constellation")
+        {
+          BuildConstellation (*it);
+        }
+    }
+  for (std::vector<Directive>::const_iterator it = m_directives.begin (); it != m_directives.end (); ++it)
+    {
+      if (it->kind == "station")
+        {
+          BuildStation (*it);
+        }
+    }
+
+  if (m_constellation)
+    {
+      m_topology.Install (m_satellites, m_planes, m_stations, m_stop);
+    }
+  else
+    {
+      InternetStackHelper stack;
+      stack.Install (m_satellites);
+      stack.Install (m_stations);
+    }
+  for (std::vector<Directive>::const_iterator it = m_directives.begin (); it != m_directives.end (); ++it)
+    {
+      if (it->kind == "link")
+        {
+          BuildLink (*it);
+        }
+    }
+  if (m_plan != 0)
+    {
+      m_plan->Compute (Seconds (0), m_stop);
+      for (std::vector<Directive>::const_iterator it = m_directives.begin (); it != m_directives.end (); ++it)
+        {
+          if (it->kind == "schedule")
+            {
+              BuildSchedule (*it);
+            }
+        }
+      for (std::vector<Link>::const_iterator it = m_links.begin (); it != m_links.end (); ++it)
+        {
+          if (it->contactSatellite < 0)
+            {
+              continue;
+            }
+          Ptr<OrbitPointToPointChannel> channel =
+            it->devices.Get (0)->GetChannel ()->GetObject<OrbitPointToPointChannel> ();
+          if (m_scheduler != 0)
+            {
+              m_scheduler->ScheduleLinkEvents (it->contactSatellite, it->contactStation, channel);
+            }
+          else
+            {
+              m_plan->ScheduleLinkEvents (it->contactSatellite, it->contactStation, channel);
+            }
+        }
+    }
+  else
+    {
+      for (std::vector<Directive>::const_iterator it = m_directives.begin (); it != m_directives.end (); ++it)
+        {
+          if (it->kind == "schedule")
+            {
+              NS_FATAL_ERROR (it->origin << ": a schedule needs links with contacts=true");
+            }
+        }
+    }
+  if (!m_constellation)
+    {
+      Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+    }
+
+  for (std::vector<Directive>::const_iterator it = m_directives.begin (); it != m_directives.end (); ++it)
+    {
+      if (it->kind == "traffic")
+        {
+          BuildTraffic (*it);
+        }
+    }
+  for (std::vector<Directive>::const_iterator it = m_directives.begin (); it != m_directives.end (); ++it)
+    {
+      if (it->kind == "probe")
+        {
+          BuildProbe (*it);
+        }
+    }
+  m_buildSeconds = clock.End () / 1000.0;
+}
+
+void
+SatcomScenarioHelper::BuildGlobal (Directive d)
+{
+  if (d.kind == "simulation")
+    {
+      m_stop = Time (Take (d, "stop", "100s"));
+      std::string seed = Take (d, "seed", "");
+      if (!seed.empty ())
+        {
+          RngSeedManager::SetSeed (static_cast<uint32_t> (ToDouble (d, seed)));
+        }
+      m_fluid = ToBool (d, "fluid", Take (d, "fluid", "false"));
+      m_fluidArgs = TakePrefix (d, "fluid.");
+      std::string weather = Take (d, "weather", "");
+      std::vector<std::pair<std::string, std::string> > weatherArgs = TakePrefix (d, "weather.");
+      if (!weather.empty ())
+        {
+          m_weather = CreateObject<WeatherAttenuation> ();
+          SetAttributes (d, m_weather, weatherArgs);
+          if (!m_weather->Open (weather))
+            {
+              NS_FATAL_ERROR (d.origin << ": cannot read weather file " << weather);
+            }
+        }
+      std::string run = Take (d, "run", "");
+      if (!run.empty ())
+        {
+          RngSeedManager::SetRun (static_cast<uint64_t> (ToDouble (d, run)));
+        }
+      if (!d.args.empty ())
+        {
+          NS_FATAL_ERROR (d.origin << ": simulation has no key " << d.args[0].first);
+        }
+    }
+  else if (d.kind == "default" || d.kind == "global")
+    {
+      for (std::vector<std::pair<std::string, std::string> >::const_iterator it = d.args.begin ();
+           it != d.args.end (); ++it)
+        {
+          bool ok = d.kind == "default" ? Config::SetDefaultFailSafe (it->first, StringValue (it->second))
+                                        : Config::SetGlobalFailSafe (it->first, StringValue (it->second));
+          if (!ok)
+            {
+              NS_FATAL_ERROR (d.origin << ": cannot set " << it->first << " to \"" << it->second << "\"");
+            }
+        }
+    }
+  else
+    {
+      std::string component = Require (d, "component");
+      std::string level = Take (d, "level", "info");
+      LogLevel l;
+      if (level == "error")
+        {
+          l = LOG_LEVEL_ERROR;
+        }
+      else if (level == "warn")
+        {
+          l = LOG_LEVEL_WARN;
+        }
+      else if (level == "debug")
+        {
+          l = LOG_LEVEL_DEBUG;
+        }
+      else if (level == "info")
+        {
+          l = LOG_LEVEL_INFO;
+        }
+      else if (level == "function")
+        {
+          l = LOG_LEVEL_FUNCTION;
+        }
+      else if (level == "logic")
+        {
+          l = LOG_LEVEL_LOGIC;
+        }
+      else if (level == "all")
+        {
+          l = LOG_LEVEL_ALL;
+        }
+      else
+        {
+          NS_FATAL_ERROR (d.origin << ": unknown log level \"" << level << "\"");
+        }
+      LogComponentEnable (component.c_str (), l);
+    }
+}
+
+void
+SatcomScenarioHelper::BuildSatellite (Directive d)
+{
+  if (m_constellation)
+    {
+      NS_FATAL_ERROR (d.origin << ": satellites cannot be added to a constellation");
+    }
+  std::string name = Require (d, "name");
+  std::string model = Take (d, "model", "ns3::SarOrbitMobilityModel");
+  uint32_t count = static_cast<uint32_t> (ToDouble (d, Take (d, "count", "1")));
+  TypeId tid;
+  if (!TypeId::LookupByNameFailSafe (model, &tid) || !tid.IsChildOf (MobilityModel::GetTypeId ()))
+    {
+      NS_FATAL_ERROR (d.origin << ": " << model << " is not a mobility model");
+    }
+  ObjectFactory factory;
+  factory.SetTypeId (tid);
+  for (std::vector<std::pair<std::string, std::string> >::const_iterator it = d.args.begin ();
+       it != d.args.end (); ++it)
+    {
+      if (!HasAttribute (tid, it->first))
+        {
+          NS_FATAL_ERROR (d.origin << ": " << model << " has no attribute " << it->first);
+        }
+      factory.Set (it->first, StringValue (it->second));
+    }
+  for (uint32_t i = 0; i < count; ++i)
+    {
+      std::ostringstream n;
+      n << name;
+      if (count > 1)
+        {
+          n << i;
+        }
+      if (m_nodes.find (n.str ()) != m_nodes.end ())
+        {
+          NS_FATAL_ERROR (d.origin << ": duplicate node name " << n.str ());
+        }
+      Ptr<Node> node = CreateObject<Node> ();
+      node->AggregateObject (factory.Create<MobilityModel> ());
+      m_nodes[n.str ()] = node;
+      m_order.push_back (n.str ());
+      m_satellites.Add (node);
+    }
+}
+
+void
+SatcomScenarioHelper::BuildConstellation (Directive d)
+{
+  if (m_constellation || m_satellites.GetN () > 0)
+    {
+      NS_FATAL_ERROR (d.origin << ": a constellation must be the only satellites");
+    }
+  m_constellation = true;
+  std::string name = Take (d, "name", "sat");
+  uint32_t total = static_cast<uint32_t> (ToDouble (d, Require (d, "total")));
+  m_planes = static_cast<uint32_t> (ToDouble (d, Require (d, "planes")));
+  uint32_t phasing = static_cast<uint32_t> (ToDouble (d, Take (d, "phasing", "0")));
+  double altitude = ToDouble (d, Require (d, "altitude"));
+  double inclination = ToDouble (d, Require (d, "inclination"));
+  m_topology.SetElevationMask (ToDouble (d, Take (d, "minElevation", "10")));
+  m_topology.SetPolarLimit (ToDouble (d, Take (d, "polarLimit", "75")),
+                            Time (Take (d, "polarInterval", "10s")));
+
+  std::vector<std::pair<std::string, std::string> > isl = TakePrefix (d, "isl.");
+  std::vector<std::pair<std::string, std::string> > ground = TakePrefix (d, "ground.");
+  TypeId device = PointToPointNetDevice::GetTypeId ();
+  for (uint32_t i = 0; i < isl.size () + ground.size (); ++i)
+    {
+      const std::pair<std::string, std::string> &a = i < isl.size () ? isl[i] : ground[i - isl.size ()];
+      if (!HasAttribute (device, a.first))
+        {
+          NS_FATAL_ERROR (d.origin << ": " << device.GetName () << " has no attribute " << a.first);
+        }
+      (i < isl.size () ? m_topology.GetIslHelper () : m_topology.GetGroundLinkHelper ())
+        .SetDeviceAttribute (a.first, StringValue (a.second));
+    }
+
+  Ptr<ConstellationPropagator> propagator = CreateObject<ConstellationPropagator> ();
+  SetAttributes (d, propagator, d.args);
+  if (m_planes == 0 || total % m_planes != 0)
+    {
+      NS_FATAL_ERROR (d.origin << ": total must be a multiple of planes");
+    }
+  propagator->AddWalkerDelta (total, m_planes, phasing, altitude, inclination);
+  NodeContainer nodes;
+  nodes.Create (total);
+  propagator->Install (nodes);
+  for (uint32_t i = 0; i < total; ++i)
+    {
+      std::ostringstream n;
+      n << name << i;
+      m_nodes[n.str ()] = nodes.Get (i);
+      m_order.push_back (n.str ());
+    }
+  m_satellites.Add (nodes);
+}
+
+void
+SatcomScenarioHelper::BuildStation (Directive d)
+{
+  std::string name = Require (d, "name");
+  double latitude = ToDouble (d, Require (d, "lat"));
+  double longitude = ToDouble (d, Require (d, "lon"));
+  double altitude = ToDouble (d, Take (d, "alt", "0"));
+  double mask = ToDouble (d, Take (d, "minElevation", "0"));
+  std::string weather = Take (d, "weather", "");
+  if (!weather.empty () && m_weather == 0)
+    {
+      NS_FATAL_ERROR (d.origin << ": weather needs a weather file in the simulation directive");
+    }
+  bool rotating = ToBool (d, "rotating", Take (d, "rotating", "false"));
+  uint32_t count = static_cast<uint32_t> (ToDouble (d, Take (d, "count", "1")));
+  double latStep = ToDouble (d, Take (d, "latStep", "0"));
+  double lonStep = ToDouble (d, Take (d, "lonStep", "0"));
+  if (!rotating && !d.args.empty ())
+    {
+      NS_FATAL_ERROR (d.origin << ": station has no key " << d.args[0].first);
+    }
+
+  for (uint32_t i = 0; i < count; ++i)
+    {
+      std::ostringstream n;
+      n << name;
+      if (count > 1)
+        {
+          n << i;
+        }
+      if (m_nodes.find (n.str ()) != m_nodes.end ())
+        {
+          NS_FATAL_ERROR (d.origin << ": duplicate node name " << n.str ());
+        }
+      double lat = latitude + i * latStep;
+      double lon = longitude + i * lonStep;
+      Ptr<Node> node = CreateObject<Node> ();
+      if (rotating)
+        {
+          Ptr<GroundStationMobilityModel> mobility = CreateObject<GroundStationMobilityModel> ();
+          SetAttributes (d, mobility, d.args);
+          mobility->SetGeographicPosition (lat, lon, altitude);
+          node->AggregateObject (mobility);
+        }
+      else
+        {
+          double phi = lat * M_PI / 180.0;
+          double lambda = lon * M_PI / 180.0;
+          double r = satcom::EARTH_RADIUS + altitude;
+          Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+          mobility->SetPosition (Vector (r * std::cos (phi) * std::cos (lambda),
+                                         r * std::cos (phi) * std::sin (lambda),
+                                         r * std::sin (phi)));
+          node->AggregateObject (mobility);
+        }
+      m_nodes[n.str ()] = node;
+      m_order.push_back (n.str ());
+      m_stations.Add (node);
+      m_masks[node->GetId ()] = mask;
+      if (!weather.empty ())
+        {
+          uint32_t index = static_cast<uint32_t> (ToDouble (d, weather)) + i;
+          if (index >= m_weather->GetNStations ())
+            {
+              NS_FATAL_ERROR (d.origin << ": the weather file has no station " << index);
+            }
+          m_weatherStations[node->GetId ()] = index;
+        }
+    }
+}
+
+void
+SatcomScenarioHelper::BuildLink (Directive d)
+{
+  if (m_constellation)
+    {
+      NS_FATAL_ERROR (d.origin << ": constellation links are built by the constellation directive");
+    }
+  std::vector<Ptr<Node> > from = FindNodes (d, Require (d, "from"));
+  std::vector<Ptr<Node> > to = FindNodes (d, Require (d, "to"));
+  bool contacts = ToBool (d, "contacts", Take (d, "contacts", "false"));
+  bool acm = ToBool (d, "acm", Take (d, "acm", "false"));
+  bool errors = ToBool (d, "errors", Take (d, "errors", "false"));
+  std::vector<std::pair<std::string, std::string> > acmArgs = TakePrefix (d, "acm.");
+  std::vector<std::pair<std::string, std::string> > errorArgs = TakePrefix (d, "errors.");
+
+  OrbitPointToPointHelper helper;
+  TypeId device = PointToPointNetDevice::GetTypeId ();
+  TypeId channel = OrbitPointToPointChannel::GetTypeId ();
+  for (std::vector<std::pair<std::string, std::string> >::const_iterator it = d.args.begin ();
+       it != d.args.end (); ++it)
+    {
+      if (HasAttribute (device, it->first))
+        {
+          helper.SetDeviceAttribute (it->first, StringValue (it->second));
+        }
+      else if (HasAttribute (channel, it->first))
+        {
+          helper.SetChannelAttribute (it->first, StringValue (it->second));
+        }
+      else
+        {
+          NS_FATAL_ERROR (d.origin << ": links have no attribute " << it->first);
+        }
+    }
+  for (std::vector<Ptr<Node> >::const_iterator a = from.begin (); a != from.end (); ++a)
+    {
+      for (std::vector<Ptr<Node> >::const_iterator b = to.begin (); b != to.end (); ++b)
+        {
+          Connect (d, *a, *b, helper, contacts, acm, errors, acmArgs, errorArgs);
+        }
+    }
+}
+
+void
+SatcomScenarioHelper::Connect (const Directive &d, Ptr<Node> a, Ptr<Node> b,
+                               OrbitPointToPointHelper &helper, bool contacts, bool acm, bool errors,
+                               const std::vector<std::pair<std::string, std::string> > &acmArgs,
+                               const std::vector<std::pair<std::string, std::string> > &errorArgs)
+{
+  Link link;
+  link.contactSatellite = -1;
+  link.contactStation = 0;
+  if (m_masks.find (a->GetId ()) == m_masks.end () && m_masks.find (b->GetId ()) != m_masks.end ())
+    {
+      link.satellite = a;
+      link.station = b;
+    }
+  else if (m_masks.find (b->GetId ()) == m_masks.end () && m_masks.find (a->GetId ()) != m_masks.end ())
+    {
+      link.satellite = b;
+      link.station = a;
+    }
+  else
+    {
+      NS_FATAL_ERROR (d.origin << ": a link joins a satellite and a ground station");
+    }
+  link.devices = helper.Install (link.station, link.satellite);
+
+  m_subnet++;
+  std::ostringstream network;
+  network << "10." << 1 + m_subnet / 256 << "." << m_subnet % 256 << ".0";
+  Ipv4AddressHelper address;
+  address.SetBase (network.str ().c_str (), "255.255.255.0");
+  address.Assign (link.devices);
+
+  if (contacts)
+    {
+      Ptr<OrbitMobilityModel> orbit = link.satellite->GetObject<OrbitMobilityModel> ();
+      if (orbit == 0)
+        {
+          NS_FATAL_ERROR (d.origin << ": contacts need an orbit mobility model");
+        }
+      if (m_plan == 0)
+        {
+          m_plan = CreateObject<ContactPlan> ();
+        }
+      // Each node enters the plan once, however many links it has
+      link.contactSatellite = -1;
+      for (uint32_t i = 0; i < m_links.size () && link.contactSatellite < 0; ++i)
+        {
+          if (m_links[i].contactSatellite >= 0 && m_links[i].satellite == link.satellite)
+            {
+              link.contactSatellite = m_links[i].contactSatellite;
+            }
+        }
+      if (link.contactSatellite < 0)
+        {
+          link.contactSatellite = m_plan->AddSatellite (orbit);
+        }
+      bool found = false;
+      for (uint32_t i = 0; i < m_links.size () && !found; ++i)
+        {
+          if (m_links[i].contactSatellite >= 0 && m_links[i].station == link.station)
+            {
+              link.contactStation = m_links[i].contactStation;
+              found = true;
+            }
+        }
+      if (!found)
+        {
+          link.contactStation = m_plan->AddGroundStation (link.station->GetObject<MobilityModel> (),
+                                                          m_masks[link.station->GetId ()]);
+        }
+    }
+
+  Ptr<AdaptiveRateController> controller;
+  if (acm)
+    {
+      controller = CreateObject<AdaptiveRateController> ();
+      SetAttributes (d, controller, acmArgs);
+      controller->Install (DynamicCast<PointToPointNetDevice> (link.devices.Get (1)));
+      SetWeather (link.station, controller->GetLinkBudget ());
+      m_controllers.push_back (controller);
+      link.controller = controller;
+    }
+  if (errors)
+    {
+      Ptr<LinkBudgetErrorModel> model = CreateObject<LinkBudgetErrorModel> ();
+      if (controller != 0)
+        {
+          model->SetAttribute ("RateController", PointerValue (controller));
+        }
+      else if (m_weatherStations.find (link.station->GetId ()) != m_weatherStations.end ())
+        {
+          Ptr<LinkBudget> budget = CreateObject<LinkBudget> ();
+          SetWeather (link.station, budget);
+          model->SetAttribute ("LinkBudget", PointerValue (budget));
+        }
+      SetAttributes (d, model, errorArgs);
+      model->Install (link.devices.Get (0));
+    }
+  m_links.push_back (link);
+}
+
+void
+SatcomScenarioHelper::BuildSchedule (Directive d)
+{
+  if (m_scheduler != 0)
+    {
+      NS_FATAL_ERROR (d.origin << ": only one schedule is allowed");
+    }
+  uint64_t backlog = static_cast<uint64_t> (ToDouble (d, Take (d, "backlog", "0")));
+  DataRate generation (Take (d, "generation", "0bps"));
+  uint32_t antennas = static_cast<uint32_t> (ToDouble (d, Take (d, "antennas", "1")));
+  std::string file = Take (d, "file", "");
+  if (antennas == 0)
+    {
+      NS_FATAL_ERROR (d.origin << ": a station needs an antenna");
+    }
+  m_scheduler = CreateObject<PassScheduler> ();
+  SetAttributes (d, m_scheduler, d.args);
+  m_scheduler->SetContactPlan (m_plan);
+  for (uint32_t i = 0; i < m_plan->GetNSatellites (); ++i)
+    {
+      m_scheduler->SetBacklog (i, backlog);
+      m_scheduler->SetGenerationRate (i, generation);
+    }
+  for (uint32_t i = 0; i < m_plan->GetNGroundStations (); ++i)
+    {
+      m_scheduler->SetAntennas (i, antennas);
+    }
+  // Each pair downlinks at the rate of its satellite device
+  for (std::vector<Link>::const_iterator it = m_links.begin (); it != m_links.end (); ++it)
+    {
+      if (it->contactSatellite >= 0)
+        {
+          DataRateValue rate;
+          it->devices.Get (1)->GetAttribute ("DataRate", rate);
+          m_scheduler->SetLinkRate (it->contactSatellite, it->contactStation, rate.Get ());
+        }
+    }
+  m_scheduler->Solve ();
+  if (!file.empty ())
+    {
+      std::ofstream os (file.c_str ());
+      m_scheduler->Print (os);
+    }
+}
+
+void
+SatcomScenarioHelper::SetWeather (Ptr<Node> station, Ptr<LinkBudget> budget) const
+{
+  std::map<uint32_t, uint32_t>::const_iterator it = m_weatherStations.find (station->GetId ());
+  if (it != m_weatherStations.end ())
+    {
+      budget->SetAttribute ("Weather", PointerValue (m_weather));
+      budget->SetAttribute ("WeatherStation", UintegerValue (it->second));
+    }
+}
+
+Ptr<Node>
+SatcomScenarioHelper::FindNode (const Directive &d, std::string name) const
+{
+  std::map<std::string, Ptr<Node> >::const_iterator it = m_nodes.find (name);
+  if (it == m_nodes.end ())
+    {
+      NS_FATAL_ERROR (d.origin << ": unknown node \"" << name << "\"");
+    }
+  return it->second;
+}
+
+std::vector<std::string>
+SatcomScenarioHelper::MatchNames (const Directive &d, std::string pattern) const
+{
+  std::vector<std::string> names;
+  if (pattern.empty () || pattern[pattern.size () - 1] != '*')
+    {
+      FindNode (d, pattern);
+      names.push_back (pattern);
+      return names;
+    }
+  std::string prefix = pattern.substr (0, pattern.size () - 1);
+  for (std::vector<std::string>::const_iterator it = m_order.begin (); it != m_order.end (); ++it)
+    {
+      if (it->compare (0, prefix.size (), prefix) == 0)
+        {
+          names.push_back (*it);
+        }
+    }
+  if (names.empty ())
+    {
+      NS_FATAL_ERROR (d.origin << ": no node matches \"" << pattern << "\"");
+    }
+  return names;
+}
+
+std::vector<Ptr<Node> >
+SatcomScenarioHelper::FindNodes (const Directive &d, std::string pattern) const
+{
+  std::vector<std::string> names = MatchNames (d, pattern);
+  std::vector<Ptr<Node> > nodes;
+  for (std::vector<std::string>::const_iterator it = names.begin (); it != names.end (); ++it)
+    {
+      nodes.push_back (FindNode (d, *it));
+    }
+  return nodes;
+}
+
+Ipv4Address
+SatcomScenarioHelper::GetAddress (Ptr<Node> node) const
+{
+  if (m_constellation)
+    {
+      for (uint32_t i = 0; i < m_stations.GetN (); ++i)
+        {
+          if (m_stations.Get (i) == node)
+            {
+              return m_topology.GetStationAddress (i);
+            }
+        }
+    }
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (ipv4 != 0 && ipv4->GetNInterfaces () > 1, "Node " << node->GetId () << " has no link");
+  return ipv4->GetAddress (1, 0).GetLocal ();
+}
+
+std::vector<Ptr<PointToPointNetDevice> >
+SatcomScenarioHelper::GetPath (const Directive &d, Ptr<Node> from, Ptr<Node> to) const
+{
+  if (m_constellation)
+    {
+      NS_FATAL_ERROR (d.origin << ": fluid traffic needs link directives");
+    }
+  std::vector<Ptr<PointToPointNetDevice> > path;
+  for (std::vector<Link>::const_iterator up = m_links.begin (); up != m_links.end (); ++up)
+    {
+      // Satellite to station, station to satellite, or station to station through a satellite
+      if (up->satellite == from && up->station == to)
+        {
+          path.push_back (DynamicCast<PointToPointNetDevice> (up->devices.Get (1)));
+          return path;
+        }
+      if (up->station != from)
+        {
+          continue;
+        }
+      path.push_back (DynamicCast<PointToPointNetDevice> (up->devices.Get (0)));
+      if (up->satellite == to)
+        {
+          return path;
+        }
+      for (std::vector<Link>::const_iterator down = m_links.begin (); down != m_links.end (); ++down)
+        {
+          if (down->satellite == up->satellite && down->station == to)
+            {
+              path.push_back (DynamicCast<PointToPointNetDevice> (down->devices.Get (1)));
+              return path;
+            }
+        }
+      path.clear ();
+    }
+  NS_FATAL_ERROR (d.origin << ": no path of at most one satellite for fluid traffic");
+  return path;
+}
+
+Ptr<FluidFlowModel>
+SatcomScenarioHelper::GetFluidModel (void)
+{
+  if (m_fluidModel == 0)
+    {
+      m_fluidModel = CreateObject<FluidFlowModel> ();
+      for (std::vector<std::pair<std::string, std::string> >::const_iterator it = m_fluidArgs.begin ();
+           it != m_fluidArgs.end (); ++it)
+        {
+          m_fluidModel->SetAttribute (it->first, StringValue (it->second));
+        }
+      for (std::vector<Link>::const_iterator it = m_links.begin (); it != m_links.end (); ++it)
+        {
+          if (it->controller != 0)
+            {
+              m_fluidModel->SetRateController (DynamicCast<PointToPointNetDevice> (it->devices.Get (1)),
+                                               it->controller);
+            }
+        }
+    }
+  return m_fluidModel;
+}
+
+void
+SatcomScenarioHelper::BuildTraffic (Directive d)
+{
+  std::vector<std::string> from = MatchNames (d, Require (d, "from"));
+  for (uint32_t i = 0; i < from.size (); ++i)
+    {
+      BuildFlow (d, from[i], i);
+    }
+}
+
+void
+SatcomScenarioHelper::BuildFlow (Directive d, std::string fromName, uint16_t portOffset)
+{
+  std::string type = Require (d, "type");
+  std::string toName = Take (d, "to", "");
+  Ptr<Node> from = FindNode (d, fromName);
+  Time start = Time (Take (d, "start", "0s"));
+  Time stop = Time (Take (d, "stop", "0s"));
+  if (stop.IsZero ())
+    {
+      stop = m_stop;
+    }
+  std::vector<std::pair<std::string, std::string> > serverArgs = TakePrefix (d, "server.");
+  // Only bulk transfers have a fluid model
+  bool fluid = ToBool (d, "fluid", Take (d, "fluid", m_fluid ? "true" : "false"));
+
+  uint32_t index = m_traffic.size ();
+  Traffic traffic;
+  traffic.name = type + " " + fromName + (toName.empty () ? "" : "->" + toName);
+  traffic.start = start;
+  traffic.stop = stop;
+  traffic.rxBytes = 0;
+  traffic.fluidFlow = -1;
+  m_traffic.push_back (traffic);
+
+  ApplicationContainer servers;
+  ApplicationContainer clients;
+  if (type == "sar")
+    {
+      if (m_constellation)
+        {
+          NS_FATAL_ERROR (d.origin << ": sar traffic needs link directives");
+        }
+      uint16_t port = static_cast<uint16_t> (ToDouble (d, Take (d, "port", "9000"))) + portOffset;
+      Ptr<SarPayloadApplication> payload = CreateObject<SarPayloadApplication> ();
+      SetAttributes (d, payload, d.args);
+      from->AddApplication (payload);
+      clients.Add (payload);
+      PacketSinkHelper sink ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+      for (std::vector<Link>::const_iterator it = m_links.begin (); it != m_links.end (); ++it)
+        {
+          if (it->satellite != from || (!toName.empty () && it->station != FindNode (d, toName)))
+            {
+              continue;
+            }
+          Ptr<Ipv4> ipv4 = it->station->GetObject<Ipv4> ();
+          Ipv4Address remote = ipv4->GetAddress (ipv4->GetInterfaceForDevice (it->devices.Get (0)), 0).GetLocal ();
+          payload->AddDownlink (it->devices.Get (1), InetSocketAddress (remote, port));
+          ApplicationContainer apps = sink.Install (it->station);
+          apps.Get (0)->TraceConnectWithoutContext (
+            "Rx", MakeCallback (&SatcomScenarioHelper::RxFrom, this).Bind (index));
+          servers.Add (apps);
+        }
+      if (servers.GetN () == 0)
+        {
+          NS_FATAL_ERROR (d.origin << ": " << fromName << " has no link for sar traffic");
+        }
+    }
+  else
+    {
+      if (toName.empty ())
+        {
+          NS_FATAL_ERROR (d.origin << ": " << type << " traffic needs to=");
+        }
+      Ptr<Node> to = FindNode (d, toName);
+      Ipv4Address remote = GetAddress (to);
+      if (type == "bulk" && fluid)
+        {
+          uint64_t maxBytes = static_cast<uint64_t> (ToDouble (d, Take (d, "MaxBytes", "0")));
+          Take (d, "port", "");
+          if (!d.args.empty () || !serverArgs.empty ())
+            {
+              NS_FATAL_ERROR (d.origin << ": fluid bulk traffic takes MaxBytes only");
+            }
+          std::vector<Ptr<PointToPointNetDevice> > path = GetPath (d, from, to);
+          m_traffic[index].fluidFlow = GetFluidModel ()->AddFlow (path, start, stop, maxBytes);
+          return;
+        }
+      else if (type == "bulk" || type == "onoff")
+        {
+          std::string factory = type == "bulk" ? "ns3::TcpSocketFactory" : "ns3::UdpSocketFactory";
+          uint16_t port = static_cast<uint16_t> (ToDouble (d, Take (d, "port", type == "bulk" ? "618" : "9000"))) + portOffset;
+          PacketSinkHelper sink (factory, InetSocketAddress (Ipv4Address::GetAny (), port));
+          servers = sink.Install (to);
+          servers.Get (0)->TraceConnectWithoutContext (
+            "Rx", MakeCallback (&SatcomScenarioHelper::RxFrom, this).Bind (index));
+          if (type == "bulk")
+            {
+              Address target = BuildPeps (d, from, to, InetSocketAddress (remote, port), port + 1000, stop);
+              clients = BulkSendHelper (factory, target).Install (from);
+            }
+          else
+            {
+              clients = OnOffHelper (factory, InetSocketAddress (remote, port)).Install (from);
+            }
+        }
+      else if (type == "echo")
+        {
+          uint16_t port = static_cast<uint16_t> (ToDouble (d, Take (d, "port", "9"))) + portOffset;
+          servers = UdpEchoServerHelper (port).Install (to);
+          clients = UdpEchoClientHelper (remote, port).Install (from);
+          clients.Get (0)->TraceConnectWithoutContext (
+            "Rx", MakeCallback (&SatcomScenarioHelper::Rx, this).Bind (index));
+        }
+      else if (type == "http")
+        {
+          uint16_t port = static_cast<uint16_t> (ToDouble (d, Take (d, "port", "80"))) + portOffset;
+          servers = ThreeGppHttpServerHelper (remote).Install (to);
+          servers.Get (0)->SetAttribute ("LocalPort", UintegerValue (port));
+          PointerValue variables;
+          servers.Get (0)->GetAttribute ("Variables", variables);
+          SetAttributes (d, variables.Get<ThreeGppHttpVariables> (), TakePrefix (d, "variables."));
+          clients = ThreeGppHttpClientHelper (remote).Install (from);
+          clients.Get (0)->SetAttribute ("RemoteServerPort", UintegerValue (port));
+          clients.Get (0)->TraceConnectWithoutContext (
+            "Rx", MakeCallback (&SatcomScenarioHelper::RxFrom, this).Bind (index));
+        }
+      else
+        {
+          NS_FATAL_ERROR (d.origin << ": unknown traffic type \"" << type << "\"");
+        }
+      SetAttributes (d, clients.Get (0), d.args);
+    }
+  for (uint32_t i = 0; i < servers.GetN (); ++i)
+    {
+      SetAttributes (d, servers.Get (i), serverArgs);
+    }
+  servers.Start (Seconds (0));
+  servers.Stop (stop);
+  clients.Start (start);
+  clients.Stop (stop);
+}
+
+Address
+SatcomScenarioHelper::BuildPeps (Directive &d, Ptr<Node> from, Ptr<Node> to, Address remote,
+                                 uint16_t port, Time stop)
+{
+  std::string names = Take (d, "pep", "");
+  std::vector<std::pair<std::string, std::string> > args = TakePrefix (d, "pep.");
+  std::vector<Ptr<Node> > peps;
+  std::istringstream is (names);
+  std::string name;
+  while (std::getline (is, name, ','))
+    {
+      peps.push_back (FindNode (d, name));
+      // TCP over the loopback acknowledges before the sender records its segment
+      if (peps.back () == from || peps.back () == to)
+        {
+          NS_FATAL_ERROR (d.origin << ": pep node " << name << " is an end of the traffic");
+        }
+    }
+  // Chain the proxies from the server back, the legs between them cross the space segment
+  for (uint32_t i = peps.size (); i-- > 0; )
+    {
+      Ptr<PepApplication> pep = CreateObject<PepApplication> ();
+      pep->SetAttribute ("Port", UintegerValue (port));
+      pep->SetAttribute ("Remote", AddressValue (remote));
+      PepApplication::SpaceLeg leg = PepApplication::BOTH;
+      if (peps.size () > 1 && i == 0)
+        {
+          leg = PepApplication::CONNECTED;
+        }
+      else if (peps.size () > 1 && i == peps.size () - 1)
+        {
+          leg = PepApplication::ACCEPTED;
+        }
+      pep->SetAttribute ("SpaceLeg", EnumValue (leg));
+      SetAttributes (d, pep, args);
+      peps[i]->AddApplication (pep);
+      pep->SetStartTime (Seconds (0));
+      pep->SetStopTime (stop);
+      remote = InetSocketAddress (GetAddress (peps[i]), port);
+    }
+  return remote;
+}
+
+void
+SatcomScenarioHelper::BuildProbe (Directive d)
+{
+  std::string type = Require (d, "type");
+  if (type == "flowmon")
+    {
+      m_flowmonFile = Require (d, "file");
+      m_outputs.push_back (std::make_pair ("flowmon", m_flowmonFile));
+      if (m_flowsFile.empty ())
+        {
+          m_flowmon.InstallAll ();
+        }
+    }
+  else if (type == "pcap")
+    {
+      std::string prefix = Require (d, "prefix");
+      m_tracing.EnablePcapAll (prefix);
+      m_outputs.push_back (std::make_pair ("pcap", prefix));
+    }
+  else if (type == "ascii")
+    {
+      AsciiTraceHelper ascii;
+      std::string file = Require (d, "file");
+      m_tracing.EnableAsciiAll (ascii.CreateFileStream (file));
+      m_outputs.push_back (std::make_pair ("ascii", file));
+    }
+  else if (type == "netanim")
+    {
+      if (m_anim != 0)
+        {
+          NS_FATAL_ERROR (d.origin << ": only one netanim probe is supported");
+        }
+      std::string file = Require (d, "file");
+      m_anim = new AnimationInterface (file);
+      m_outputs.push_back (std::make_pair ("netanim", file));
+      Time interval = Time (Take (d, "interval", "0.5s"));
+      std::string route = Take (d, "route", "");
+      if (!route.empty ())
+        {
+          m_outputs.push_back (std::make_pair ("netanim", route));
+          m_anim->EnableIpv4RouteTracking (route, Seconds (0), m_stop, interval);
+        }
+      m_anim->SetMobilityPollInterval (interval);
+      m_anim->EnablePacketMetadata (ToBool (d, "metadata", Take (d, "metadata", "true")));
+    }
+  else if (type == "course")
+    {
+      for (uint32_t i = 0; i < m_satellites.GetN (); ++i)
+        {
+          std::ostringstream path;
+          path << "/NodeList/" << m_satellites.Get (i)->GetId () << "/$ns3::MobilityModel/CourseChange";
+          Config::Connect (path.str (), MakeCallback (&SatcomScenarioHelper::CourseChange));
+        }
+    }
+  else if (type == "geometry")
+    {
+      if (m_geometry != 0)
+        {
+          NS_FATAL_ERROR (d.origin << ": only one geometry probe is supported");
+        }
+      std::string file = Take (d, "file", "geometry.bin");
+      m_geometry = CreateObject<LinkGeometryTrace> ();
+      m_geometry->SetAttribute ("Interval", TimeValue (Time (Take (d, "interval", "1s"))));
+      SetAttributes (d, m_geometry, d.args);
+      d.args.clear ();
+      // Every orbit link once, from either of its devices
+      std::set<Ptr<OrbitPointToPointChannel> > seen;
+      for (std::map<std::string, Ptr<Node> >::const_iterator it = m_nodes.begin (); it != m_nodes.end (); ++it)
+        {
+          for (uint32_t i = 0; i < it->second->GetNDevices (); ++i)
+            {
+              Ptr<Channel> channel = it->second->GetDevice (i)->GetChannel ();
+              Ptr<OrbitPointToPointChannel> orbit = channel != 0 ? channel->GetObject<OrbitPointToPointChannel> () : 0;
+              if (orbit != 0 && orbit->GetNDevices () == 2 && seen.insert (orbit).second)
+                {
+                  m_geometry->AddLink (orbit);
+                }
+            }
+        }
+      if (!m_geometry->Open (file, Seconds (0), m_stop))
+        {
+          NS_FATAL_ERROR (d.origin << ": cannot create " << file);
+        }
+      m_outputs.push_back (std::make_pair ("geometry", file));
+    }
+  else if (type == "flows")
+    {
+      m_flowsFile = Require (d, "file");
+      if (m_flowmonFile.empty ())
+        {
+          m_flowmon.InstallAll ();
+        }
+    }
+  else if (type == "cost")
+    {
+      m_costFile = Take (d, "file", "cost.csv");
+    }
+  else if (type == "rx")
+    {
+      m_reportRx = true;
+      m_rxFile = Take (d, "file", "");
+    }
+  else
+    {
+      NS_FATAL_ERROR (d.origin << ": unknown probe type \"" << type << "\"");
+    }
+  if (!d.args.empty ())
+    {
+      NS_FATAL_ERROR (d.origin << ": " << type << " probe has no key " << d.args[0].first);
+    }
+}
+
+void
+SatcomScenarioHelper::RxFrom (uint32_t traffic, Ptr<const Packet> packet, const Address &from)
+{
+  m_traffic[traffic].rxBytes += packet->GetSize ();
+}
+
+void
+SatcomScenarioHelper::Rx (uint32_t traffic, Ptr<const Packet> packet)
+{
+  m_traffic[traffic].rxBytes += packet->GetSize ();
+}
+
+void
+SatcomScenarioHelper::CourseChange (std::string context, Ptr<const MobilityModel> model)
+{
+  Vector position = model->GetPosition ();
+  std::cout << Simulator::Now ().GetSeconds () << "s " << context << " x=" << position.x
+            << " y=" << position.y << " z=" << position.z << std::endl;
+}
+
+void
+SatcomScenarioHelper::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_built)
+    {
+      Build ();
+    }
+  Simulator::Stop (m_stop);
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Run ();
+  double runSeconds = clock.End () / 1000.0;
+  uint64_t events = Simulator::GetEventCount ();
+  if (m_fluidModel != 0)
+    {
+      m_fluidModel->Update ();
+      for (std::vector<Traffic>::iterator it = m_traffic.begin (); it != m_traffic.end (); ++it)
+        {
+          it->rxBytes = it->fluidFlow >= 0 ? m_fluidModel->GetRxBytes (it->fluidFlow) : it->rxBytes;
+        }
+    }
+  if (!m_flowmonFile.empty ())
+    {
+      m_flowmon.SerializeToXmlFile (m_flowmonFile, true, true);
+    }
+  if (!m_flowsFile.empty ())
+    {
+      ReportFlows ();
+    }
+  if (m_reportRx)
+    {
+      ReportRx ();
+    }
+  if (m_geometry != 0)
+    {
+      m_geometry->Close ();
+      m_geometry = 0;
+    }
+  Simulator::Destroy ();
+  delete m_anim;
+  m_anim = 0;
+  // Drop the last references to the devices so that their trace files close
+  m_nodes.clear ();
+  m_satellites = NodeContainer ();
+  m_stations = NodeContainer ();
+  m_devices = NetDeviceContainer ();
+  m_links.clear ();
+  m_controllers.clear ();
+  m_fluidModel = 0;
+  m_plan = 0;
+  m_scheduler = 0;
+  m_weather = 0;
+  m_topology = ConstellationTopologyHelper ();
+  if (!m_costFile.empty ())
+    {
+      ReportCost (runSeconds, events);
+    }
+}
+
+uint64_t
+SatcomScenarioHelper::GetOutputBytes (std::string kind) const
+{
+  uint64_t bytes = 0;
+  struct stat st;
+  for (std::vector<std::pair<std::string, std::string> >::const_iterator it = m_outputs.begin ();
+       it != m_outputs.end (); ++it)
+    {
+      if (it->first != kind)
+        {
+          continue;
+        }
+      if (kind != "pcap")
+        {
+          bytes += stat (it->second.c_str (), &st) == 0 ? st.st_size : 0;
+          continue;
+        }
+      // One pcap file per device, named after the prefix
+      std::string::size_type slash = it->second.rfind ('/');
+      std::string directory = slash == std::string::npos ? "." : it->second.substr (0, slash);
+      std::string base = slash == std::string::npos ? it->second : it->second.substr (slash + 1);
+      DIR *dir = opendir (directory.c_str ());
+      if (dir == 0)
+        {
+          continue;
+        }
+      for (struct dirent *entry = readdir (dir); entry != 0; entry = readdir (dir))
+        {
+          std::string name = entry->d_name;
+          if (name.compare (0, base.size (), base) == 0 && name.size () > 5
+              && name.compare (name.size () - 5, 5, ".pcap") == 0
+              && stat ((directory + "/" + name).c_str (), &st) == 0)
+            {
+              bytes += st.st_size;
+            }
+        }
+      closedir (dir);
+    }
+  return bytes;
+}
+
+void
+SatcomScenarioHelper::ReportCost (double runSeconds, uint64_t events) const
+{
+  std::ofstream os (m_costFile.c_str ());
+  os << "buildSeconds,runSeconds,simulatedSeconds,events,eventsPerSecond,"
+     << "pcapBytes,asciiBytes,netanimBytes,flowmonBytes,geometryBytes" << std::endl;
+  os << m_buildSeconds << "," << runSeconds << "," << m_stop.GetSeconds () << "," << events << ","
+     << (runSeconds > 0 ? events / runSeconds : 0) << "," << GetOutputBytes ("pcap") << ","
+     << GetOutputBytes ("ascii") << "," << GetOutputBytes ("netanim") << ","
+     << GetOutputBytes ("flowmon") << "," << GetOutputBytes ("geometry") << std::endl;
+}
+
+void
+SatcomScenarioHelper::ReportRx (void)
+{
+  std::ofstream file;
+  if (!m_rxFile.empty ())
+    {
+      file.open (m_rxFile.c_str ());
+    }
+  std::ostream &os = m_rxFile.empty () ? std::cout : file;
+  for (std::vector<Traffic>::const_iterator it = m_traffic.begin (); it != m_traffic.end (); ++it)
+    {
+      double seconds = (it->stop - it->start).GetSeconds ();
+      os << it->name << " " << it->rxBytes << " bytes "
+         << (seconds > 0 ? it->rxBytes * 8 / seconds : 0) << " bps" << std::endl;
+    }
+}
+
+void
+SatcomScenarioHelper::ReportFlows (void)
+{
+  std::ofstream os (m_flowsFile.c_str ());
+  Ptr<FlowMonitor> monitor = m_flowmon.GetMonitor ();
+  Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier> (m_flowmon.GetClassifier ());
+  monitor->CheckForLostPackets ();
+  os << "flow,source,destination,protocol,txPackets,rxPackets,txBytes,rxBytes,lostPackets,"
+     << "meanDelay,throughput" << std::endl;
+  const FlowMonitor::FlowStatsContainer &stats = monitor->GetFlowStats ();
+  for (FlowMonitor::FlowStatsContainer::const_iterator it = stats.begin (); it != stats.end (); ++it)
+    {
+      Ipv4FlowClassifier::FiveTuple t = classifier->FindFlow (it->first);
+      const FlowMonitor::FlowStats &f = it->second;
+      double duration = (f.timeLastRxPacket - f.timeFirstTxPacket).GetSeconds ();
+      os << it->first << "," << t.sourceAddress << ":" << t.sourcePort << ","
+         << t.destinationAddress << ":" << t.destinationPort << "," << +t.protocol << ","
+         << f.txPackets << "," << f.rxPackets << "," << f.txBytes << "," << f.rxBytes << ","
+         << f.lostPackets << "," << (f.rxPackets ? f.delaySum.GetSeconds () / f.rxPackets : 0) << ","
+         << (duration > 0 ? f.rxBytes * 8 / duration : 0) << std::endl;
+    }
+}
+
+Ptr<Node>
+SatcomScenarioHelper::GetNode (std::string name) const
+{
+  std::map<std::string, Ptr<Node> >::const_iterator it = m_nodes.find (name);
+  return it == m_nodes.end () ? 0 : it->second;
+}
+
+NodeContainer
+SatcomScenarioHelper::GetSatellites (void) const
+{
+  return m_satellites;
+}
+
+NodeContainer
+SatcomScenarioHelper::GetStations (void) const
+{
+  return m_stations;
+}
+
+Time
+SatcomScenarioHelper::GetStopTime (void) const
+{
+  return m_stop;
+}
+
+uint64_t
+SatcomScenarioHelper::GetRxBytes (uint32_t traffic) const
+{
+  NS_ASSERT (traffic < m_traffic.size ());
+  return m_traffic[traffic].rxBytes;
+}
+
+} // namespace ns3
@@ -0,0 +1,458 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SATCOM_SCENARIO_HELPER_H
+#define SATCOM_SCENARIO_HELPER_H
+
+#include <istream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/application-container.h"
+#include "ns3/flow-monitor-helper.h"
+#include "ns3/nstime.h"
+#include "ns3/orbit-point-to-point-helper.h"
+#include "ns3/constellation-topology-helper.h"
+
+namespace ns3 {
+
+class AnimationInterface;
+class ContactPlan;
+class PassScheduler;
+class AdaptiveRateController;
+class FluidFlowModel;
+class LinkGeometryTrace;
+class LinkBudget;
+class WeatherAttenuation;
+class PointToPointNetDevice;
+class MobilityModel;
+class Packet;
+class Address;
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Build and run a satcom simulation described by a scenario file.
+ *
+ * A scenario file has one directive per line, a keyword followed by
+ * key=value pairs; values with spaces are double-quoted and '#' starts
+ * a comment. "$name" or "${name}" in a value is replaced by a
+ * parameter, declared with a default by "param name value" and
+ * overridable with SetParameter () before loading. Keys a directive
+ * does not know are attributes of the object it creates, so any
+ * attribute is reachable without recompiling. Any directive with
+ * "if=false" (typically "if=\$pcap") is skipped.
+ *
+ * \verbatim
+   param rate 520Mbps
+   default ns3::TcpSocket::SegmentSize=1448     # Config::SetDefault
+   log component=PacketSink level=info
+   simulation stop=12000s seed=1 run=1 [fluid=true] [weather=weather.bin]
+   satellite name=sar model=ns3::SarOrbitMobilityModel EvaluationMode=Lazy
+   station name=north lat=90 lon=0 minElevation=10 [rotating=true] [weather=0]
+   link from=sar to=north DataRate=$rate [contacts=true] [acm=true] [errors=true]
+   schedule backlog=16e9 generation=40Mbps [antennas=1] [file=passes.txt]
+   traffic type=bulk from=north to=south start=2s port=618 MaxBytes=0
+   probe type=flowmon file=capture.xml
+   \endverbatim
+ *
+ * Satellites take the mobility model type in "model" and its
+ * attributes; "count" creates several, suffixed by their index.
+ * Stations take the same "count", spaced by "latStep" and "lonStep"
+ * degrees. Where a directive names nodes, "name*" matches every node
+ * whose name starts with "name": a link is built per pair, a traffic
+ * per source, each on the next port.
+ * Alternatively one "constellation" directive (total, planes, phasing,
+ * altitude in m, inclination in degrees, ConstellationPropagator
+ * attributes) builds a Walker constellation wired by
+ * ConstellationTopologyHelper, with "isl." and "ground." prefixed link
+ * device attributes, "minElevation", "polarLimit" and "polarInterval"; "link"
+ * directives are then not allowed. Otherwise every link is an
+ * OrbitPointToPointChannel whose unknown keys are device, then channel
+ * attributes; "contacts" drives it from a ContactPlan with the
+ * station's elevation mask, "acm" adds an AdaptiveRateController to the
+ * satellite device ("acm." attributes) and "errors" a
+ * LinkBudgetErrorModel to the station device ("errors." attributes).
+ * A "weather" file in the simulation directive (WeatherAttenuation
+ * attributes as "weather." keys) gives the stations with a "weather"
+ * index, incremented with "count", the rain and cloud attenuation of
+ * that record in the link budget of their acm and errors links.
+ * A "schedule" directive lets a PassScheduler assign the contact
+ * windows instead, each station tracking "antennas" satellites at a
+ * time and each satellite holding "backlog" bytes plus what it
+ * produces at the "generation" rate; the links are then only up
+ * during their assigned passes, "file" receives the schedule and the
+ * other keys are scheduler attributes.
+ * Routing is global routing.
+ *
+ * Traffic types are bulk (TCP BulkSend to a PacketSink), onoff (UDP
+ * OnOff to a PacketSink), echo (UDP echo), http (3GPP HTTP, with
+ * "variables." attributes) and sar (a SarPayloadApplication on the
+ * satellite "from", draining over all its links). A bulk traffic with
+ * "fluid=true", the default after "simulation fluid=true", is a
+ * FluidFlowModel flow over the star links ("MaxBytes" only) instead
+ * of packets; "simulation" takes the model's "fluid." attributes. A
+ * packet bulk traffic with "pep=north,south" is split by a chain of
+ * PepApplication proxies on the named nodes, in path order, listening
+ * on the traffic port plus 1000; the legs between proxies, or both legs
+ * of a single proxy, cross the space segment, and "pep." keys are
+ * proxy attributes. The proxies run on other nodes than the ends. Unknown keys are
+ * attributes of the client, "server." ones of the server. Probes are
+ * flowmon (file), flows (file, per-flow FlowMonitor statistics as
+ * CSV), pcap (prefix), ascii (file), netanim (file, route, interval),
+ * course (logs the satellite course changes), geometry (file, interval,
+ * LinkGeometryTrace attributes: the range, elevation, Doppler, delay and
+ * state of every orbit link as a binary columnar file), rx (prints, or
+ * writes to file, the bytes each traffic delivered) and cost (file, the
+ * wall time, event count and bytes written by the other probes as CSV).
+ */
+class SatcomScenarioHelper
+{
+public:
+  SatcomScenarioHelper ();
+  ~SatcomScenarioHelper ();
+
+  /**
+   * \param name a parameter name
+   * \param value its value, which takes precedence over the scenario default
+   */
+  void SetParameter (std::string name, std::string value);
+
+  /**
+   * \param assignments comma-separated name=value parameter assignments
+   */
+  void SetParameters (std::string assignments);
+
+  /**
+   * \param filename a scenario file to append to the scenario
+   */
+  void Load (std::string filename);
+
+  /**
+   * \param is a stream of scenario directives to append to the scenario
+   * \param origin the name of the stream in error messages
+   */
+  void Parse (std::istream &is, std::string origin);
+
+  /// \brief Create the nodes, links, applications and probes
+  void Build (void);
+
+  /// \brief Run the simulation, write the probes and destroy the simulator
+  void Run (void);
+
+  /**
+   * \param name a satellite or ground station name
+   * \return the node
+   */
+  Ptr<Node> GetNode (std::string name) const;
+
+  /// \return the satellites
+  NodeContainer GetSatellites (void) const;
+
+  /// \return the ground stations
+  NodeContainer GetStations (void) const;
+
+  /// \return the end of the simulation
+  Time GetStopTime (void) const;
+
+  /**
+   * \param traffic a traffic index, in scenario order
+   * \return the bytes it delivered so far
+   */
+  uint64_t GetRxBytes (uint32_t traffic) const;
+
+private:
+  /// One line of the scenario
+  struct Directive
+  {
+    std::string kind;                                         //!< Keyword
+    std::vector<std::pair<std::string, std::string> > args;   //!< Key=value pairs
+    std::string origin;                                       //!< File and line
+  };
+
+  /// A traffic flow and what it delivered
+  struct Traffic
+  {
+    std::string name;    //!< Type, source and destination
+    Time start;          //!< Start time
+    Time stop;           //!< Stop time
+    uint64_t rxBytes;    //!< Bytes delivered
+    int32_t fluidFlow;   //!< Flow of the fluid model, or -1 if packet-level
+  };
+
+  /// A link between a satellite and a ground station
+  struct Link
+  {
+    Ptr<Node> satellite;                 //!< Satellite end
+    Ptr<Node> station;                   //!< Ground station end
+    NetDeviceContainer devices;          //!< Station device, then satellite device
+    int32_t contactSatellite;            //!< Satellite index in the contact plan, or -1
+    uint32_t contactStation;             //!< Station index in the contact plan
+    Ptr<AdaptiveRateController> controller;  //!< Rate controller of the satellite device, if any
+  };
+
+  /**
+   * \param value a value with parameter references
+   * \param origin where the value comes from
+   * \return the value with the references replaced
+   */
+  std::string Substitute (std::string value, std::string origin) const;
+
+  /**
+   * \brief Remove a key from a directive
+   * \param d the directive
+   * \param key the key
+   * \param value the value to return if the key is absent
+   * \return the value of the key
+   */
+  static std::string Take (Directive &d, std::string key, std::string value);
+
+  /**
+   * \brief Remove a mandatory key from a directive
+   * \param d the directive
+   * \param key the key
+   * \return the value of the key
+   */
+  static std::string Require (Directive &d, std::string key);
+
+  /**
+   * \brief Remove all keys with a prefix from a directive
+   * \param d the directive
+   * \param prefix the prefix, such as "acm."
+   * \return the keys without the prefix, with their values
+   */
+  static std::vector<std::pair<std::string, std::string> > TakePrefix (Directive &d, std::string prefix);
+
+  /**
+   * \param d a directive
+   * \param key a key
+   * \param value its value
+   * \return the value as a boolean
+   */
+  static bool ToBool (const Directive &d, std::string key, std::string value);
+
+  /**
+   * \param d a directive
+   * \param value a number
+   * \return the number
+   */
+  static double ToDouble (const Directive &d, std::string value);
+
+  /**
+   * \param tid a type
+   * \param name an attribute name
+   * \return whether tid has the attribute
+   */
+  static bool HasAttribute (TypeId tid, std::string name);
+
+  /**
+   * \param d a directive
+   * \param object an object
+   * \param args attributes to set on it, all of which must exist
+   */
+  static void SetAttributes (const Directive &d, Ptr<Object> object,
+                             const std::vector<std::pair<std::string, std::string> > &args);
+
+  /// \param d a "simulation", "default", "global" or "log" directive
+  void BuildGlobal (Directive d);
+  /// \param d a "satellite" directive
+  void BuildSatellite (Directive d);
+  /// \param d a "constellation" directive
+  void BuildConstellation (Directive d);
+  /// \param d a "station" directive
+  void BuildStation (Directive d);
+  /// \param d a "link" directive
+  void BuildLink (Directive d);
+  /// \param d a "schedule" directive
+  void BuildSchedule (Directive d);
+  /// \param d a "traffic" directive
+  void BuildTraffic (Directive d);
+
+  /**
+   * \brief Build one link
+   * \param d the "link" directive
+   * \param a one end
+   * \param b the other end
+   * \param helper the helper with the link attributes
+   * \param contacts whether a contact plan drives the link
+   * \param acm whether the satellite device gets a rate controller
+   * \param errors whether the station device gets an error model
+   * \param acmArgs attributes of the rate controller
+   * \param errorArgs attributes of the error model
+   */
+  void Connect (const Directive &d, Ptr<Node> a, Ptr<Node> b,
+                OrbitPointToPointHelper &helper, bool contacts, bool acm, bool errors,
+                const std::vector<std::pair<std::string, std::string> > &acmArgs,
+                const std::vector<std::pair<std::string, std::string> > &errorArgs);
+
+  /**
+   * \brief Build the traffic of one source
+   * \param d the "traffic" directive
+   * \param fromName the source node name
+   * \param portOffset added to the port, so that the sources of one
+   *        directive reach distinct servers
+   */
+  void BuildFlow (Directive d, std::string fromName, uint16_t portOffset);
+
+  /**
+   * \brief Chain the PepApplications named by the "pep" key of a bulk traffic
+   * \param d the "traffic" directive, whose "pep" and "pep." keys are taken
+   * \param from the client node
+   * \param to the server node
+   * \param remote the server address and port
+   * \param port the port the proxies listen on
+   * \param stop when the proxies stop
+   * \return the address the client connects to: the first proxy, or remote
+   */
+  Address BuildPeps (Directive &d, Ptr<Node> from, Ptr<Node> to, Address remote,
+                     uint16_t port, Time stop);
+
+  /**
+   * \param d the "traffic" directive
+   * \param from the source node
+   * \param to the destination node
+   * \return the transmitting device of each hop from a star link to another
+   */
+  std::vector<Ptr<PointToPointNetDevice> > GetPath (const Directive &d, Ptr<Node> from,
+                                                    Ptr<Node> to) const;
+
+  /**
+   * \brief Make a link budget follow the weather record of a station, if it has one
+   * \param station the ground station of the link
+   * \param budget the link budget
+   */
+  void SetWeather (Ptr<Node> station, Ptr<LinkBudget> budget) const;
+
+  /// \return the fluid model, created with the "fluid." attributes on first use
+  Ptr<FluidFlowModel> GetFluidModel (void);
+
+  /// \param d a "probe" directive
+  void BuildProbe (Directive d);
+
+  /**
+   * \param d the directive naming the node
+   * \param name a node name
+   * \return the node
+   */
+  Ptr<Node> FindNode (const Directive &d, std::string name) const;
+
+  /**
+   * \param d the directive naming the nodes
+   * \param pattern a node name, or a name prefix followed by '*'
+   * \return the matching node names, in creation order
+   */
+  std::vector<std::string> MatchNames (const Directive &d, std::string pattern) const;
+
+  /**
+   * \param d the directive naming the nodes
+   * \param pattern a node name, or a name prefix followed by '*'
+   * \return the matching nodes, in creation order
+   */
+  std::vector<Ptr<Node> > FindNodes (const Directive &d, std::string pattern) const;
+
+  /**
+   * \param node a node with an internet stack
+   * \return the address other nodes reach it at
+   */
+  Ipv4Address GetAddress (Ptr<Node> node) const;
+
+  /**
+   * \param traffic the traffic index
+   * \param packet a received packet
+   * \param from its source
+   */
+  void RxFrom (uint32_t traffic, Ptr<const Packet> packet, const Address &from);
+
+  /**
+   * \param traffic the traffic index
+   * \param packet a received packet
+   */
+  void Rx (uint32_t traffic, Ptr<const Packet> packet);
+
+  /**
+   * \param context the trace context
+   * \param model the satellite mobility model
+   */
+  static void CourseChange (std::string context, Ptr<const MobilityModel> model);
+
+  /// \brief Print or write the per-traffic delivered bytes
+  void ReportRx (void);
+
+  /// \brief Write the per-flow FlowMonitor statistics as CSV
+  void ReportFlows (void);
+
+  /**
+   * \param kind a probe type writing files
+   * \return the bytes its files take on disk
+   */
+  uint64_t GetOutputBytes (std::string kind) const;
+
+  /**
+   * \brief Write the simulation cost as CSV
+   * \param runSeconds wall-clock time of Simulator::Run
+   * \param events the number of events executed
+   */
+  void ReportCost (double runSeconds, uint64_t events) const;
+
+  std::map<std::string, std::string> m_parameters;   //!< Parameter values
+  std::vector<Directive> m_directives;               //!< Parsed scenario
+  bool m_built;                                      //!< Whether Build () ran
+  Time m_stop;                                       //!< End of the simulation
+
+  std::map<std::string, Ptr<Node> > m_nodes;         //!< Nodes by name
+  std::vector<std::string> m_order;                  //!< Node names in creation order
+  NodeContainer m_satellites;                        //!< All satellites
+  NodeContainer m_stations;                          //!< All ground stations
+  std::map<uint32_t, double> m_masks;                //!< Elevation mask by station node id
+  Ptr<WeatherAttenuation> m_weather;                 //!< Weather record, if any
+  std::map<uint32_t, uint32_t> m_weatherStations;    //!< Weather record index by station node id
+
+  bool m_constellation;                              //!< Whether a constellation is used
+  uint32_t m_planes;                                 //!< Planes of the constellation
+  ConstellationTopologyHelper m_topology;            //!< Wires the constellation
+
+  OrbitPointToPointHelper m_tracing;                 //!< Pcap and ascii tracing
+  NetDeviceContainer m_devices;                      //!< All link devices
+  std::vector<Link> m_links;                         //!< Links of a star scenario
+  Ptr<ContactPlan> m_plan;                           //!< Contact plan of the links
+  Ptr<PassScheduler> m_scheduler;                    //!< Pass assignment of the links, if any
+  std::vector<Ptr<AdaptiveRateController> > m_controllers;  //!< Rate controllers of the links
+  uint32_t m_subnet;                                 //!< Last allocated /24
+
+  std::vector<Traffic> m_traffic;                    //!< Traffic flows
+  bool m_fluid;                                      //!< Whether bulk traffic is fluid by default
+  std::vector<std::pair<std::string, std::string> > m_fluidArgs;  //!< FluidFlowModel attributes
+  Ptr<FluidFlowModel> m_fluidModel;                  //!< Fluid bulk flows, if any
+
+  FlowMonitorHelper m_flowmon;                       //!< Flow monitor
+  std::string m_flowmonFile;                         //!< Flow monitor output, if any
+  std::string m_flowsFile;                           //!< Per-flow CSV output, if any
+  AnimationInterface *m_anim;                        //!< NetAnim output, if any
+  Ptr<LinkGeometryTrace> m_geometry;                 //!< Link geometry output, if any
+  bool m_reportRx;                                   //!< Whether rx is probed
+  std::string m_rxFile;                              //!< rx output, stdout if empty
+  std::string m_costFile;                            //!< Cost output, if any
+  std::vector<std::pair<std::string, std::string> > m_outputs;  //!< Probe type and file of each output
+  double m_buildSeconds;                             //!< Wall-clock time of Build ()
+};
+
+} // namespace ns3
+
+#endif /* SATCOM_SCENARIO_HELPER_H */
@@ -0,0 +1,393 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include "satcom-sweep-helper.h"
+#include "satcom-scenario-helper.h"
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SatcomSweepHelper");
+
+namespace {
+
+/// \return the wall-clock time in seconds
+double
+WallClock (void)
+{
+  struct timeval tv;
+  gettimeofday (&tv, 0);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+/**
+ * \param directory a directory to create if it does not exist
+ */
+void
+MakeDirectory (std::string directory)
+{
+  if (mkdir (directory.c_str (), 0755) != 0 && errno != EEXIST)
+    {
+      NS_FATAL_ERROR ("Cannot create directory " << directory);
+    }
+}
+
+} // unnamed namespace
+
+SatcomSweepHelper::SatcomSweepHelper ()
+  : m_jobs (0),
+    m_output ("satcom-sweep")
+{
+}
+
+void
+SatcomSweepHelper::SetScenario (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::ifstream is (filename.c_str ());
+  if (!is)
+    {
+      NS_FATAL_ERROR ("Cannot open scenario file " << filename);
+    }
+  std::ostringstream text;
+  text << is.rdbuf ();
+  m_scenario = filename;
+  m_text = text.str ();
+}
+
+void
+SatcomSweepHelper::AddParameter (std::string name, std::vector<std::string> values)
+{
+  NS_LOG_FUNCTION (this << name);
+  NS_ASSERT_MSG (!values.empty (), "Parameter " << name << " has no value");
+  m_parameters.push_back (std::make_pair (name, values));
+}
+
+void
+SatcomSweepHelper::AddGrid (std::string spec)
+{
+  std::istringstream is (spec);
+  std::string item;
+  while (std::getline (is, item, ';'))
+    {
+      if (item.empty ())
+        {
+          continue;
+        }
+      std::string::size_type eq = item.find ('=');
+      if (eq == std::string::npos || eq == 0)
+        {
+          NS_FATAL_ERROR ("Grid item \"" << item << "\" is not name=values");
+        }
+      std::string values = item.substr (eq + 1);
+      std::vector<std::string> list;
+      long first, last, step = 1;
+      char extra;
+      int n = std::sscanf (values.c_str (), "%ld:%ld:%ld%c", &first, &last, &step, &extra);
+      if ((n == 2 || n == 3) && step > 0 && first <= last)
+        {
+          for (long v = first; v <= last; v += step)
+            {
+              std::ostringstream value;
+              value << v;
+              list.push_back (value.str ());
+            }
+        }
+      else
+        {
+          std::istringstream vs (values);
+          std::string value;
+          while (std::getline (vs, value, ','))
+            {
+              list.push_back (value);
+            }
+        }
+      AddParameter (item.substr (0, eq), list);
+    }
+}
+
+void
+SatcomSweepHelper::SetJobs (uint32_t jobs)
+{
+  m_jobs = jobs;
+}
+
+void
+SatcomSweepHelper::SetOutputDirectory (std::string directory)
+{
+  m_output = directory;
+}
+
+uint32_t
+SatcomSweepHelper::GetNRuns (void) const
+{
+  uint32_t n = 1;
+  for (uint32_t i = 0; i < m_parameters.size (); ++i)
+    {
+      n *= m_parameters[i].second.size ();
+    }
+  return n;
+}
+
+std::vector<std::string>
+SatcomSweepHelper::GetValues (uint32_t index) const
+{
+  // The last parameter varies fastest
+  std::vector<std::string> values (m_parameters.size ());
+  for (uint32_t i = m_parameters.size (); i-- > 0; )
+    {
+      const std::vector<std::string> &v = m_parameters[i].second;
+      values[i] = v[index % v.size ()];
+      index /= v.size ();
+    }
+  return values;
+}
+
+uint32_t
+SatcomSweepHelper::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (!m_scenario.empty (), "No scenario");
+  uint32_t jobs = m_jobs;
+  if (jobs == 0)
+    {
+      long cores = sysconf (_SC_NPROCESSORS_ONLN);
+      jobs = cores > 0 ? cores : 1;
+    }
+  MakeDirectory (m_output);
+
+  uint32_t n = GetNRuns ();
+  std::vector<Job> all (n);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      std::ostringstream directory;
+      directory << m_output << "/run-" << i;
+      all[i].values = GetValues (i);
+      all[i].directory = directory.str ();
+      all[i].status = -1;
+      all[i].seconds = 0;
+      all[i].maxRss = 0;
+    }
+
+  // Flush before forking so that children do not repeat buffered output
+  std::cout.flush ();
+  std::map<pid_t, uint32_t> running;
+  std::map<pid_t, double> started;
+  uint32_t next = 0;
+  uint32_t done = 0;
+  uint32_t failed = 0;
+  double begin = WallClock ();
+  while (done < n)
+    {
+      while (next < n && running.size () < jobs)
+        {
+          MakeDirectory (all[next].directory);
+          pid_t pid = fork ();
+          if (pid < 0)
+            {
+              NS_FATAL_ERROR ("fork failed");
+            }
+          if (pid == 0)
+            {
+              RunChild (all[next]);
+            }
+          running[pid] = next;
+          started[pid] = WallClock ();
+          next++;
+        }
+      int status;
+      struct rusage usage;
+      pid_t pid = wait4 (-1, &status, 0, &usage);
+      if (pid < 0)
+        {
+          NS_FATAL_ERROR ("wait4 failed");
+        }
+      std::map<pid_t, uint32_t>::iterator it = running.find (pid);
+      if (it == running.end ())
+        {
+          continue;
+        }
+      Job &job = all[it->second];
+      job.status = status;
+      job.seconds = WallClock () - started[pid];
+      job.maxRss = usage.ru_maxrss;
+      running.erase (it);
+      started.erase (pid);
+      done++;
+      if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          failed++;
+        }
+      std::cout << "[" << done << "/" << n << "] " << job.directory << " " << GetStatus (job)
+                << " " << job.seconds << "s " << job.maxRss << "kB" << std::endl;
+    }
+  std::cout << n << " runs on " << jobs << " workers in " << WallClock () - begin << "s, "
+            << failed << " failed" << std::endl;
+  Merge (all);
+  return failed;
+}
+
+void
+SatcomSweepHelper::RunChild (const Job &job) const
+{
+  if (chdir (job.directory.c_str ()) != 0)
+    {
+      _exit (2);
+    }
+  int log = open ("log.txt", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (log >= 0)
+    {
+      dup2 (log, STDOUT_FILENO);
+      dup2 (log, STDERR_FILENO);
+      close (log);
+    }
+
+  SatcomScenarioHelper helper;
+  for (uint32_t i = 0; i < m_parameters.size (); ++i)
+    {
+      helper.SetParameter (m_parameters[i].first, job.values[i]);
+    }
+  std::istringstream scenario (m_text);
+  helper.Parse (scenario, m_scenario);
+  std::istringstream probes ("probe type=flows file=flows.csv\nprobe type=rx file=rx.txt\n"
+                              "probe type=cost file=cost.csv\n");
+  helper.Parse (probes, "sweep");
+  helper.Build ();
+  helper.Run ();
+  std::cout.flush ();
+  std::cerr.flush ();
+  _exit (0);
+}
+
+std::string
+SatcomSweepHelper::GetStatus (const Job &job)
+{
+  std::ostringstream status;
+  if (WIFEXITED (job.status))
+    {
+      if (WEXITSTATUS (job.status) == 0)
+        {
+          return "ok";
+        }
+      status << "exit " << WEXITSTATUS (job.status);
+    }
+  else if (WIFSIGNALED (job.status))
+    {
+      status << "signal " << WTERMSIG (job.status);
+    }
+  else
+    {
+      status << "unknown";
+    }
+  return status.str ();
+}
+
+void
+SatcomSweepHelper::Merge (const std::vector<Job> &jobs) const
+{
+  std::string names = "index";
+  for (uint32_t i = 0; i < m_parameters.size (); ++i)
+    {
+      names += "," + m_parameters[i].first;
+    }
+  std::ofstream runs ((m_output + "/runs.csv").c_str ());
+  std::ofstream rx ((m_output + "/rx.csv").c_str ());
+  runs << names << ",status,seconds,maxRssKb,directory" << std::endl;
+  rx << names << ",traffic,bytes,bps" << std::endl;
+
+  // Per-run CSV files are concatenated, each row prefixed by its run
+  const char *tables[] = { "flows.csv", "cost.csv" };
+  const uint32_t nTables = sizeof (tables) / sizeof (tables[0]);
+  std::vector<std::ofstream *> merged (nTables);
+  std::vector<bool> header (nTables, false);
+  for (uint32_t t = 0; t < nTables; ++t)
+    {
+      merged[t] = new std::ofstream ((m_output + "/" + tables[t]).c_str ());
+    }
+
+  for (uint32_t j = 0; j < jobs.size (); ++j)
+    {
+      const Job &job = jobs[j];
+      std::ostringstream key;
+      key << j;
+      for (uint32_t i = 0; i < job.values.size (); ++i)
+        {
+          key << "," << job.values[i];
+        }
+      runs << key.str () << "," << GetStatus (job) << "," << job.seconds << "," << job.maxRss
+           << "," << job.directory << std::endl;
+
+      std::string line;
+      for (uint32_t t = 0; t < nTables; ++t)
+        {
+          std::ifstream f ((job.directory + "/" + tables[t]).c_str ());
+          if (std::getline (f, line) && !header[t])
+            {
+              *merged[t] << names << "," << line << std::endl;
+              header[t] = true;
+            }
+          while (std::getline (f, line))
+            {
+              *merged[t] << key.str () << "," << line << std::endl;
+            }
+        }
+
+      // rx.txt lines are "<traffic name> <bytes> bytes <bps> bps"
+      std::ifstream r ((job.directory + "/rx.txt").c_str ());
+      while (std::getline (r, line))
+        {
+          std::istringstream words (line);
+          std::vector<std::string> w;
+          std::string word;
+          while (words >> word)
+            {
+              w.push_back (word);
+            }
+          if (w.size () < 5)
+            {
+              continue;
+            }
+          std::string traffic = w[0];
+          for (uint32_t i = 1; i + 4 < w.size (); ++i)
+            {
+              traffic += " " + w[i];
+            }
+          rx << key.str () << "," << traffic << "," << w[w.size () - 4] << "," << w[w.size () - 2] << std::endl;
+        }
+    }
+  for (uint32_t t = 0; t < nTables; ++t)
+    {
+      delete merged[t];
+    }
+}
+
+} // namespace ns3
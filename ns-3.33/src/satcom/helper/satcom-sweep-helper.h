@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SATCOM_SWEEP_HELPER_H
+#define SATCOM_SWEEP_HELPER_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Run a satcom scenario over a grid of parameter values, one
+ * process per run, on all local cores.
+ *
+ * Every point of the Cartesian product of the parameter values is a
+ * run of the scenario file by SatcomScenarioHelper, with the point's
+ * values overriding the scenario parameters ("run" typically feeds
+ * "simulation run=$run"). Each run is a child process forked from the
+ * caller, so no program is rebuilt per variant and runs share no
+ * simulator state. Runs sit in one queue that idle workers take the
+ * next run from, so a slow run never holds up the others.
+ *
+ * A run executes in its own directory under the output directory,
+ * where the scenario's relative probe outputs and its console output
+ * (log.txt) land. The runner adds "flows", "rx" and "cost" probes to
+ * every run and merges them, keyed by run index and parameter values,
+ * into flows.csv, rx.csv and cost.csv; runs.csv indexes the runs with
+ * their exit status, wall-clock time and peak resident memory.
+ */
+class SatcomSweepHelper
+{
+public:
+  SatcomSweepHelper ();
+
+  /**
+   * \param filename the scenario file
+   */
+  void SetScenario (std::string filename);
+
+  /**
+   * \param name a scenario parameter
+   * \param values the values it takes
+   */
+  void AddParameter (std::string name, std::vector<std::string> values);
+
+  /**
+   * \brief Add parameters from a grid specification
+   * \param spec semicolon-separated name=values, where values are
+   *        comma-separated, or an integer range first:last[:step],
+   *        such as "rate=10Mbps,50Mbps;run=1:10"
+   */
+  void AddGrid (std::string spec);
+
+  /**
+   * \param jobs the number of concurrent runs, 0 for one per core
+   */
+  void SetJobs (uint32_t jobs);
+
+  /**
+   * \param directory where the run directories and merged results go
+   */
+  void SetOutputDirectory (std::string directory);
+
+  /// \return the number of runs in the grid
+  uint32_t GetNRuns (void) const;
+
+  /**
+   * \brief Execute every run and merge the results
+   * \return the number of runs that failed
+   */
+  uint32_t Run (void);
+
+private:
+  /// One point of the grid
+  struct Job
+  {
+    std::vector<std::string> values;   //!< Parameter values
+    std::string directory;             //!< Run directory
+    int status;                        //!< wait4 status
+    double seconds;                    //!< Wall-clock time
+    long maxRss;                       //!< Peak resident set size in kB
+  };
+
+  /**
+   * \param index a run index
+   * \return the parameter values of the run
+   */
+  std::vector<std::string> GetValues (uint32_t index) const;
+
+  /**
+   * \brief Execute a run in the current (child) process and exit
+   * \param job the run
+   */
+  void RunChild (const Job &job) const;
+
+  /**
+   * \param job a finished run
+   * \return its exit status as text
+   */
+  static std::string GetStatus (const Job &job);
+
+  /**
+   * \brief Write runs.csv, flows.csv, cost.csv and rx.csv
+   * \param jobs all runs
+   */
+  void Merge (const std::vector<Job> &jobs) const;
+
+  std::string m_scenario;    //!< Scenario file name
+  std::string m_text;        //!< Scenario file contents
+  std::vector<std::pair<std::string, std::vector<std::string> > > m_parameters;  //!< Grid
+  uint32_t m_jobs;           //!< Concurrent runs
+  std::string m_output;      //!< Output directory
+};
+
+} // namespace ns3
+
+#endif /* SATCOM_SWEEP_HELPER_H */
@@ -0,0 +1,227 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "adaptive-rate-controller.h"
+#include "orbit-point-to-point-channel.h"
+#include "ns3/contact-plan.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/pointer.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("AdaptiveRateController");
+
+NS_OBJECT_ENSURE_REGISTERED (AdaptiveRateController);
+
+TypeId
+AdaptiveRateController::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::AdaptiveRateController")
+    .SetParent<Object> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<AdaptiveRateController> ()
+    .AddAttribute ("LinkBudget", "The link budget, a default one is created if unset.",
+                   PointerValue (),
+                   MakePointerAccessor (&AdaptiveRateController::m_budget),
+                   MakePointerChecker<LinkBudget> ())
+    .AddAttribute ("SymbolRate", "Symbol rate of the carrier in Bd.",
+                   DoubleValue (150e6),
+                   MakeDoubleAccessor (&AdaptiveRateController::m_symbolRate),
+                   MakeDoubleChecker<double> (1))
+    .AddAttribute ("Margin", "Es/N0 margin a scheme needs above its threshold, in dB.",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&AdaptiveRateController::m_margin),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("UpdateInterval", "Period at which the geometry is sampled.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&AdaptiveRateController::m_interval),
+                   MakeTimeChecker (NanoSeconds (1)))
+    .AddTraceSource ("RateChange", "The scheme, and so the data rate, changed.",
+                     MakeTraceSourceAccessor (&AdaptiveRateController::m_rateTrace),
+                     "ns3::AdaptiveRateController::RateChangeCallback")
+  ;
+  return tid;
+}
+
+AdaptiveRateController::AdaptiveRateController ()
+  : m_table (ModcodTable::GetDvbS2 ()),
+    m_evaluated (false),
+    m_linkUp (true),
+    m_modcod (-2),
+    m_esN0 (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+AdaptiveRateController::~AdaptiveRateController ()
+{
+}
+
+void
+AdaptiveRateController::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_event);
+  m_budget = 0;
+  m_device = 0;
+  m_channel = 0;
+  m_mobility[0] = 0;
+  m_mobility[1] = 0;
+  Object::DoDispose ();
+}
+
+void
+AdaptiveRateController::Install (Ptr<PointToPointNetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  Ptr<PointToPointChannel> channel = DynamicCast<PointToPointChannel> (device->GetChannel ());
+  NS_ASSERT_MSG (channel != 0 && channel->GetNDevices () == 2, "Device is not attached");
+  Ptr<NetDevice> peer = channel->GetDevice (0) == device ? channel->GetDevice (1) : channel->GetDevice (0);
+  m_device = device;
+  m_mobility[0] = device->GetNode ()->GetObject<MobilityModel> ();
+  m_mobility[1] = peer->GetNode ()->GetObject<MobilityModel> ();
+  NS_ASSERT_MSG (m_mobility[0] != 0 && m_mobility[1] != 0, "Both nodes need a MobilityModel");
+  if (m_budget == 0)
+    {
+      m_budget = CreateObject<LinkBudget> ();
+    }
+
+  m_channel = DynamicCast<OrbitPointToPointChannel> (channel);
+  if (m_channel != 0)
+    {
+      m_linkUp = m_channel->IsLinkUp ();
+      m_channel->TraceConnectWithoutContext (
+        "LinkState", MakeCallback (&AdaptiveRateController::LinkStateChanged, this));
+    }
+  Simulator::Cancel (m_event);
+  m_event = Simulator::ScheduleNow (&AdaptiveRateController::Update, this);
+}
+
+void
+AdaptiveRateController::SetModcodTable (const ModcodTable &table)
+{
+  NS_ASSERT (table.GetN () > 0);
+  m_table = table;
+  m_evaluated = false;
+  m_modcod = -2;
+}
+
+const ModcodTable &
+AdaptiveRateController::GetModcodTable (void) const
+{
+  return m_table;
+}
+
+Ptr<LinkBudget>
+AdaptiveRateController::GetLinkBudget (void) const
+{
+  return m_budget;
+}
+
+double
+AdaptiveRateController::GetSymbolRate (void) const
+{
+  return m_symbolRate;
+}
+
+int32_t
+AdaptiveRateController::GetModcod (void) const
+{
+  return m_modcod;
+}
+
+double
+AdaptiveRateController::GetEsN0 (void) const
+{
+  return m_esN0;
+}
+
+void
+AdaptiveRateController::LinkStateChanged (bool up)
+{
+  NS_LOG_FUNCTION (this << up);
+  m_linkUp = up;
+  Simulator::Cancel (m_event);
+  if (up)
+    {
+      m_event = Simulator::ScheduleNow (&AdaptiveRateController::Update, this);
+    }
+}
+
+void
+AdaptiveRateController::Update (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_linkUp || m_device == 0)
+    {
+      return;
+    }
+  m_event = Simulator::Schedule (m_interval, &AdaptiveRateController::Update, this);
+
+  Vector a = m_mobility[0]->GetPosition ();
+  Vector b = m_mobility[1]->GetPosition ();
+  if (m_evaluated && a == m_lastPosition[0] && b == m_lastPosition[1] && !m_budget->HasWeather ())
+    {
+      return;
+    }
+  m_evaluated = true;
+  m_lastPosition[0] = a;
+  m_lastPosition[1] = b;
+
+  // The elevation is seen from the ground end of the link
+  bool aIsGround = a.GetLength () < b.GetLength ();
+  double elevation = aIsGround ? ContactPlan::GetElevation (a, b)
+                               : ContactPlan::GetElevation (b, a);
+  double range = CalculateDistance (a, b);
+  m_esN0 = m_budget->GetEsN0 (range, elevation, m_symbolRate);
+
+  int32_t modcod = m_table.Select (m_esN0 - m_margin);
+  if (modcod == m_modcod)
+    {
+      return;
+    }
+  m_modcod = modcod;
+  if (m_channel != 0)
+    {
+      m_channel->SetOutage (m_device, modcod < 0);
+    }
+  if (modcod < 0)
+    {
+      NS_LOG_LOGIC ("range " << range << " m, elevation " << elevation << " deg, Es/N0 "
+                    << m_esN0 << " dB: outage");
+      if (m_channel == 0)
+        {
+          double efficiency = m_table.Get (0).efficiency;
+          m_device->SetDataRate (DataRate (static_cast<uint64_t> (m_symbolRate * efficiency)));
+        }
+      m_rateTrace (DataRate (0), m_esN0, modcod);
+      return;
+    }
+  const ModcodTable::Modcod &m = m_table.Get (modcod);
+  DataRate rate (static_cast<uint64_t> (m_symbolRate * m.efficiency));
+  NS_LOG_LOGIC ("range " << range << " m, elevation " << elevation << " deg, Es/N0 "
+                << m_esN0 << " dB: " << m.name << " " << rate);
+  m_device->SetDataRate (rate);
+  m_rateTrace (rate, m_esN0, modcod);
+}
+
+} // namespace ns3
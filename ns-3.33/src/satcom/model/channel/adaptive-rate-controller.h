@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ADAPTIVE_RATE_CONTROLLER_H
+#define ADAPTIVE_RATE_CONTROLLER_H
+
+#include "ns3/object.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+#include "ns3/vector.h"
+#include "ns3/link-budget.h"
+
+namespace ns3 {
+
+class PointToPointNetDevice;
+class OrbitPointToPointChannel;
+class MobilityModel;
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Adaptive coding and modulation for one direction of a
+ * satellite-to-ground point-to-point link.
+ *
+ * Every UpdateInterval, and whenever the link comes up, the controller
+ * takes the slant range and the elevation seen from the endpoint
+ * closer to the Earth centre, evaluates the LinkBudget and picks the
+ * most efficient scheme of its ModcodTable that closes with Margin.
+ * The data rate of the transmitting device becomes SymbolRate times
+ * the scheme efficiency. Nothing is evaluated per packet, nor while
+ * the link is down or, unless the budget follows a weather record,
+ * neither endpoint has moved.
+ *
+ * Below the threshold of the most robust scheme the link is in
+ * outage and reports a rate of zero and a scheme index of -1. Over an
+ * OrbitPointToPointChannel the direction of the device is then put in
+ * outage, which refuses its transmissions like a link down; over a
+ * plain channel the device keeps the most robust scheme's rate.
+ */
+class AdaptiveRateController : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  AdaptiveRateController ();
+  virtual ~AdaptiveRateController ();
+
+  /**
+   * TracedCallback signature for rate changes.
+   * \param rate the new data rate, zero in outage
+   * \param esN0 the Es/N0 it was chosen for, in dB
+   * \param modcod the scheme index, or -1 in outage
+   */
+  typedef void (* RateChangeCallback) (DataRate rate, double esN0, int32_t modcod);
+
+  /**
+   * \brief Drive the data rate of a device
+   * \param device the transmitting device; both nodes of its channel
+   *        need a MobilityModel
+   */
+  void Install (Ptr<PointToPointNetDevice> device);
+
+  /**
+   * \param table the schemes to choose from, DVB-S2 by default
+   */
+  void SetModcodTable (const ModcodTable &table);
+
+  /// \return the scheme table
+  const ModcodTable &GetModcodTable (void) const;
+
+  /// \return the link budget, created by Install () if unset
+  Ptr<LinkBudget> GetLinkBudget (void) const;
+
+  /// \return the symbol rate in Bd
+  double GetSymbolRate (void) const;
+
+  /// \return the current scheme index, or -1 in outage
+  int32_t GetModcod (void) const;
+
+  /// \return the Es/N0 of the last evaluation in dB
+  double GetEsN0 (void) const;
+
+  /// \brief Re-evaluate the link budget now
+  void Update (void);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \param up the new link state
+   */
+  void LinkStateChanged (bool up);
+
+  Ptr<LinkBudget> m_budget;           //!< Link budget
+  ModcodTable m_table;                //!< Schemes to choose from
+  double m_symbolRate;                //!< Symbol rate in Bd
+  double m_margin;                    //!< Required margin in dB
+  Time m_interval;                    //!< Geometry sampling period
+  Ptr<PointToPointNetDevice> m_device;   //!< Controlled device
+  Ptr<OrbitPointToPointChannel> m_channel;  //!< Channel of the device, if an orbit one
+  Ptr<MobilityModel> m_mobility[2];   //!< Mobility of the local and remote node
+  Vector m_lastPosition[2];           //!< Positions of the last evaluation
+  bool m_evaluated;                   //!< Whether m_lastPosition is valid
+  bool m_linkUp;                      //!< Last known link state
+  int32_t m_modcod;                   //!< Current scheme index
+  double m_esN0;                      //!< Last Es/N0 in dB
+  EventId m_event;                    //!< Next periodic evaluation
+
+  /// Trace fired when the scheme changes
+  TracedCallback<DataRate, double, int32_t> m_rateTrace;
+};
+
+} // namespace ns3
+
+#endif /* ADAPTIVE_RATE_CONTROLLER_H */
@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "device-queue-feeder.h"
+#include "orbit-point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/queue.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DeviceQueueFeeder");
+
+NS_OBJECT_ENSURE_REGISTERED (DeviceQueueFeeder);
+
+TypeId
+DeviceQueueFeeder::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::DeviceQueueFeeder")
+    .SetParent<Object> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<DeviceQueueFeeder> ()
+  ;
+  return tid;
+}
+
+DeviceQueueFeeder::DeviceQueueFeeder ()
+  : m_target (1),
+    m_up (true),
+    m_transmitting (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+DeviceQueueFeeder::~DeviceQueueFeeder ()
+{
+}
+
+void
+DeviceQueueFeeder::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_device = 0;
+  m_queued = 0;
+  m_channel = 0;
+  m_fill = MakeNullCallback<bool> ();
+  m_linkCallback = MakeNullCallback<void, bool> ();
+  Object::DoDispose ();
+}
+
+void
+DeviceQueueFeeder::Setup (Ptr<NetDevice> device, uint32_t target, Callback<bool> fill)
+{
+  NS_LOG_FUNCTION (this << device << target);
+  NS_ASSERT (device != 0 && target > 0);
+  m_device = device;
+  m_target = target;
+  m_fill = fill;
+  m_queued = DynamicCast<PointToPointNetDevice> (device);
+  m_channel = DynamicCast<OrbitPointToPointChannel> (device->GetChannel ());
+  if (m_channel != 0)
+    {
+      m_up = m_channel->IsLinkUp (device);
+      m_channel->TraceConnectWithoutContext (
+        "LinkState", MakeCallback (&DeviceQueueFeeder::LinkStateChanged, this));
+      m_channel->TraceConnectWithoutContext (
+        "Outage", MakeCallback (&DeviceQueueFeeder::OutageChanged, this));
+    }
+  device->TraceConnectWithoutContext (
+    "PhyTxBegin", MakeCallback (&DeviceQueueFeeder::TxBegin, this));
+  device->TraceConnectWithoutContext (
+    "PhyTxEnd", MakeCallback (&DeviceQueueFeeder::TxEnd, this));
+}
+
+void
+DeviceQueueFeeder::SetLinkCallback (Callback<void, bool> callback)
+{
+  m_linkCallback = callback;
+}
+
+Ptr<NetDevice>
+DeviceQueueFeeder::GetDevice (void) const
+{
+  return m_device;
+}
+
+bool
+DeviceQueueFeeder::IsUp (void) const
+{
+  return m_up;
+}
+
+void
+DeviceQueueFeeder::Feed (void)
+{
+  if (!m_up || m_fill.IsNull ())
+    {
+      return;
+    }
+  if (m_queued == 0)
+    {
+      // Without a queue to watch, hand over one packet per transmission
+      m_fill ();
+      return;
+    }
+  while (m_queued->GetQueue ()->GetNPackets () + m_transmitting < m_target)
+    {
+      if (!m_fill ())
+        {
+          return;
+        }
+    }
+}
+
+void
+DeviceQueueFeeder::LinkStateChanged (bool up)
+{
+  NS_LOG_FUNCTION (this << up);
+  UpdateLink ();
+}
+
+void
+DeviceQueueFeeder::OutageChanged (Ptr<const NetDevice> src, bool outage)
+{
+  if (src == m_device)
+    {
+      NS_LOG_FUNCTION (this << outage);
+      UpdateLink ();
+    }
+}
+
+void
+DeviceQueueFeeder::UpdateLink (void)
+{
+  bool up = m_channel->IsLinkUp (m_device);
+  if (up == m_up)
+    {
+      return;
+    }
+  m_up = up;
+  if (!m_linkCallback.IsNull ())
+    {
+      m_linkCallback (up);
+    }
+  Feed ();
+}
+
+void
+DeviceQueueFeeder::TxBegin (Ptr<const Packet> packet)
+{
+  m_transmitting = true;
+}
+
+void
+DeviceQueueFeeder::TxEnd (Ptr<const Packet> packet)
+{
+  m_transmitting = false;
+  // The device is inside its transmit completion, refill once it returned
+  Simulator::ScheduleNow (&DeviceQueueFeeder::Feed, this);
+}
+
+} // namespace ns3
@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DEVICE_QUEUE_FEEDER_H
+#define DEVICE_QUEUE_FEEDER_H
+
+#include "ns3/object.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+class NetDevice;
+class Packet;
+class PointToPointNetDevice;
+class OrbitPointToPointChannel;
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Keeps the device of a link busy on behalf of an application.
+ *
+ * Applications that send as fast as a link allows (SarPayloadApplication,
+ * FileDeliverySender, BundleAgent) hand their packets to a socket only
+ * when the device can take them, so that nothing piles up in the IP
+ * stack and the application decides what goes next. The feeder calls
+ * the fill callback, which sends one packet, until the device holds
+ * Target packets, queued or in transmission, and again at the end of
+ * every transmission. A device that is not a PointToPointNetDevice has
+ * no queue to watch and gets one packet per call to Feed ().
+ *
+ * Over an OrbitPointToPointChannel the feeder follows its LinkState and
+ * Outage traces: the link counts as down while it is down or while the
+ * direction of the device is in outage, nothing is fed then, and the
+ * link callback is told of every change. Other links are always up.
+ */
+class DeviceQueueFeeder : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  DeviceQueueFeeder ();
+  virtual ~DeviceQueueFeeder ();
+
+  /**
+   * \brief Attach to a device and follow its link
+   * \param device the local device of the link
+   * \param target the packets to keep in the device, queued or in transmission
+   * \param fill sends one packet and returns true, or returns false if
+   *        there is nothing to send
+   */
+  void Setup (Ptr<NetDevice> device, uint32_t target, Callback<bool> fill);
+
+  /**
+   * \param callback called with the new state when the link goes up or
+   *        down, before the feeder fills a link that came up
+   */
+  void SetLinkCallback (Callback<void, bool> callback);
+
+  /// \return the device of the link
+  Ptr<NetDevice> GetDevice (void) const;
+
+  /// \return whether the link is up and not in outage
+  bool IsUp (void) const;
+
+  /// \brief Fill the device up to the target, unless the link is down
+  void Feed (void);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// LinkState trace sink
+  void LinkStateChanged (bool up);
+  /// Outage trace sink
+  void OutageChanged (Ptr<const NetDevice> src, bool outage);
+  /// Read the link state and report a change
+  void UpdateLink (void);
+  /// PhyTxBegin trace sink
+  void TxBegin (Ptr<const Packet> packet);
+  /// PhyTxEnd trace sink
+  void TxEnd (Ptr<const Packet> packet);
+
+  Ptr<NetDevice> m_device;                   //!< Device of the link
+  Ptr<PointToPointNetDevice> m_queued;       //!< The device if its queue can be watched
+  Ptr<OrbitPointToPointChannel> m_channel;   //!< Channel of the link, if it has a state
+  uint32_t m_target;                         //!< Packets to keep in the device
+  bool m_up;                                 //!< Whether the link is up
+  bool m_transmitting;                       //!< Whether the device is transmitting
+  Callback<bool> m_fill;                     //!< Sends one packet
+  Callback<void, bool> m_linkCallback;       //!< Told of link changes
+};
+
+} // namespace ns3
+
+#endif /* DEVICE_QUEUE_FEEDER_H */
@@ -0,0 +1,388 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "fluid-flow-model.h"
+#include "orbit-point-to-point-channel.h"
+#include "adaptive-rate-controller.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FluidFlowModel");
+
+NS_OBJECT_ENSURE_REGISTERED (FluidFlowModel);
+
+TypeId
+FluidFlowModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FluidFlowModel")
+    .SetParent<Object> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<FluidFlowModel> ()
+    .AddAttribute ("UpdateInterval", "Period at which rates and round-trip times are updated.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&FluidFlowModel::m_interval),
+                   MakeTimeChecker (NanoSeconds (1)))
+    .AddAttribute ("Window", "Largest TCP window in bytes, by default the "
+                   "ns3::TcpSocket buffer size.",
+                   UintegerValue (131072),
+                   MakeUintegerAccessor (&FluidFlowModel::m_maxWindow),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("InitialWindow", "TCP window in bytes after a start or an outage.",
+                   UintegerValue (10 * 536),
+                   MakeUintegerAccessor (&FluidFlowModel::m_initialWindow),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("PacketShare", "Fraction of each link capacity kept for packet-level traffic.",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&FluidFlowModel::m_packetShare),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("PayloadFraction", "Fraction of the link rate delivered as payload, "
+                   "by default 536-byte segments in TCP, IPv4 and PPP headers.",
+                   DoubleValue (536.0 / 590.0),
+                   MakeDoubleAccessor (&FluidFlowModel::m_payloadFraction),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddTraceSource ("Rate", "The delivered rate of a flow changed.",
+                     MakeTraceSourceAccessor (&FluidFlowModel::m_rateTrace),
+                     "ns3::FluidFlowModel::RateCallback")
+  ;
+  return tid;
+}
+
+FluidFlowModel::FluidFlowModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FluidFlowModel::~FluidFlowModel ()
+{
+}
+
+void
+FluidFlowModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_event);
+  m_links.clear ();
+  Object::DoDispose ();
+}
+
+uint32_t
+FluidFlowModel::GetLink (Ptr<PointToPointNetDevice> device)
+{
+  for (uint32_t i = 0; i < m_links.size (); ++i)
+    {
+      if (m_links[i].device == device)
+        {
+          return i;
+        }
+    }
+  NS_ASSERT_MSG (device->GetChannel () != 0, "Device is not attached");
+  Link link;
+  link.device = device;
+  link.channel = DynamicCast<OrbitPointToPointChannel> (device->GetChannel ());
+  DataRateValue rate;
+  device->GetAttribute ("DataRate", rate);
+  link.capacity = rate.Get ().GetBitRate ();
+  link.up = link.channel == 0 || link.channel->IsLinkUp (device);
+  uint32_t index = m_links.size ();
+  m_links.push_back (link);
+  if (link.channel != 0)
+    {
+      link.channel->TraceConnectWithoutContext (
+        "LinkState", MakeCallback (&FluidFlowModel::LinkStateChanged, this).Bind (index));
+      link.channel->TraceConnectWithoutContext (
+        "Outage", MakeCallback (&FluidFlowModel::OutageChanged, this).Bind (index));
+    }
+  return index;
+}
+
+uint32_t
+FluidFlowModel::AddFlow (std::vector<Ptr<PointToPointNetDevice> > path, Time start, Time stop,
+                         uint64_t maxBytes)
+{
+  NS_LOG_FUNCTION (this << start << stop << maxBytes);
+  NS_ASSERT_MSG (!path.empty (), "A flow needs a path");
+  Flow flow;
+  for (uint32_t i = 0; i < path.size (); ++i)
+    {
+      flow.links.push_back (GetLink (path[i]));
+    }
+  flow.start = start;
+  flow.stop = stop;
+  flow.maxBytes = maxBytes;
+  flow.rxBytes = 0;
+  flow.window = m_initialWindow;
+  flow.share = 0;
+  flow.rtt = 0;
+  flow.up = false;
+  m_flows.push_back (flow);
+
+  // Rates only change at the ends of a flow between periodic updates
+  Time now = Simulator::Now ();
+  Simulator::Schedule (std::max (start - now, Time (0)), &FluidFlowModel::Update, this);
+  Simulator::Schedule (std::max (stop - now, Time (0)), &FluidFlowModel::Update, this);
+  return m_flows.size () - 1;
+}
+
+void
+FluidFlowModel::SetRateController (Ptr<PointToPointNetDevice> device,
+                                   Ptr<AdaptiveRateController> controller)
+{
+  NS_LOG_FUNCTION (this << device << controller);
+  controller->TraceConnectWithoutContext (
+    "RateChange", MakeCallback (&FluidFlowModel::RateChanged, this).Bind (GetLink (device)));
+}
+
+uint32_t
+FluidFlowModel::GetNFlows (void) const
+{
+  return m_flows.size ();
+}
+
+uint64_t
+FluidFlowModel::GetRxBytes (uint32_t flow) const
+{
+  NS_ASSERT (flow < m_flows.size ());
+  return static_cast<uint64_t> (m_flows[flow].rxBytes);
+}
+
+double
+FluidFlowModel::GetRate (uint32_t flow) const
+{
+  NS_ASSERT (flow < m_flows.size ());
+  return 8 * GetPayloadRate (m_flows[flow]);
+}
+
+DataRate
+FluidFlowModel::GetCapacity (Ptr<PointToPointNetDevice> device) const
+{
+  for (uint32_t i = 0; i < m_links.size (); ++i)
+    {
+      if (m_links[i].device == device)
+        {
+          return DataRate (static_cast<uint64_t> (m_links[i].capacity));
+        }
+    }
+  NS_FATAL_ERROR ("Device carries no fluid flow");
+  return DataRate ();
+}
+
+bool
+FluidFlowModel::IsActive (const Flow &flow) const
+{
+  Time now = Simulator::Now ();
+  return now >= flow.start && now < flow.stop
+         && (flow.maxBytes == 0 || flow.rxBytes < flow.maxBytes);
+}
+
+double
+FluidFlowModel::GetPayloadRate (const Flow &flow) const
+{
+  if (flow.share <= 0)
+    {
+      return 0;
+    }
+  if (flow.rtt <= 0)
+    {
+      return flow.share;
+    }
+  double window = std::min (flow.window, std::min (flow.share * flow.rtt, double (m_maxWindow)));
+  return window / flow.rtt;
+}
+
+void
+FluidFlowModel::LinkStateChanged (uint32_t link, bool up)
+{
+  NS_LOG_FUNCTION (this << link << up);
+  Advance ();
+  m_links[link].up = m_links[link].channel->IsLinkUp (m_links[link].device);
+  Update ();
+}
+
+void
+FluidFlowModel::OutageChanged (uint32_t link, Ptr<const NetDevice> src, bool outage)
+{
+  NS_LOG_FUNCTION (this << link << src << outage);
+  if (src != m_links[link].device)
+    {
+      return;
+    }
+  Advance ();
+  m_links[link].up = m_links[link].channel->IsLinkUp (m_links[link].device);
+  Update ();
+}
+
+void
+FluidFlowModel::RateChanged (uint32_t link, DataRate rate, double esN0, int32_t modcod)
+{
+  NS_LOG_FUNCTION (this << link << rate);
+  Advance ();
+  m_links[link].capacity = rate.GetBitRate ();
+  Update ();
+}
+
+void
+FluidFlowModel::Update (void)
+{
+  NS_LOG_FUNCTION (this);
+  Advance ();
+  Allocate ();
+  Simulator::Cancel (m_event);
+  for (std::vector<Flow>::const_iterator it = m_flows.begin (); it != m_flows.end (); ++it)
+    {
+      if (IsActive (*it))
+        {
+          m_event = Simulator::Schedule (m_interval, &FluidFlowModel::Update, this);
+          return;
+        }
+    }
+}
+
+void
+FluidFlowModel::Advance (void)
+{
+  Time now = Simulator::Now ();
+  double dt = (now - m_last).GetSeconds ();
+  m_last = now;
+  if (dt <= 0)
+    {
+      return;
+    }
+  for (std::vector<Flow>::iterator it = m_flows.begin (); it != m_flows.end (); ++it)
+    {
+      Flow &f = *it;
+      if (f.share <= 0)
+        {
+          continue;
+        }
+      double bytes;
+      if (f.rtt <= 0)
+        {
+          bytes = f.share * dt;
+        }
+      else
+        {
+          // Slow start doubles the window every round trip up to its limit
+          double limit = std::min (f.share * f.rtt, double (m_maxWindow));
+          double rampTime = f.window < limit ? f.rtt * std::log2 (limit / f.window) : 0;
+          if (rampTime >= dt)
+            {
+              double growth = std::pow (2.0, dt / f.rtt);
+              bytes = f.window * (growth - 1) / std::log (2.0);
+              f.window *= growth;
+            }
+          else
+            {
+              bytes = (f.window < limit ? (limit - f.window) / std::log (2.0) : 0)
+                + limit / f.rtt * (dt - rampTime);
+              f.window = limit;
+            }
+        }
+      f.rxBytes += bytes;
+      if (f.maxBytes > 0 && f.rxBytes > f.maxBytes)
+        {
+          f.rxBytes = f.maxBytes;
+        }
+    }
+}
+
+void
+FluidFlowModel::Allocate (void)
+{
+  std::vector<uint32_t> users (m_links.size (), 0);
+  for (std::vector<Flow>::iterator it = m_flows.begin (); it != m_flows.end (); ++it)
+    {
+      it->up = true;
+      for (uint32_t i = 0; i < it->links.size (); ++i)
+        {
+          it->up = it->up && m_links[it->links[i]].up;
+        }
+      if (it->up && IsActive (*it))
+        {
+          for (uint32_t i = 0; i < it->links.size (); ++i)
+            {
+              users[it->links[i]]++;
+            }
+        }
+    }
+
+  std::vector<double> used (m_links.size (), 0);
+  for (uint32_t j = 0; j < m_flows.size (); ++j)
+    {
+      Flow &f = m_flows[j];
+      double before = GetPayloadRate (f);
+      f.share = 0;
+      f.rtt = 0;
+      if (!f.up)
+        {
+          // An outage times the connection out
+          f.window = m_initialWindow;
+        }
+      else if (IsActive (f))
+        {
+          f.share = -1;
+          for (uint32_t i = 0; i < f.links.size (); ++i)
+            {
+              const Link &link = m_links[f.links[i]];
+              double share = link.capacity * (1 - m_packetShare) * m_payloadFraction / 8
+                / users[f.links[i]];
+              f.share = f.share < 0 ? share : std::min (f.share, share);
+              Time delay;
+              if (link.channel != 0)
+                {
+                  delay = link.channel->GetPropagationDelay ();
+                }
+              else
+                {
+                  TimeValue value;
+                  link.device->GetChannel ()->GetAttribute ("Delay", value);
+                  delay = value.Get ();
+                }
+              f.rtt += 2 * delay.GetSeconds ();
+            }
+        }
+      double after = GetPayloadRate (f);
+      for (uint32_t i = 0; i < f.links.size (); ++i)
+        {
+          used[f.links[i]] += 8 * after / m_payloadFraction;
+        }
+      if (after != before)
+        {
+          NS_LOG_LOGIC ("flow " << j << " at " << 8 * after << " bps, rtt " << f.rtt << " s");
+          m_rateTrace (j, 8 * after);
+        }
+    }
+
+  // Packet-level traffic gets what the fluid flows leave
+  for (uint32_t i = 0; i < m_links.size (); ++i)
+    {
+      double rest = std::max (m_links[i].capacity - used[i], m_links[i].capacity * m_packetShare);
+      if (rest > 0)
+        {
+          // A link without capacity is in outage and refuses packets anyway
+          m_links[i].device->SetDataRate (DataRate (static_cast<uint64_t> (rest)));
+        }
+    }
+}
+
+} // namespace ns3
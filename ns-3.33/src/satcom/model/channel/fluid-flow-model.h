@@ -0,0 +1,209 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLUID_FLOW_MODEL_H
+#define FLUID_FLOW_MODEL_H
+
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+class NetDevice;
+class PointToPointNetDevice;
+class OrbitPointToPointChannel;
+class AdaptiveRateController;
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Fluid model of long-lived bulk TCP transfers over satellite
+ * point-to-point links.
+ *
+ * A flow is a rate along a path of transmitting devices rather than a
+ * stream of packets, so a pass of many gigabytes costs a few events
+ * per UpdateInterval instead of one per packet and hop. Every
+ * UpdateInterval, and whenever a link of a flow changes state or
+ * rate, each link's capacity less PacketShare is split equally among
+ * the flows crossing it; a flow gets the smallest of its shares,
+ * limited by Window over the round-trip time of its path. Between
+ * updates the window of a flow grows as TCP slow start from
+ * InitialWindow, which it restarts from whenever a link of its path
+ * goes down. Windows count payload, of which a link carries
+ * PayloadFraction of its rate.
+ *
+ * Packet-level traffic keeps the devices: the data rate of each device
+ * is set to what the fluid flows leave, so that echo probes or HTTP on
+ * the same link see the remaining capacity. The link capacity is the
+ * device's data rate when the link is added, or follows an
+ * AdaptiveRateController given by SetRateController (). A link in
+ * outage has no capacity and counts as down.
+ */
+class FluidFlowModel : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  FluidFlowModel ();
+  virtual ~FluidFlowModel ();
+
+  /**
+   * TracedCallback signature for flow rate changes.
+   * \param flow the flow index
+   * \param rate the new delivered rate in bit/s
+   */
+  typedef void (* RateCallback) (uint32_t flow, double rate);
+
+  /**
+   * \brief Add a bulk transfer
+   * \param path the transmitting device of each hop, attached to a
+   *        point-to-point channel
+   * \param start when the transfer starts
+   * \param stop when the transfer stops
+   * \param maxBytes the bytes to deliver, 0 for no limit
+   * \return the flow index
+   */
+  uint32_t AddFlow (std::vector<Ptr<PointToPointNetDevice> > path, Time start, Time stop,
+                    uint64_t maxBytes);
+
+  /**
+   * \brief Take the capacity of a link from a rate controller
+   * \param device the transmitting device the controller drives
+   * \param controller the controller
+   */
+  void SetRateController (Ptr<PointToPointNetDevice> device, Ptr<AdaptiveRateController> controller);
+
+  /// \return the number of flows
+  uint32_t GetNFlows (void) const;
+
+  /**
+   * \param flow a flow index
+   * \return the bytes it delivered up to now
+   */
+  uint64_t GetRxBytes (uint32_t flow) const;
+
+  /**
+   * \param flow a flow index
+   * \return its delivered rate in bit/s
+   */
+  double GetRate (uint32_t flow) const;
+
+  /**
+   * \param device a transmitting device of a flow
+   * \return the capacity of its link
+   */
+  DataRate GetCapacity (Ptr<PointToPointNetDevice> device) const;
+
+  /// \brief Bring the flows up to now and share the capacity again
+  void Update (void);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// One direction of a point-to-point link
+  struct Link
+  {
+    Ptr<PointToPointNetDevice> device;         //!< Transmitting device
+    Ptr<OrbitPointToPointChannel> channel;     //!< Its channel, if orbit-aware
+    double capacity;                           //!< Data rate in bit/s
+    bool up;                                   //!< Link state, down in outage
+  };
+
+  /// A bulk transfer
+  struct Flow
+  {
+    std::vector<uint32_t> links;   //!< Link of each hop
+    Time start;                    //!< Start time
+    Time stop;                     //!< Stop time
+    uint64_t maxBytes;             //!< Bytes to deliver, 0 for no limit
+    double rxBytes;                //!< Bytes delivered
+    double window;                 //!< Congestion window in payload bytes
+    double share;                  //!< Fair share in payload bytes/s
+    double rtt;                    //!< Round-trip time in s
+    bool up;                       //!< Whether every link is up
+  };
+
+  /**
+   * \param device a transmitting device
+   * \return its link index, added if new
+   */
+  uint32_t GetLink (Ptr<PointToPointNetDevice> device);
+
+  /**
+   * \param flow a flow
+   * \return whether it transfers now
+   */
+  bool IsActive (const Flow &flow) const;
+
+  /**
+   * \param flow a flow
+   * \return its payload rate in bytes/s
+   */
+  double GetPayloadRate (const Flow &flow) const;
+
+  /**
+   * \param link a link index
+   * \param up the new link state
+   */
+  void LinkStateChanged (uint32_t link, bool up);
+
+  /**
+   * \param link a link index
+   * \param src the transmitting device of the direction
+   * \param outage the new outage state
+   */
+  void OutageChanged (uint32_t link, Ptr<const NetDevice> src, bool outage);
+
+  /**
+   * \param link a link index
+   * \param rate the new data rate, zero in outage
+   * \param esN0 the Es/N0 it was chosen for, in dB
+   * \param modcod the scheme index, or -1 in outage
+   */
+  void RateChanged (uint32_t link, DataRate rate, double esN0, int32_t modcod);
+
+  /// \brief Integrate the flows from the last update to now
+  void Advance (void);
+
+  /// \brief Share the link capacities and set the device rates
+  void Allocate (void);
+
+  Time m_interval;                 //!< Update period
+  uint32_t m_maxWindow;            //!< Largest window in bytes
+  uint32_t m_initialWindow;        //!< Window after a start or outage
+  double m_packetShare;            //!< Capacity kept for packet traffic
+  double m_payloadFraction;        //!< Goodput over link rate
+  std::vector<Link> m_links;       //!< Links of the flows
+  std::vector<Flow> m_flows;       //!< Flows
+  Time m_last;                     //!< Time the flows were integrated to
+  EventId m_event;                 //!< Next periodic update
+
+  /// Trace fired when the rate of a flow changes
+  TracedCallback<uint32_t, double> m_rateTrace;
+};
+
+} // namespace ns3
+
+#endif /* FLUID_FLOW_MODEL_H */
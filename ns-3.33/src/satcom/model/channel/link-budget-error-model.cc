@@ -0,0 +1,273 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <limits>
+
+#include "link-budget-error-model.h"
+#include "adaptive-rate-controller.h"
+#include "ns3/contact-plan.h"
+#include "ns3/channel.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LinkBudgetErrorModel");
+
+NS_OBJECT_ENSURE_REGISTERED (LinkBudgetErrorModel);
+
+TypeId
+LinkBudgetErrorModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LinkBudgetErrorModel")
+    .SetParent<ErrorModel> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<LinkBudgetErrorModel> ()
+    .AddAttribute ("RateController", "Adaptive rate controller of the sender, "
+                   "which then provides the scheme, link budget and symbol rate.",
+                   PointerValue (),
+                   MakePointerAccessor (&LinkBudgetErrorModel::m_controller),
+                   MakePointerChecker<AdaptiveRateController> ())
+    .AddAttribute ("LinkBudget", "The link budget without a RateController, "
+                   "a default one is created if unset.",
+                   PointerValue (),
+                   MakePointerAccessor (&LinkBudgetErrorModel::m_budget),
+                   MakePointerChecker<LinkBudget> ())
+    .AddAttribute ("Modcod", "Index of the DVB-S2 scheme used without a RateController.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&LinkBudgetErrorModel::m_modcod),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("SymbolRate", "Symbol rate in Bd without a RateController.",
+                   DoubleValue (150e6),
+                   MakeDoubleAccessor (&LinkBudgetErrorModel::m_symbolRate),
+                   MakeDoubleChecker<double> (1))
+    .AddAttribute ("FrameBits", "Information bits carried by a FEC frame.",
+                   DoubleValue (48600),
+                   MakeDoubleAccessor (&LinkBudgetErrorModel::SetFrameBits),
+                   MakeDoubleChecker<double> (1))
+    .AddAttribute ("WaterfallWidth", "Standard deviation in dB of the Gaussian "
+                   "waterfall of the frame error rate.",
+                   DoubleValue (0.2),
+                   MakeDoubleAccessor (&LinkBudgetErrorModel::SetWaterfallWidth),
+                   MakeDoubleChecker<double> (0.001))
+    .AddAttribute ("QefRate", "Frame error rate at the scheme threshold.",
+                   DoubleValue (1e-7),
+                   MakeDoubleAccessor (&LinkBudgetErrorModel::SetQefRate),
+                   MakeDoubleChecker<double> (1e-15, 0.5))
+    .AddAttribute ("UpdateInterval", "Period at which the Es/N0 is re-evaluated.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&LinkBudgetErrorModel::m_interval),
+                   MakeTimeChecker ())
+    .AddAttribute ("RanVar", "The decision variable attached to this error model.",
+                   StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=1.0]"),
+                   MakePointerAccessor (&LinkBudgetErrorModel::m_ranvar),
+                   MakePointerChecker<RandomVariableStream> ())
+  ;
+  return tid;
+}
+
+LinkBudgetErrorModel::LinkBudgetErrorModel ()
+  : m_table (ModcodTable::GetDvbS2 ()),
+    m_frameBits (48600),
+    m_width (0.2),
+    m_qefRate (1e-7),
+    m_esN0 (0),
+    m_esN0Valid (false),
+    m_waterfallValid (false),
+    m_low (0),
+    m_step (0.01)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LinkBudgetErrorModel::~LinkBudgetErrorModel ()
+{
+}
+
+void
+LinkBudgetErrorModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_controller = 0;
+  m_budget = 0;
+  m_mobility[0] = 0;
+  m_mobility[1] = 0;
+  ErrorModel::DoDispose ();
+}
+
+void
+LinkBudgetErrorModel::Install (Ptr<NetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  Ptr<Channel> channel = device->GetChannel ();
+  NS_ASSERT_MSG (channel != 0 && channel->GetNDevices () == 2, "Device is not attached");
+  Ptr<NetDevice> peer = channel->GetDevice (0) == device ? channel->GetDevice (1) : channel->GetDevice (0);
+  m_mobility[0] = device->GetNode ()->GetObject<MobilityModel> ();
+  m_mobility[1] = peer->GetNode ()->GetObject<MobilityModel> ();
+  NS_ASSERT_MSG (m_mobility[0] != 0 && m_mobility[1] != 0, "Both nodes need a MobilityModel");
+  m_esN0Valid = false;
+  device->SetAttribute ("ReceiveErrorModel", PointerValue (this));
+}
+
+int64_t
+LinkBudgetErrorModel::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_ranvar->SetStream (stream);
+  return 1;
+}
+
+const ModcodTable &
+LinkBudgetErrorModel::GetTable (void) const
+{
+  return m_controller != 0 ? m_controller->GetModcodTable () : m_table;
+}
+
+void
+LinkBudgetErrorModel::SetFrameBits (double bits)
+{
+  m_frameBits = bits;
+  m_waterfallValid = false;
+}
+
+void
+LinkBudgetErrorModel::SetWaterfallWidth (double width)
+{
+  m_width = width;
+  m_waterfallValid = false;
+}
+
+void
+LinkBudgetErrorModel::SetQefRate (double rate)
+{
+  m_qefRate = rate;
+  m_waterfallValid = false;
+}
+
+void
+LinkBudgetErrorModel::BuildWaterfall (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Offset of the waterfall centre below the threshold, where the frame
+  // error rate is one half
+  double lo = 0;
+  double hi = 20;
+  for (int i = 0; i < 60; ++i)
+    {
+      double mid = (lo + hi) / 2;
+      (0.5 * std::erfc (mid / std::sqrt (2.0)) > m_qefRate ? lo : hi) = mid;
+    }
+  double offset = lo * m_width;
+  m_low = -offset - 8 * m_width;
+  uint32_t n = static_cast<uint32_t> (std::ceil ((offset + 14 * m_width) / m_step)) + 1;
+
+  m_waterfall.resize (n);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      double x = m_low + i * m_step + offset;
+      double fer = 0.5 * std::erfc (x / (m_width * std::sqrt (2.0)));
+      // Frames fail independently: per-bit rate of -log (1 - fer)
+      double perBit = -std::log1p (-std::min (fer, 1 - 1e-12)) / m_frameBits;
+      m_waterfall[i] = std::log (std::max (perBit, std::numeric_limits<double>::min ()));
+    }
+  m_waterfallValid = true;
+}
+
+double
+LinkBudgetErrorModel::GetPacketErrorRate (double esN0, uint32_t modcod, uint32_t bytes)
+{
+  if (!m_waterfallValid)
+    {
+      BuildWaterfall ();
+    }
+  NS_ASSERT (modcod < GetTable ().GetN ());
+  const std::vector<double> &t = m_waterfall;
+  double pos = (esN0 - GetTable ().Get (modcod).threshold - m_low) / m_step;
+  if (pos <= 0)
+    {
+      return 1.0;
+    }
+  if (pos >= t.size () - 1)
+    {
+      return 0.0;
+    }
+  uint32_t i = static_cast<uint32_t> (pos);
+  double frac = pos - i;
+  double logPerBit = t[i] + frac * (t[i + 1] - t[i]);
+  return -std::expm1 (-std::exp (logPerBit) * 8.0 * bytes);
+}
+
+double
+LinkBudgetErrorModel::GetEsN0 (void)
+{
+  Time now = Simulator::Now ();
+  if (m_esN0Valid && now - m_esN0Time < m_interval)
+    {
+      return m_esN0;
+    }
+  NS_ASSERT_MSG (m_mobility[0] != 0, "LinkBudgetErrorModel is not installed");
+  Vector a = m_mobility[0]->GetPosition ();
+  Vector b = m_mobility[1]->GetPosition ();
+  double elevation = a.GetLength () < b.GetLength () ? ContactPlan::GetElevation (a, b)
+                                                     : ContactPlan::GetElevation (b, a);
+  double range = CalculateDistance (a, b);
+  if (m_controller != 0)
+    {
+      m_esN0 = m_controller->GetLinkBudget ()->GetEsN0 (range, elevation, m_controller->GetSymbolRate ());
+    }
+  else
+    {
+      if (m_budget == 0)
+        {
+          m_budget = CreateObject<LinkBudget> ();
+        }
+      m_esN0 = m_budget->GetEsN0 (range, elevation, m_symbolRate);
+    }
+  m_esN0Time = now;
+  m_esN0Valid = true;
+  return m_esN0;
+}
+
+bool
+LinkBudgetErrorModel::DoCorrupt (Ptr<Packet> p)
+{
+  NS_LOG_FUNCTION (this << p);
+  uint32_t modcod = m_modcod;
+  if (m_controller != 0)
+    {
+      modcod = std::max (m_controller->GetModcod (), 0);
+    }
+  double per = GetPacketErrorRate (GetEsN0 (), modcod, p->GetSize ());
+  return m_ranvar->GetValue () < per;
+}
+
+void
+LinkBudgetErrorModel::DoReset (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_esN0Valid = false;
+}
+
+} // namespace ns3
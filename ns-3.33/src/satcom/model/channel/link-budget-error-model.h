@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LINK_BUDGET_ERROR_MODEL_H
+#define LINK_BUDGET_ERROR_MODEL_H
+
+#include <vector>
+
+#include "ns3/error-model.h"
+#include "ns3/nstime.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/link-budget.h"
+
+namespace ns3 {
+
+class NetDevice;
+class MobilityModel;
+class AdaptiveRateController;
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Packet error model of a satellite-to-ground link driven by
+ * its link budget.
+ *
+ * The Es/N0 at the receiver comes from the slant range and elevation
+ * between the two nodes of the link, evaluated at most once per
+ * UpdateInterval. The packet error probability is looked up in a
+ * waterfall model of the LDPC frame error rate that reaches the
+ * quasi-error-free rate at the scheme threshold, and scaled to the
+ * packet length. The waterfall has the same shape for every scheme, so
+ * a single table indexed by the Es/N0 margin over the threshold serves
+ * them all; it is built on first use and again after FrameBits,
+ * WaterfallWidth or QefRate change. A packet costs two exponentials and
+ * a random draw, whatever its size.
+ *
+ * The scheme is the one an AdaptiveRateController currently uses, if
+ * RateController is set, or the fixed Modcod of the DVB-S2 table
+ * otherwise. In outage the most robust scheme is assumed.
+ */
+class LinkBudgetErrorModel : public ErrorModel
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  LinkBudgetErrorModel ();
+  virtual ~LinkBudgetErrorModel ();
+
+  /**
+   * \brief Become the receive error model of a device
+   * \param device the receiving device; both nodes of its channel
+   *        need a MobilityModel
+   */
+  void Install (Ptr<NetDevice> device);
+
+  /**
+   * \param esN0 an Es/N0 in dB
+   * \param modcod a scheme index
+   * \param bytes a packet size
+   * \return the probability that the packet is lost
+   */
+  double GetPacketErrorRate (double esN0, uint32_t modcod, uint32_t bytes);
+
+  /// \return the Es/N0 at the receiver now, in dB
+  double GetEsN0 (void);
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual bool DoCorrupt (Ptr<Packet> p);
+  virtual void DoReset (void);
+
+  /// \return the scheme table in use
+  const ModcodTable &GetTable (void) const;
+
+  /// \param bits the information bits of a FEC frame
+  void SetFrameBits (double bits);
+  /// \param width the waterfall width in dB
+  void SetWaterfallWidth (double width);
+  /// \param rate the frame error rate at the threshold
+  void SetQefRate (double rate);
+
+  /// \brief Build the error table of the waterfall
+  void BuildWaterfall (void);
+
+  Ptr<AdaptiveRateController> m_controller;  //!< Scheme source, if any
+  Ptr<LinkBudget> m_budget;           //!< Link budget without a controller
+  ModcodTable m_table;                //!< Schemes without a controller
+  uint32_t m_modcod;                  //!< Fixed scheme without a controller
+  double m_symbolRate;                //!< Symbol rate without a controller
+  double m_frameBits;                 //!< Information bits of a FEC frame
+  double m_width;                     //!< Waterfall width in dB
+  double m_qefRate;                   //!< Frame error rate at the threshold
+  Time m_interval;                    //!< Es/N0 sampling period
+  Ptr<RandomVariableStream> m_ranvar; //!< Decision variable
+  Ptr<MobilityModel> m_mobility[2];   //!< Mobility of the receiver and the sender
+
+  Time m_esN0Time;                    //!< Time of the cached Es/N0
+  double m_esN0;                      //!< Cached Es/N0 in dB
+  bool m_esN0Valid;                   //!< Whether m_esN0 is valid
+
+  /**
+   * Natural log of the per-bit error rate on a grid of Es/N0 margins
+   * over the scheme threshold, starting at m_low dB in steps of m_step dB.
+   */
+  std::vector<double> m_waterfall;
+  bool m_waterfallValid;              //!< Whether m_waterfall matches the attributes
+  double m_low;                       //!< Grid start relative to the threshold
+  double m_step;                      //!< Grid step in dB
+};
+
+} // namespace ns3
+
+#endif /* LINK_BUDGET_ERROR_MODEL_H */
@@ -0,0 +1,223 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "link-budget.h"
+#include "weather-attenuation.h"
+#include "ns3/satcom-constants.h"
+#include "ns3/double.h"
+#include "ns3/pointer.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LinkBudget");
+
+NS_OBJECT_ENSURE_REGISTERED (LinkBudget);
+
+ModcodTable::ModcodTable ()
+{
+}
+
+ModcodTable
+ModcodTable::GetDvbS2 (void)
+{
+  ModcodTable table;
+  table.Add ("QPSK 1/4", 0.490243, -2.35);
+  table.Add ("QPSK 1/3", 0.656448, -1.24);
+  table.Add ("QPSK 2/5", 0.789412, -0.30);
+  table.Add ("QPSK 1/2", 0.988858, 1.00);
+  table.Add ("QPSK 3/5", 1.188304, 2.23);
+  table.Add ("QPSK 2/3", 1.322253, 3.10);
+  table.Add ("QPSK 3/4", 1.487473, 4.03);
+  table.Add ("QPSK 4/5", 1.587196, 4.68);
+  table.Add ("QPSK 5/6", 1.654663, 5.18);
+  table.Add ("QPSK 8/9", 1.766451, 6.20);
+  table.Add ("QPSK 9/10", 1.788612, 6.42);
+  table.Add ("8PSK 3/5", 1.779991, 5.50);
+  table.Add ("8PSK 2/3", 1.980636, 6.62);
+  table.Add ("8PSK 3/4", 2.228124, 7.91);
+  table.Add ("8PSK 5/6", 2.478562, 9.35);
+  table.Add ("8PSK 8/9", 2.646012, 10.69);
+  table.Add ("8PSK 9/10", 2.679207, 10.98);
+  table.Add ("16APSK 2/3", 2.637201, 8.97);
+  table.Add ("16APSK 3/4", 2.966728, 10.21);
+  table.Add ("16APSK 4/5", 3.165623, 11.03);
+  table.Add ("16APSK 5/6", 3.300184, 11.61);
+  table.Add ("16APSK 8/9", 3.523143, 12.89);
+  table.Add ("16APSK 9/10", 3.567342, 13.13);
+  table.Add ("32APSK 3/4", 3.703295, 12.73);
+  table.Add ("32APSK 4/5", 3.951571, 13.64);
+  table.Add ("32APSK 5/6", 4.119540, 14.28);
+  table.Add ("32APSK 8/9", 4.397854, 15.69);
+  table.Add ("32APSK 9/10", 4.453027, 16.05);
+  return table;
+}
+
+void
+ModcodTable::Add (std::string name, double efficiency, double threshold)
+{
+  Modcod m;
+  m.name = name;
+  m.efficiency = efficiency;
+  m.threshold = threshold;
+  m_modcods.push_back (m);
+  std::sort (m_modcods.begin (), m_modcods.end (),
+             [] (const Modcod &a, const Modcod &b)
+             {
+               return a.threshold < b.threshold
+                      || (a.threshold == b.threshold && a.efficiency > b.efficiency);
+             });
+  // Drop schemes that need more Es/N0 than a more efficient one
+  std::vector<Modcod> kept;
+  for (std::vector<Modcod>::const_iterator it = m_modcods.begin (); it != m_modcods.end (); ++it)
+    {
+      if (kept.empty () || it->efficiency > kept.back ().efficiency)
+        {
+          kept.push_back (*it);
+        }
+    }
+  m_modcods.swap (kept);
+}
+
+int32_t
+ModcodTable::Select (double esN0) const
+{
+  std::vector<Modcod>::const_iterator it =
+    std::upper_bound (m_modcods.begin (), m_modcods.end (), esN0,
+                      [] (double value, const Modcod &m) { return value < m.threshold; });
+  return static_cast<int32_t> (it - m_modcods.begin ()) - 1;
+}
+
+uint32_t
+ModcodTable::GetN (void) const
+{
+  return m_modcods.size ();
+}
+
+const ModcodTable::Modcod &
+ModcodTable::Get (uint32_t i) const
+{
+  NS_ASSERT (i < m_modcods.size ());
+  return m_modcods[i];
+}
+
+TypeId
+LinkBudget::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LinkBudget")
+    .SetParent<Object> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<LinkBudget> ()
+    .AddAttribute ("Frequency", "Carrier frequency in Hz.",
+                   DoubleValue (8.2e9),
+                   MakeDoubleAccessor (&LinkBudget::m_frequency),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("TxPower", "Transmit power in dBW.",
+                   DoubleValue (7.0),
+                   MakeDoubleAccessor (&LinkBudget::m_txPower),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("TxGain", "Transmit antenna gain in dBi.",
+                   DoubleValue (3.0),
+                   MakeDoubleAccessor (&LinkBudget::m_txGain),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("GOverT", "Receiver figure of merit in dB/K.",
+                   DoubleValue (26.0),
+                   MakeDoubleAccessor (&LinkBudget::m_gOverT),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("Losses", "Pointing, polarization and implementation losses in dB.",
+                   DoubleValue (2.0),
+                   MakeDoubleAccessor (&LinkBudget::m_losses),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("ZenithAttenuation", "Atmospheric attenuation at zenith in dB.",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&LinkBudget::m_zenithLoss),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("MinElevation", "Elevation in degrees below which the "
+                   "atmospheric attenuation stops growing.",
+                   DoubleValue (3.0),
+                   MakeDoubleAccessor (&LinkBudget::m_minElevation),
+                   MakeDoubleChecker<double> (0.1, 90))
+    .AddAttribute ("Weather", "Rain and cloud attenuation record of the ground station, if any.",
+                   PointerValue (),
+                   MakePointerAccessor (&LinkBudget::m_weather),
+                   MakePointerChecker<WeatherAttenuation> ())
+    .AddAttribute ("WeatherStation", "Index of the ground station in the Weather record.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&LinkBudget::m_weatherStation),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+LinkBudget::LinkBudget ()
+  : m_weatherStation (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LinkBudget::~LinkBudget ()
+{
+}
+
+double
+LinkBudget::GetFreeSpaceLoss (double range) const
+{
+  return 20.0 * std::log10 (4 * M_PI * range * m_frequency / satcom::SPEED_OF_LIGHT);
+}
+
+double
+LinkBudget::GetAtmosphericLoss (double elevation) const
+{
+  double el = std::max (elevation, m_minElevation) * M_PI / 180.0;
+  return (m_zenithLoss + GetWeatherLoss ()) / std::sin (el);
+}
+
+double
+LinkBudget::GetWeatherLoss (void) const
+{
+  if (m_weather == 0)
+    {
+      return 0;
+    }
+  return m_weather->GetAttenuation (m_weatherStation, Simulator::Now (), m_frequency);
+}
+
+bool
+LinkBudget::HasWeather (void) const
+{
+  return m_weather != 0;
+}
+
+double
+LinkBudget::GetCN0 (double range, double elevation) const
+{
+  // 228.6 dB is -10 log10 of the Boltzmann constant
+  return m_txPower + m_txGain - GetFreeSpaceLoss (range) - GetAtmosphericLoss (elevation)
+         - m_losses + m_gOverT + 228.6;
+}
+
+double
+LinkBudget::GetEsN0 (double range, double elevation, double symbolRate) const
+{
+  return GetCN0 (range, elevation) - 10.0 * std::log10 (symbolRate);
+}
+
+} // namespace ns3
@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LINK_BUDGET_H
+#define LINK_BUDGET_H
+
+#include <string>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Table of modulation and coding schemes sorted by the Es/N0
+ * they need.
+ *
+ * Schemes that need more Es/N0 than another for no more spectral
+ * efficiency are removed when the table is built, so Select () is a
+ * binary search over monotonic thresholds.
+ */
+class WeatherAttenuation;
+
+class ModcodTable
+{
+public:
+  /// A modulation and coding scheme
+  struct Modcod
+  {
+    std::string name;      //!< Name, such as "8PSK 3/4"
+    double efficiency;     //!< Information bits per symbol
+    double threshold;      //!< Es/N0 needed, in dB
+  };
+
+  /// Build an empty table
+  ModcodTable ();
+
+  /**
+   * \return the DVB-S2 normal frame schemes with their ideal
+   *         quasi-error-free Es/N0 (ETSI EN 302 307, table 13)
+   */
+  static ModcodTable GetDvbS2 (void);
+
+  /**
+   * \param name the scheme name
+   * \param efficiency its spectral efficiency in bit/symbol
+   * \param threshold the Es/N0 it needs in dB
+   */
+  void Add (std::string name, double efficiency, double threshold);
+
+  /**
+   * \param esN0 an Es/N0 in dB, margin included
+   * \return the index of the most efficient scheme that closes, or -1
+   */
+  int32_t Select (double esN0) const;
+
+  /// \return the number of schemes kept
+  uint32_t GetN (void) const;
+
+  /**
+   * \param i a scheme index
+   * \return the scheme
+   */
+  const Modcod &Get (uint32_t i) const;
+
+private:
+  std::vector<Modcod> m_modcods;  //!< Non-dominated schemes by threshold
+};
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Clear-sky link budget of a satellite-to-ground link.
+ *
+ * Free-space loss over the slant range, atmospheric attenuation scaled
+ * from its zenith value by the cosecant of the elevation, and the
+ * receiver figure of merit give C/N0 and the Es/N0 at a symbol rate.
+ *
+ * With a Weather source, the zenith rain and cloud attenuation of
+ * WeatherStation at the current simulation time adds to the clear-sky
+ * one before the cosecant scaling, so the budget, and the rate and
+ * errors derived from it, follow the weather record of the site. A
+ * record made for another carrier frequency is scaled to Frequency.
+ */
+class LinkBudget : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  LinkBudget ();
+  virtual ~LinkBudget ();
+
+  /**
+   * \param range the slant range in m
+   * \return the free-space loss in dB
+   */
+  double GetFreeSpaceLoss (double range) const;
+
+  /**
+   * \param elevation the elevation in degrees
+   * \return the atmospheric attenuation in dB
+   */
+  double GetAtmosphericLoss (double elevation) const;
+
+  /// \return the zenith rain and cloud attenuation now at Frequency in dB, 0 without Weather
+  double GetWeatherLoss (void) const;
+
+  /// \return whether the budget follows a weather record, and so changes over time
+  bool HasWeather (void) const;
+
+  /**
+   * \param range the slant range in m
+   * \param elevation the elevation in degrees
+   * \return the carrier to noise density ratio in dBHz
+   */
+  double GetCN0 (double range, double elevation) const;
+
+  /**
+   * \param range the slant range in m
+   * \param elevation the elevation in degrees
+   * \param symbolRate the symbol rate in Bd
+   * \return the energy per symbol to noise density ratio in dB
+   */
+  double GetEsN0 (double range, double elevation, double symbolRate) const;
+
+private:
+  double m_frequency;        //!< Carrier frequency in Hz
+  double m_txPower;          //!< Transmit power in dBW
+  double m_txGain;           //!< Transmit antenna gain in dBi
+  double m_gOverT;           //!< Receiver figure of merit in dB/K
+  double m_losses;           //!< Other losses in dB
+  double m_zenithLoss;       //!< Atmospheric attenuation at zenith in dB
+  double m_minElevation;     //!< Elevation the cosecant law is clamped at, degrees
+  Ptr<WeatherAttenuation> m_weather;  //!< Weather record, if any
+  uint32_t m_weatherStation; //!< Station index in the weather record
+};
+
+} // namespace ns3
+
+#endif /* LINK_BUDGET_H */
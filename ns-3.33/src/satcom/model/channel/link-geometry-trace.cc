@@ -0,0 +1,371 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "link-geometry-trace.h"
+#include "ns3/contact-plan.h"
+#include "ns3/satcom-constants.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LinkGeometryTrace");
+
+NS_OBJECT_ENSURE_REGISTERED (LinkGeometryTrace);
+
+namespace {
+
+/// On-disk header, see LinkGeometryTrace
+struct GeometryHeader
+{
+  char magic[8];      //!< "SATGEOT1"
+  uint32_t links;     //!< Number of links
+  uint32_t columns;   //!< Number of columns
+  uint64_t capacity;  //!< Samples allocated
+  uint64_t count;     //!< Samples written
+  double start;       //!< Time of the first sample in s
+  double interval;    //!< Sampling interval in s
+  double frequency;   //!< Carrier frequency in Hz
+};
+
+const char GEOMETRY_MAGIC[8] = { 'S', 'A', 'T', 'G', 'E', 'O', 'T', '1' };
+
+/// Number of columns
+const uint32_t GEOMETRY_COLUMNS = 5;
+
+/// Byte offsets of the sections of a file
+struct GeometryLayout
+{
+  std::size_t nodes;      //!< Link ends
+  std::size_t range;      //!< Range column
+  std::size_t delay;      //!< Delay column
+  std::size_t elevation;  //!< Elevation column
+  std::size_t doppler;    //!< Doppler column
+  std::size_t state;      //!< State column
+  std::size_t size;       //!< Whole file
+};
+
+/**
+ * \param links number of links
+ * \param capacity samples allocated
+ * \return the layout of the file; every column stays aligned on its type
+ */
+GeometryLayout
+GetLayout (uint64_t links, uint64_t capacity)
+{
+  GeometryLayout layout;
+  uint64_t values = links * capacity;
+  layout.nodes = sizeof (GeometryHeader);
+  layout.range = layout.nodes + 2 * links * sizeof (uint32_t);
+  layout.delay = layout.range + values * sizeof (double);
+  layout.elevation = layout.delay + values * sizeof (double);
+  layout.doppler = layout.elevation + values * sizeof (float);
+  layout.state = layout.doppler + values * sizeof (float);
+  layout.size = layout.state + values * sizeof (uint8_t);
+  return layout;
+}
+
+} // anonymous namespace
+
+TypeId
+LinkGeometryTrace::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LinkGeometryTrace")
+    .SetParent<Object> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<LinkGeometryTrace> ()
+    .AddAttribute ("Interval",
+                   "Sampling interval.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&LinkGeometryTrace::m_interval),
+                   MakeTimeChecker (MicroSeconds (1)))
+    .AddAttribute ("Frequency",
+                   "Carrier frequency of the Doppler shift, in Hz.",
+                   DoubleValue (8.1e9),
+                   MakeDoubleAccessor (&LinkGeometryTrace::m_frequency),
+                   MakeDoubleChecker<double> (0.0))
+  ;
+  return tid;
+}
+
+LinkGeometryTrace::LinkGeometryTrace ()
+  : m_frequency (8.1e9),
+    m_capacity (0),
+    m_count (0),
+    m_range (0),
+    m_delay (0),
+    m_elevation (0),
+    m_doppler (0),
+    m_state (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LinkGeometryTrace::~LinkGeometryTrace ()
+{
+  Close ();
+}
+
+void
+LinkGeometryTrace::DoDispose (void)
+{
+  Close ();
+  m_links.clear ();
+  Object::DoDispose ();
+}
+
+uint32_t
+LinkGeometryTrace::AddLink (Ptr<OrbitPointToPointChannel> channel)
+{
+  NS_LOG_FUNCTION (this << channel);
+  NS_ASSERT_MSG (!m_file.IsOpen (), "Add the links before opening the file");
+  NS_ASSERT_MSG (channel->GetNDevices () == 2, "The link needs both devices attached");
+  Link link;
+  link.channel = channel;
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      link.mobility[i] = channel->GetDevice (i)->GetNode ()->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (link.mobility[i] != 0, "Both ends of a recorded link need a mobility model");
+    }
+  m_links.push_back (link);
+  return m_links.size () - 1;
+}
+
+uint32_t
+LinkGeometryTrace::GetNLinks (void) const
+{
+  return m_links.size ();
+}
+
+uint64_t
+LinkGeometryTrace::GetNSamples (void) const
+{
+  return m_count;
+}
+
+bool
+LinkGeometryTrace::Open (const std::string &filename, Time start, Time stop)
+{
+  NS_LOG_FUNCTION (this << filename << start << stop);
+  NS_ASSERT (stop >= start && start >= Simulator::Now ());
+  Close ();
+  m_capacity = static_cast<uint64_t> ((stop - start).GetSeconds () / m_interval.GetSeconds ()) + 1;
+  m_count = 0;
+  GeometryLayout layout = GetLayout (m_links.size (), m_capacity);
+
+  if (!m_file.Create (filename, layout.size))
+    {
+      NS_LOG_WARN ("Cannot create geometry trace " << filename);
+      return false;
+    }
+
+  GeometryHeader *header = static_cast<GeometryHeader *> (m_file.GetData ());
+  std::memcpy (header->magic, GEOMETRY_MAGIC, sizeof (header->magic));
+  header->links = m_links.size ();
+  header->columns = GEOMETRY_COLUMNS;
+  header->capacity = m_capacity;
+  header->count = 0;
+  header->start = start.GetSeconds ();
+  header->interval = m_interval.GetSeconds ();
+  header->frequency = m_frequency;
+  char *base = static_cast<char *> (m_file.GetData ());
+  uint32_t *nodes = reinterpret_cast<uint32_t *> (base + layout.nodes);
+  for (uint32_t l = 0; l < m_links.size (); ++l)
+    {
+      nodes[2 * l] = m_links[l].channel->GetDevice (0)->GetNode ()->GetId ();
+      nodes[2 * l + 1] = m_links[l].channel->GetDevice (1)->GetNode ()->GetId ();
+    }
+  m_range = reinterpret_cast<double *> (base + layout.range);
+  m_delay = reinterpret_cast<double *> (base + layout.delay);
+  m_elevation = reinterpret_cast<float *> (base + layout.elevation);
+  m_doppler = reinterpret_cast<float *> (base + layout.doppler);
+  m_state = reinterpret_cast<uint8_t *> (base + layout.state);
+  m_event = Simulator::Schedule (start - Simulator::Now (), &LinkGeometryTrace::Sample, this);
+  return true;
+}
+
+void
+LinkGeometryTrace::Close (void)
+{
+  m_event.Cancel ();
+  if (m_file.IsOpen ())
+    {
+      NS_LOG_FUNCTION (this << m_count);
+      static_cast<GeometryHeader *> (m_file.GetData ())->count = m_count;
+      m_file.Close ();
+    }
+}
+
+void
+LinkGeometryTrace::Sample (void)
+{
+  uint64_t base = m_count * m_links.size ();
+  for (uint32_t l = 0; l < m_links.size (); ++l)
+    {
+      const Link &link = m_links[l];
+      Vector a = link.mobility[0]->GetPosition ();
+      Vector b = link.mobility[1]->GetPosition ();
+      Vector va = link.mobility[0]->GetVelocity ();
+      Vector vb = link.mobility[1]->GetVelocity ();
+      Vector d (b.x - a.x, b.y - a.y, b.z - a.z);
+      double range = std::sqrt (d.x * d.x + d.y * d.y + d.z * d.z);
+      double rate = range > 0 ? (d.x * (vb.x - va.x) + d.y * (vb.y - va.y) + d.z * (vb.z - va.z)) / range : 0;
+      m_range[base + l] = range;
+      m_delay[base + l] = link.channel->GetPropagationDelay ().GetSeconds ();
+      // The elevation is seen from the ground end of the link
+      m_elevation[base + l] = a.GetLength () < b.GetLength () ? ContactPlan::GetElevation (a, b)
+                                                              : ContactPlan::GetElevation (b, a);
+      m_doppler[base + l] = -m_frequency * rate / satcom::SPEED_OF_LIGHT;
+      m_state[base + l] = link.channel->IsLinkUp ();
+    }
+  m_count++;
+  static_cast<GeometryHeader *> (m_file.GetData ())->count = m_count;
+  if (m_count < m_capacity)
+    {
+      m_event = Simulator::Schedule (m_interval, &LinkGeometryTrace::Sample, this);
+    }
+}
+
+LinkGeometryTraceReader::LinkGeometryTraceReader ()
+  : m_links (0),
+    m_count (0),
+    m_start (0),
+    m_interval (0),
+    m_frequency (0),
+    m_nodes (0),
+    m_range (0),
+    m_delay (0),
+    m_elevation (0),
+    m_doppler (0),
+    m_state (0)
+{
+}
+
+LinkGeometryTraceReader::~LinkGeometryTraceReader ()
+{
+}
+
+bool
+LinkGeometryTraceReader::Open (const std::string &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  MappedFile file;
+  if (!file.Open (filename, sizeof (GeometryHeader)))
+    {
+      return false;
+    }
+
+  const GeometryHeader *header = static_cast<const GeometryHeader *> (file.GetData ());
+  GeometryLayout layout = GetLayout (header->links, header->capacity);
+  bool valid = std::memcmp (header->magic, GEOMETRY_MAGIC, sizeof (header->magic)) == 0
+    && header->columns == GEOMETRY_COLUMNS
+    && header->count <= header->capacity
+    && header->interval > 0
+    && file.GetSize () == layout.size;
+  if (!valid)
+    {
+      NS_LOG_WARN ("Geometry trace " << filename << " is not well formed");
+      return false;
+    }
+
+  m_file.Swap (file);
+  m_links = header->links;
+  m_count = header->count;
+  m_start = header->start;
+  m_interval = header->interval;
+  m_frequency = header->frequency;
+  const char *base = static_cast<const char *> (m_file.GetData ());
+  m_nodes = reinterpret_cast<const uint32_t *> (base + layout.nodes);
+  m_range = reinterpret_cast<const double *> (base + layout.range);
+  m_delay = reinterpret_cast<const double *> (base + layout.delay);
+  m_elevation = reinterpret_cast<const float *> (base + layout.elevation);
+  m_doppler = reinterpret_cast<const float *> (base + layout.doppler);
+  m_state = reinterpret_cast<const uint8_t *> (base + layout.state);
+  return true;
+}
+
+uint32_t
+LinkGeometryTraceReader::GetNLinks (void) const
+{
+  return m_links;
+}
+
+uint64_t
+LinkGeometryTraceReader::GetNSamples (void) const
+{
+  return m_count;
+}
+
+double
+LinkGeometryTraceReader::GetStart (void) const
+{
+  return m_start;
+}
+
+double
+LinkGeometryTraceReader::GetInterval (void) const
+{
+  return m_interval;
+}
+
+double
+LinkGeometryTraceReader::GetFrequency (void) const
+{
+  return m_frequency;
+}
+
+uint32_t
+LinkGeometryTraceReader::GetNode (uint32_t link, uint32_t end) const
+{
+  NS_ASSERT (link < m_links && end < 2);
+  return m_nodes[2 * link + end];
+}
+
+const double *
+LinkGeometryTraceReader::GetRange (void) const
+{
+  return m_range;
+}
+
+const double *
+LinkGeometryTraceReader::GetDelay (void) const
+{
+  return m_delay;
+}
+
+const float *
+LinkGeometryTraceReader::GetElevation (void) const
+{
+  return m_elevation;
+}
+
+const float *
+LinkGeometryTraceReader::GetDoppler (void) const
+{
+  return m_doppler;
+}
+
+const uint8_t *
+LinkGeometryTraceReader::GetState (void) const
+{
+  return m_state;
+}
+
+} // namespace ns3
@@ -0,0 +1,218 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LINK_GEOMETRY_TRACE_H
+#define LINK_GEOMETRY_TRACE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/mobility-model.h"
+#include "ns3/orbit-point-to-point-channel.h"
+#include "ns3/mapped-file.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Records the geometry of orbit links as columnar binary time
+ * series.
+ *
+ * Every "Interval", one event samples all the added links: slant range,
+ * propagation delay, elevation of the outer end above the horizon of the
+ * end closer to the Earth centre (the station side of a ground link,
+ * whichever device it is), Doppler shift at "Frequency" and link
+ * state. The samples are written in place into a file preallocated for
+ * the whole run and mapped with mmap, so recording costs no formatting
+ * and no system call per sample. LinkGeometryTraceReader maps the file
+ * back and serves each column as a plain array.
+ *
+ * The file is a fixed header, the node ids of the two ends of every link,
+ * then one column per quantity, each holding capacity x links values in
+ * sample-major order (all the links of sample 0, then sample 1...):
+ *
+ * \verbatim
+   char     magic[8]     "SATGEOT1"
+   uint32_t links        number of links
+   uint32_t columns      number of columns, 5
+   uint64_t capacity     number of samples allocated
+   uint64_t count        number of samples written
+   double   start        time of the first sample in s
+   double   interval     sampling interval in s
+   double   frequency    carrier frequency of the Doppler column in Hz
+   uint32_t nodes[2 * links]                ends of each link
+   double   range[capacity * links]          slant range in m
+   double   delay[capacity * links]          propagation delay in s
+   float    elevation[capacity * links]      elevation in degrees
+   float    doppler[capacity * links]        Doppler shift in Hz
+   uint8_t  state[capacity * links]          1 if the link is up
+   \endverbatim
+ */
+class LinkGeometryTrace : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  LinkGeometryTrace ();
+  virtual ~LinkGeometryTrace ();
+
+  /**
+   * \param channel a link to record, both devices attached and both nodes
+   * with a mobility model
+   * \return the link index in the file
+   */
+  uint32_t AddLink (Ptr<OrbitPointToPointChannel> channel);
+
+  /**
+   * \return the number of links
+   */
+  uint32_t GetNLinks (void) const;
+
+  /**
+   * \brief Create the file and schedule the sampling
+   *
+   * The file is sized for every sample in [start, stop]; the links must
+   * be added before.
+   *
+   * \param filename the file to write
+   * \param start the time of the first sample
+   * \param stop the latest time of the last sample
+   * \return true if the file could be created and mapped
+   */
+  bool Open (const std::string &filename, Time start, Time stop);
+
+  /**
+   * \brief Stop sampling, record the sample count and unmap the file
+   *
+   * Called on dispose if needed.
+   */
+  void Close (void);
+
+  /**
+   * \return the number of samples written so far
+   */
+  uint64_t GetNSamples (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// A recorded link
+  struct Link
+  {
+    Ptr<OrbitPointToPointChannel> channel;  //!< The channel
+    Ptr<MobilityModel> mobility[2];         //!< Mobility of the two ends
+  };
+
+  /// Record one sample of every link
+  void Sample (void);
+
+  Time m_interval;                //!< Sampling interval
+  double m_frequency;             //!< Carrier frequency in Hz
+  std::vector<Link> m_links;      //!< Recorded links
+
+  MappedFile m_file;              //!< Mapped file, if open
+  uint64_t m_capacity;            //!< Samples allocated
+  uint64_t m_count;               //!< Samples written
+  double *m_range;                //!< Range column in the mapping
+  double *m_delay;                //!< Delay column in the mapping
+  float *m_elevation;             //!< Elevation column in the mapping
+  float *m_doppler;               //!< Doppler column in the mapping
+  uint8_t *m_state;               //!< State column in the mapping
+  EventId m_event;                //!< Next sample
+};
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Maps a file written by LinkGeometryTrace for reading.
+ *
+ * The columns are served in place from the mapping; value i of a column
+ * is sample i / links of link i % links.
+ */
+class LinkGeometryTraceReader
+{
+public:
+  LinkGeometryTraceReader ();
+  ~LinkGeometryTraceReader ();
+
+  /**
+   * \param filename the file to map
+   * \return true if the file exists and is well formed
+   */
+  bool Open (const std::string &filename);
+
+  /// \return the number of links
+  uint32_t GetNLinks (void) const;
+  /// \return the number of samples of each link
+  uint64_t GetNSamples (void) const;
+  /// \return the time of the first sample in s
+  double GetStart (void) const;
+  /// \return the sampling interval in s
+  double GetInterval (void) const;
+  /// \return the carrier frequency of the Doppler column in Hz
+  double GetFrequency (void) const;
+
+  /**
+   * \param link a link index
+   * \param end 0 or 1
+   * \return the node id of that end of the link
+   */
+  uint32_t GetNode (uint32_t link, uint32_t end) const;
+
+  /// \return the slant ranges in m
+  const double *GetRange (void) const;
+  /// \return the propagation delays in s
+  const double *GetDelay (void) const;
+  /// \return the elevations in degrees
+  const float *GetElevation (void) const;
+  /// \return the Doppler shifts in Hz
+  const float *GetDoppler (void) const;
+  /// \return the link states, 1 if up
+  const uint8_t *GetState (void) const;
+
+private:
+  /// Not copyable, the columns live in a mapping
+  LinkGeometryTraceReader (const LinkGeometryTraceReader &);
+  /// Not copyable, the columns live in a mapping
+  LinkGeometryTraceReader & operator = (const LinkGeometryTraceReader &);
+
+  MappedFile m_file;              //!< Mapped file, if open
+  uint32_t m_links;               //!< Number of links
+  uint64_t m_count;               //!< Samples per link
+  double m_start;                 //!< Time of the first sample in s
+  double m_interval;              //!< Sampling interval in s
+  double m_frequency;             //!< Carrier frequency in Hz
+  const uint32_t *m_nodes;        //!< Ends of the links
+  const double *m_range;          //!< Range column
+  const double *m_delay;          //!< Delay column
+  const float *m_elevation;       //!< Elevation column
+  const float *m_doppler;         //!< Doppler column
+  const uint8_t *m_state;         //!< State column
+};
+
+} // namespace ns3
+
+#endif /* LINK_GEOMETRY_TRACE_H */
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+
+#include "orbit-point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/satcom-constants.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("OrbitPointToPointChannel");
+
+NS_OBJECT_ENSURE_REGISTERED (OrbitPointToPointChannel);
+
+TypeId
+OrbitPointToPointChannel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::OrbitPointToPointChannel")
+    .SetParent<PointToPointChannel> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<OrbitPointToPointChannel> ()
+    .AddAttribute ("PropagationSpeed",
+                   "Propagation speed of the signal in m/s.",
+                   DoubleValue (satcom::SPEED_OF_LIGHT),
+                   MakeDoubleAccessor (&OrbitPointToPointChannel::m_propagationSpeed),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("LinkUp",
+                   "Whether the link initially carries traffic.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&OrbitPointToPointChannel::m_linkUp),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("TxRxOrbit",
+                     "Trace source indicating transmission of a packet "
+                     "with its geometry-derived delay.",
+                     MakeTraceSourceAccessor (&OrbitPointToPointChannel::m_txrxOrbit),
+                     "ns3::OrbitPointToPointChannel::TxRxCallback")
+    .AddTraceSource ("LinkState",
+                     "The link went up (true) or down (false).",
+                     MakeTraceSourceAccessor (&OrbitPointToPointChannel::m_linkStateTrace),
+                     "ns3::OrbitPointToPointChannel::LinkStateCallback")
+    .AddTraceSource ("Outage",
+                     "A direction entered (true) or left (false) outage.",
+                     MakeTraceSourceAccessor (&OrbitPointToPointChannel::m_outageTrace),
+                     "ns3::OrbitPointToPointChannel::OutageCallback")
+  ;
+  return tid;
+}
+
+OrbitPointToPointChannel::OrbitPointToPointChannel ()
+  : PointToPointChannel (),
+    m_propagationSpeed (satcom::SPEED_OF_LIGHT),
+    m_linkUp (true)
+{
+  NS_LOG_FUNCTION (this);
+  m_mobilityWarned[0] = false;
+  m_mobilityWarned[1] = false;
+  m_outage[0] = false;
+  m_outage[1] = false;
+}
+
+OrbitPointToPointChannel::~OrbitPointToPointChannel ()
+{
+}
+
+void
+OrbitPointToPointChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_mobility[0] = 0;
+  m_mobility[1] = 0;
+  PointToPointChannel::DoDispose ();
+}
+
+Ptr<MobilityModel>
+OrbitPointToPointChannel::GetMobility (uint32_t i) const
+{
+  if (m_mobility[i] == 0)
+    {
+      // Looked up again until found, the model may be aggregated later
+      Ptr<PointToPointNetDevice> device = GetPointToPointDevice (i);
+      if (device == 0 || device->GetNode () == 0)
+        {
+          return 0;
+        }
+      m_mobility[i] = device->GetNode ()->GetObject<MobilityModel> ();
+      if (m_mobility[i] == 0 && !m_mobilityWarned[i])
+        {
+          m_mobilityWarned[i] = true;
+          NS_LOG_WARN ("Node " << device->GetNode ()->GetId ()
+                       << " has no MobilityModel, falling back to the Delay attribute");
+        }
+    }
+  return m_mobility[i];
+}
+
+void
+OrbitPointToPointChannel::SetLinkUp (bool up)
+{
+  NS_LOG_FUNCTION (this << up);
+  if (up != m_linkUp)
+    {
+      m_linkUp = up;
+      m_linkStateTrace (up);
+    }
+}
+
+bool
+OrbitPointToPointChannel::IsLinkUp (void) const
+{
+  return m_linkUp;
+}
+
+uint32_t
+OrbitPointToPointChannel::GetWire (Ptr<const NetDevice> src) const
+{
+  NS_ASSERT_MSG (src == GetDevice (0) || src == GetDevice (1), "Device is not attached");
+  return src == GetDevice (0) ? 0 : 1;
+}
+
+void
+OrbitPointToPointChannel::SetOutage (Ptr<const NetDevice> src, bool outage)
+{
+  NS_LOG_FUNCTION (this << src << outage);
+  uint32_t wire = GetWire (src);
+  if (outage != m_outage[wire])
+    {
+      m_outage[wire] = outage;
+      m_outageTrace (src, outage);
+    }
+}
+
+bool
+OrbitPointToPointChannel::IsLinkUp (Ptr<const NetDevice> src) const
+{
+  return m_linkUp && !m_outage[GetWire (src)];
+}
+
+double
+OrbitPointToPointChannel::GetSlantRange (void) const
+{
+  Ptr<MobilityModel> a = GetMobility (0);
+  Ptr<MobilityModel> b = GetMobility (1);
+  if (a == 0 || b == 0)
+    {
+      return -1.0;
+    }
+  Vector pa = a->GetPosition ();
+  Vector pb = b->GetPosition ();
+  double dx = pb.x - pa.x;
+  double dy = pb.y - pa.y;
+  double dz = pb.z - pa.z;
+  return std::sqrt (dx * dx + dy * dy + dz * dz);
+}
+
+Time
+OrbitPointToPointChannel::GetPropagationDelay (void) const
+{
+  double range = GetSlantRange ();
+  if (range < 0)
+    {
+      return GetDelay ();
+    }
+  return Seconds (range / m_propagationSpeed);
+}
+
+bool
+OrbitPointToPointChannel::TransmitStart (
+  Ptr<const Packet> p,
+  Ptr<PointToPointNetDevice> src,
+  Time txTime)
+{
+  NS_LOG_FUNCTION (this << p << src);
+  NS_LOG_LOGIC ("UID is " << p->GetUid () << ")");
+
+  NS_ASSERT (IsInitialized ());
+
+  if (!m_linkUp)
+    {
+      NS_LOG_LOGIC ("link is down, dropping packet");
+      return false;
+    }
+
+  uint32_t wire = src == GetSource (0) ? 0 : 1;
+  if (m_outage[wire])
+    {
+      NS_LOG_LOGIC ("direction is in outage, dropping packet");
+      return false;
+    }
+  Ptr<PointToPointNetDevice> dst = GetDestination (wire);
+
+  Time delay = GetPropagationDelay ();
+  NS_LOG_LOGIC ("propagation delay " << delay.GetSeconds () << "s");
+
+  Simulator::ScheduleWithContext (dst->GetNode ()->GetId (),
+                                  txTime + delay, &PointToPointNetDevice::Receive,
+                                  dst, p->Copy ());
+
+  m_txrxPointToPoint (p, src, dst, txTime, txTime + delay);
+  m_txrxOrbit (p, src, dst, txTime, txTime + delay);
+  return true;
+}
+
+} // namespace ns3
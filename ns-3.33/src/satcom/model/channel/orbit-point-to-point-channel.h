@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ORBIT_POINT_TO_POINT_CHANNEL_H
+#define ORBIT_POINT_TO_POINT_CHANNEL_H
+
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/mobility-model.h"
+#include "ns3/traced-callback.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup satcom
+ *
+ * \brief A point-to-point channel whose propagation delay follows the
+ * geometry of the two endpoints.
+ *
+ * Instead of relying on a fixed "Delay" attribute that has to be rewritten
+ * whenever the satellite moves, the channel looks up the MobilityModel of
+ * both endpoint nodes when a transmission starts and schedules the
+ * reception after the true slant-range delay.  If either node has no
+ * MobilityModel, the inherited "Delay" attribute is used instead.
+ * Each transmission fires the inherited TxRxPointToPoint trace, which
+ * NetAnim follows, and TxRxOrbit with const devices.
+ *
+ * The channel also carries a link state so that visibility can be driven
+ * from outside (e.g. by a ContactPlan).  While the link is down every
+ * transmission is refused and shows up in the device's PhyTxDrop trace.
+ * Each direction can in addition be put in outage, e.g. by an
+ * AdaptiveRateController when no scheme closes the link; the
+ * transmissions of that direction are then refused the same way.
+ */
+class OrbitPointToPointChannel : public PointToPointChannel
+{
+public:
+  /**
+   * \brief Get the TypeId
+   *
+   * \return The TypeId for this class
+   */
+  static TypeId GetTypeId (void);
+
+  OrbitPointToPointChannel ();
+  virtual ~OrbitPointToPointChannel ();
+
+  /**
+   * \brief Transmit a packet over this channel
+   *
+   * The propagation delay is evaluated once, from the current positions of
+   * both endpoints.
+   *
+   * \param p Packet to transmit
+   * \param src Source PointToPointNetDevice
+   * \param txTime Transmit time to apply
+   * \returns true if successful (currently always true)
+   */
+  virtual bool TransmitStart (Ptr<const Packet> p, Ptr<PointToPointNetDevice> src, Time txTime);
+
+  /**
+   * \brief Bring the link up or down
+   * \param up the new link state
+   */
+  void SetLinkUp (bool up);
+
+  /**
+   * \returns true if the link currently carries traffic
+   */
+  bool IsLinkUp (void) const;
+
+  /**
+   * \brief Put the direction a device transmits on in or out of outage
+   * \param src the transmitting device, attached to this channel
+   * \param outage the new outage state
+   */
+  void SetOutage (Ptr<const NetDevice> src, bool outage);
+
+  /**
+   * \param src the transmitting device, attached to this channel
+   * \returns true if the link is up and the direction of src not in outage
+   */
+  bool IsLinkUp (Ptr<const NetDevice> src) const;
+
+  /**
+   * \returns the current distance between the two endpoints in meters,
+   * or a negative value if the geometry is unknown
+   */
+  double GetSlantRange (void) const;
+
+  /**
+   * \returns the propagation delay a packet sent now would experience
+   */
+  Time GetPropagationDelay (void) const;
+
+  /**
+   * TracedCallback signature for packet transmission events.
+   *
+   * \param [in] packet The packet being transmitted.
+   * \param [in] txDevice the transmitting NetDevice.
+   * \param [in] rxDevice the receiving NetDevice.
+   * \param [in] duration The amount of time to transmit the packet.
+   * \param [in] lastBitTime Last bit receive time (relative to now)
+   */
+  typedef void (* TxRxCallback)
+    (Ptr<const Packet> packet,
+     Ptr<const NetDevice> txDevice, Ptr<const NetDevice> rxDevice,
+     Time duration, Time lastBitTime);
+
+  /**
+   * TracedCallback signature for link state changes.
+   *
+   * \param [in] up The new link state.
+   */
+  typedef void (* LinkStateCallback) (bool up);
+
+  /**
+   * TracedCallback signature for outage changes.
+   *
+   * \param [in] src The transmitting device of the direction.
+   * \param [in] outage The new outage state.
+   */
+  typedef void (* OutageCallback) (Ptr<const NetDevice> src, bool outage);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Look up (and cache) the MobilityModel of the node behind device i
+   * \param i the device index on this channel
+   * \returns the mobility model, or 0 if the node has none
+   */
+  Ptr<MobilityModel> GetMobility (uint32_t i) const;
+
+  /**
+   * \param src a device attached to this channel
+   * \returns the index of its direction
+   */
+  uint32_t GetWire (Ptr<const NetDevice> src) const;
+
+  double m_propagationSpeed; //!< Propagation speed in m/s
+  bool m_linkUp;             //!< Whether the link currently carries traffic
+  bool m_outage[2];          //!< Whether the direction of device i is in outage
+
+  /// Cached endpoint mobility models, filled once they are found
+  mutable Ptr<MobilityModel> m_mobility[2];
+  /// Whether the missing MobilityModel of node i was reported
+  mutable bool m_mobilityWarned[2];
+
+  /// Trace fired for every transmission with the geometry-derived delay
+  TracedCallback<Ptr<const Packet>,
+                 Ptr<const NetDevice>,
+                 Ptr<const NetDevice>,
+                 Time,
+                 Time> m_txrxOrbit;
+
+  /// Trace fired whenever the link state changes
+  TracedCallback<bool> m_linkStateTrace;
+
+  /// Trace fired whenever a direction enters or leaves outage
+  TracedCallback<Ptr<const NetDevice>, bool> m_outageTrace;
+};
+
+} // namespace ns3
+
+#endif /* ORBIT_POINT_TO_POINT_CHANNEL_H */
@@ -0,0 +1,333 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "weather-attenuation.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("WeatherAttenuation");
+
+NS_OBJECT_ENSURE_REGISTERED (WeatherAttenuation);
+
+namespace {
+
+/// On-disk header, see WeatherAttenuation
+struct WeatherHeader
+{
+  char magic[8];      //!< "SATWXAT1"
+  uint32_t stations;  //!< Number of stations
+  uint32_t columns;   //!< Number of columns
+  uint64_t samples;   //!< Samples per station
+  double start;       //!< Time of the first sample in s
+  double interval;    //!< Sampling interval in s
+  double frequency;   //!< Carrier frequency in Hz
+};
+
+const char WEATHER_MAGIC[8] = { 'S', 'A', 'T', 'W', 'X', 'A', 'T', '1' };
+
+/// Number of columns
+const uint32_t WEATHER_COLUMNS = 2;
+
+/**
+ * \param stations number of stations
+ * \param samples samples per station
+ * \return the size of the file
+ */
+std::size_t
+GetFileSize (uint64_t stations, uint64_t samples)
+{
+  return sizeof (WeatherHeader) + WEATHER_COLUMNS * stations * samples * sizeof (float);
+}
+
+/// Frequency range of the ITU-R P.618 rain scaling, in GHz
+const double RAIN_SCALING_MIN = 7.0;
+const double RAIN_SCALING_MAX = 55.0;
+
+/**
+ * \param f a frequency in GHz
+ * \return the phi term of the ITU-R P.618 rain frequency scaling
+ */
+double
+GetRainPhi (double f)
+{
+  return f * f / (1 + 1e-4 * f * f);
+}
+
+/**
+ * \param f a frequency in GHz
+ * \return the specific attenuation coefficient of cloud liquid water at
+ *         0 C after ITU-R P.840, in (dB/km)/(g/m3)
+ */
+double
+GetCloudCoefficient (double f)
+{
+  const double theta = 300 / 273.15;
+  double e0 = 77.66 + 103.3 * (theta - 1);
+  double e1 = 0.0671 * e0;
+  double e2 = 3.52;
+  double fp = 20.20 - 146 * (theta - 1) + 316 * (theta - 1) * (theta - 1);
+  double fs = 39.8 * fp;
+  double rp = 1 + (f / fp) * (f / fp);
+  double rs = 1 + (f / fs) * (f / fs);
+  double real = (e0 - e1) / rp + (e1 - e2) / rs + e2;
+  double imaginary = f * (e0 - e1) / (fp * rp) + f * (e1 - e2) / (fs * rs);
+  double eta = (2 + real) / imaginary;
+  return 0.819 * f / (imaginary * (1 + eta * eta));
+}
+
+} // anonymous namespace
+
+TypeId
+WeatherAttenuation::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::WeatherAttenuation")
+    .SetParent<Object> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<WeatherAttenuation> ()
+    .AddAttribute ("Offset",
+                   "Time in the record that simulation time zero maps to.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&WeatherAttenuation::m_offset),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+WeatherAttenuation::WeatherAttenuation ()
+  : m_stations (0),
+    m_samples (0),
+    m_start (0),
+    m_interval (0),
+    m_frequency (0),
+    m_rain (0),
+    m_cloud (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+WeatherAttenuation::~WeatherAttenuation ()
+{
+}
+
+void
+WeatherAttenuation::DoDispose (void)
+{
+  m_file.Close ();
+  m_rain = 0;
+  m_cloud = 0;
+  Object::DoDispose ();
+}
+
+bool
+WeatherAttenuation::Open (const std::string &filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  MappedFile file;
+  if (!file.Open (filename, sizeof (WeatherHeader)))
+    {
+      return false;
+    }
+
+  const WeatherHeader *header = static_cast<const WeatherHeader *> (file.GetData ());
+  bool valid = std::memcmp (header->magic, WEATHER_MAGIC, sizeof (header->magic)) == 0
+    && header->columns == WEATHER_COLUMNS
+    && header->stations > 0
+    && header->samples > 0
+    && header->interval > 0
+    && file.GetSize () == GetFileSize (header->stations, header->samples);
+  if (!valid)
+    {
+      NS_LOG_WARN ("Weather file " << filename << " is not well formed");
+      return false;
+    }
+
+  m_file.Swap (file);
+  m_stations = header->stations;
+  m_samples = header->samples;
+  m_start = header->start;
+  m_interval = header->interval;
+  m_frequency = header->frequency;
+  m_rain = reinterpret_cast<const float *> (header + 1);
+  m_cloud = m_rain + static_cast<uint64_t> (m_stations) * m_samples;
+  return true;
+}
+
+uint32_t
+WeatherAttenuation::GetNStations (void) const
+{
+  return m_stations;
+}
+
+uint64_t
+WeatherAttenuation::GetNSamples (void) const
+{
+  return m_samples;
+}
+
+double
+WeatherAttenuation::GetStart (void) const
+{
+  return m_start;
+}
+
+double
+WeatherAttenuation::GetInterval (void) const
+{
+  return m_interval;
+}
+
+double
+WeatherAttenuation::GetFrequency (void) const
+{
+  return m_frequency;
+}
+
+double
+WeatherAttenuation::GetRain (uint32_t station, Time t) const
+{
+  return Lookup (m_rain, station, t);
+}
+
+double
+WeatherAttenuation::GetCloud (uint32_t station, Time t) const
+{
+  return Lookup (m_cloud, station, t);
+}
+
+double
+WeatherAttenuation::GetAttenuation (uint32_t station, Time t) const
+{
+  return Lookup (m_rain, station, t) + Lookup (m_cloud, station, t);
+}
+
+double
+WeatherAttenuation::GetAttenuation (uint32_t station, Time t, double frequency) const
+{
+  if (frequency == m_frequency)
+    {
+      return GetAttenuation (station, t);
+    }
+  double f1 = m_frequency * 1e-9;
+  double f2 = frequency * 1e-9;
+  NS_ABORT_MSG_IF (f1 < RAIN_SCALING_MIN || f1 > RAIN_SCALING_MAX || f2 < RAIN_SCALING_MIN || f2 > RAIN_SCALING_MAX,
+                   "The weather record holds for " << f1 << " GHz and cannot be scaled to "
+                   << f2 << " GHz, outside the " << RAIN_SCALING_MIN << "-" << RAIN_SCALING_MAX
+                   << " GHz range of ITU-R P.618");
+  double rain = Lookup (m_rain, station, t);
+  if (rain > 0)
+    {
+      double phi1 = GetRainPhi (f1);
+      double ratio = GetRainPhi (f2) / phi1;
+      double h = 1.12e-3 * std::sqrt (ratio) * std::pow (phi1 * rain, 0.55);
+      rain *= std::pow (ratio, 1 - h);
+    }
+  double cloud = Lookup (m_cloud, station, t) * GetCloudCoefficient (f2) / GetCloudCoefficient (f1);
+  return rain + cloud;
+}
+
+double
+WeatherAttenuation::Lookup (const float *column, uint32_t station, Time t) const
+{
+  NS_ASSERT_MSG (m_file.IsOpen (), "No weather file is open");
+  NS_ASSERT_MSG (station < m_stations, "No station " << station << " in the weather file");
+  const float *values = column + station * m_samples;
+  double x = ((t + m_offset).GetSeconds () - m_start) / m_interval;
+  if (!(x > 0))
+    {
+      return values[0];
+    }
+  if (x >= m_samples - 1)
+    {
+      return values[m_samples - 1];
+    }
+  uint64_t i = static_cast<uint64_t> (x);
+  double f = x - i;
+  return values[i] + f * (values[i + 1] - values[i]);
+}
+
+WeatherAttenuationWriter::WeatherAttenuationWriter ()
+  : m_stations (0),
+    m_samples (0),
+    m_rain (0),
+    m_cloud (0)
+{
+}
+
+WeatherAttenuationWriter::~WeatherAttenuationWriter ()
+{
+  Close ();
+}
+
+bool
+WeatherAttenuationWriter::Open (const std::string &filename, uint32_t stations, uint64_t samples,
+                                double start, double interval, double frequency)
+{
+  NS_LOG_FUNCTION (this << filename << stations << samples << start << interval << frequency);
+  NS_ASSERT (stations > 0 && samples > 0 && interval > 0);
+  Close ();
+  if (!m_file.Create (filename, GetFileSize (stations, samples)))
+    {
+      NS_LOG_WARN ("Cannot create weather file " << filename);
+      return false;
+    }
+  m_stations = stations;
+  m_samples = samples;
+
+  WeatherHeader *header = static_cast<WeatherHeader *> (m_file.GetData ());
+  std::memcpy (header->magic, WEATHER_MAGIC, sizeof (header->magic));
+  header->stations = stations;
+  header->columns = WEATHER_COLUMNS;
+  header->samples = samples;
+  header->start = start;
+  header->interval = interval;
+  header->frequency = frequency;
+  m_rain = reinterpret_cast<float *> (header + 1);
+  m_cloud = m_rain + static_cast<uint64_t> (stations) * samples;
+  return true;
+}
+
+float *
+WeatherAttenuationWriter::GetRain (uint32_t station)
+{
+  NS_ASSERT (m_file.IsOpen () && station < m_stations);
+  return m_rain + station * m_samples;
+}
+
+float *
+WeatherAttenuationWriter::GetCloud (uint32_t station)
+{
+  NS_ASSERT (m_file.IsOpen () && station < m_stations);
+  return m_cloud + station * m_samples;
+}
+
+void
+WeatherAttenuationWriter::Close (void)
+{
+  if (m_file.IsOpen ())
+    {
+      NS_LOG_FUNCTION (this);
+      m_file.Close ();
+      m_rain = 0;
+      m_cloud = 0;
+    }
+}
+
+} // namespace ns3
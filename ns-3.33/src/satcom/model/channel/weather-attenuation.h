@@ -0,0 +1,205 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef WEATHER_ATTENUATION_H
+#define WEATHER_ATTENUATION_H
+
+#include <stdint.h>
+#include <string>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/mapped-file.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Rain and cloud attenuation time series of ground stations,
+ * served from a memory-mapped file.
+ *
+ * The file holds the zenith attenuation of every station at a fixed
+ * interval, typically years of weather data per site. It is mapped
+ * read-only and never parsed: a lookup computes the sample index from
+ * the time and interpolates between two values, so its cost does not
+ * depend on the length of the record and only the pages a run touches
+ * are read from disk. Offset shifts simulation time into the record,
+ * so successive runs can cover different periods of the same file.
+ * Before the first and after the last sample the edge value holds.
+ *
+ * Each column is station-major, so the record of one station is
+ * contiguous and a run reads it sequentially:
+ *
+ * \verbatim
+   char     magic[8]     "SATWXAT1"
+   uint32_t stations     number of stations
+   uint32_t columns      number of columns, 2
+   uint64_t samples      number of samples per station
+   double   start        time of the first sample in s
+   double   interval     sampling interval in s
+   double   frequency    carrier frequency the values hold for, in Hz
+   float    rain[stations * samples]    zenith rain attenuation in dB
+   float    cloud[stations * samples]   zenith cloud attenuation in dB
+   \endverbatim
+ *
+ * WeatherAttenuationWriter creates such files.
+ */
+class WeatherAttenuation : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  WeatherAttenuation ();
+  virtual ~WeatherAttenuation ();
+
+  /**
+   * \param filename the file to map
+   * \return true if the file exists and is well formed
+   */
+  bool Open (const std::string &filename);
+
+  /// \return the number of stations
+  uint32_t GetNStations (void) const;
+  /// \return the number of samples per station
+  uint64_t GetNSamples (void) const;
+  /// \return the time of the first sample in s
+  double GetStart (void) const;
+  /// \return the sampling interval in s
+  double GetInterval (void) const;
+  /// \return the carrier frequency the values hold for, in Hz
+  double GetFrequency (void) const;
+
+  /**
+   * \param station a station index in the file
+   * \param t a simulation time
+   * \return the zenith rain attenuation in dB
+   */
+  double GetRain (uint32_t station, Time t) const;
+
+  /**
+   * \param station a station index in the file
+   * \param t a simulation time
+   * \return the zenith cloud attenuation in dB
+   */
+  double GetCloud (uint32_t station, Time t) const;
+
+  /**
+   * \param station a station index in the file
+   * \param t a simulation time
+   * \return the zenith rain and cloud attenuation in dB
+   */
+  double GetAttenuation (uint32_t station, Time t) const;
+
+  /**
+   * \brief Attenuation at another carrier frequency than the record's
+   *
+   * Rain is scaled with the long-term frequency scaling of ITU-R P.618,
+   * which holds from 7 to 55 GHz; the simulation aborts if either
+   * frequency is outside that range. Cloud is scaled by the ratio of the
+   * liquid water coefficients of ITU-R P.840 at 0 C.
+   *
+   * \param station a station index in the file
+   * \param t a simulation time
+   * \param frequency the carrier frequency in Hz
+   * \return the zenith rain and cloud attenuation at frequency in dB
+   */
+  double GetAttenuation (uint32_t station, Time t, double frequency) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \param column a column of the mapping
+   * \param station a station index
+   * \param t a simulation time
+   * \return the value of the station at t, interpolated
+   */
+  double Lookup (const float *column, uint32_t station, Time t) const;
+
+  Time m_offset;                  //!< Record time of simulation time zero
+  MappedFile m_file;              //!< Mapped file, if open
+  uint32_t m_stations;            //!< Number of stations
+  uint64_t m_samples;             //!< Samples per station
+  double m_start;                 //!< Time of the first sample in s
+  double m_interval;              //!< Sampling interval in s
+  double m_frequency;             //!< Carrier frequency in Hz
+  const float *m_rain;            //!< Rain column
+  const float *m_cloud;           //!< Cloud column
+};
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Creates a file for WeatherAttenuation.
+ *
+ * The file is allocated for its whole size and mapped, and the columns
+ * are filled in place, so records longer than the memory can be
+ * written station by station.
+ */
+class WeatherAttenuationWriter
+{
+public:
+  WeatherAttenuationWriter ();
+  ~WeatherAttenuationWriter ();
+
+  /**
+   * \param filename the file to create
+   * \param stations the number of stations
+   * \param samples the number of samples per station
+   * \param start the time of the first sample in s
+   * \param interval the sampling interval in s
+   * \param frequency the carrier frequency the values hold for, in Hz
+   * \return true if the file could be created and mapped
+   */
+  bool Open (const std::string &filename, uint32_t stations, uint64_t samples,
+             double start, double interval, double frequency);
+
+  /**
+   * \param station a station index
+   * \return its samples of zenith rain attenuation in dB, to fill
+   */
+  float *GetRain (uint32_t station);
+
+  /**
+   * \param station a station index
+   * \return its samples of zenith cloud attenuation in dB, to fill
+   */
+  float *GetCloud (uint32_t station);
+
+  /// \brief Unmap the file, called on destruction if needed
+  void Close (void);
+
+private:
+  /// Not copyable, the columns live in a mapping
+  WeatherAttenuationWriter (const WeatherAttenuationWriter &);
+  /// Not copyable, the columns live in a mapping
+  WeatherAttenuationWriter & operator = (const WeatherAttenuationWriter &);
+
+  MappedFile m_file;              //!< Mapped file, if open
+  uint32_t m_stations;            //!< Number of stations
+  uint64_t m_samples;             //!< Samples per station
+  float *m_rain;                  //!< Rain column
+  float *m_cloud;                 //!< Cloud column
+};
+
+} // namespace ns3
+
+#endif /* WEATHER_ATTENUATION_H */
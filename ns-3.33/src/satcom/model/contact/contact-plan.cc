@@ -0,0 +1,418 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "contact-plan.h"
+#include "ns3/orbit-point-to-point-channel.h"
+#include "ns3/calculatedistance.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ContactPlan");
+
+NS_OBJECT_ENSURE_REGISTERED (ContactPlan);
+
+std::ostream &
+operator << (std::ostream &os, const ContactWindow &window)
+{
+  os << "satellite " << window.satellite
+     << " station " << window.station
+     << " [" << window.start.GetSeconds () << "s, " << window.end.GetSeconds () << "s]"
+     << " peak " << window.peakElevation << "deg at " << window.peakTime.GetSeconds () << "s";
+  return os;
+}
+
+/// Orders windows by start time, then by pair
+static bool
+WindowLess (const ContactWindow &a, const ContactWindow &b)
+{
+  if (a.start != b.start)
+    {
+      return a.start < b.start;
+    }
+  if (a.satellite != b.satellite)
+    {
+      return a.satellite < b.satellite;
+    }
+  return a.station < b.station;
+}
+
+TypeId
+ContactPlan::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ContactPlan")
+    .SetParent<Object> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<ContactPlan> ()
+    .AddAttribute ("SearchStep",
+                   "Step of the coarse scan used to bracket mask crossings. "
+                   "Must be shorter than the shortest pass of interest.",
+                   TimeValue (Seconds (60)),
+                   MakeTimeAccessor (&ContactPlan::m_searchStep),
+                   MakeTimeChecker (MilliSeconds (1)))
+    .AddAttribute ("Tolerance",
+                   "Accuracy of the window edges.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&ContactPlan::m_tolerance),
+                   MakeTimeChecker (NanoSeconds (1)))
+  ;
+  return tid;
+}
+
+ContactPlan::ContactPlan ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ContactPlan::~ContactPlan ()
+{
+}
+
+void
+ContactPlan::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_satellites.clear ();
+  m_stations.clear ();
+  m_windows.clear ();
+  Object::DoDispose ();
+}
+
+uint32_t
+ContactPlan::AddSatellite (Ptr<OrbitMobilityModel> orbit)
+{
+  NS_LOG_FUNCTION (this << orbit);
+  NS_ASSERT (orbit != 0);
+  m_satellites.push_back (orbit);
+  return m_satellites.size () - 1;
+}
+
+uint32_t
+ContactPlan::AddGroundStation (Ptr<MobilityModel> station, double elevationMask)
+{
+  NS_LOG_FUNCTION (this << station << elevationMask);
+  NS_ASSERT (station != 0);
+  Station s;
+  s.mobility = station;
+  s.mask = elevationMask;
+  m_stations.push_back (s);
+  return m_stations.size () - 1;
+}
+
+uint32_t
+ContactPlan::GetNSatellites (void) const
+{
+  return m_satellites.size ();
+}
+
+uint32_t
+ContactPlan::GetNGroundStations (void) const
+{
+  return m_stations.size ();
+}
+
+double
+ContactPlan::GetElevation (const Vector &station, const Vector &target)
+{
+  double r = std::sqrt (station.x * station.x + station.y * station.y + station.z * station.z);
+  NS_ASSERT_MSG (r > 0, "A ground station at the center of the Earth has no horizon");
+  double dx = target.x - station.x;
+  double dy = target.y - station.y;
+  double dz = target.z - station.z;
+  double d = std::sqrt (dx * dx + dy * dy + dz * dz);
+  if (d == 0)
+    {
+      return 90.0;
+    }
+  double sinEl = (dx * station.x + dy * station.y + dz * station.z) / (d * r);
+  sinEl = std::max (-1.0, std::min (1.0, sinEl));
+  return std::asin (sinEl) * 180.0 / M_PI;
+}
+
+Vector
+ContactPlan::GetPositionAt (Ptr<const MobilityModel> model, Time t)
+{
+  Ptr<const OrbitMobilityModel> orbit = DynamicCast<const OrbitMobilityModel> (model);
+  if (orbit != 0)
+    {
+      return orbit->GetPositionAt (t);
+    }
+  return model->GetPosition ();
+}
+
+double
+ContactPlan::Margin (uint32_t sat, uint32_t st, double t) const
+{
+  Vector s = m_satellites[sat]->GetPositionAt (Seconds (t));
+  Vector g = GetPositionAt (m_stations[st].mobility, Seconds (t));
+  return GetElevation (g, s) - m_stations[st].mask;
+}
+
+double
+ContactPlan::FindCrossing (uint32_t sat, uint32_t st, double a, double fa, double b, double fb) const
+{
+  // Illinois variant of regula falsi: keeps the bracket like bisection
+  // but converges superlinearly on the smooth elevation curve.
+  double tol = m_tolerance.GetSeconds ();
+  int side = 0;
+  for (uint32_t i = 0; i < 200 && (b - a) > tol; ++i)
+    {
+      double c = (a * fb - b * fa) / (fb - fa);
+      if (!(c > a && c < b))
+        {
+          c = 0.5 * (a + b);
+        }
+      double fc = Margin (sat, st, c);
+      if ((fc >= 0) == (fb >= 0))
+        {
+          b = c;
+          fb = fc;
+          if (side == -1)
+            {
+              fa /= 2;
+            }
+          side = -1;
+        }
+      else
+        {
+          a = c;
+          fa = fc;
+          if (side == 1)
+            {
+              fb /= 2;
+            }
+          side = 1;
+        }
+    }
+  return 0.5 * (a + b);
+}
+
+double
+ContactPlan::FindPeak (uint32_t sat, uint32_t st, double a, double b, double &peak) const
+{
+  // Golden-section search, the elevation is unimodal within one pass.
+  const double g = 0.5 * (std::sqrt (5.0) - 1.0);
+  double tol = m_tolerance.GetSeconds ();
+  double c = b - g * (b - a);
+  double d = a + g * (b - a);
+  double fc = Margin (sat, st, c);
+  double fd = Margin (sat, st, d);
+  while (b - a > tol)
+    {
+      if (fc > fd)
+        {
+          b = d;
+          d = c;
+          fd = fc;
+          c = b - g * (b - a);
+          fc = Margin (sat, st, c);
+        }
+      else
+        {
+          a = c;
+          c = d;
+          fc = fd;
+          d = a + g * (b - a);
+          fd = Margin (sat, st, d);
+        }
+    }
+  double t = 0.5 * (a + b);
+  peak = Margin (sat, st, t);
+  return t;
+}
+
+void
+ContactPlan::AddWindow (uint32_t sat, uint32_t st, double rise, double set, bool clipped)
+{
+  ContactWindow w;
+  w.satellite = sat;
+  w.station = st;
+  w.start = Seconds (rise);
+  w.end = Seconds (set);
+  double peak = 0;
+  w.peakTime = Seconds (FindPeak (sat, st, rise, set, peak));
+  w.peakElevation = peak + m_stations[st].mask;
+  w.clipped = clipped;
+  NS_LOG_LOGIC (w);
+  m_windows.push_back (w);
+}
+
+void
+ContactPlan::SampleMargins (uint32_t sat, double t, std::vector<double> &margin) const
+{
+  Vector s = m_satellites[sat]->GetPositionAt (Seconds (t));
+  for (uint32_t st = 0; st < m_stations.size (); ++st)
+    {
+      Vector g = GetPositionAt (m_stations[st].mobility, Seconds (t));
+      m_x[st] = g.x;
+      m_y[st] = g.y;
+      m_z[st] = g.z;
+    }
+  CalculateLinkGeometry (&m_x[0], &m_y[0], &m_z[0], m_stations.size (), s, 0, &margin[0], 0);
+  for (uint32_t st = 0; st < m_stations.size (); ++st)
+    {
+      margin[st] -= m_stations[st].mask;
+    }
+}
+
+void
+ContactPlan::ComputeSatellite (uint32_t sat, double start, double stop)
+{
+  uint32_t n = m_stations.size ();
+  double h = m_searchStep.GetSeconds ();
+  std::vector<double> f0 (n);
+  std::vector<double> f1 (n);
+  std::vector<double> fPrev (n);
+  std::vector<double> rise (n, start);
+  std::vector<bool> inside (n);
+  double t0 = start;
+  SampleMargins (sat, t0, f0);
+  for (uint32_t st = 0; st < n; ++st)
+    {
+      inside[st] = f0[st] >= 0;
+    }
+  double tPrev = t0;
+  bool havePrev = false;
+
+  while (t0 < stop)
+    {
+      double t1 = std::min (t0 + h, stop);
+      SampleMargins (sat, t1, f1);
+      for (uint32_t st = 0; st < n; ++st)
+        {
+          if (!inside[st] && f1[st] >= 0)
+            {
+              rise[st] = FindCrossing (sat, st, t0, f0[st], t1, f1[st]);
+              inside[st] = true;
+            }
+          else if (inside[st] && f1[st] < 0)
+            {
+              AddWindow (sat, st, rise[st], FindCrossing (sat, st, t0, f0[st], t1, f1[st]), false);
+              inside[st] = false;
+            }
+          else if (!inside[st] && havePrev && f0[st] > fPrev[st] && f0[st] > f1[st])
+            {
+              // A sampled local maximum below the mask: the true maximum
+              // may still clear it between the samples.
+              double peak = 0;
+              double tp = FindPeak (sat, st, tPrev, t1, peak);
+              if (peak >= 0)
+                {
+                  AddWindow (sat, st,
+                             FindCrossing (sat, st, tPrev, fPrev[st], tp, peak),
+                             FindCrossing (sat, st, tp, peak, t1, f1[st]), false);
+                }
+            }
+        }
+      tPrev = t0;
+      fPrev.swap (f0);
+      f0.swap (f1);
+      t0 = t1;
+      havePrev = true;
+    }
+  for (uint32_t st = 0; st < n; ++st)
+    {
+      if (inside[st])
+        {
+          AddWindow (sat, st, rise[st], stop, true);
+        }
+    }
+}
+
+void
+ContactPlan::Compute (Time start, Time stop)
+{
+  NS_LOG_FUNCTION (this << start << stop);
+  NS_ASSERT (start <= stop);
+  m_windows.clear ();
+  if (m_stations.empty ())
+    {
+      return;
+    }
+  m_x.resize (m_stations.size ());
+  m_y.resize (m_stations.size ());
+  m_z.resize (m_stations.size ());
+  for (uint32_t sat = 0; sat < m_satellites.size (); ++sat)
+    {
+      ComputeSatellite (sat, start.GetSeconds (), stop.GetSeconds ());
+    }
+  std::sort (m_windows.begin (), m_windows.end (), &WindowLess);
+  NS_LOG_INFO ("computed " << m_windows.size () << " contact windows");
+}
+
+const std::vector<ContactWindow> &
+ContactPlan::GetWindows (void) const
+{
+  return m_windows;
+}
+
+std::vector<ContactWindow>
+ContactPlan::GetWindows (uint32_t satellite, uint32_t station) const
+{
+  std::vector<ContactWindow> windows;
+  for (std::vector<ContactWindow>::const_iterator it = m_windows.begin (); it != m_windows.end (); ++it)
+    {
+      if (it->satellite == satellite && it->station == station)
+        {
+          windows.push_back (*it);
+        }
+    }
+  return windows;
+}
+
+bool
+ContactPlan::IsVisible (uint32_t satellite, uint32_t station, Time t) const
+{
+  for (std::vector<ContactWindow>::const_iterator it = m_windows.begin (); it != m_windows.end (); ++it)
+    {
+      if (it->start > t)
+        {
+          break;
+        }
+      if (it->satellite == satellite && it->station == station && t < it->end)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+ContactPlan::ScheduleLinkEvents (uint32_t satellite, uint32_t station,
+                                 Ptr<OrbitPointToPointChannel> channel) const
+{
+  NS_LOG_FUNCTION (this << satellite << station << channel);
+  Time now = Simulator::Now ();
+  channel->SetLinkUp (IsVisible (satellite, station, now));
+  std::vector<ContactWindow> windows = GetWindows (satellite, station);
+  for (std::vector<ContactWindow>::const_iterator it = windows.begin (); it != windows.end (); ++it)
+    {
+      if (it->start > now)
+        {
+          Simulator::Schedule (it->start - now, &OrbitPointToPointChannel::SetLinkUp, channel, true);
+        }
+      if (it->end > now && !it->clipped)
+        {
+          Simulator::Schedule (it->end - now, &OrbitPointToPointChannel::SetLinkUp, channel, false);
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,232 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CONTACT_PLAN_H
+#define CONTACT_PLAN_H
+
+#include <ostream>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/mobility-model.h"
+#include "ns3/orbit-mobility-model.h"
+
+namespace ns3 {
+
+class OrbitPointToPointChannel;
+
+/**
+ * \ingroup satcom
+ *
+ * \brief One interval during which a satellite is above the elevation
+ * mask of a ground station.
+ */
+struct ContactWindow
+{
+  uint32_t satellite;       //!< Satellite index in the ContactPlan
+  uint32_t station;         //!< Ground station index in the ContactPlan
+  Time start;               //!< Rise time (elevation crosses the mask upwards)
+  Time end;                 //!< Set time (elevation crosses the mask downwards)
+  Time peakTime;            //!< Time of maximum elevation
+  double peakElevation;     //!< Maximum elevation during the window, in degrees
+  bool clipped;             //!< Still open at the end of the planning horizon, which is then its end
+
+  /**
+   * \returns the duration of the window
+   */
+  Time GetDuration (void) const
+  {
+    return end - start;
+  }
+};
+
+std::ostream & operator << (std::ostream &os, const ContactWindow &window);
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Precomputes satellite / ground station visibility windows.
+ *
+ * The orbits are analytic, so the windows are found before the simulation
+ * starts: the elevation of every satellite/station pair is bracketed on a
+ * coarse "SearchStep" grid and each mask crossing is then refined by
+ * root-finding down to "Tolerance".  Each grid point evaluates the
+ * satellite once and all the stations in one CalculateLinkGeometry ()
+ * batch.  Passes that peak between two grid
+ * points without any sample above the mask are caught by maximizing the
+ * elevation around every sampled local maximum.
+ *
+ * Once computed, the plan can drive OrbitPointToPointChannel link states
+ * with exactly two events per window.
+ */
+class ContactPlan : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  ContactPlan ();
+  virtual ~ContactPlan ();
+
+  /**
+   * \param orbit the mobility model of a satellite
+   * \returns the satellite index
+   */
+  uint32_t AddSatellite (Ptr<OrbitMobilityModel> orbit);
+
+  /**
+   * \param station the mobility model of a ground station
+   * \param elevationMask the minimum usable elevation in degrees
+   * \returns the ground station index
+   */
+  uint32_t AddGroundStation (Ptr<MobilityModel> station, double elevationMask);
+
+  /**
+   * \returns the number of satellites
+   */
+  uint32_t GetNSatellites (void) const;
+
+  /**
+   * \returns the number of ground stations
+   */
+  uint32_t GetNGroundStations (void) const;
+
+  /**
+   * \brief Compute every window in [start, stop]
+   *
+   * Previously computed windows are discarded.
+   *
+   * \param start the beginning of the planning horizon
+   * \param stop the end of the planning horizon
+   */
+  void Compute (Time start, Time stop);
+
+  /**
+   * \returns all windows, sorted by start time
+   */
+  const std::vector<ContactWindow> & GetWindows (void) const;
+
+  /**
+   * \param satellite the satellite index
+   * \param station the ground station index
+   * \returns the windows of one pair, sorted by start time
+   */
+  std::vector<ContactWindow> GetWindows (uint32_t satellite, uint32_t station) const;
+
+  /**
+   * \param satellite the satellite index
+   * \param station the ground station index
+   * \param t an absolute simulation time
+   * \returns true if t falls into a window of the pair
+   */
+  bool IsVisible (uint32_t satellite, uint32_t station, Time t) const;
+
+  /**
+   * \brief Drive the link state of a channel from the windows of a pair
+   *
+   * The link state is set for the current time and toggled at each
+   * future window edge. A window still open at the end of the planning
+   * horizon leaves the link up.
+   *
+   * \param satellite the satellite index
+   * \param station the ground station index
+   * \param channel the channel between them
+   */
+  void ScheduleLinkEvents (uint32_t satellite, uint32_t station,
+                           Ptr<OrbitPointToPointChannel> channel) const;
+
+  /**
+   * \param station position of the observer
+   * \param target position of the observed object
+   * \returns the elevation of target above the local horizon of station
+   * (spherical Earth), in degrees
+   */
+  static double GetElevation (const Vector &station, const Vector &target);
+
+  /**
+   * \param model a mobility model
+   * \param t an absolute simulation time
+   * \returns the position of model at t; models that are not analytic
+   * are assumed to be fixed
+   */
+  static Vector GetPositionAt (Ptr<const MobilityModel> model, Time t);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// A ground station and its mask
+  struct Station
+  {
+    Ptr<MobilityModel> mobility;  //!< Position source
+    double mask;                  //!< Elevation mask in degrees
+  };
+
+  /**
+   * \param sat satellite index
+   * \param st station index
+   * \param t seconds of simulation time
+   * \returns elevation minus mask, in degrees
+   */
+  double Margin (uint32_t sat, uint32_t st, double t) const;
+
+  /**
+   * \brief Refine a sign change of Margin () in [a, b]
+   * \returns the crossing time in seconds
+   */
+  double FindCrossing (uint32_t sat, uint32_t st, double a, double fa, double b, double fb) const;
+
+  /**
+   * \brief Locate the maximum of Margin () in [a, b]
+   * \param [out] peak the maximum value
+   * \returns the time of the maximum in seconds
+   */
+  double FindPeak (uint32_t sat, uint32_t st, double a, double b, double &peak) const;
+
+  /**
+   * \brief Evaluate Margin () for every station at once
+   * \param sat satellite index
+   * \param t seconds of simulation time
+   * \param [out] margin elevation minus mask of each station, in degrees
+   */
+  void SampleMargins (uint32_t sat, double t, std::vector<double> &margin) const;
+
+  /// Compute the windows of one satellite with every station and append them to m_windows
+  void ComputeSatellite (uint32_t sat, double start, double stop);
+
+  /// Close a window that opened at rise and append it, clipped if the horizon closed it
+  void AddWindow (uint32_t sat, uint32_t st, double rise, double set, bool clipped);
+
+  Time m_searchStep;   //!< Bracketing step, shorter than the shortest pass
+  Time m_tolerance;    //!< Root-finding tolerance
+
+  std::vector<Ptr<OrbitMobilityModel> > m_satellites;  //!< Satellites
+  std::vector<Station> m_stations;                     //!< Ground stations
+  std::vector<ContactWindow> m_windows;                //!< Sorted windows
+
+  mutable std::vector<double> m_x;  //!< Station x coordinates of the current sample
+  mutable std::vector<double> m_y;  //!< Station y coordinates of the current sample
+  mutable std::vector<double> m_z;  //!< Station z coordinates of the current sample
+};
+
+} // namespace ns3
+
+#endif /* CONTACT_PLAN_H */
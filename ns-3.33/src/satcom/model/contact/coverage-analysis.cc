@@ -0,0 +1,541 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <unistd.h>
+
+#include "coverage-analysis.h"
+#include "ns3/boolean.h"
+#include "ns3/core-config.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/calculatedistance.h"
+#include "ns3/earth-rotation.h"
+#include "ns3/orbit-mobility-model.h"
+#include "ns3/satcom-constants.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CoverageAnalysis");
+
+NS_OBJECT_ENSURE_REGISTERED (CoverageAnalysis);
+
+namespace {
+
+/// Degrees to radians
+const double DEG = M_PI / 180.0;
+
+/**
+ * \param a a vector
+ * \param b another vector
+ * \return their dot product
+ */
+double
+Dot (const Vector &a, const Vector &b)
+{
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+/**
+ * \param a a contact window
+ * \param b another contact window
+ * \return whether a comes first by station, then satellite
+ */
+bool
+ByStationSatellite (const ContactWindow &a, const ContactWindow &b)
+{
+  return a.station != b.station ? a.station < b.station : a.satellite < b.satellite;
+}
+
+} // anonymous namespace
+
+TypeId
+CoverageAnalysis::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CoverageAnalysis")
+    .SetParent<Object> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<CoverageAnalysis> ()
+    .AddAttribute ("Start", "Time of the first sample.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&CoverageAnalysis::m_start),
+                   MakeTimeChecker ())
+    .AddAttribute ("Stop", "End of the analysis.",
+                   TimeValue (Days (1)),
+                   MakeTimeAccessor (&CoverageAnalysis::m_stop),
+                   MakeTimeChecker ())
+    .AddAttribute ("Step", "Sampling period of the orbits.",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&CoverageAnalysis::m_step),
+                   MakeTimeChecker (MilliSeconds (1)))
+    .AddAttribute ("Tolerance", "Accuracy of the contact rise and set times.",
+                   TimeValue (MilliSeconds (10)),
+                   MakeTimeAccessor (&CoverageAnalysis::m_tolerance),
+                   MakeTimeChecker (NanoSeconds (1)))
+    .AddAttribute ("MinElevation", "Lowest elevation, seen from a grid cell, "
+                   "at which it is imaged, in degrees.",
+                   DoubleValue (30),
+                   MakeDoubleAccessor (&CoverageAnalysis::m_minElevation),
+                   MakeDoubleChecker<double> (0, 90))
+    .AddAttribute ("MaxElevation", "Highest elevation, seen from a grid cell, "
+                   "at which it is imaged, in degrees.",
+                   DoubleValue (90),
+                   MakeDoubleAccessor (&CoverageAnalysis::m_maxElevation),
+                   MakeDoubleChecker<double> (0, 90))
+    .AddAttribute ("Inertial", "Whether the orbit models are inertial rather than Earth-fixed.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&CoverageAnalysis::m_inertial),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Threads", "Number of threads, 0 for one per core.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&CoverageAnalysis::m_threads),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("BlockSteps", "Number of steps sampled before the threads sweep them.",
+                   UintegerValue (8192),
+                   MakeUintegerAccessor (&CoverageAnalysis::m_blockSteps),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+CoverageAnalysis::CoverageAnalysis ()
+  : m_minLatitude (0),
+    m_minLongitude (0),
+    m_resolution (1),
+    m_rows (0),
+    m_columns (0),
+    m_wraps (false),
+    m_blockBegin (0),
+    m_nSteps (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CoverageAnalysis::~CoverageAnalysis ()
+{
+}
+
+void
+CoverageAnalysis::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_satellites.clear ();
+  Object::DoDispose ();
+}
+
+uint32_t
+CoverageAnalysis::AddSatellite (Ptr<OrbitMobilityModel> orbit)
+{
+  NS_LOG_FUNCTION (this << orbit);
+  m_satellites.push_back (orbit);
+  return m_satellites.size () - 1;
+}
+
+uint32_t
+CoverageAnalysis::AddGroundStation (double latitude, double longitude, double altitude,
+                                    double elevationMask)
+{
+  NS_LOG_FUNCTION (this << latitude << longitude << altitude << elevationMask);
+  double r = satcom::EARTH_RADIUS + altitude;
+  Station station;
+  station.position = Vector (r * std::cos (latitude * DEG) * std::cos (longitude * DEG),
+                             r * std::cos (latitude * DEG) * std::sin (longitude * DEG),
+                             r * std::sin (latitude * DEG));
+  station.mask = elevationMask;
+  m_stations.push_back (station);
+  m_stationX.push_back (station.position.x);
+  m_stationY.push_back (station.position.y);
+  m_stationZ.push_back (station.position.z);
+  return m_stations.size () - 1;
+}
+
+void
+CoverageAnalysis::SetGrid (double minLatitude, double maxLatitude, double minLongitude,
+                           double maxLongitude, double resolution)
+{
+  NS_LOG_FUNCTION (this << minLatitude << maxLatitude << minLongitude << maxLongitude << resolution);
+  NS_ASSERT (resolution > 0 && maxLatitude > minLatitude && maxLongitude > minLongitude);
+  m_minLatitude = minLatitude;
+  m_minLongitude = minLongitude;
+  m_resolution = resolution;
+  m_rows = static_cast<uint32_t> (std::ceil ((maxLatitude - minLatitude) / resolution - 1e-9));
+  m_columns = static_cast<uint32_t> (std::ceil ((maxLongitude - minLongitude) / resolution - 1e-9));
+  m_wraps = m_columns * resolution >= 360 - 1e-9;
+  m_cells.clear ();
+  for (uint32_t i = 0; i < m_rows; ++i)
+    {
+      double lat = (minLatitude + (i + 0.5) * resolution) * DEG;
+      for (uint32_t j = 0; j < m_columns; ++j)
+        {
+          double lon = (minLongitude + (j + 0.5) * resolution) * DEG;
+          m_cells.push_back (Vector (std::cos (lat) * std::cos (lon), std::cos (lat) * std::sin (lon),
+                                     std::sin (lat)));
+        }
+    }
+}
+
+Vector
+CoverageAnalysis::GetPosition (uint32_t sat, Time t) const
+{
+  Vector position = m_satellites[sat]->GetPositionAt (t);
+  return m_inertial ? EarthRotation::GetDefault ()->EciToEcef (position, t.GetSeconds ()) : position;
+}
+
+void
+CoverageAnalysis::Visit (Track &track, int64_t step)
+{
+  if (track.last == step)
+    {
+      return;
+    }
+  if (track.last < 0)
+    {
+      track.first = step;
+      track.runs = 1;
+    }
+  else if (track.last < step - 1)
+    {
+      int64_t gap = step - track.last;
+      track.runs++;
+      track.gaps++;
+      track.sumGap += gap;
+      track.maxGap = std::max (track.maxGap, gap);
+    }
+  track.visible++;
+  track.last = step;
+}
+
+void
+CoverageAnalysis::Join (Track &track, const Track &later)
+{
+  if (later.last < 0)
+    {
+      return;
+    }
+  if (track.last < 0)
+    {
+      track = later;
+      return;
+    }
+  int64_t gap = later.first - track.last;
+  track.runs += later.runs - (gap == 1 ? 1 : 0);
+  if (gap > 1)
+    {
+      track.gaps++;
+      track.sumGap += gap;
+      track.maxGap = std::max (track.maxGap, gap);
+    }
+  track.gaps += later.gaps;
+  track.sumGap += later.sumGap;
+  track.maxGap = std::max (track.maxGap, later.maxGap);
+  track.visible += later.visible;
+  track.last = later.last;
+}
+
+void
+CoverageAnalysis::Sweep (uint32_t index)
+{
+  Slice &slice = m_slices[index];
+  Track empty = { -1, -1, 0, 0, 0, 0, 0 };
+  slice.tracks.assign (m_cells.size (), empty);
+  slice.runs.clear ();
+  slice.open.assign (m_stations.size () * m_satellites.size (), -1);
+  slice.elevation.resize (m_stations.size ());
+
+  const double radius = satcom::EARTH_RADIUS;
+  const double sinMin2 = std::pow (std::sin (m_minElevation * DEG), 2);
+  const double sinMax2 = std::pow (std::sin (m_maxElevation * DEG), 2);
+  const double cosMin = std::cos (m_minElevation * DEG);
+  const uint32_t nSat = m_satellites.size ();
+  for (uint64_t k = slice.begin; k < slice.end; ++k)
+    {
+      const Vector *positions = &m_positions[(k - m_blockBegin) * nSat];
+      for (uint32_t sat = 0; sat < nSat; ++sat)
+        {
+          const Vector &p = positions[sat];
+          if (!m_stations.empty ())
+            {
+              CalculateLinkGeometry (&m_stationX[0], &m_stationY[0], &m_stationZ[0], m_stations.size (),
+                                     p, 0, &slice.elevation[0], 0);
+            }
+          for (uint32_t st = 0; st < m_stations.size (); ++st)
+            {
+              double elevation = slice.elevation[st];
+              if (elevation < m_stations[st].mask)
+                {
+                  continue;
+                }
+              int64_t &open = slice.open[st * nSat + sat];
+              if (open >= 0 && slice.runs[open].last == int64_t (k) - 1)
+                {
+                  Pass &run = slice.runs[open];
+                  run.last = k;
+                  if (elevation > run.peakElevation)
+                    {
+                      run.peakElevation = elevation;
+                      run.peakStep = k;
+                    }
+                }
+              else
+                {
+                  Pass run = { st, sat, int64_t (k), int64_t (k), int64_t (k), elevation };
+                  open = slice.runs.size ();
+                  slice.runs.push_back (run);
+                }
+            }
+          if (m_cells.empty ())
+            {
+              continue;
+            }
+
+          // Only the cells under the footprint of the satellite can see it
+          double r = p.GetLength ();
+          double lambda = (std::acos (radius / r * cosMin) - m_minElevation * DEG) / DEG;
+          double latitude = std::asin (p.z / r) / DEG;
+          double longitude = std::atan2 (p.y, p.x) / DEG;
+          int64_t row0 = std::max<int64_t> (0, std::floor ((latitude - lambda - m_minLatitude) / m_resolution));
+          int64_t row1 = std::min<int64_t> (m_rows - 1, std::floor ((latitude + lambda - m_minLatitude) / m_resolution));
+          bool polar = std::fabs (latitude) + lambda >= 90;
+          for (int64_t i = row0; i <= row1; ++i)
+            {
+              double cosLatitude = std::cos ((m_minLatitude + (i + 0.5) * m_resolution) * DEG);
+              int64_t column0 = 0;
+              int64_t column1 = m_columns - 1;
+              double sinLambda = std::sin (lambda * DEG);
+              if (!polar && sinLambda < cosLatitude)
+                {
+                  double width = std::asin (sinLambda / cosLatitude) / DEG + m_resolution;
+                  column0 = std::floor ((longitude - width - m_minLongitude) / m_resolution);
+                  column1 = std::floor ((longitude + width - m_minLongitude) / m_resolution);
+                  if (m_wraps && column1 - column0 >= m_columns)
+                    {
+                      column0 = 0;
+                      column1 = m_columns - 1;
+                    }
+                }
+              for (int64_t c = column0; c <= column1; ++c)
+                {
+                  int64_t j = c;
+                  if (m_wraps)
+                    {
+                      j = ((c % m_columns) + m_columns) % m_columns;
+                    }
+                  else if (j < 0 || j >= m_columns)
+                    {
+                      continue;
+                    }
+                  uint32_t cell = i * m_columns + j;
+                  // sin (elevation) = up / range, compared squared
+                  const Vector &u = m_cells[cell];
+                  Vector d = Vector (p.x - radius * u.x, p.y - radius * u.y, p.z - radius * u.z);
+                  double up = Dot (d, u);
+                  double range2 = Dot (d, d);
+                  if (up >= 0 && up * up >= sinMin2 * range2 && up * up <= sinMax2 * range2)
+                    {
+                      Visit (slice.tracks[cell], k);
+                    }
+                }
+            }
+        }
+    }
+}
+
+Time
+CoverageAnalysis::Refine (uint32_t station, uint32_t sat, Time below, Time above) const
+{
+  const Station &s = m_stations[station];
+  while (Abs (above - below) > m_tolerance)
+    {
+      Time middle = below + (above - below) / 2;
+      double elevation = ContactPlan::GetElevation (s.position, GetPosition (sat, middle));
+      (elevation >= s.mask ? above : below) = middle;
+    }
+  return above;
+}
+
+void
+CoverageAnalysis::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_stop > m_start, "Empty analysis period");
+  NS_ASSERT_MSG (!m_satellites.empty (), "No satellite");
+  uint32_t threads = m_threads;
+  if (threads == 0)
+    {
+      long cores = sysconf (_SC_NPROCESSORS_ONLN);
+      threads = cores > 0 ? cores : 1;
+    }
+#ifndef HAVE_PTHREAD_H
+  threads = 1;
+#endif
+
+  const uint32_t nSat = m_satellites.size ();
+  m_nSteps = (m_stop - m_start).GetTimeStep () / m_step.GetTimeStep () + 1;
+  Track empty = { -1, -1, 0, 0, 0, 0, 0 };
+  m_tracks.assign (m_cells.size (), empty);
+  std::vector<Pass> runs;
+  std::vector<int64_t> open (m_stations.size () * nSat, -1);
+
+  for (m_blockBegin = 0; m_blockBegin < m_nSteps; m_blockBegin += m_blockSteps)
+    {
+      uint64_t blockEnd = std::min<uint64_t> (m_nSteps, m_blockBegin + m_blockSteps);
+      m_positions.resize ((blockEnd - m_blockBegin) * nSat);
+      for (uint64_t k = m_blockBegin; k < blockEnd; ++k)
+        {
+          Time t = m_start + m_step * int64_t (k);
+          for (uint32_t sat = 0; sat < nSat; ++sat)
+            {
+              m_positions[(k - m_blockBegin) * nSat + sat] = GetPosition (sat, t);
+            }
+        }
+
+      uint32_t nSlices = std::min<uint64_t> (threads, blockEnd - m_blockBegin);
+      m_slices.resize (nSlices);
+      for (uint32_t i = 0; i < nSlices; ++i)
+        {
+          m_slices[i].begin = m_blockBegin + (blockEnd - m_blockBegin) * i / nSlices;
+          m_slices[i].end = m_blockBegin + (blockEnd - m_blockBegin) * (i + 1) / nSlices;
+        }
+#ifdef HAVE_PTHREAD_H
+      std::vector<Ptr<SystemThread> > workers;
+      for (uint32_t i = 1; i < nSlices; ++i)
+        {
+          workers.push_back (Create<SystemThread> (MakeCallback (&CoverageAnalysis::Sweep, this).Bind (i)));
+          workers.back ()->Start ();
+        }
+      Sweep (0);
+      for (uint32_t i = 0; i < workers.size (); ++i)
+        {
+          workers[i]->Join ();
+        }
+#else
+      Sweep (0);
+#endif
+
+      // Join the slices in time order
+      for (uint32_t i = 0; i < nSlices; ++i)
+        {
+          const Slice &slice = m_slices[i];
+          for (uint32_t cell = 0; cell < m_cells.size (); ++cell)
+            {
+              Join (m_tracks[cell], slice.tracks[cell]);
+            }
+          for (std::vector<Pass>::const_iterator it = slice.runs.begin (); it != slice.runs.end (); ++it)
+            {
+              int64_t &o = open[it->station * nSat + it->satellite];
+              if (o >= 0 && runs[o].last == it->first - 1)
+                {
+                  runs[o].last = it->last;
+                  if (it->peakElevation > runs[o].peakElevation)
+                    {
+                      runs[o].peakElevation = it->peakElevation;
+                      runs[o].peakStep = it->peakStep;
+                    }
+                }
+              else
+                {
+                  o = runs.size ();
+                  runs.push_back (*it);
+                }
+            }
+        }
+    }
+  m_positions.clear ();
+  m_slices.clear ();
+
+  m_contacts.clear ();
+  for (std::vector<Pass>::const_iterator it = runs.begin (); it != runs.end (); ++it)
+    {
+      ContactWindow window;
+      window.satellite = it->satellite;
+      window.station = it->station;
+      Time first = m_start + m_step * it->first;
+      Time last = m_start + m_step * it->last;
+      window.start = it->first == 0 ? first : Refine (it->station, it->satellite, first - m_step, first);
+      window.end = uint64_t (it->last) == m_nSteps - 1
+        ? last : Refine (it->station, it->satellite, last + m_step, last);
+      window.peakTime = m_start + m_step * it->peakStep;
+      window.peakElevation = it->peakElevation;
+      window.clipped = uint64_t (it->last) == m_nSteps - 1;
+      m_contacts.push_back (window);
+    }
+  std::stable_sort (m_contacts.begin (), m_contacts.end (), ByStationSatellite);
+  NS_LOG_INFO (m_nSteps << " steps of " << nSat << " satellites on " << threads << " threads: "
+               << m_contacts.size () << " contacts, " << m_cells.size () << " cells");
+}
+
+uint32_t
+CoverageAnalysis::GetNCells (void) const
+{
+  return m_cells.size ();
+}
+
+CoverageAnalysis::Cell
+CoverageAnalysis::GetCell (uint32_t i) const
+{
+  NS_ASSERT (i < m_cells.size () && i < m_tracks.size ());
+  const Track &track = m_tracks[i];
+  Cell cell;
+  cell.latitude = m_minLatitude + (i / m_columns + 0.5) * m_resolution;
+  cell.longitude = m_minLongitude + (i % m_columns + 0.5) * m_resolution;
+  cell.coverage = m_nSteps > 0 ? double (track.visible) / m_nSteps : 0;
+  cell.accesses = track.runs;
+  cell.firstAccess = track.first < 0 ? Time (-1) : m_start + m_step * track.first;
+  cell.meanRevisit = track.gaps > 0 ? m_step * track.sumGap / int64_t (track.gaps) : Time (0);
+  cell.maxRevisit = m_step * track.maxGap;
+  return cell;
+}
+
+const std::vector<ContactWindow> &
+CoverageAnalysis::GetContacts (void) const
+{
+  return m_contacts;
+}
+
+void
+CoverageAnalysis::WriteGrid (std::string filename) const
+{
+  std::ofstream os (filename.c_str ());
+  os << "latitude,longitude,coverage,accesses,firstAccess,meanRevisit,maxRevisit" << std::endl;
+  for (uint32_t i = 0; i < GetNCells (); ++i)
+    {
+      Cell cell = GetCell (i);
+      os << cell.latitude << "," << cell.longitude << "," << cell.coverage << "," << cell.accesses
+         << "," << cell.firstAccess.GetSeconds () << "," << cell.meanRevisit.GetSeconds () << ","
+         << cell.maxRevisit.GetSeconds () << std::endl;
+    }
+}
+
+void
+CoverageAnalysis::WriteContacts (std::string filename) const
+{
+  std::ofstream os (filename.c_str ());
+  os << "station,satellite,start,end,duration,peakTime,peakElevation" << std::endl;
+  for (std::vector<ContactWindow>::const_iterator it = m_contacts.begin (); it != m_contacts.end (); ++it)
+    {
+      os << it->station << "," << it->satellite << "," << it->start.GetSeconds () << ","
+         << it->end.GetSeconds () << "," << it->GetDuration ().GetSeconds () << ","
+         << it->peakTime.GetSeconds () << "," << it->peakElevation << std::endl;
+    }
+}
+
+} // namespace ns3
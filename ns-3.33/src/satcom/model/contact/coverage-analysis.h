@@ -0,0 +1,251 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef COVERAGE_ANALYSIS_H
+#define COVERAGE_ANALYSIS_H
+
+#include <string>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/contact-plan.h"
+
+namespace ns3 {
+
+class OrbitMobilityModel;
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Imaging coverage, revisit and ground station contact analysis
+ * from the orbit models alone, without running a simulation.
+ *
+ * The orbits are sampled every Step from Start to Stop, in blocks.
+ * Within a block the time steps are cut into one slice per thread;
+ * each thread sweeps its slice, visiting only the grid cells under
+ * the footprint of each satellite (as GroundStationIndex does), and
+ * summarizes every cell and contact by its first and last visible
+ * step, so that the slices are then joined in time order. The station
+ * elevations of each sample are computed in one CalculateLinkGeometry ()
+ * batch. The orbit models are only called from the calling thread, to sample a block
+ * before the threads start and to refine contact edges afterwards.
+ *
+ * A grid cell is imaged while a satellite is seen from it between
+ * MinElevation and MaxElevation, the incidence range of a side-looking
+ * SAR; its revisit gaps are the times between two accesses. Contacts
+ * are windows above the station's elevation mask, whose rise and set
+ * are refined to Tolerance by bisection; the other statistics are
+ * exact to one Step.
+ *
+ * Satellite positions are taken as Earth-fixed, as those of the
+ * default SarOrbitMobilityModel, unless Inertial is set, in which case
+ * they are rotated by the default EarthRotation.
+ */
+class CoverageAnalysis : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  CoverageAnalysis ();
+  virtual ~CoverageAnalysis ();
+
+  /// Coverage statistics of one grid cell
+  struct Cell
+  {
+    double latitude;        //!< Cell centre latitude, degrees
+    double longitude;       //!< Cell centre longitude, degrees
+    double coverage;        //!< Fraction of the samples imaged
+    uint32_t accesses;      //!< Number of distinct accesses
+    Time firstAccess;       //!< Start of the first access, if any
+    Time meanRevisit;       //!< Mean gap between accesses
+    Time maxRevisit;        //!< Longest gap between accesses
+  };
+
+  /**
+   * \param orbit the mobility model of a satellite
+   * \return the satellite index
+   */
+  uint32_t AddSatellite (Ptr<OrbitMobilityModel> orbit);
+
+  /**
+   * \param latitude geocentric latitude in degrees
+   * \param longitude longitude in degrees, east positive
+   * \param altitude height above the sphere in m
+   * \param elevationMask the minimum usable elevation in degrees
+   * \return the ground station index
+   */
+  uint32_t AddGroundStation (double latitude, double longitude, double altitude,
+                             double elevationMask);
+
+  /**
+   * \brief Set the imaging grid, empty by default
+   * \param minLatitude southern edge in degrees
+   * \param maxLatitude northern edge in degrees
+   * \param minLongitude western edge in degrees
+   * \param maxLongitude eastern edge in degrees
+   * \param resolution cell size in degrees
+   */
+  void SetGrid (double minLatitude, double maxLatitude, double minLongitude,
+                double maxLongitude, double resolution);
+
+  /// \brief Sample the orbits and compute every statistic
+  void Run (void);
+
+  /// \return the number of grid cells
+  uint32_t GetNCells (void) const;
+
+  /**
+   * \param i a cell index, latitude rows from the south
+   * \return the statistics of the cell
+   */
+  Cell GetCell (uint32_t i) const;
+
+  /**
+   * \return the contact windows, by station, satellite and time
+   */
+  const std::vector<ContactWindow> &GetContacts (void) const;
+
+  /**
+   * \param filename a CSV file for the grid statistics
+   */
+  void WriteGrid (std::string filename) const;
+
+  /**
+   * \param filename a CSV file for the contact windows
+   */
+  void WriteContacts (std::string filename) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// Visibility summary of a cell over a range of steps
+  struct Track
+  {
+    int64_t first;          //!< First visible step, -1 if none
+    int64_t last;           //!< Last visible step, -1 if none
+    uint64_t visible;       //!< Number of visible steps
+    uint32_t runs;          //!< Number of runs of visible steps
+    uint32_t gaps;          //!< Number of gaps between runs
+    int64_t sumGap;         //!< Total steps from the end of a run to the next
+    int64_t maxGap;         //!< Most steps from the end of a run to the next
+  };
+
+  /// A ground station
+  struct Station
+  {
+    Vector position;        //!< Earth-fixed position
+    double mask;            //!< Elevation mask, degrees
+  };
+
+  /// Contact runs of one thread, in step units
+  struct Pass
+  {
+    uint32_t station;       //!< Station index
+    uint32_t satellite;     //!< Satellite index
+    int64_t first;          //!< First visible step
+    int64_t last;           //!< Last visible step
+    int64_t peakStep;       //!< Step of the highest elevation
+    double peakElevation;   //!< Highest elevation, degrees
+  };
+
+  /// Work of one thread over a slice of a block
+  struct Slice
+  {
+    uint64_t begin;                 //!< First step
+    uint64_t end;                   //!< Past the last step
+    std::vector<Track> tracks;      //!< Per cell
+    std::vector<Pass> runs;         //!< Contact runs by start
+    std::vector<int64_t> open;      //!< Open run per pair, -1 if none
+    std::vector<double> elevation;  //!< Station elevations of the current sample
+  };
+
+  /**
+   * \param sat a satellite index
+   * \param t an absolute simulation time
+   * \return its Earth-fixed position
+   */
+  Vector GetPosition (uint32_t sat, Time t) const;
+
+  /**
+   * \brief Sweep the steps of a slice, called by its thread
+   * \param slice the slice index
+   */
+  void Sweep (uint32_t slice);
+
+  /**
+   * \param track the summary of a cell
+   * \param step a step it is visible at
+   */
+  static void Visit (Track &track, int64_t step);
+
+  /**
+   * \param track a summary to extend
+   * \param later the summary of the following steps
+   */
+  static void Join (Track &track, const Track &later);
+
+  /**
+   * \brief Find an elevation crossing of a pair by bisection
+   * \param station the station index
+   * \param sat the satellite index
+   * \param below a time below the mask
+   * \param above a time above the mask
+   * \return the crossing time
+   */
+  Time Refine (uint32_t station, uint32_t sat, Time below, Time above) const;
+
+  Time m_start;                        //!< First sample
+  Time m_stop;                         //!< End of the analysis
+  Time m_step;                         //!< Sampling period
+  Time m_tolerance;                    //!< Contact edge accuracy
+  double m_minElevation;               //!< Lowest imaging elevation, degrees
+  double m_maxElevation;               //!< Highest imaging elevation, degrees
+  bool m_inertial;                     //!< Whether the orbits are inertial
+  uint32_t m_threads;                  //!< Worker threads, 0 for one per core
+  uint32_t m_blockSteps;               //!< Steps sampled at once
+
+  std::vector<Ptr<OrbitMobilityModel> > m_satellites;  //!< Satellites
+  std::vector<Station> m_stations;     //!< Ground stations
+  std::vector<double> m_stationX;      //!< Station x coordinates, for the batch kernel
+  std::vector<double> m_stationY;      //!< Station y coordinates, for the batch kernel
+  std::vector<double> m_stationZ;      //!< Station z coordinates, for the batch kernel
+
+  double m_minLatitude;                //!< Grid southern edge, degrees
+  double m_minLongitude;               //!< Grid western edge, degrees
+  double m_resolution;                 //!< Cell size, degrees
+  uint32_t m_rows;                     //!< Latitude rows
+  uint32_t m_columns;                  //!< Longitude columns
+  bool m_wraps;                        //!< Whether the grid spans all longitudes
+  std::vector<Vector> m_cells;         //!< Unit vector of each cell centre
+
+  uint64_t m_blockBegin;               //!< First step of the sampled block
+  std::vector<Vector> m_positions;     //!< Block samples, by step then satellite
+  std::vector<Slice> m_slices;         //!< Slices of the block
+
+  uint64_t m_nSteps;                   //!< Steps of the last run
+  std::vector<Track> m_tracks;         //!< Per-cell results
+  std::vector<ContactWindow> m_contacts;  //!< Contact windows
+};
+
+} // namespace ns3
+
+#endif /* COVERAGE_ANALYSIS_H */
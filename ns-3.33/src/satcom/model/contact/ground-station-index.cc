@@ -0,0 +1,261 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "ground-station-index.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("GroundStationIndex");
+
+NS_OBJECT_ENSURE_REGISTERED (GroundStationIndex);
+
+TypeId
+GroundStationIndex::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::GroundStationIndex")
+    .SetParent<Object> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<GroundStationIndex> ()
+    .AddAttribute ("CellSize",
+                   "Size of the latitude/longitude buckets in degrees.",
+                   DoubleValue (2.0),
+                   MakeDoubleAccessor (&GroundStationIndex::m_cellSize),
+                   MakeDoubleChecker<double> (0.1, 90.0))
+  ;
+  return tid;
+}
+
+GroundStationIndex::GroundStationIndex ()
+  : m_cellSize (2.0),
+    m_minRadius (0),
+    m_maxRadius (0),
+    m_minMask (M_PI / 2),
+    m_dirty (true),
+    m_rows (0),
+    m_cols (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+GroundStationIndex::~GroundStationIndex ()
+{
+}
+
+uint32_t
+GroundStationIndex::Add (const Vector &position, double elevationMask)
+{
+  NS_LOG_FUNCTION (this << position << elevationMask);
+  double r = std::sqrt (position.x * position.x + position.y * position.y + position.z * position.z);
+  NS_ASSERT_MSG (r > 0, "A ground station at the center of the Earth has no horizon");
+  double mask = elevationMask * M_PI / 180.0;
+
+  m_x.push_back (position.x);
+  m_y.push_back (position.y);
+  m_z.push_back (position.z);
+  m_ux.push_back (position.x / r);
+  m_uy.push_back (position.y / r);
+  m_uz.push_back (position.z / r);
+  m_sinMask.push_back (std::sin (mask));
+  m_minRadius = m_x.size () == 1 ? r : std::min (m_minRadius, r);
+  m_maxRadius = std::max (m_maxRadius, r);
+  m_minMask = std::min (m_minMask, mask);
+  m_dirty = true;
+  return m_x.size () - 1;
+}
+
+uint32_t
+GroundStationIndex::GetN (void) const
+{
+  return m_x.size ();
+}
+
+Vector
+GroundStationIndex::GetPosition (uint32_t i) const
+{
+  NS_ASSERT (i < m_x.size ());
+  return Vector (m_x[i], m_y[i], m_z[i]);
+}
+
+void
+GroundStationIndex::Build (void) const
+{
+  NS_LOG_FUNCTION (this);
+  m_rows = static_cast<uint32_t> (std::ceil (180.0 / m_cellSize));
+  m_cols = static_cast<uint32_t> (std::ceil (360.0 / m_cellSize));
+  uint32_t nCells = m_rows * m_cols;
+
+  // Counting sort of the stations by cell
+  std::vector<uint32_t> cellOf (m_x.size ());
+  m_cellStart.assign (nCells + 1, 0);
+  for (uint32_t i = 0; i < m_x.size (); ++i)
+    {
+      double lat = std::asin (std::max (-1.0, std::min (1.0, m_uz[i]))) * 180.0 / M_PI;
+      double lon = std::atan2 (m_uy[i], m_ux[i]) * 180.0 / M_PI;
+      uint32_t row = std::min (m_rows - 1, static_cast<uint32_t> ((lat + 90.0) / m_cellSize));
+      uint32_t col = std::min (m_cols - 1, static_cast<uint32_t> ((lon + 180.0) / m_cellSize));
+      cellOf[i] = row * m_cols + col;
+      m_cellStart[cellOf[i] + 1]++;
+    }
+  for (uint32_t c = 0; c < nCells; ++c)
+    {
+      m_cellStart[c + 1] += m_cellStart[c];
+    }
+  m_items.resize (m_x.size ());
+  std::vector<uint32_t> fill (m_cellStart.begin (), m_cellStart.end () - 1);
+  for (uint32_t i = 0; i < m_x.size (); ++i)
+    {
+      m_items[fill[cellOf[i]]++] = i;
+    }
+  m_dirty = false;
+}
+
+bool
+GroundStationIndex::IsVisible (uint32_t i, const Vector &satellite) const
+{
+  double dx = satellite.x - m_x[i];
+  double dy = satellite.y - m_y[i];
+  double dz = satellite.z - m_z[i];
+  double up = dx * m_ux[i] + dy * m_uy[i] + dz * m_uz[i];
+  double s = m_sinMask[i];
+  // up / |d| >= s without the square root
+  if (up < 0)
+    {
+      return s < 0 && up * up <= s * s * (dx * dx + dy * dy + dz * dz);
+    }
+  return s <= 0 || up * up >= s * s * (dx * dx + dy * dy + dz * dz);
+}
+
+void
+GroundStationIndex::QueryAll (const Vector &satellite, std::vector<uint32_t> &visible) const
+{
+  visible.clear ();
+  for (uint32_t i = 0; i < m_x.size (); ++i)
+    {
+      if (IsVisible (i, satellite))
+        {
+          visible.push_back (i);
+        }
+    }
+}
+
+void
+GroundStationIndex::Query (const Vector &satellite, std::vector<uint32_t> &visible) const
+{
+  visible.clear ();
+  if (m_x.empty ())
+    {
+      return;
+    }
+  if (m_dirty)
+    {
+      Build ();
+    }
+
+  double rs = std::sqrt (satellite.x * satellite.x + satellite.y * satellite.y + satellite.z * satellite.z);
+  if (rs <= m_maxRadius)
+    {
+      // Inside the station shell the cap bound does not hold
+      QueryAll (satellite, visible);
+      return;
+    }
+
+  // Earth central angle of the visibility cap, in degrees
+  double lambda = std::acos (std::min (1.0, m_minRadius / rs * std::cos (m_minMask))) - m_minMask;
+  if (lambda <= 0)
+    {
+      return;
+    }
+  lambda = lambda * 180.0 / M_PI + m_cellSize * 1e-9;
+  double lat = std::asin (satellite.z / rs) * 180.0 / M_PI;
+  double lon = std::atan2 (satellite.y, satellite.x) * 180.0 / M_PI;
+
+  double latMin = lat - lambda;
+  double latMax = lat + lambda;
+  int rowMin = std::max (0, static_cast<int> (std::floor ((latMin + 90.0) / m_cellSize)));
+  int rowMax = std::min (static_cast<int> (m_rows) - 1, static_cast<int> (std::floor ((latMax + 90.0) / m_cellSize)));
+
+  // Each row only visits the longitudes the cap spans within that row.
+  // The cap is widest at widestLat unless it covers a pole, in which
+  // case its width grows monotonically towards that pole.
+  bool coversPole = latMax >= 90.0 || latMin <= -90.0;
+  double lat0 = lat * M_PI / 180.0;
+  double lam = lambda * M_PI / 180.0;
+  double cosLam = std::cos (lam);
+  double sinLat0 = std::sin (lat0);
+  double cosLat0 = std::cos (lat0);
+  double widest = 180.0;
+  double widestLat = 0;
+  if (!coversPole)
+    {
+      widest = std::asin (std::min (1.0, std::sin (lam) / cosLat0)) * 180.0 / M_PI;
+      widestLat = std::asin (std::max (-1.0, std::min (1.0, sinLat0 / cosLam))) * 180.0 / M_PI;
+    }
+
+  for (int row = rowMin; row <= rowMax; ++row)
+    {
+      int colMin = 0;
+      int colCount = m_cols;
+      double rowLow = std::max (latMin, -90.0 + row * m_cellSize);
+      double rowHigh = std::min (latMax, -90.0 + (row + 1) * m_cellSize);
+      bool allCols = rowLow <= -90.0 || rowHigh >= 90.0;
+      double width = 180.0;
+      if (!allCols)
+        {
+          width = widest;
+          if (coversPole || widestLat < rowLow || widestLat > rowHigh)
+            {
+              width = 0;
+              double edges[2] = { rowLow, rowHigh };
+              for (int e = 0; e < 2; ++e)
+                {
+                  double phi = edges[e] * M_PI / 180.0;
+                  double c = (cosLam - std::sin (phi) * sinLat0) / (std::cos (phi) * cosLat0);
+                  double w = c >= 1.0 ? 0.0 : (c <= -1.0 ? 180.0 : std::acos (c) * 180.0 / M_PI);
+                  width = std::max (width, w);
+                }
+            }
+          width += m_cellSize * 1e-9;
+          allCols = width >= 180.0;
+        }
+      if (!allCols)
+        {
+          colMin = static_cast<int> (std::floor ((lon - width + 180.0) / m_cellSize));
+          int colMax = static_cast<int> (std::floor ((lon + width + 180.0) / m_cellSize));
+          colCount = std::min (static_cast<int> (m_cols), colMax - colMin + 1);
+        }
+      for (int k = 0; k < colCount; ++k)
+        {
+          int col = ((colMin + k) % static_cast<int> (m_cols) + m_cols) % m_cols;
+          uint32_t cell = row * m_cols + col;
+          for (uint32_t j = m_cellStart[cell]; j < m_cellStart[cell + 1]; ++j)
+            {
+              uint32_t i = m_items[j];
+              if (IsVisible (i, satellite))
+                {
+                  visible.push_back (i);
+                }
+            }
+        }
+    }
+  std::sort (visible.begin (), visible.end ());
+}
+
+} // namespace ns3
@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef GROUND_STATION_INDEX_H
+#define GROUND_STATION_INDEX_H
+
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Spatial index answering "which ground stations see this
+ * satellite?" without visiting every station.
+ *
+ * Stations are bucketed by the latitude/longitude of their local vertical
+ * on a grid of "CellSize" degrees.  A satellite at radius r can only be
+ * seen above an elevation mask e from within the Earth central angle
+ *
+ *   lambda = acos (R / r cos e) - e
+ *
+ * of its sub-satellite point, so a query only visits the grid cells
+ * covering that cap (using the smallest station radius and the lowest
+ * mask of the index) and runs the exact elevation test on their stations.
+ *
+ * Station and satellite positions must be expressed in the same
+ * Earth-fixed frame.
+ */
+class GroundStationIndex : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  GroundStationIndex ();
+  virtual ~GroundStationIndex ();
+
+  /**
+   * \param position the station position
+   * \param elevationMask the minimum usable elevation in degrees
+   * \returns the station index
+   */
+  uint32_t Add (const Vector &position, double elevationMask);
+
+  /**
+   * \returns the number of stations
+   */
+  uint32_t GetN (void) const;
+
+  /**
+   * \param i the station index
+   * \returns the station position
+   */
+  Vector GetPosition (uint32_t i) const;
+
+  /**
+   * \brief Find the stations that see a satellite above their mask
+   * \param satellite the satellite position
+   * \param visible the matching station indices, in increasing order;
+   * the vector is cleared first so callers can reuse its storage
+   */
+  void Query (const Vector &satellite, std::vector<uint32_t> &visible) const;
+
+  /**
+   * \brief Reference implementation of Query () visiting every station
+   * \param satellite the satellite position
+   * \param visible the matching station indices, in increasing order
+   */
+  void QueryAll (const Vector &satellite, std::vector<uint32_t> &visible) const;
+
+private:
+  /// Rebuild the buckets after stations were added
+  void Build (void) const;
+
+  /**
+   * \param i the station index
+   * \param satellite the satellite position
+   * \returns true if the satellite is above the mask of station i
+   */
+  bool IsVisible (uint32_t i, const Vector &satellite) const;
+
+  double m_cellSize;                //!< Grid cell size in degrees
+
+  // Stations, one entry per station
+  std::vector<double> m_x;          //!< Position x
+  std::vector<double> m_y;          //!< Position y
+  std::vector<double> m_z;          //!< Position z
+  std::vector<double> m_ux;         //!< Local vertical x
+  std::vector<double> m_uy;         //!< Local vertical y
+  std::vector<double> m_uz;         //!< Local vertical z
+  std::vector<double> m_sinMask;    //!< sin of the elevation mask
+  double m_minRadius;               //!< Smallest station radius
+  double m_maxRadius;               //!< Largest station radius
+  double m_minMask;                 //!< Lowest mask in rad
+
+  // Buckets in compressed row form, rebuilt lazily
+  mutable bool m_dirty;                      //!< Buckets are stale
+  mutable uint32_t m_rows;                   //!< Latitude cells
+  mutable uint32_t m_cols;                   //!< Longitude cells
+  mutable std::vector<uint32_t> m_cellStart; //!< First item of each cell
+  mutable std::vector<uint32_t> m_items;     //!< Station indices by cell
+};
+
+} // namespace ns3
+
+#endif /* GROUND_STATION_INDEX_H */
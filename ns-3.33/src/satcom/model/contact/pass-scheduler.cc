@@ -0,0 +1,511 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+
+#include "pass-scheduler.h"
+#include "ns3/orbit-point-to-point-channel.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PassScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (PassScheduler);
+
+std::ostream &
+operator << (std::ostream &os, const ScheduledPass &pass)
+{
+  os << "satellite " << pass.satellite
+     << " station " << pass.station
+     << " [" << pass.start.GetSeconds () << "s, " << pass.end.GetSeconds () << "s]"
+     << " " << pass.bytes << " bytes";
+  return os;
+}
+
+TypeId
+PassScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PassScheduler")
+    .SetParent<Object> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<PassScheduler> ()
+    .AddAttribute ("DataRate",
+                   "Downlink rate of the pairs without a rate of their own.",
+                   DataRateValue (DataRate ("334Mbps")),
+                   MakeDataRateAccessor (&PassScheduler::m_rate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("SetupTime",
+                   "Time a station antenna needs between two passes.",
+                   TimeValue (Seconds (60)),
+                   MakeTimeAccessor (&PassScheduler::m_setupTime),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("MinDuration",
+                   "Windows shorter than this are not assigned.",
+                   TimeValue (Seconds (60)),
+                   MakeTimeAccessor (&PassScheduler::m_minDuration),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("MaxRounds",
+                   "Rounds of the local search, 0 for the greedy schedule.",
+                   UintegerValue (20),
+                   MakeUintegerAccessor (&PassScheduler::m_maxRounds),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+PassScheduler::PassScheduler ()
+  : m_maxRounds (20),
+    m_greedy (0),
+    m_exchanges (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PassScheduler::~PassScheduler ()
+{
+}
+
+void
+PassScheduler::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_plan = 0;
+  m_candidates.clear ();
+  m_schedule.clear ();
+  Object::DoDispose ();
+}
+
+void
+PassScheduler::SetContactPlan (Ptr<ContactPlan> plan)
+{
+  m_plan = plan;
+}
+
+void
+PassScheduler::SetBacklog (uint32_t satellite, uint64_t bytes)
+{
+  m_backlog[satellite] = bytes;
+}
+
+void
+PassScheduler::SetGenerationRate (uint32_t satellite, DataRate rate)
+{
+  m_generation[satellite] = rate;
+}
+
+void
+PassScheduler::SetLinkRate (uint32_t satellite, uint32_t station, DataRate rate)
+{
+  m_linkRates[std::make_pair (satellite, station)] = rate;
+}
+
+void
+PassScheduler::SetAntennas (uint32_t station, uint32_t antennas)
+{
+  NS_ASSERT (antennas > 0);
+  m_antennas[station] = antennas;
+}
+
+void
+PassScheduler::Solve (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_plan != 0, "No contact plan to schedule");
+  m_candidates.clear ();
+  m_schedule.clear ();
+  m_exchanges = 0;
+
+  const std::vector<ContactWindow> &windows = m_plan->GetWindows ();
+  for (std::vector<ContactWindow>::const_iterator it = windows.begin (); it != windows.end (); ++it)
+    {
+      if (it->GetDuration () < m_minDuration)
+        {
+          continue;
+        }
+      std::map<std::pair<uint32_t, uint32_t>, DataRate>::const_iterator rate =
+        m_linkRates.find (std::make_pair (it->satellite, it->station));
+      Candidate c;
+      c.window = *it;
+      c.capacity = (rate != m_linkRates.end () ? rate->second : m_rate).GetBitRate ()
+        * it->GetDuration ().GetSeconds () / 8;
+      c.planned = 0;
+      c.selected = false;
+      m_candidates.push_back (c);
+    }
+
+  // Windows are sorted by start, so the overlapping ones follow closely
+  m_bySatellite.assign (m_plan->GetNSatellites (), std::vector<uint32_t> ());
+  for (uint32_t i = 0; i < m_candidates.size (); ++i)
+    {
+      const ContactWindow &a = m_candidates[i].window;
+      m_bySatellite[a.satellite].push_back (i);
+      for (uint32_t j = i + 1; j < m_candidates.size (); ++j)
+        {
+          const ContactWindow &b = m_candidates[j].window;
+          if (b.start >= a.end + m_setupTime)
+            {
+              break;
+            }
+          if (a.station == b.station)
+            {
+              m_candidates[i].stationConflicts.push_back (j);
+              m_candidates[j].stationConflicts.push_back (i);
+            }
+          else if (a.satellite == b.satellite && b.start < a.end)
+            {
+              m_candidates[i].satelliteConflicts.push_back (j);
+              m_candidates[j].satelliteConflicts.push_back (i);
+            }
+        }
+    }
+
+  // Largest windows first, earlier ones first among equals
+  std::vector<std::pair<double, uint32_t> > keys;
+  for (uint32_t i = 0; i < m_candidates.size (); ++i)
+    {
+      keys.push_back (std::make_pair (-m_candidates[i].capacity, i));
+    }
+  std::sort (keys.begin (), keys.end ());
+  m_order.resize (keys.size ());
+  m_rank.resize (keys.size ());
+  for (uint32_t i = 0; i < keys.size (); ++i)
+    {
+      m_order[i] = keys[i].second;
+      m_rank[keys[i].second] = i;
+    }
+
+  m_values.assign (m_plan->GetNSatellites (), 0);
+  for (std::vector<uint32_t>::const_iterator it = m_order.begin (); it != m_order.end (); ++it)
+    {
+      TryAdd (*it);
+    }
+  m_greedy = GetTotal ();
+
+  for (uint32_t round = 0; round < m_maxRounds; ++round)
+    {
+      bool improved = false;
+      for (std::vector<uint32_t>::const_iterator it = m_order.begin (); it != m_order.end (); ++it)
+        {
+          if (!m_candidates[*it].selected && TryExchange (*it))
+            {
+              improved = true;
+              m_exchanges++;
+            }
+        }
+      NS_LOG_LOGIC ("Round " << round << ": " << GetTotal () << " bytes");
+      if (!improved)
+        {
+          break;
+        }
+    }
+
+  for (std::vector<Candidate>::const_iterator it = m_candidates.begin (); it != m_candidates.end (); ++it)
+    {
+      if (it->selected)
+        {
+          ScheduledPass pass;
+          pass.satellite = it->window.satellite;
+          pass.station = it->window.station;
+          pass.start = it->window.start;
+          pass.end = it->window.end;
+          pass.bytes = static_cast<uint64_t> (it->planned);
+          m_schedule.push_back (pass);
+        }
+    }
+  NS_LOG_INFO (m_schedule.size () << " of " << m_candidates.size () << " windows assigned, "
+               << GetTotal () << " bytes planned, " << m_greedy << " by the greedy step, "
+               << m_exchanges << " exchanges");
+}
+
+double
+PassScheduler::Evaluate (uint32_t satellite)
+{
+  std::map<uint32_t, double>::const_iterator backlog = m_backlog.find (satellite);
+  std::map<uint32_t, DataRate>::const_iterator generation = m_generation.find (satellite);
+  double initial = backlog != m_backlog.end () ? backlog->second : 0;
+  double rate = generation != m_generation.end () ? generation->second.GetBitRate () / 8.0 : 0;
+  double delivered = 0;
+  const std::vector<uint32_t> &candidates = m_bySatellite[satellite];
+  for (std::vector<uint32_t>::const_iterator it = candidates.begin (); it != candidates.end (); ++it)
+    {
+      Candidate &c = m_candidates[*it];
+      if (!c.selected)
+        {
+          c.planned = 0;
+          continue;
+        }
+      // Data generated during the pass may still go down in it
+      double available = initial + rate * c.window.end.GetSeconds () - delivered;
+      c.planned = std::max (0.0, std::min (c.capacity, available));
+      delivered += c.planned;
+    }
+  return delivered;
+}
+
+bool
+PassScheduler::IsFeasible (uint32_t c) const
+{
+  const Candidate &candidate = m_candidates[c];
+  for (std::vector<uint32_t>::const_iterator it = candidate.satelliteConflicts.begin ();
+       it != candidate.satelliteConflicts.end (); ++it)
+    {
+      if (m_candidates[*it].selected)
+        {
+          return false;
+        }
+    }
+  std::map<uint32_t, uint32_t>::const_iterator antennas = m_antennas.find (candidate.window.station);
+  uint32_t n = antennas != m_antennas.end () ? antennas->second : 1;
+  // Antenna use over the candidate's occupation, as +1/-1 steps
+  std::vector<std::pair<Time, int> > steps;
+  for (std::vector<uint32_t>::const_iterator it = candidate.stationConflicts.begin ();
+       it != candidate.stationConflicts.end (); ++it)
+    {
+      const Candidate &other = m_candidates[*it];
+      if (other.selected)
+        {
+          steps.push_back (std::make_pair (std::max (other.window.start, candidate.window.start), 1));
+          steps.push_back (std::make_pair (other.window.end + m_setupTime, -1));
+        }
+    }
+  if (steps.size () / 2 < n)
+    {
+      return true;
+    }
+  std::sort (steps.begin (), steps.end ());
+  int busy = 0;
+  for (std::vector<std::pair<Time, int> >::const_iterator it = steps.begin (); it != steps.end (); ++it)
+    {
+      busy += it->second;
+      if (busy >= static_cast<int> (n))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+bool
+PassScheduler::TryAdd (uint32_t c)
+{
+  Candidate &candidate = m_candidates[c];
+  if (candidate.selected || !IsFeasible (c))
+    {
+      return false;
+    }
+  uint32_t satellite = candidate.window.satellite;
+  candidate.selected = true;
+  double value = Evaluate (satellite);
+  if (value > m_values[satellite] + 0.5)
+    {
+      m_values[satellite] = value;
+      return true;
+    }
+  candidate.selected = false;
+  Evaluate (satellite);
+  return false;
+}
+
+bool
+PassScheduler::TryExchange (uint32_t c)
+{
+  Candidate &candidate = m_candidates[c];
+  std::vector<uint32_t> removed;
+  std::vector<uint32_t> freed;
+  for (int kind = 0; kind < 2; ++kind)
+    {
+      const std::vector<uint32_t> &conflicts = kind == 0 ? candidate.stationConflicts
+                                                         : candidate.satelliteConflicts;
+      for (std::vector<uint32_t>::const_iterator it = conflicts.begin (); it != conflicts.end (); ++it)
+        {
+          if (m_candidates[*it].selected)
+            {
+              removed.push_back (*it);
+            }
+        }
+    }
+  if (removed.empty ())
+    {
+      return TryAdd (c);
+    }
+
+  // Trial volume of every satellite the exchange touches
+  std::map<uint32_t, double> trial;
+  candidate.selected = true;
+  trial[candidate.window.satellite] = 0;
+  for (std::vector<uint32_t>::const_iterator it = removed.begin (); it != removed.end (); ++it)
+    {
+      const Candidate &r = m_candidates[*it];
+      m_candidates[*it].selected = false;
+      trial[r.window.satellite] = 0;
+      freed.insert (freed.end (), r.stationConflicts.begin (), r.stationConflicts.end ());
+      freed.insert (freed.end (), r.satelliteConflicts.begin (), r.satelliteConflicts.end ());
+    }
+  for (std::map<uint32_t, double>::iterator it = trial.begin (); it != trial.end (); ++it)
+    {
+      it->second = Evaluate (it->first);
+    }
+
+  // Refill the freed time, largest windows first
+  std::vector<std::pair<uint32_t, uint32_t> > refill;
+  for (std::vector<uint32_t>::const_iterator it = freed.begin (); it != freed.end (); ++it)
+    {
+      refill.push_back (std::make_pair (m_rank[*it], *it));
+    }
+  std::sort (refill.begin (), refill.end ());
+  refill.erase (std::unique (refill.begin (), refill.end ()), refill.end ());
+  std::vector<uint32_t> added;
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator it = refill.begin ();
+       it != refill.end (); ++it)
+    {
+      uint32_t i = it->second;
+      Candidate &f = m_candidates[i];
+      if (i == c || f.selected || !IsFeasible (i))
+        {
+          continue;
+        }
+      uint32_t satellite = f.window.satellite;
+      std::map<uint32_t, double>::const_iterator known = trial.find (satellite);
+      double before = known != trial.end () ? known->second : m_values[satellite];
+      f.selected = true;
+      double after = Evaluate (satellite);
+      if (after > before + 0.5)
+        {
+          trial[satellite] = after;
+          added.push_back (i);
+        }
+      else
+        {
+          f.selected = false;
+          Evaluate (satellite);
+        }
+    }
+
+  double delta = 0;
+  for (std::map<uint32_t, double>::const_iterator it = trial.begin (); it != trial.end (); ++it)
+    {
+      delta += it->second - m_values[it->first];
+    }
+  if (delta > 0.5)
+    {
+      for (std::map<uint32_t, double>::const_iterator it = trial.begin (); it != trial.end (); ++it)
+        {
+          m_values[it->first] = it->second;
+        }
+      return true;
+    }
+
+  for (std::vector<uint32_t>::const_iterator it = added.begin (); it != added.end (); ++it)
+    {
+      m_candidates[*it].selected = false;
+    }
+  for (std::vector<uint32_t>::const_iterator it = removed.begin (); it != removed.end (); ++it)
+    {
+      m_candidates[*it].selected = true;
+    }
+  candidate.selected = false;
+  for (std::map<uint32_t, double>::const_iterator it = trial.begin (); it != trial.end (); ++it)
+    {
+      Evaluate (it->first);
+    }
+  return false;
+}
+
+double
+PassScheduler::GetTotal (void) const
+{
+  double total = 0;
+  for (std::vector<double>::const_iterator it = m_values.begin (); it != m_values.end (); ++it)
+    {
+      total += *it;
+    }
+  return total;
+}
+
+const std::vector<ScheduledPass> &
+PassScheduler::GetSchedule (void) const
+{
+  return m_schedule;
+}
+
+uint64_t
+PassScheduler::GetPlannedBytes (void) const
+{
+  return static_cast<uint64_t> (GetTotal ());
+}
+
+uint64_t
+PassScheduler::GetGreedyBytes (void) const
+{
+  return static_cast<uint64_t> (m_greedy);
+}
+
+uint32_t
+PassScheduler::GetNExchanges (void) const
+{
+  return m_exchanges;
+}
+
+bool
+PassScheduler::IsScheduled (uint32_t satellite, uint32_t station, Time t) const
+{
+  for (std::vector<ScheduledPass>::const_iterator it = m_schedule.begin (); it != m_schedule.end (); ++it)
+    {
+      if (it->satellite == satellite && it->station == station && it->start <= t && t < it->end)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+PassScheduler::ScheduleLinkEvents (uint32_t satellite, uint32_t station,
+                                   Ptr<OrbitPointToPointChannel> channel) const
+{
+  NS_LOG_FUNCTION (this << satellite << station << channel);
+  Time now = Simulator::Now ();
+  channel->SetLinkUp (IsScheduled (satellite, station, now));
+  for (std::vector<ScheduledPass>::const_iterator it = m_schedule.begin (); it != m_schedule.end (); ++it)
+    {
+      if (it->satellite != satellite || it->station != station)
+        {
+          continue;
+        }
+      if (it->start > now)
+        {
+          Simulator::Schedule (it->start - now, &OrbitPointToPointChannel::SetLinkUp, channel, true);
+        }
+      if (it->end > now)
+        {
+          Simulator::Schedule (it->end - now, &OrbitPointToPointChannel::SetLinkUp, channel, false);
+        }
+    }
+}
+
+void
+PassScheduler::Print (std::ostream &os) const
+{
+  for (std::vector<ScheduledPass>::const_iterator it = m_schedule.begin (); it != m_schedule.end (); ++it)
+    {
+      os << *it << std::endl;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PASS_SCHEDULER_H
+#define PASS_SCHEDULER_H
+
+#include <map>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "contact-plan.h"
+
+namespace ns3 {
+
+class OrbitPointToPointChannel;
+
+/**
+ * \ingroup satcom
+ *
+ * \brief One contact window a PassScheduler assigned.
+ */
+struct ScheduledPass
+{
+  uint32_t satellite;  //!< Satellite index in the ContactPlan
+  uint32_t station;    //!< Ground station index in the ContactPlan
+  Time start;          //!< Start of the window
+  Time end;            //!< End of the window
+  uint64_t bytes;      //!< Volume the pass is planned to deliver
+};
+
+std::ostream & operator << (std::ostream &os, const ScheduledPass &pass);
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Assigns the contact windows of a ContactPlan to maximize the
+ * delivered volume of a satellite fleet.
+ *
+ * Each ground station has a number of antennas, each tracking one
+ * satellite at a time and needing SetupTime between two passes; each
+ * satellite transmits to one station at a time. A window carries at
+ * most its duration times the link rate, and no more than the data
+ * its satellite holds: the initial backlog plus what it generated
+ * until the end of the window, minus what its earlier passes took.
+ *
+ * Solve () builds the schedule in two steps. A greedy step takes the
+ * windows by decreasing capacity and keeps those that fit and add
+ * volume. A local search then tries every window left out in place of
+ * the windows it conflicts with, refilling the freed antenna and
+ * satellite time greedily, and keeps the exchange when the total
+ * volume grows, until a round brings nothing or MaxRounds is reached.
+ * Windows are assigned whole.
+ *
+ * ScheduleLinkEvents () then drives a channel from the assigned
+ * windows only, the way ContactPlan::ScheduleLinkEvents () does from
+ * all of them, so the simulation executes the schedule directly.
+ */
+class PassScheduler : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  PassScheduler ();
+  virtual ~PassScheduler ();
+
+  /// \param plan the computed contact plan to schedule
+  void SetContactPlan (Ptr<ContactPlan> plan);
+
+  /**
+   * \param satellite a satellite index in the contact plan
+   * \param bytes the data it holds at time zero
+   */
+  void SetBacklog (uint32_t satellite, uint64_t bytes);
+
+  /**
+   * \param satellite a satellite index in the contact plan
+   * \param rate the mean rate at which it produces data
+   */
+  void SetGenerationRate (uint32_t satellite, DataRate rate);
+
+  /**
+   * \param satellite a satellite index in the contact plan
+   * \param station a ground station index in the contact plan
+   * \param rate the downlink rate of the pair, instead of DataRate
+   */
+  void SetLinkRate (uint32_t satellite, uint32_t station, DataRate rate);
+
+  /**
+   * \param station a ground station index in the contact plan
+   * \param antennas the number of satellites it tracks at once
+   */
+  void SetAntennas (uint32_t station, uint32_t antennas);
+
+  /// \brief Compute the schedule
+  void Solve (void);
+
+  /// \return the assigned passes, sorted by start time
+  const std::vector<ScheduledPass> & GetSchedule (void) const;
+
+  /// \return the volume the schedule is planned to deliver
+  uint64_t GetPlannedBytes (void) const;
+
+  /// \return the volume planned by the greedy step alone
+  uint64_t GetGreedyBytes (void) const;
+
+  /// \return the number of exchanges the local search kept
+  uint32_t GetNExchanges (void) const;
+
+  /**
+   * \param satellite the satellite index
+   * \param station the ground station index
+   * \param t an absolute simulation time
+   * \returns true if t falls into an assigned pass of the pair
+   */
+  bool IsScheduled (uint32_t satellite, uint32_t station, Time t) const;
+
+  /**
+   * \brief Drive the link state of a channel from the assigned passes of a pair
+   *
+   * The link state is set for the current time and toggled at each
+   * future edge of an assigned pass.
+   *
+   * \param satellite the satellite index
+   * \param station the ground station index
+   * \param channel the channel between them
+   */
+  void ScheduleLinkEvents (uint32_t satellite, uint32_t station,
+                           Ptr<OrbitPointToPointChannel> channel) const;
+
+  /**
+   * \brief Print the schedule, one pass per line
+   * \param os the output stream
+   */
+  void Print (std::ostream &os) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// A contact window that may be assigned
+  struct Candidate
+  {
+    ContactWindow window;                   //!< The window
+    double capacity;                        //!< Link rate times duration, in bytes
+    double planned;                         //!< Volume delivered if assigned, in bytes
+    bool selected;                          //!< Whether it is assigned
+    std::vector<uint32_t> stationConflicts;   //!< Overlapping candidates of the station
+    std::vector<uint32_t> satelliteConflicts; //!< Overlapping candidates of the satellite
+  };
+
+  /**
+   * \param satellite a satellite index
+   * \return the volume its assigned candidates deliver, updating their planned volume
+   */
+  double Evaluate (uint32_t satellite);
+
+  /**
+   * \param c a candidate index
+   * \return whether it can be assigned next to the assigned candidates
+   */
+  bool IsFeasible (uint32_t c) const;
+
+  /**
+   * \brief Assign a candidate if it fits and adds volume
+   * \param c a candidate index
+   * \return whether it was assigned
+   */
+  bool TryAdd (uint32_t c);
+
+  /**
+   * \brief Assign an unassigned candidate in place of those it conflicts with
+   * \param c a candidate index
+   * \return whether the exchange increased the volume and was kept
+   */
+  bool TryExchange (uint32_t c);
+
+  /// \return the total volume of the current assignment
+  double GetTotal (void) const;
+
+  DataRate m_rate;                   //!< Default link rate
+  Time m_setupTime;                  //!< Antenna time between two passes
+  Time m_minDuration;                //!< Shortest window worth assigning
+  uint32_t m_maxRounds;              //!< Local search rounds
+
+  Ptr<ContactPlan> m_plan;                                   //!< Contact windows
+  std::map<uint32_t, double> m_backlog;                      //!< Initial data by satellite, in bytes
+  std::map<uint32_t, DataRate> m_generation;                 //!< Production rate by satellite
+  std::map<std::pair<uint32_t, uint32_t>, DataRate> m_linkRates; //!< Rates by pair
+  std::map<uint32_t, uint32_t> m_antennas;                   //!< Antennas by station
+
+  std::vector<Candidate> m_candidates;                       //!< Windows, sorted by start time
+  std::vector<std::vector<uint32_t> > m_bySatellite;         //!< Candidates of each satellite
+  std::vector<uint32_t> m_order;                             //!< Candidates by decreasing capacity
+  std::vector<uint32_t> m_rank;                              //!< Position of each candidate in m_order
+  std::vector<double> m_values;                              //!< Volume of each satellite
+  std::vector<ScheduledPass> m_schedule;                     //!< Assigned passes
+  double m_greedy;                                           //!< Volume after the greedy step
+  uint32_t m_exchanges;                                      //!< Exchanges kept
+};
+
+} // namespace ns3
+
+#endif /* PASS_SCHEDULER_H */
@@ -0,0 +1,386 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "bundle-agent.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BundleAgent");
+
+NS_OBJECT_ENSURE_REGISTERED (BundleAgent);
+
+TypeId
+BundleAgent::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BundleAgent")
+    .SetParent<Application> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<BundleAgent> ()
+    .AddAttribute ("Port", "UDP port the agents exchange bundles on.",
+                   UintegerValue (4556),
+                   MakeUintegerAccessor (&BundleAgent::m_port),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("StorageCapacity", "Payload bytes the store holds, 0 for unbounded.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&BundleAgent::m_capacity),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("MaxBundleSize", "Largest bundle payload in bytes.",
+                   UintegerValue (60000),
+                   MakeUintegerAccessor (&BundleAgent::m_maxBundleSize),
+                   MakeUintegerChecker<uint32_t> (1, 65000))
+    .AddAttribute ("Lifetime", "Lifetime of the bundles created here, zero for never.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&BundleAgent::m_lifetime),
+                   MakeTimeChecker (Seconds (0)))
+    .AddTraceSource ("Deliver", "A bundle reached its destination here.",
+                     MakeTraceSourceAccessor (&BundleAgent::m_deliverTrace),
+                     "ns3::BundleAgent::BundleCallback")
+    .AddTraceSource ("Forward", "A bundle was sent to a neighbour.",
+                     MakeTraceSourceAccessor (&BundleAgent::m_forwardTrace),
+                     "ns3::BundleAgent::BundleCallback")
+    .AddTraceSource ("Drop", "A bundle was dropped from the store.",
+                     MakeTraceSourceAccessor (&BundleAgent::m_dropTrace),
+                     "ns3::BundleAgent::BundleCallback")
+  ;
+  return tid;
+}
+
+BundleAgent::BundleAgent ()
+  : m_port (4556),
+    m_capacity (0),
+    m_maxBundleSize (60000),
+    m_storedBytes (0),
+    m_sequence (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BundleAgent::~BundleAgent ()
+{
+}
+
+void
+BundleAgent::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_socket = 0;
+  m_graph = 0;
+  m_neighbors.clear ();
+  m_unroutable.clear ();
+  Application::DoDispose ();
+}
+
+void
+BundleAgent::SetContactGraph (Ptr<ContactGraph> graph)
+{
+  m_graph = graph;
+}
+
+uint32_t
+BundleAgent::AddNeighbor (Ptr<NetDevice> device, Ipv4Address peer, uint32_t node)
+{
+  NS_LOG_FUNCTION (this << device << peer << node);
+  Neighbor n;
+  n.device = device;
+  n.peer = peer;
+  n.node = node;
+  DataRateValue rate;
+  if (device->GetAttributeFailSafe ("DataRate", rate))
+    {
+      n.rate = rate.Get ();
+    }
+  m_neighbors.push_back (n);
+  m_neighborOfNode[node] = m_neighbors.size () - 1;
+  return m_neighbors.size () - 1;
+}
+
+uint32_t
+BundleAgent::GetWireSize (uint32_t payload)
+{
+  // Bundle and UDP headers, then 1480-byte IPv4 fragments in PPP frames
+  uint32_t datagram = payload + 28 + 8;
+  uint32_t fragments = (datagram + 1479) / 1480;
+  return datagram + fragments * (20 + 2);
+}
+
+uint64_t
+BundleAgent::GetStoredBytes (void) const
+{
+  return m_storedBytes;
+}
+
+void
+BundleAgent::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (m_graph != 0, "The bundle agent needs a contact graph");
+  m_socket = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId ());
+  m_socket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_port));
+  m_socket->SetRecvCallback (MakeCallback (&BundleAgent::HandleRead, this));
+  for (uint32_t i = 0; i < m_neighbors.size (); ++i)
+    {
+      Neighbor &n = m_neighbors[i];
+      // One bundle at a time, the next one is chosen when the device is idle
+      n.feeder = CreateObject<DeviceQueueFeeder> ();
+      n.feeder->Setup (n.device, 1, MakeCallback (&BundleAgent::SendBundle, this).Bind (i));
+      n.feeder->SetLinkCallback (MakeCallback (&BundleAgent::LinkChanged, this).Bind (i));
+    }
+  RetryUnroutable ();
+  for (uint32_t i = 0; i < m_neighbors.size (); ++i)
+    {
+      TrySend (i);
+    }
+}
+
+void
+BundleAgent::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_retryEvent.Cancel ();
+  if (m_socket != 0)
+    {
+      m_socket->Close ();
+      m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+      m_socket = 0;
+    }
+}
+
+uint32_t
+BundleAgent::Send (uint32_t destination, uint64_t bytes)
+{
+  NS_LOG_FUNCTION (this << destination << bytes);
+  uint32_t accepted = 0;
+  while (bytes > 0)
+    {
+      uint32_t size = std::min<uint64_t> (bytes, m_maxBundleSize);
+      bytes -= size;
+      Stored bundle;
+      bundle.payload = Create<Packet> (size);
+      bundle.header.SetSource (GetNode ()->GetId ());
+      bundle.header.SetDestination (destination);
+      bundle.header.SetSequence (m_sequence++);
+      bundle.header.SetCreation (Simulator::Now ());
+      bundle.header.SetLifetime (m_lifetime);
+      bundle.contact = -1;
+      if (m_capacity != 0 && m_storedBytes + size > m_capacity)
+        {
+          m_dropTrace (bundle.payload, bundle.header);
+          continue;
+        }
+      m_storedBytes += size;
+      accepted++;
+      Route (bundle);
+    }
+  return accepted;
+}
+
+void
+BundleAgent::Route (Stored bundle)
+{
+  ContactGraph::Route route;
+  uint32_t wire = GetWireSize (bundle.payload->GetSize ());
+  if (m_graph == 0
+      || !m_graph->FindRoute (GetNode ()->GetId (), bundle.header.GetDestination (),
+                              Simulator::Now (), wire, route))
+    {
+      NS_LOG_LOGIC ("No route for bundle " << bundle.header.GetSequence ());
+      bundle.contact = -1;
+      m_unroutable.push_back (bundle);
+      ScheduleRetry ();
+      return;
+    }
+  uint32_t first = route.contacts.front ();
+  std::map<uint32_t, uint32_t>::const_iterator it = m_neighborOfNode.find (m_graph->GetContact (first).to);
+  NS_ASSERT_MSG (it != m_neighborOfNode.end (), "The contact graph has a contact to an unknown neighbour");
+  m_graph->Book (first, wire);
+  bundle.contact = first;
+  m_neighbors[it->second].queue.push_back (bundle);
+  TrySend (it->second);
+}
+
+void
+BundleAgent::RetryUnroutable (void)
+{
+  NS_LOG_FUNCTION (this << m_unroutable.size ());
+  m_retryEvent.Cancel ();
+  Time now = Simulator::Now ();
+  std::deque<Stored> pending;
+  pending.swap (m_unroutable);
+  for (std::deque<Stored>::iterator it = pending.begin (); it != pending.end (); ++it)
+    {
+      if (it->header.IsExpired (now))
+        {
+          Drop (*it);
+        }
+      else
+        {
+          Route (*it);
+        }
+    }
+}
+
+void
+BundleAgent::ScheduleRetry (void)
+{
+  if (m_socket == 0 || m_retryEvent.IsRunning ())
+    {
+      return;
+    }
+  Time next = m_graph->GetNextContactStart (GetNode ()->GetId (), Simulator::Now ());
+  if (next != Time::Max ())
+    {
+      m_retryEvent = Simulator::Schedule (next - Simulator::Now (), &BundleAgent::RetryUnroutable, this);
+    }
+}
+
+void
+BundleAgent::Drop (Stored &bundle)
+{
+  NS_LOG_LOGIC ("Drop bundle " << bundle.header.GetSequence () << " from " << bundle.header.GetSource ());
+  Release (bundle);
+  m_storedBytes -= bundle.payload->GetSize ();
+  m_dropTrace (bundle.payload, bundle.header);
+}
+
+void
+BundleAgent::Release (Stored &bundle)
+{
+  if (bundle.contact >= 0)
+    {
+      m_graph->Release (bundle.contact, GetWireSize (bundle.payload->GetSize ()));
+      bundle.contact = -1;
+    }
+}
+
+void
+BundleAgent::TrySend (uint32_t neighbor)
+{
+  Neighbor &n = m_neighbors[neighbor];
+  if (n.feeder != 0)
+    {
+      n.feeder->Feed ();
+    }
+}
+
+bool
+BundleAgent::SendBundle (uint32_t neighbor)
+{
+  Neighbor &n = m_neighbors[neighbor];
+  if (m_socket == 0)
+    {
+      return false;
+    }
+  Time now = Simulator::Now ();
+  int32_t current = m_graph->FindCurrentContact (GetNode ()->GetId (), n.node, now);
+  while (!n.queue.empty ())
+    {
+      Stored bundle = n.queue.front ();
+      if (bundle.header.IsExpired (now))
+        {
+          n.queue.pop_front ();
+          Drop (bundle);
+          continue;
+        }
+      uint32_t wire = GetWireSize (bundle.payload->GetSize ());
+      if (current >= 0 && n.rate.GetBitRate () > 0
+          && now + n.rate.CalculateBytesTxTime (wire) > m_graph->GetContact (current).end)
+        {
+          // Would be cut by the end of the contact, wait for the next one
+          return false;
+        }
+      n.queue.pop_front ();
+      m_storedBytes -= bundle.payload->GetSize ();
+      Ptr<Packet> packet = bundle.payload->Copy ();
+      packet->AddHeader (bundle.header);
+      if (m_socket->SendTo (packet, 0, InetSocketAddress (n.peer, m_port)) < 0)
+        {
+          m_storedBytes += bundle.payload->GetSize ();
+          Drop (bundle);
+          continue;
+        }
+      m_forwardTrace (bundle.payload, bundle.header);
+      return true;
+    }
+  return false;
+}
+
+void
+BundleAgent::LinkChanged (uint32_t neighbor, bool up)
+{
+  NS_LOG_FUNCTION (this << neighbor << up);
+  if (up)
+    {
+      // The feeder starts the queue of the neighbour next
+      RetryUnroutable ();
+      return;
+    }
+  Neighbor &n = m_neighbors[neighbor];
+  // Bundles booked on the contact that just closed need a new route
+  Time now = Simulator::Now ();
+  std::deque<Stored> kept;
+  std::deque<Stored> missed;
+  for (std::deque<Stored>::iterator it = n.queue.begin (); it != n.queue.end (); ++it)
+    {
+      if (it->contact >= 0 && m_graph->GetContact (it->contact).end > now)
+        {
+          kept.push_back (*it);
+        }
+      else
+        {
+          missed.push_back (*it);
+        }
+    }
+  n.queue.swap (kept);
+  for (std::deque<Stored>::iterator it = missed.begin (); it != missed.end (); ++it)
+    {
+      Release (*it);
+      Route (*it);
+    }
+}
+
+void
+BundleAgent::HandleRead (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  Address from;
+  while ((packet = socket->RecvFrom (from)))
+    {
+      Stored bundle;
+      packet->RemoveHeader (bundle.header);
+      bundle.payload = packet;
+      bundle.contact = -1;
+      if (bundle.header.GetDestination () == GetNode ()->GetId ())
+        {
+          NS_LOG_LOGIC ("Deliver bundle " << bundle.header.GetSequence () << " from " << bundle.header.GetSource ());
+          m_deliverTrace (bundle.payload, bundle.header);
+          continue;
+        }
+      if (m_capacity != 0 && m_storedBytes + packet->GetSize () > m_capacity)
+        {
+          m_dropTrace (bundle.payload, bundle.header);
+          continue;
+        }
+      m_storedBytes += packet->GetSize ();
+      Route (bundle);
+    }
+}
+
+} // namespace ns3
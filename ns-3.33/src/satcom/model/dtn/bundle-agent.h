@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BUNDLE_AGENT_H
+#define BUNDLE_AGENT_H
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/socket.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/data-rate.h"
+#include "ns3/traced-callback.h"
+#include "ns3/bundle-header.h"
+#include "ns3/contact-graph.h"
+#include "ns3/device-queue-feeder.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Store-and-forward bundle agent with contact graph routing.
+ *
+ * Bundles are carried over UDP to the neighbours registered with
+ * AddNeighbor (), one hop at a time. Each bundle is routed on the shared
+ * ContactGraph when it enters the store and queued for the neighbour of
+ * the first contact of its route, booking its volume on that contact
+ * only: each hop books the contact it transmits on, so with a graph
+ * shared by all agents no contact is booked twice. The booking is
+ * released when the bundle is dropped or routed again. The
+ * queue of a neighbour drains while its link is up, one bundle at a
+ * time as soon as a DeviceQueueFeeder finds the device idle, so a
+ * contact is used at line rate. A bundle is only started if its
+ * transmission ends before the contact does; bundles whose contact
+ * closed are routed again. Links over an OrbitPointToPointChannel
+ * follow its LinkState and Outage traces, a direction in outage
+ * counting as down; other links are always up.
+ *
+ * Bundles without a route are kept aside and routed again when a link
+ * comes up and at the start of the next contact of this node, until
+ * they expire.
+ *
+ * The store is held across contacts and bounded by StorageCapacity;
+ * bundles that do not fit or that expire are dropped.
+ */
+class BundleAgent : public Application
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  BundleAgent ();
+  virtual ~BundleAgent ();
+
+  /**
+   * TracedCallback signature for bundle events.
+   * \param payload the bundle payload
+   * \param header the bundle header
+   */
+  typedef void (* BundleCallback) (Ptr<const Packet> payload, const BundleHeader &header);
+
+  /**
+   * \param graph the contact graph to route on
+   */
+  void SetContactGraph (Ptr<ContactGraph> graph);
+
+  /**
+   * \param device the local device of the link
+   * \param peer the address of the neighbour on the link
+   * \param node the id of the neighbour node
+   * \return the neighbour index
+   */
+  uint32_t AddNeighbor (Ptr<NetDevice> device, Ipv4Address peer, uint32_t node);
+
+  /**
+   * Split data into bundles and store them.
+   * \param destination the destination node id
+   * \param bytes the amount of data
+   * \return the number of bundles accepted by the store
+   */
+  uint32_t Send (uint32_t destination, uint64_t bytes);
+
+  /// \return the bytes of payload in the store
+  uint64_t GetStoredBytes (void) const;
+
+  /**
+   * \param payload a bundle payload size
+   * \return the bytes the bundle takes on a point-to-point link, with
+   *         its UDP, IP and PPP headers after fragmentation
+   */
+  static uint32_t GetWireSize (uint32_t payload);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /// A bundle in the store
+  struct Stored
+  {
+    Ptr<Packet> payload;    //!< Payload
+    BundleHeader header;    //!< Header
+    int32_t contact;        //!< Contact it is booked on, -1 if none
+  };
+
+  /// A neighbour and its queue
+  struct Neighbor
+  {
+    Ptr<NetDevice> device;       //!< Local device of the link
+    Ipv4Address peer;            //!< Address of the neighbour
+    uint32_t node;               //!< Node id of the neighbour
+    DataRate rate;               //!< Rate of the link
+    Ptr<DeviceQueueFeeder> feeder; //!< Starts a bundle when the device is idle
+    std::deque<Stored> queue;    //!< Bundles waiting for this neighbour
+  };
+
+  /// Route a bundle and queue it, or keep it aside if unroutable
+  void Route (Stored bundle);
+  /// Route again the bundles kept aside, dropping the expired ones
+  void RetryUnroutable (void);
+  /// Schedule RetryUnroutable () at the start of the next contact
+  void ScheduleRetry (void);
+  /// Start the next bundle to a neighbour if the link is up and idle
+  void TrySend (uint32_t neighbor);
+  /**
+   * \brief Send the next bundle of a neighbour's queue
+   * \param neighbor the neighbour index
+   * \return false if no bundle can be sent now
+   */
+  bool SendBundle (uint32_t neighbor);
+  /**
+   * \brief Route again when a link comes back or its contact closes
+   * \param neighbor the neighbour index
+   * \param up whether the link is up
+   */
+  void LinkChanged (uint32_t neighbor, bool up);
+  /// Socket receive callback
+  void HandleRead (Ptr<Socket> socket);
+  /// Drop a bundle from the store
+  void Drop (Stored &bundle);
+  /// Give back the volume a bundle booked on its contact
+  void Release (Stored &bundle);
+
+  uint16_t m_port;                       //!< UDP port of the agents
+  uint64_t m_capacity;                   //!< Store capacity in bytes, 0 for unbounded
+  uint32_t m_maxBundleSize;              //!< Largest bundle payload
+  Time m_lifetime;                       //!< Lifetime of new bundles
+  Ptr<ContactGraph> m_graph;             //!< Contact graph
+  Ptr<Socket> m_socket;                  //!< UDP socket
+  std::vector<Neighbor> m_neighbors;     //!< Neighbours
+  std::map<uint32_t, uint32_t> m_neighborOfNode; //!< Neighbour index by node id
+  std::deque<Stored> m_unroutable;       //!< Bundles without a route yet
+  EventId m_retryEvent;                  //!< Next RetryUnroutable ()
+  uint64_t m_storedBytes;                //!< Payload bytes in the store
+  uint32_t m_sequence;                   //!< Next sequence number
+
+  TracedCallback<Ptr<const Packet>, const BundleHeader &> m_deliverTrace; //!< Delivered here
+  TracedCallback<Ptr<const Packet>, const BundleHeader &> m_forwardTrace; //!< Sent to a neighbour
+  TracedCallback<Ptr<const Packet>, const BundleHeader &> m_dropTrace;    //!< Dropped
+};
+
+} // namespace ns3
+
+#endif /* BUNDLE_AGENT_H */
@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "bundle-header.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (BundleHeader);
+
+BundleHeader::BundleHeader ()
+  : m_source (0),
+    m_destination (0),
+    m_sequence (0),
+    m_creation (0),
+    m_lifetime (0)
+{
+}
+
+TypeId
+BundleHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BundleHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<BundleHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+BundleHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+BundleHeader::GetSerializedSize (void) const
+{
+  return 28;
+}
+
+void
+BundleHeader::Serialize (Buffer::Iterator start) const
+{
+  start.WriteHtonU32 (m_source);
+  start.WriteHtonU32 (m_destination);
+  start.WriteHtonU32 (m_sequence);
+  start.WriteHtonU64 (m_creation);
+  start.WriteHtonU64 (m_lifetime);
+}
+
+uint32_t
+BundleHeader::Deserialize (Buffer::Iterator start)
+{
+  m_source = start.ReadNtohU32 ();
+  m_destination = start.ReadNtohU32 ();
+  m_sequence = start.ReadNtohU32 ();
+  m_creation = start.ReadNtohU64 ();
+  m_lifetime = start.ReadNtohU64 ();
+  return GetSerializedSize ();
+}
+
+void
+BundleHeader::Print (std::ostream &os) const
+{
+  os << "source " << m_source << " destination " << m_destination
+     << " sequence " << m_sequence << " created " << GetCreation ().As (Time::S)
+     << " lifetime " << GetLifetime ().As (Time::S);
+}
+
+void
+BundleHeader::SetSource (uint32_t source)
+{
+  m_source = source;
+}
+
+uint32_t
+BundleHeader::GetSource (void) const
+{
+  return m_source;
+}
+
+void
+BundleHeader::SetDestination (uint32_t destination)
+{
+  m_destination = destination;
+}
+
+uint32_t
+BundleHeader::GetDestination (void) const
+{
+  return m_destination;
+}
+
+void
+BundleHeader::SetSequence (uint32_t sequence)
+{
+  m_sequence = sequence;
+}
+
+uint32_t
+BundleHeader::GetSequence (void) const
+{
+  return m_sequence;
+}
+
+void
+BundleHeader::SetCreation (Time creation)
+{
+  m_creation = creation.GetNanoSeconds ();
+}
+
+Time
+BundleHeader::GetCreation (void) const
+{
+  return NanoSeconds (m_creation);
+}
+
+void
+BundleHeader::SetLifetime (Time lifetime)
+{
+  m_lifetime = lifetime.GetNanoSeconds ();
+}
+
+Time
+BundleHeader::GetLifetime (void) const
+{
+  return NanoSeconds (m_lifetime);
+}
+
+bool
+BundleHeader::IsExpired (Time now) const
+{
+  return m_lifetime != 0 && now.GetNanoSeconds () - m_creation >= m_lifetime;
+}
+
+} // namespace ns3
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BUNDLE_HEADER_H
+#define BUNDLE_HEADER_H
+
+#include "ns3/header.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Primary block of a store-and-forward bundle.
+ *
+ * A compact fixed-size stand-in for the RFC 5050 primary block: node
+ * ids instead of endpoint URIs, and the creation time and lifetime in
+ * simulation time.
+ */
+class BundleHeader : public Header
+{
+public:
+  BundleHeader ();
+
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual void Print (std::ostream &os) const;
+
+  /// \param source the id of the node that created the bundle
+  void SetSource (uint32_t source);
+  /// \return the id of the node that created the bundle
+  uint32_t GetSource (void) const;
+
+  /// \param destination the id of the destination node
+  void SetDestination (uint32_t destination);
+  /// \return the id of the destination node
+  uint32_t GetDestination (void) const;
+
+  /// \param sequence the sequence number of the bundle at its source
+  void SetSequence (uint32_t sequence);
+  /// \return the sequence number of the bundle at its source
+  uint32_t GetSequence (void) const;
+
+  /// \param creation the creation time
+  void SetCreation (Time creation);
+  /// \return the creation time
+  Time GetCreation (void) const;
+
+  /// \param lifetime the time after creation the bundle expires at, zero for never
+  void SetLifetime (Time lifetime);
+  /// \return the lifetime
+  Time GetLifetime (void) const;
+
+  /**
+   * \param now the current time
+   * \return true if the bundle has expired at \p now
+   */
+  bool IsExpired (Time now) const;
+
+private:
+  uint32_t m_source;       //!< Source node id
+  uint32_t m_destination;  //!< Destination node id
+  uint32_t m_sequence;     //!< Sequence number at the source
+  int64_t m_creation;      //!< Creation time in ns
+  int64_t m_lifetime;      //!< Lifetime in ns, 0 for never
+};
+
+} // namespace ns3
+
+#endif /* BUNDLE_HEADER_H */
@@ -0,0 +1,215 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <limits>
+#include <queue>
+
+#include "contact-graph.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ContactGraph");
+
+NS_OBJECT_ENSURE_REGISTERED (ContactGraph);
+
+TypeId
+ContactGraph::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ContactGraph")
+    .SetParent<Object> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<ContactGraph> ()
+  ;
+  return tid;
+}
+
+ContactGraph::ContactGraph ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ContactGraph::~ContactGraph ()
+{
+}
+
+uint32_t
+ContactGraph::AddContact (uint32_t from, uint32_t to, Time start, Time end, DataRate rate, Time delay)
+{
+  NS_LOG_FUNCTION (this << from << to << start << end << rate << delay);
+  NS_ASSERT (start <= end);
+  Contact c;
+  c.from = from;
+  c.to = to;
+  c.start = start;
+  c.end = end;
+  c.rate = rate;
+  c.delay = delay;
+  c.residual = end == Time::Max () ? std::numeric_limits<double>::infinity ()
+    : (end - start).GetSeconds () * rate.GetBitRate () / 8.0;
+  m_contacts.push_back (c);
+  m_outgoing[from].push_back (m_contacts.size () - 1);
+  return m_contacts.size () - 1;
+}
+
+void
+ContactGraph::AddContactPlan (Ptr<const ContactPlan> plan, const std::vector<uint32_t> &satellites,
+                              const std::vector<uint32_t> &stations, DataRate rate, Time delay)
+{
+  NS_LOG_FUNCTION (this << plan);
+  const std::vector<ContactWindow> &windows = plan->GetWindows ();
+  for (std::vector<ContactWindow>::const_iterator it = windows.begin (); it != windows.end (); ++it)
+    {
+      NS_ASSERT (it->satellite < satellites.size () && it->station < stations.size ());
+      AddContact (satellites[it->satellite], stations[it->station], it->start, it->end, rate, delay);
+      AddContact (stations[it->station], satellites[it->satellite], it->start, it->end, rate, delay);
+    }
+}
+
+uint32_t
+ContactGraph::GetNContacts (void) const
+{
+  return m_contacts.size ();
+}
+
+const Contact &
+ContactGraph::GetContact (uint32_t i) const
+{
+  NS_ASSERT (i < m_contacts.size ());
+  return m_contacts[i];
+}
+
+int32_t
+ContactGraph::FindCurrentContact (uint32_t from, uint32_t to, Time now) const
+{
+  std::map<uint32_t, std::vector<uint32_t> >::const_iterator out = m_outgoing.find (from);
+  if (out == m_outgoing.end ())
+    {
+      return -1;
+    }
+  for (std::vector<uint32_t>::const_iterator it = out->second.begin (); it != out->second.end (); ++it)
+    {
+      const Contact &c = m_contacts[*it];
+      if (c.to == to && c.start <= now && now < c.end)
+        {
+          return *it;
+        }
+    }
+  return -1;
+}
+
+Time
+ContactGraph::GetNextContactStart (uint32_t from, Time now) const
+{
+  Time next = Time::Max ();
+  std::map<uint32_t, std::vector<uint32_t> >::const_iterator out = m_outgoing.find (from);
+  if (out == m_outgoing.end ())
+    {
+      return next;
+    }
+  for (std::vector<uint32_t>::const_iterator it = out->second.begin (); it != out->second.end (); ++it)
+    {
+      const Contact &c = m_contacts[*it];
+      if (c.start > now && c.start < next)
+        {
+          next = c.start;
+        }
+    }
+  return next;
+}
+
+bool
+ContactGraph::FindRoute (uint32_t from, uint32_t to, Time now, uint32_t bytes, Route &route) const
+{
+  NS_LOG_FUNCTION (this << from << to << now << bytes);
+  // Earliest arrival search: waiting at a node is allowed, so the
+  // arrival times are monotonic and Dijkstra over the nodes applies.
+  std::map<uint32_t, Time> arrival;
+  std::map<uint32_t, int32_t> via;
+  typedef std::pair<Time, uint32_t> Entry;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+  arrival[from] = now;
+  via[from] = -1;
+  queue.push (Entry (now, from));
+  while (!queue.empty ())
+    {
+      Entry top = queue.top ();
+      queue.pop ();
+      if (top.first > arrival[top.second])
+        {
+          continue;
+        }
+      if (top.second == to)
+        {
+          break;
+        }
+      std::map<uint32_t, std::vector<uint32_t> >::const_iterator out = m_outgoing.find (top.second);
+      if (out == m_outgoing.end ())
+        {
+          continue;
+        }
+      for (std::vector<uint32_t>::const_iterator it = out->second.begin (); it != out->second.end (); ++it)
+        {
+          const Contact &c = m_contacts[*it];
+          if (c.end <= top.first || c.residual < bytes)
+            {
+              continue;
+            }
+          Time departure = std::max (top.first, c.start);
+          Time done = departure + c.rate.CalculateBytesTxTime (bytes);
+          if (done > c.end)
+            {
+              continue;
+            }
+          Time reach = done + c.delay;
+          std::map<uint32_t, Time>::iterator known = arrival.find (c.to);
+          if (known == arrival.end () || reach < known->second)
+            {
+              arrival[c.to] = reach;
+              via[c.to] = *it;
+              queue.push (Entry (reach, c.to));
+            }
+        }
+    }
+  std::map<uint32_t, Time>::const_iterator found = arrival.find (to);
+  if (found == arrival.end () || to == from)
+    {
+      return false;
+    }
+  route.arrival = found->second;
+  route.contacts.clear ();
+  for (int32_t c = via[to]; c >= 0; c = via[m_contacts[c].from])
+    {
+      route.contacts.insert (route.contacts.begin (), c);
+    }
+  return true;
+}
+
+void
+ContactGraph::Book (uint32_t contact, uint32_t bytes)
+{
+  NS_ASSERT (contact < m_contacts.size ());
+  m_contacts[contact].residual -= bytes;
+}
+
+void
+ContactGraph::Release (uint32_t contact, uint32_t bytes)
+{
+  NS_ASSERT (contact < m_contacts.size ());
+  m_contacts[contact].residual += bytes;
+}
+
+} // namespace ns3
@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CONTACT_GRAPH_H
+#define CONTACT_GRAPH_H
+
+#include <map>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "ns3/contact-plan.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief A directed transmission opportunity between two nodes.
+ */
+struct Contact
+{
+  uint32_t from;    //!< Transmitting node id
+  uint32_t to;      //!< Receiving node id
+  Time start;       //!< Start of the contact
+  Time end;         //!< End of the contact
+  DataRate rate;    //!< Transmission rate
+  Time delay;       //!< One-way light time
+  double residual;  //!< Volume not yet booked, in bytes
+};
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Predicted contacts of a delay-tolerant network and contact
+ * graph routing over them.
+ *
+ * FindRoute () is an earliest-arrival search over the contacts: a
+ * bundle may wait at a node for a later contact, must finish its
+ * transmission before the contact ends, and only fits in the volume of
+ * a contact that is not already booked by earlier bundles. Book ()
+ * reserves the volume of a bundle on a contact so that the following
+ * bundles spill over to the next opportunity instead of oversubscribing
+ * a pass, Release () gives it back when the bundle leaves that contact
+ * without being sent on it.
+ */
+class ContactGraph : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  ContactGraph ();
+  virtual ~ContactGraph ();
+
+  /// A route found by FindRoute ()
+  struct Route
+  {
+    std::vector<uint32_t> contacts;  //!< Contacts from the source on
+    Time arrival;                    //!< Predicted arrival at the destination
+  };
+
+  /**
+   * \param from the transmitting node id
+   * \param to the receiving node id
+   * \param start start of the contact
+   * \param end end of the contact, Time::Max () for a permanent link
+   * \param rate the transmission rate
+   * \param delay the one-way light time
+   * \return the contact index
+   */
+  uint32_t AddContact (uint32_t from, uint32_t to, Time start, Time end, DataRate rate, Time delay);
+
+  /**
+   * Add both directions of every window of a computed contact plan.
+   * \param plan the contact plan
+   * \param satellites node id of each satellite of the plan
+   * \param stations node id of each ground station of the plan
+   * \param rate the transmission rate of the ground links
+   * \param delay the one-way light time of the ground links
+   */
+  void AddContactPlan (Ptr<const ContactPlan> plan, const std::vector<uint32_t> &satellites,
+                       const std::vector<uint32_t> &stations, DataRate rate, Time delay);
+
+  /// \return the number of contacts
+  uint32_t GetNContacts (void) const;
+
+  /**
+   * \param i a contact index
+   * \return the contact
+   */
+  const Contact &GetContact (uint32_t i) const;
+
+  /**
+   * \param from the transmitting node id
+   * \param to the receiving node id
+   * \param now the current time
+   * \return the index of the contact open at \p now, or -1
+   */
+  int32_t FindCurrentContact (uint32_t from, uint32_t to, Time now) const;
+
+  /**
+   * \param from the transmitting node id
+   * \param now the current time
+   * \return the start of the first contact from \p from that opens after
+   *         \p now, or Time::Max () if there is none
+   */
+  Time GetNextContactStart (uint32_t from, Time now) const;
+
+  /**
+   * \param from the node holding the bundle
+   * \param to the destination node
+   * \param now the current time
+   * \param bytes the size of the bundle on the wire
+   * \param route the route found
+   * \return true if the destination can be reached
+   */
+  bool FindRoute (uint32_t from, uint32_t to, Time now, uint32_t bytes, Route &route) const;
+
+  /**
+   * Reserve the volume of a bundle on one contact.
+   * \param contact a contact index
+   * \param bytes the size of the bundle on the wire
+   */
+  void Book (uint32_t contact, uint32_t bytes);
+
+  /**
+   * Give back the volume of a bundle on one contact.
+   * \param contact a contact index
+   * \param bytes the size of the bundle on the wire
+   */
+  void Release (uint32_t contact, uint32_t bytes);
+
+private:
+  std::vector<Contact> m_contacts;                         //!< Contacts
+  std::map<uint32_t, std::vector<uint32_t> > m_outgoing;   //!< Contacts by transmitting node
+};
+
+} // namespace ns3
+
+#endif /* CONTACT_GRAPH_H */
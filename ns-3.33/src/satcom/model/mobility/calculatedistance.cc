@@ -1,8 +1,16 @@
 #include <math.h>
 #include "ns3/calculatedistance.h"
 
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define SATCOM_LINK_GEOMETRY_AVX2
+#include <immintrin.h>
+#endif
+
 namespace ns3 {
 
+/// Distance beyond which CalculateDistance () and CalculateDistances () report INFINITY
+static const double MAX_DISTANCE = 9512610;
+
 double
 CalculateDistance(const Vector &a, const Vector &b)
 {
@@ -12,7 +20,202 @@ CalculateDistance(const Vector &a, const Vector &b)
 
     double euclidean_distance = sqrt (pow(kx,2) + pow(ky,2) + pow(kz,2));
 
-    return euclidean_distance > 9512610 ? double(INFINITY) : euclidean_distance;
+    return euclidean_distance > MAX_DISTANCE ? double(INFINITY) : euclidean_distance;
+}
+
+namespace {
+
+const double RAD_TO_DEG = 180.0 / M_PI;
+
+/**
+ * Scalar kernel, also used for the tail of the vectorized loop.
+ * Distances above \p maxDistance are written as INFINITY.
+ */
+void
+LinkGeometryScalar (const double *x, const double *y, const double *z, uint32_t begin, uint32_t end,
+                    const Vector &s, double *distance, double *elevation, double *delay, double speed,
+                    double maxDistance)
+{
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        double dx = s.x - x[i];
+        double dy = s.y - y[i];
+        double dz = s.z - z[i];
+        double d = sqrt (dx * dx + dy * dy + dz * dz);
+        if (distance)
+        {
+            distance[i] = d > maxDistance ? double (INFINITY) : d;
+        }
+        if (delay)
+        {
+            delay[i] = d / speed;
+        }
+        if (elevation)
+        {
+            double den = d * sqrt (x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+            double sinEl = den == 0 ? 1.0 : (dx * x[i] + dy * y[i] + dz * z[i]) / den;
+            sinEl = sinEl > 1.0 ? 1.0 : (sinEl < -1.0 ? -1.0 : sinEl);
+            elevation[i] = asin (sinEl) * RAD_TO_DEG;
+        }
+    }
+}
+
+#ifdef SATCOM_LINK_GEOMETRY_AVX2
+
+/// Number of odd terms of the arcsine series after the linear one
+const int ASIN_TERMS = 22;
+
+/**
+ * Coefficients of asin (t) = t + t * sum_k c_k t^(2k), k = 1..ASIN_TERMS.
+ * With |t| <= 0.5 the truncated series is exact to double precision.
+ */
+struct AsinSeries
+{
+    AsinSeries ()
+    {
+        double a = 1.0;
+        for (int k = 1; k <= ASIN_TERMS; ++k)
+        {
+            a *= (2.0 * k - 1.0) / (2.0 * k);
+            c[k - 1] = a / (2.0 * k + 1.0);
+        }
+    }
+    double c[ASIN_TERMS];
+};
+
+const AsinSeries g_asinSeries;
+
+/**
+ * Arcsine of four values in [-1, 1]. Arguments above 0.5 in magnitude
+ * are reduced with asin (x) = pi/2 - 2 asin (sqrt ((1 - x) / 2)).
+ */
+__attribute__ ((target ("avx2,fma"))) inline __m256d
+Asin4 (__m256d x)
+{
+    const __m256d signMask = _mm256_set1_pd (-0.0);
+    const __m256d half = _mm256_set1_pd (0.5);
+    __m256d sign = _mm256_and_pd (x, signMask);
+    __m256d ax = _mm256_andnot_pd (signMask, x);
+    __m256d big = _mm256_cmp_pd (ax, half, _CMP_GT_OQ);
+    __m256d reduced = _mm256_sqrt_pd (_mm256_mul_pd (_mm256_sub_pd (_mm256_set1_pd (1.0), ax), half));
+    __m256d t = _mm256_blendv_pd (ax, reduced, big);
+    __m256d t2 = _mm256_mul_pd (t, t);
+    __m256d p = _mm256_set1_pd (g_asinSeries.c[ASIN_TERMS - 1]);
+    for (int k = ASIN_TERMS - 2; k >= 0; --k)
+    {
+        p = _mm256_fmadd_pd (p, t2, _mm256_set1_pd (g_asinSeries.c[k]));
+    }
+    __m256d r = _mm256_fmadd_pd (_mm256_mul_pd (t, t2), p, t);
+    __m256d r2 = _mm256_fnmadd_pd (_mm256_set1_pd (2.0), r, _mm256_set1_pd (M_PI / 2));
+    r = _mm256_blendv_pd (r, r2, big);
+    return _mm256_or_pd (r, sign);
+}
+
+/**
+ * AVX2 kernel, four ground points per iteration.
+ * Distances above \p maxDistance are written as INFINITY.
+ * \return the index of the first point left to the scalar tail
+ */
+__attribute__ ((target ("avx2,fma"))) uint32_t
+LinkGeometryAvx2 (const double *x, const double *y, const double *z, uint32_t n,
+                  const Vector &s, double *distance, double *elevation, double *delay, double speed,
+                  double maxDistance)
+{
+    const __m256d sx = _mm256_set1_pd (s.x);
+    const __m256d sy = _mm256_set1_pd (s.y);
+    const __m256d sz = _mm256_set1_pd (s.z);
+    const __m256d vspeed = _mm256_set1_pd (speed);
+    const __m256d zero = _mm256_setzero_pd ();
+    const __m256d one = _mm256_set1_pd (1.0);
+    const __m256d minusOne = _mm256_set1_pd (-1.0);
+    const __m256d degrees = _mm256_set1_pd (RAD_TO_DEG);
+    const __m256d vmax = _mm256_set1_pd (maxDistance);
+    const __m256d infinity = _mm256_set1_pd (INFINITY);
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d gx = _mm256_loadu_pd (x + i);
+        __m256d gy = _mm256_loadu_pd (y + i);
+        __m256d gz = _mm256_loadu_pd (z + i);
+        __m256d dx = _mm256_sub_pd (sx, gx);
+        __m256d dy = _mm256_sub_pd (sy, gy);
+        __m256d dz = _mm256_sub_pd (sz, gz);
+        __m256d d = _mm256_sqrt_pd (_mm256_fmadd_pd (dz, dz, _mm256_fmadd_pd (dy, dy, _mm256_mul_pd (dx, dx))));
+        if (distance)
+        {
+            _mm256_storeu_pd (distance + i, _mm256_blendv_pd (d, infinity, _mm256_cmp_pd (d, vmax, _CMP_GT_OQ)));
+        }
+        if (delay)
+        {
+            _mm256_storeu_pd (delay + i, _mm256_div_pd (d, vspeed));
+        }
+        if (elevation)
+        {
+            __m256d r = _mm256_sqrt_pd (_mm256_fmadd_pd (gz, gz, _mm256_fmadd_pd (gy, gy, _mm256_mul_pd (gx, gx))));
+            __m256d den = _mm256_mul_pd (d, r);
+            __m256d dot = _mm256_fmadd_pd (dz, gz, _mm256_fmadd_pd (dy, gy, _mm256_mul_pd (dx, gx)));
+            __m256d sinEl = _mm256_div_pd (dot, den);
+            sinEl = _mm256_blendv_pd (sinEl, one, _mm256_cmp_pd (den, zero, _CMP_EQ_OQ));
+            sinEl = _mm256_max_pd (minusOne, _mm256_min_pd (one, sinEl));
+            _mm256_storeu_pd (elevation + i, _mm256_mul_pd (Asin4 (sinEl), degrees));
+        }
+    }
+    return i;
+}
+
+bool
+HaveAvx2 (void)
+{
+    static const bool have = __builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma");
+    return have;
+}
+
+#endif /* SATCOM_LINK_GEOMETRY_AVX2 */
+
+/**
+ * Run the vectorized kernel if the processor has it and the scalar one
+ * on what is left.
+ */
+void
+LinkGeometry (const double *x, const double *y, const double *z, uint32_t n,
+              const Vector &s, double *distance, double *elevation, double *delay, double speed,
+              double maxDistance)
+{
+    uint32_t done = 0;
+#ifdef SATCOM_LINK_GEOMETRY_AVX2
+    if (HaveAvx2 ())
+    {
+        done = LinkGeometryAvx2 (x, y, z, n, s, distance, elevation, delay, speed, maxDistance);
+    }
+#endif
+    LinkGeometryScalar (x, y, z, done, n, s, distance, elevation, delay, speed, maxDistance);
+}
+
+} // anonymous namespace
+
+void
+CalculateLinkGeometry (const double *x, const double *y, const double *z, uint32_t n,
+                       const Vector &satellite, double *distance, double *elevation,
+                       double *delay, double speed)
+{
+    LinkGeometry (x, y, z, n, satellite, distance, elevation, delay, speed, INFINITY);
+}
+
+void
+CalculateDistances (const double *x, const double *y, const double *z, uint32_t n,
+                    const Vector &target, double *distance)
+{
+    LinkGeometry (x, y, z, n, target, distance, 0, 0, 1.0, MAX_DISTANCE);
+}
+
+bool
+IsLinkGeometryVectorized (void)
+{
+#ifdef SATCOM_LINK_GEOMETRY_AVX2
+    return HaveAvx2 ();
+#else
+    return false;
+#endif
 }
 
 }
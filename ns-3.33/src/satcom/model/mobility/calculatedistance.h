@@ -3,11 +3,75 @@
 #ifndef CALCULATE_DISTANCE_H
 #define CALCULATE_DISTANCE_H
 
+#include <stdint.h>
 #include "ns3/vector.h"
+#include "ns3/satcom-constants.h"
 
 namespace ns3 {
 
+/**
+ * \ingroup satcom
+ * \brief Distance between two points, cut off at the radio horizon.
+ *
+ * \param a first point
+ * \param b second point
+ * \return the distance in m, or INFINITY above 9512610 m, the longest
+ *         range at which the points are taken to see each other
+ */
 double CalculateDistance(const Vector &a, const Vector &b);
 
+/**
+ * \ingroup satcom
+ * \brief Slant range, elevation and propagation delay from many ground
+ * points to one satellite in a single pass.
+ *
+ * The ground points are given as separate contiguous x, y and z arrays
+ * of \p n earth-centred coordinates in m. For each point i the function
+ * writes the distance to \p satellite in m, the elevation of the
+ * satellite above the local horizon of the point in degrees and the
+ * propagation delay in s. Any of the output arrays may be null when the
+ * quantity is not needed. Unlike CalculateDistance () the distances are
+ * not cut off at 9512610 m, the elevation tells whether the satellite
+ * is in sight. The kernel uses AVX2 when the processor supports it and
+ * a scalar loop otherwise; both give the same results to within a few
+ * ulp.
+ *
+ * \param x ground point x coordinates
+ * \param y ground point y coordinates
+ * \param z ground point z coordinates
+ * \param n number of ground points
+ * \param satellite satellite position
+ * \param distance output distances, or null
+ * \param elevation output elevations, or null
+ * \param delay output propagation delays, or null
+ * \param speed propagation speed in m/s
+ */
+void CalculateLinkGeometry (const double *x, const double *y, const double *z, uint32_t n,
+                            const Vector &satellite, double *distance, double *elevation,
+                            double *delay, double speed = satcom::SPEED_OF_LIGHT);
+
+/**
+ * \ingroup satcom
+ * \brief Distances from many points to one target, see CalculateLinkGeometry.
+ *
+ * The batch form of CalculateDistance (): distances above 9512610 m are
+ * written as INFINITY.
+ *
+ * \param x point x coordinates
+ * \param y point y coordinates
+ * \param z point z coordinates
+ * \param n number of points
+ * \param target target position
+ * \param distance output distances
+ */
+void CalculateDistances (const double *x, const double *y, const double *z, uint32_t n,
+                         const Vector &target, double *distance);
+
+/**
+ * \ingroup satcom
+ * \return true if the batch geometry kernels run vectorized on this processor
+ */
+bool IsLinkGeometryVectorized (void);
+
 }
 #endif
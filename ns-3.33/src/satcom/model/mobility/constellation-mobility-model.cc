@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "constellation-mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ConstellationMobilityModel");
+
+NS_OBJECT_ENSURE_REGISTERED (ConstellationMobilityModel);
+
+TypeId
+ConstellationMobilityModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ConstellationMobilityModel")
+    .SetParent<OrbitMobilityModel> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<ConstellationMobilityModel> ()
+  ;
+  return tid;
+}
+
+ConstellationMobilityModel::ConstellationMobilityModel ()
+  : m_index (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ConstellationMobilityModel::~ConstellationMobilityModel ()
+{
+}
+
+void
+ConstellationMobilityModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_propagator != 0)
+    {
+      m_propagator->Unregister (this);
+      m_propagator = 0;
+    }
+  OrbitMobilityModel::DoDispose ();
+}
+
+void
+ConstellationMobilityModel::SetPropagator (Ptr<ConstellationPropagator> propagator, uint32_t index)
+{
+  NS_LOG_FUNCTION (this << propagator << index);
+  m_propagator = propagator;
+  m_index = index;
+}
+
+uint32_t
+ConstellationMobilityModel::GetIndex (void) const
+{
+  return m_index;
+}
+
+void
+ConstellationMobilityModel::DoGetStateAt (double t, Vector &position, Vector &velocity) const
+{
+  NS_ASSERT_MSG (m_propagator != 0, "ConstellationMobilityModel used without a propagator");
+  // The propagator works in absolute simulation time.  Queries for the
+  // current time go through its stored state, others are computed alone.
+  Time now = Simulator::Now ();
+  if (t == (now - GetEpoch ()).GetSeconds ())
+    {
+      m_propagator->GetState (m_index, now, position, velocity);
+    }
+  else
+    {
+      m_propagator->GetStateAt (m_index, GetEpoch ().GetSeconds () + t, position, velocity);
+    }
+}
+
+void
+ConstellationMobilityModel::NotifyTick (void)
+{
+  NotifyCourseChange ();
+}
+
+} // namespace ns3
@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CONSTELLATION_MOBILITY_MODEL_H
+#define CONSTELLATION_MOBILITY_MODEL_H
+
+#include "ns3/orbit-mobility-model.h"
+#include "ns3/constellation-propagator.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Mobility of one satellite of a ConstellationPropagator.
+ *
+ * The model holds no orbit of its own: it reads the shared batch state of
+ * its propagator.  It is meant to run in the "Lazy" evaluation mode, which
+ * ConstellationPropagator::CreateMobilityModel selects, so that the only
+ * periodic event is the propagator tick.
+ */
+class ConstellationMobilityModel : public OrbitMobilityModel
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  ConstellationMobilityModel ();
+  virtual ~ConstellationMobilityModel ();
+
+  /**
+   * \param propagator the propagator holding the orbit
+   * \param index the satellite index in the propagator
+   */
+  void SetPropagator (Ptr<ConstellationPropagator> propagator, uint32_t index);
+
+  /**
+   * \returns the satellite index in the propagator
+   */
+  uint32_t GetIndex (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  friend class ConstellationPropagator;
+
+  virtual void DoGetStateAt (double t, Vector &position, Vector &velocity) const;
+
+  /// Called by the propagator tick
+  void NotifyTick (void);
+
+  Ptr<ConstellationPropagator> m_propagator;  //!< Shared batch state
+  uint32_t m_index;                           //!< Satellite index
+};
+
+} // namespace ns3
+
+#endif /* CONSTELLATION_MOBILITY_MODEL_H */
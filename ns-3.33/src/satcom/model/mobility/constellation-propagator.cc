@@ -0,0 +1,274 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "constellation-propagator.h"
+#include "constellation-mobility-model.h"
+#include "satcom-constants.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/enum.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ConstellationPropagator");
+
+NS_OBJECT_ENSURE_REGISTERED (ConstellationPropagator);
+
+TypeId
+ConstellationPropagator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ConstellationPropagator")
+    .SetParent<Object> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<ConstellationPropagator> ()
+    .AddAttribute ("NotificationInterval",
+                   "Period of the batched CourseChange notifications, "
+                   "zero disables them.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&ConstellationPropagator::m_notifyInterval),
+                   MakeTimeChecker (Seconds (0)))
+  ;
+  return tid;
+}
+
+ConstellationPropagator::ConstellationPropagator ()
+  : m_stateValid (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ConstellationPropagator::~ConstellationPropagator ()
+{
+}
+
+void
+ConstellationPropagator::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  m_models.clear ();
+  Object::DoDispose ();
+}
+
+uint32_t
+ConstellationPropagator::AddSatellite (double altitude, double inclination, double raan, double phase)
+{
+  NS_LOG_FUNCTION (this << altitude << inclination << raan << phase);
+  double radius = satcom::EARTH_RADIUS + altitude;
+  NS_ASSERT_MSG (radius > 0, "Orbit radius must be positive");
+  double inc = inclination * M_PI / 180.0;
+  double node = raan * M_PI / 180.0;
+
+  m_radius.push_back (radius);
+  m_meanMotion.push_back (std::sqrt (satcom::EARTH_MU / (radius * radius * radius)));
+  m_phase.push_back (phase * M_PI / 180.0);
+  m_cosRaan.push_back (std::cos (node));
+  m_sinRaan.push_back (std::sin (node));
+  m_cosInc.push_back (std::cos (inc));
+  m_sinInc.push_back (std::sin (inc));
+
+  uint32_t n = m_radius.size ();
+  m_cosU.resize (n);
+  m_sinU.resize (n);
+  m_x.resize (n);
+  m_y.resize (n);
+  m_z.resize (n);
+  m_vx.resize (n);
+  m_vy.resize (n);
+  m_vz.resize (n);
+  m_time.resize (n, Time::Min ());
+  m_stateValid = false;
+  return n - 1;
+}
+
+uint32_t
+ConstellationPropagator::AddWalkerDelta (uint32_t total, uint32_t planes, uint32_t phasing,
+                                         double altitude, double inclination)
+{
+  NS_LOG_FUNCTION (this << total << planes << phasing << altitude << inclination);
+  NS_ASSERT_MSG (planes > 0 && total % planes == 0,
+                 "The number of satellites must be a multiple of the number of planes");
+  uint32_t first = GetN ();
+  uint32_t perPlane = total / planes;
+  for (uint32_t p = 0; p < planes; ++p)
+    {
+      for (uint32_t s = 0; s < perPlane; ++s)
+        {
+          double raan = 360.0 * p / planes;
+          double phase = 360.0 * s / perPlane + 360.0 * phasing * p / total;
+          AddSatellite (altitude, inclination, raan, phase);
+        }
+    }
+  return first;
+}
+
+uint32_t
+ConstellationPropagator::GetN (void) const
+{
+  return m_radius.size ();
+}
+
+void
+ConstellationPropagator::Propagate (Time t)
+{
+  if (m_stateValid && t == m_stateTime)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << t);
+
+  const double ts = t.GetSeconds ();
+  const std::size_t n = m_radius.size ();
+
+  const double *radius = m_radius.data ();
+  const double *meanMotion = m_meanMotion.data ();
+  const double *phase = m_phase.data ();
+  const double *cosRaan = m_cosRaan.data ();
+  const double *sinRaan = m_sinRaan.data ();
+  const double *cosInc = m_cosInc.data ();
+  const double *sinInc = m_sinInc.data ();
+  double *cosU = m_cosU.data ();
+  double *sinU = m_sinU.data ();
+  double *x = m_x.data ();
+  double *y = m_y.data ();
+  double *z = m_z.data ();
+  double *vx = m_vx.data ();
+  double *vy = m_vy.data ();
+  double *vz = m_vz.data ();
+
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      double u = phase[i] + meanMotion[i] * ts;
+      cosU[i] = std::cos (u);
+      sinU[i] = std::sin (u);
+    }
+
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      double r = radius[i];
+      double rv = r * meanMotion[i];
+      double px = cosU[i];
+      double py = sinU[i] * cosInc[i];
+      double qx = -sinU[i];
+      double qy = cosU[i] * cosInc[i];
+      x[i] = r * (cosRaan[i] * px - sinRaan[i] * py);
+      y[i] = r * (sinRaan[i] * px + cosRaan[i] * py);
+      z[i] = r * sinU[i] * sinInc[i];
+      vx[i] = rv * (cosRaan[i] * qx - sinRaan[i] * qy);
+      vy[i] = rv * (sinRaan[i] * qx + cosRaan[i] * qy);
+      vz[i] = rv * cosU[i] * sinInc[i];
+    }
+
+  std::fill (m_time.begin (), m_time.end (), t);
+  m_stateTime = t;
+  m_stateValid = true;
+}
+
+void
+ConstellationPropagator::GetStateAt (uint32_t i, double t, Vector &position, Vector &velocity) const
+{
+  NS_ASSERT (i < m_radius.size ());
+  double u = m_phase[i] + m_meanMotion[i] * t;
+  double cu = std::cos (u);
+  double su = std::sin (u);
+  double r = m_radius[i];
+  double rv = r * m_meanMotion[i];
+  double py = su * m_cosInc[i];
+  double qy = cu * m_cosInc[i];
+  position = Vector (r * (m_cosRaan[i] * cu - m_sinRaan[i] * py),
+                     r * (m_sinRaan[i] * cu + m_cosRaan[i] * py),
+                     r * su * m_sinInc[i]);
+  velocity = Vector (rv * (-m_cosRaan[i] * su - m_sinRaan[i] * qy),
+                     rv * (-m_sinRaan[i] * su + m_cosRaan[i] * qy),
+                     rv * cu * m_sinInc[i]);
+}
+
+void
+ConstellationPropagator::GetState (uint32_t i, Time t, Vector &position, Vector &velocity)
+{
+  NS_ASSERT (i < m_radius.size ());
+  if (m_time[i] != t)
+    {
+      // Only this satellite, the batch is left to Propagate () and Tick ()
+      GetStateAt (i, t.GetSeconds (), position, velocity);
+      m_x[i] = position.x;
+      m_y[i] = position.y;
+      m_z[i] = position.z;
+      m_vx[i] = velocity.x;
+      m_vy[i] = velocity.y;
+      m_vz[i] = velocity.z;
+      m_time[i] = t;
+      m_stateValid = false;
+      return;
+    }
+  position = Vector (m_x[i], m_y[i], m_z[i]);
+  velocity = Vector (m_vx[i], m_vy[i], m_vz[i]);
+}
+
+Ptr<ConstellationMobilityModel>
+ConstellationPropagator::CreateMobilityModel (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  NS_ASSERT_MSG (i < GetN (), "No satellite " << i << " in the constellation");
+  Ptr<ConstellationMobilityModel> model = CreateObject<ConstellationMobilityModel> ();
+  model->SetAttribute ("EvaluationMode", EnumValue (OrbitMobilityModel::LAZY));
+  model->SetPropagator (this, i);
+  m_models.push_back (PeekPointer (model));
+  return model;
+}
+
+void
+ConstellationPropagator::Install (NodeContainer nodes, uint32_t first)
+{
+  NS_LOG_FUNCTION (this << first);
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      Ptr<Node> node = nodes.Get (i);
+      NS_ASSERT_MSG (node->GetObject<MobilityModel> () == 0,
+                     "Node " << node->GetId () << " already has a MobilityModel");
+      node->AggregateObject (CreateMobilityModel (first + i));
+    }
+  if (!m_notifyInterval.IsZero () && !m_event.IsRunning ())
+    {
+      m_event = Simulator::ScheduleNow (&ConstellationPropagator::Tick, this);
+    }
+}
+
+void
+ConstellationPropagator::Unregister (ConstellationMobilityModel *model)
+{
+  m_models.erase (std::remove (m_models.begin (), m_models.end (), model), m_models.end ());
+}
+
+void
+ConstellationPropagator::Tick (void)
+{
+  NS_LOG_FUNCTION (this);
+  Propagate (Simulator::Now ());
+  m_event = Simulator::Schedule (m_notifyInterval, &ConstellationPropagator::Tick, this);
+  // Copy, a trace sink could dispose of a model
+  std::vector<ConstellationMobilityModel *> models = m_models;
+  for (std::vector<ConstellationMobilityModel *>::iterator it = models.begin (); it != models.end (); ++it)
+    {
+      (*it)->NotifyTick ();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CONSTELLATION_PROPAGATOR_H
+#define CONSTELLATION_PROPAGATOR_H
+
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/vector.h"
+#include "ns3/node-container.h"
+
+namespace ns3 {
+
+class ConstellationMobilityModel;
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Propagates the circular orbits of a whole constellation at once.
+ *
+ * The orbital elements and the resulting states are kept in
+ * structure-of-arrays form.  Propagate () advances every satellite in one
+ * pass of branch-free loops over contiguous arrays, with the trigonometry
+ * isolated in its own loop, so the compiler can vectorize it.
+ *
+ * Per-satellite ConstellationMobilityModel objects read from the shared
+ * state, which is memoized per satellite: a query at the time of the
+ * stored state is a lookup, a query at another time computes that
+ * satellite alone and stores it, so the cost of a query does not grow
+ * with the constellation.  The whole batch is only propagated by
+ * Propagate () and by the ticks: if "NotificationInterval" is non-zero,
+ * one event per interval propagates the batch and fires CourseChange on
+ * every model, instead of one event chain per satellite.
+ */
+class ConstellationPropagator : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  ConstellationPropagator ();
+  virtual ~ConstellationPropagator ();
+
+  /**
+   * \brief Add a satellite on a circular orbit
+   * \param altitude altitude above the mean Earth radius in m
+   * \param inclination inclination in degrees
+   * \param raan right ascension of the ascending node in degrees
+   * \param phase argument of latitude at time zero in degrees
+   * \returns the satellite index
+   */
+  uint32_t AddSatellite (double altitude, double inclination, double raan, double phase);
+
+  /**
+   * \brief Add a Walker delta constellation i:t/p/f
+   * \param total number of satellites t
+   * \param planes number of equally spaced planes p
+   * \param phasing relative phasing f between adjacent planes
+   * \param altitude altitude above the mean Earth radius in m
+   * \param inclination inclination i in degrees
+   * \returns the index of the first added satellite
+   */
+  uint32_t AddWalkerDelta (uint32_t total, uint32_t planes, uint32_t phasing,
+                           double altitude, double inclination);
+
+  /**
+   * \returns the number of satellites
+   */
+  uint32_t GetN (void) const;
+
+  /**
+   * \brief Bring the state of every satellite to time t
+   *
+   * Does nothing if the batch already refers to t.
+   *
+   * \param t an absolute simulation time
+   */
+  void Propagate (Time t);
+
+  /**
+   * \brief Read the state of one satellite
+   *
+   * Served from the stored state when it refers to t, otherwise computed
+   * for that satellite alone and stored.
+   *
+   * \param i the satellite index
+   * \param t an absolute simulation time
+   * \param position the position at t
+   * \param velocity the velocity at t
+   */
+  void GetState (uint32_t i, Time t, Vector &position, Vector &velocity);
+
+  /**
+   * \brief Compute the state of one satellite without touching the batch
+   * \param i the satellite index
+   * \param t absolute simulation time in seconds
+   * \param position the position at t
+   * \param velocity the velocity at t
+   */
+  void GetStateAt (uint32_t i, double t, Vector &position, Vector &velocity) const;
+
+  /**
+   * \brief Aggregate a ConstellationMobilityModel to each node
+   *
+   * The i-th node follows satellite first + i.
+   *
+   * \param nodes the satellite nodes
+   * \param first index of the satellite of the first node
+   */
+  void Install (NodeContainer nodes, uint32_t first = 0);
+
+  /**
+   * \param i the satellite index
+   * \returns a new mobility model following satellite i
+   */
+  Ptr<ConstellationMobilityModel> CreateMobilityModel (uint32_t i);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  friend class ConstellationMobilityModel;
+
+  /// Forget a model that is being disposed
+  void Unregister (ConstellationMobilityModel *model);
+
+  /// Propagate and notify every model, then reschedule
+  void Tick (void);
+
+  Time m_notifyInterval;    //!< Period of batched CourseChange notifications
+  EventId m_event;          //!< Pending tick
+
+  // Elements, one entry per satellite
+  std::vector<double> m_radius;      //!< Orbit radius in m
+  std::vector<double> m_meanMotion;  //!< Mean motion in rad/s
+  std::vector<double> m_phase;       //!< Argument of latitude at t = 0 in rad
+  std::vector<double> m_cosRaan;     //!< cos of the RAAN
+  std::vector<double> m_sinRaan;     //!< sin of the RAAN
+  std::vector<double> m_cosInc;      //!< cos of the inclination
+  std::vector<double> m_sinInc;      //!< sin of the inclination
+
+  // State, one entry per satellite
+  std::vector<double> m_cosU;   //!< cos of the argument of latitude, scratch of Propagate ()
+  std::vector<double> m_sinU;   //!< sin of the argument of latitude, scratch of Propagate ()
+  std::vector<double> m_x;      //!< Position x
+  std::vector<double> m_y;      //!< Position y
+  std::vector<double> m_z;      //!< Position z
+  std::vector<double> m_vx;     //!< Velocity x
+  std::vector<double> m_vy;     //!< Velocity y
+  std::vector<double> m_vz;     //!< Velocity z
+  std::vector<Time> m_time;     //!< Time the state of each satellite refers to
+  Time m_stateTime;             //!< Time the whole batch refers to
+  bool m_stateValid;            //!< Whether every satellite is at m_stateTime
+
+  /// Models to notify on each tick, they unregister when disposed
+  std::vector<ConstellationMobilityModel *> m_models;
+};
+
+} // namespace ns3
+
+#endif /* CONSTELLATION_PROPAGATOR_H */
@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+
+#include "earth-rotation.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EarthRotation");
+
+NS_OBJECT_ENSURE_REGISTERED (EarthRotation);
+
+Ptr<EarthRotation> EarthRotation::s_default;
+
+TypeId
+EarthRotation::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::EarthRotation")
+    .SetParent<Object> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<EarthRotation> ()
+    .AddAttribute ("InitialGmst",
+                   "Greenwich mean sidereal time at simulation time zero, in degrees.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&EarthRotation::SetInitialGmst),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("RotationRate",
+                   "Sidereal rotation rate of the Earth in rad/s.",
+                   DoubleValue (7.2921158553e-5),
+                   MakeDoubleAccessor (&EarthRotation::SetRotationRate),
+                   MakeDoubleChecker<double> ())
+  ;
+  return tid;
+}
+
+EarthRotation::EarthRotation ()
+  : m_gmst0 (0),
+    m_rate (7.2921158553e-5),
+    m_cacheValid (false),
+    m_cacheTime (0),
+    m_cos (1),
+    m_sin (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+EarthRotation::~EarthRotation ()
+{
+}
+
+Ptr<EarthRotation>
+EarthRotation::GetDefault (void)
+{
+  if (s_default == 0)
+    {
+      s_default = CreateObject<EarthRotation> ();
+      Simulator::ScheduleDestroy (&EarthRotation::DestroyDefault);
+    }
+  return s_default;
+}
+
+void
+EarthRotation::DestroyDefault (void)
+{
+  s_default = 0;
+}
+
+void
+EarthRotation::SetInitialGmst (double gmst0)
+{
+  m_gmst0 = gmst0;
+  m_cacheValid = false;
+}
+
+void
+EarthRotation::SetRotationRate (double rate)
+{
+  m_rate = rate;
+  m_cacheValid = false;
+}
+
+double
+EarthRotation::GetGmst (double seconds) const
+{
+  double gmst = std::fmod (m_gmst0 * M_PI / 180.0 + m_rate * seconds, 2 * M_PI);
+  return gmst < 0 ? gmst + 2 * M_PI : gmst;
+}
+
+double
+EarthRotation::GetRate (void) const
+{
+  return m_rate;
+}
+
+void
+EarthRotation::Update (double seconds) const
+{
+  if (m_cacheValid && seconds == m_cacheTime)
+    {
+      return;
+    }
+  double gmst = GetGmst (seconds);
+  m_cos = std::cos (gmst);
+  m_sin = std::sin (gmst);
+  m_cacheTime = seconds;
+  m_cacheValid = true;
+}
+
+Vector
+EarthRotation::EcefToEci (const Vector &ecef, double seconds) const
+{
+  Update (seconds);
+  return Vector (m_cos * ecef.x - m_sin * ecef.y,
+                 m_sin * ecef.x + m_cos * ecef.y,
+                 ecef.z);
+}
+
+Vector
+EarthRotation::EciToEcef (const Vector &eci, double seconds) const
+{
+  Update (seconds);
+  return Vector (m_cos * eci.x + m_sin * eci.y,
+                 -m_sin * eci.x + m_cos * eci.y,
+                 eci.z);
+}
+
+Vector
+EarthRotation::GetSurfaceVelocity (const Vector &eci) const
+{
+  return Vector (-m_rate * eci.y, m_rate * eci.x, 0);
+}
+
+double
+EarthRotation::GetGmstFromJulianDate (double julianDate)
+{
+  double tut1 = (julianDate - 2451545.0) / 36525.0;
+  double seconds = 67310.54841 + (876600.0 * 3600.0 + 8640184.812866) * tut1
+    + 0.093104 * tut1 * tut1 - 6.2e-6 * tut1 * tut1 * tut1;
+  double gmst = std::fmod (seconds * M_PI / 43200.0, 2 * M_PI);
+  return gmst < 0 ? gmst + 2 * M_PI : gmst;
+}
+
+} // namespace ns3
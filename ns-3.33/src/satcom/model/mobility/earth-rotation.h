@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EARTH_ROTATION_H
+#define EARTH_ROTATION_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Rotation between the Earth-fixed (ECEF) and the inertial (ECI)
+ * frame.
+ *
+ * The Earth turns about the z axis at a constant rate from a given
+ * Greenwich mean sidereal time at simulation time zero; precession and
+ * nutation are ignored. The rotation for the last queried instant is
+ * cached, so all the ground stations evaluated at one timestamp share a
+ * single cosine and sine instead of recomputing them per node; setting
+ * an attribute drops it. The attributes are write-only.
+ *
+ * The GetDefault () instance is shared by every model that is not given
+ * its own. It lives for one simulation: Simulator::Destroy () releases
+ * it, and the next run gets a fresh instance from the attribute
+ * defaults.
+ */
+class EarthRotation : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  EarthRotation ();
+  virtual ~EarthRotation ();
+
+  /**
+   * \return the instance used by models without an explicit one,
+   *         created on first use in each simulation
+   */
+  static Ptr<EarthRotation> GetDefault (void);
+
+  /**
+   * \param seconds absolute simulation time in seconds
+   * \return the Greenwich mean sidereal time in radians, in [0, 2 pi)
+   */
+  double GetGmst (double seconds) const;
+
+  /**
+   * \return the sidereal rotation rate in rad/s
+   */
+  double GetRate (void) const;
+
+  /**
+   * \param ecef an Earth-fixed position
+   * \param seconds absolute simulation time in seconds
+   * \return the same position in the inertial frame
+   */
+  Vector EcefToEci (const Vector &ecef, double seconds) const;
+
+  /**
+   * \param eci an inertial position
+   * \param seconds absolute simulation time in seconds
+   * \return the same position in the Earth-fixed frame
+   */
+  Vector EciToEcef (const Vector &eci, double seconds) const;
+
+  /**
+   * \param eci an inertial position
+   * \return the inertial velocity of a point fixed to the Earth there
+   */
+  Vector GetSurfaceVelocity (const Vector &eci) const;
+
+  /**
+   * \param julianDate a UT1 Julian date
+   * \return the Greenwich mean sidereal time at that date in radians (IAU 1982)
+   */
+  static double GetGmstFromJulianDate (double julianDate);
+
+private:
+  /// Refresh the cached rotation if \p seconds is a new instant
+  void Update (double seconds) const;
+
+  /**
+   * \param gmst0 the GMST at simulation time zero in degrees
+   */
+  void SetInitialGmst (double gmst0);
+  /**
+   * \param rate the rotation rate in rad/s
+   */
+  void SetRotationRate (double rate);
+
+  /// Release the default instance at Simulator::Destroy ()
+  static void DestroyDefault (void);
+
+  /// The default instance of the current simulation, if created
+  static Ptr<EarthRotation> s_default;
+
+  double m_gmst0;              //!< GMST at simulation time zero, degrees
+  double m_rate;               //!< Rotation rate in rad/s
+
+  mutable bool m_cacheValid;   //!< Whether the cached rotation may be used
+  mutable double m_cacheTime;  //!< Instant the cached rotation refers to
+  mutable double m_cos;        //!< Cosine of the cached GMST
+  mutable double m_sin;        //!< Sine of the cached GMST
+};
+
+} // namespace ns3
+
+#endif /* EARTH_ROTATION_H */
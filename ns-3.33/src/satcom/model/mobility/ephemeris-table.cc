@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include "ephemeris-table.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EphemerisTable");
+
+namespace {
+
+/// On-disk header, see EphemerisTable
+struct EphemerisHeader
+{
+  char magic[8];      //!< "SATEPHM1"
+  uint64_t key;       //!< Identity of the contents
+  uint64_t count;     //!< Number of samples
+  double start;       //!< Time of the first sample in s
+  double step;        //!< Sampling step in s
+};
+
+const char EPHEMERIS_MAGIC[8] = { 'S', 'A', 'T', 'E', 'P', 'H', 'M', '1' };
+
+/// Doubles per sample
+const uint64_t SAMPLE_SIZE = 6;
+
+} // anonymous namespace
+
+EphemerisTable::EphemerisTable ()
+  : m_start (0),
+    m_step (0),
+    m_count (0),
+    m_samples (0)
+{
+}
+
+EphemerisTable::~EphemerisTable ()
+{
+}
+
+void
+EphemerisTable::Reset (double start, double step, uint64_t count)
+{
+  NS_LOG_FUNCTION (this << start << step << count);
+  NS_ASSERT_MSG (step > 0 && count >= 2, "An ephemeris needs at least two samples");
+  m_file.Close ();
+  m_start = start;
+  m_step = step;
+  m_count = count;
+  m_storage.assign (count * SAMPLE_SIZE, 0.0);
+  m_samples = m_storage.data ();
+}
+
+void
+EphemerisTable::Set (uint64_t i, const Vector &position, const Vector &velocity)
+{
+  NS_ASSERT_MSG (m_samples == m_storage.data () && i < m_count, "Sample out of range");
+  double *s = &m_storage[i * SAMPLE_SIZE];
+  s[0] = position.x;
+  s[1] = position.y;
+  s[2] = position.z;
+  s[3] = velocity.x;
+  s[4] = velocity.y;
+  s[5] = velocity.z;
+}
+
+bool
+EphemerisTable::IsEmpty (void) const
+{
+  return m_count == 0;
+}
+
+bool
+EphemerisTable::Contains (double t) const
+{
+  return m_count >= 2 && t >= m_start && t <= m_start + m_step * (m_count - 1);
+}
+
+double
+EphemerisTable::GetStart (void) const
+{
+  return m_start;
+}
+
+double
+EphemerisTable::GetStep (void) const
+{
+  return m_step;
+}
+
+uint64_t
+EphemerisTable::GetCount (void) const
+{
+  return m_count;
+}
+
+void
+EphemerisTable::Interpolate (double t, Vector &position, Vector &velocity) const
+{
+  NS_ASSERT_MSG (Contains (t), "Time " << t << "s is outside of the ephemeris");
+  double x = (t - m_start) / m_step;
+  uint64_t k = static_cast<uint64_t> (std::floor (x));
+  if (k >= m_count - 1)
+    {
+      k = m_count - 2;
+    }
+  double s = x - k;
+  double h = m_step;
+
+  // Cubic Hermite basis and its derivative
+  double s2 = s * s;
+  double s3 = s2 * s;
+  double h00 = 2 * s3 - 3 * s2 + 1;
+  double h10 = s3 - 2 * s2 + s;
+  double h01 = -2 * s3 + 3 * s2;
+  double h11 = s3 - s2;
+  double d00 = (6 * s2 - 6 * s) / h;
+  double d10 = 3 * s2 - 4 * s + 1;
+  double d01 = (-6 * s2 + 6 * s) / h;
+  double d11 = 3 * s2 - 2 * s;
+
+  const double *a = m_samples + k * SAMPLE_SIZE;
+  const double *b = a + SAMPLE_SIZE;
+  double p[3];
+  double v[3];
+  for (int j = 0; j < 3; ++j)
+    {
+      p[j] = h00 * a[j] + h10 * h * a[j + 3] + h01 * b[j] + h11 * h * b[j + 3];
+      v[j] = d00 * a[j] + d10 * a[j + 3] + d01 * b[j] + d11 * b[j + 3];
+    }
+  position = Vector (p[0], p[1], p[2]);
+  velocity = Vector (v[0], v[1], v[2]);
+}
+
+bool
+EphemerisTable::Save (const std::string &filename, uint64_t key) const
+{
+  NS_LOG_FUNCTION (this << filename << key);
+  std::ofstream out (filename.c_str (), std::ios::binary | std::ios::trunc);
+  if (!out)
+    {
+      NS_LOG_WARN ("Cannot write ephemeris file " << filename);
+      return false;
+    }
+  EphemerisHeader header;
+  std::memcpy (header.magic, EPHEMERIS_MAGIC, sizeof (header.magic));
+  header.key = key;
+  header.count = m_count;
+  header.start = m_start;
+  header.step = m_step;
+  out.write (reinterpret_cast<const char *> (&header), sizeof (header));
+  out.write (reinterpret_cast<const char *> (m_samples), m_count * SAMPLE_SIZE * sizeof (double));
+  return out.good ();
+}
+
+bool
+EphemerisTable::Load (const std::string &filename, uint64_t key)
+{
+  NS_LOG_FUNCTION (this << filename << key);
+  MappedFile file;
+  if (!file.Open (filename, sizeof (EphemerisHeader)))
+    {
+      return false;
+    }
+
+  const EphemerisHeader *header = static_cast<const EphemerisHeader *> (file.GetData ());
+  bool valid = std::memcmp (header->magic, EPHEMERIS_MAGIC, sizeof (header->magic)) == 0
+    && header->key == key
+    && header->count >= 2
+    && header->step > 0
+    && file.GetSize () == sizeof (EphemerisHeader) + header->count * SAMPLE_SIZE * sizeof (double);
+  if (!valid)
+    {
+      NS_LOG_INFO ("Ephemeris file " << filename << " does not match, ignoring it");
+      return false;
+    }
+
+  m_file.Swap (file);
+  m_storage.clear ();
+  m_start = header->start;
+  m_step = header->step;
+  m_count = header->count;
+  m_samples = reinterpret_cast<const double *> (static_cast<const char *> (m_file.GetData ()) + sizeof (EphemerisHeader));
+  return true;
+}
+
+} // namespace ns3
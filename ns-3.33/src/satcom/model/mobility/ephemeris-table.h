@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EPHEMERIS_TABLE_H
+#define EPHEMERIS_TABLE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ns3/vector.h"
+#include "ns3/mapped-file.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Equally spaced position/velocity samples of one orbit, served by
+ * cubic Hermite interpolation.
+ *
+ * Each sample holds the position and the velocity, so the interpolant
+ * matches both at every node and a coarse step (tens of seconds in LEO)
+ * keeps the error well below a meter.
+ *
+ * A table can be saved to a binary file and mapped back into memory with
+ * mmap; the mapped samples are used in place, so loading costs no
+ * propagation and no copy.  The file layout is a fixed header followed
+ * by six native doubles per sample (x, y, z, vx, vy, vz):
+ *
+ * \verbatim
+   char     magic[8]     "SATEPHM1"
+   uint64_t key          caller-defined identity of the table contents
+   uint64_t count        number of samples
+   double   start        time of the first sample in s
+   double   step         sampling step in s
+   \endverbatim
+ */
+class EphemerisTable
+{
+public:
+  EphemerisTable ();
+  ~EphemerisTable ();
+
+  /**
+   * \brief Drop any content and allocate count zeroed samples
+   * \param start time of the first sample in s
+   * \param step sampling step in s
+   * \param count number of samples, at least two
+   */
+  void Reset (double start, double step, uint64_t count);
+
+  /**
+   * \brief Fill one sample of a table created by Reset ()
+   * \param i the sample index
+   * \param position the position
+   * \param velocity the velocity
+   */
+  void Set (uint64_t i, const Vector &position, const Vector &velocity);
+
+  /**
+   * \returns true if the table holds samples
+   */
+  bool IsEmpty (void) const;
+
+  /**
+   * \param t time in s
+   * \returns true if t lies within the sampled interval
+   */
+  bool Contains (double t) const;
+
+  /**
+   * \param t time in s, within the sampled interval
+   * \param position the interpolated position
+   * \param velocity the interpolated velocity
+   */
+  void Interpolate (double t, Vector &position, Vector &velocity) const;
+
+  /**
+   * \param filename the file to write
+   * \param key identity of the contents, checked by Load ()
+   * \returns true on success
+   */
+  bool Save (const std::string &filename, uint64_t key) const;
+
+  /**
+   * \brief Map a file written by Save ()
+   * \param filename the file to map
+   * \param key the expected identity of the contents
+   * \returns true if the file exists, is well formed and matches key
+   */
+  bool Load (const std::string &filename, uint64_t key);
+
+  /**
+   * \returns the time of the first sample in s
+   */
+  double GetStart (void) const;
+
+  /**
+   * \returns the sampling step in s
+   */
+  double GetStep (void) const;
+
+  /**
+   * \returns the number of samples
+   */
+  uint64_t GetCount (void) const;
+
+private:
+  /// Not copyable, the samples may live in a mapping
+  EphemerisTable (const EphemerisTable &);
+  /// Not copyable, the samples may live in a mapping
+  EphemerisTable & operator = (const EphemerisTable &);
+
+  double m_start;                 //!< Time of the first sample in s
+  double m_step;                  //!< Sampling step in s
+  uint64_t m_count;               //!< Number of samples
+  std::vector<double> m_storage;  //!< Samples built in memory
+  const double *m_samples;        //!< Samples in use, owned or mapped
+  MappedFile m_file;              //!< Mapped file, if loaded
+};
+
+} // namespace ns3
+
+#endif /* EPHEMERIS_TABLE_H */
@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+
+#include "ground-station-mobility-model.h"
+#include "satcom-constants.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("GroundStationMobilityModel");
+
+NS_OBJECT_ENSURE_REGISTERED (GroundStationMobilityModel);
+
+TypeId
+GroundStationMobilityModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::GroundStationMobilityModel")
+    .SetParent<OrbitMobilityModel> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<GroundStationMobilityModel> ()
+    .AddAttribute ("EarthRotation",
+                   "The Earth rotation to follow, the shared default one if unset.",
+                   PointerValue (),
+                   MakePointerAccessor (&GroundStationMobilityModel::m_rotation),
+                   MakePointerChecker<EarthRotation> ())
+  ;
+  return tid;
+}
+
+GroundStationMobilityModel::GroundStationMobilityModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+GroundStationMobilityModel::~GroundStationMobilityModel ()
+{
+}
+
+const EarthRotation *
+GroundStationMobilityModel::GetRotation (void) const
+{
+  return m_rotation != 0 ? PeekPointer (m_rotation) : PeekPointer (EarthRotation::GetDefault ());
+}
+
+void
+GroundStationMobilityModel::SetEcefPosition (const Vector &position)
+{
+  NS_LOG_FUNCTION (this << position);
+  m_ecef = position;
+  OrbitMobilityModel::DoSetPosition (GetRotation ()->EcefToEci (m_ecef, Simulator::Now ().GetSeconds ()));
+}
+
+Vector
+GroundStationMobilityModel::GetEcefPosition (void) const
+{
+  return m_ecef;
+}
+
+void
+GroundStationMobilityModel::SetGeographicPosition (double latitude, double longitude, double altitude)
+{
+  double lat = latitude * M_PI / 180.0;
+  double lon = longitude * M_PI / 180.0;
+  double r = satcom::EARTH_RADIUS + altitude;
+  SetEcefPosition (Vector (r * std::cos (lat) * std::cos (lon),
+                           r * std::cos (lat) * std::sin (lon),
+                           r * std::sin (lat)));
+}
+
+void
+GroundStationMobilityModel::DoSetPosition (const Vector &position)
+{
+  NS_LOG_FUNCTION (this << position);
+  m_ecef = GetRotation ()->EciToEcef (position, Simulator::Now ().GetSeconds ());
+  OrbitMobilityModel::DoSetPosition (position);
+}
+
+void
+GroundStationMobilityModel::DoGetStateAt (double t, Vector &position, Vector &velocity) const
+{
+  const EarthRotation *rotation = GetRotation ();
+  position = rotation->EcefToEci (m_ecef, GetEpoch ().GetSeconds () + t);
+  velocity = rotation->GetSurfaceVelocity (position);
+}
+
+} // namespace ns3
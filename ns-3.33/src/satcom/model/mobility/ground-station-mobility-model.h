@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef GROUND_STATION_MOBILITY_MODEL_H
+#define GROUND_STATION_MOBILITY_MODEL_H
+
+#include "ns3/orbit-mobility-model.h"
+#include "ns3/earth-rotation.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief A point fixed to the rotating Earth, reported in the inertial
+ * frame of the orbit models.
+ *
+ * The station keeps its Earth-fixed position and rotates it with the
+ * shared EarthRotation, so stations and satellites are compared in the
+ * same frame. SetPosition () takes an inertial position at the current
+ * time; with the default zero initial sidereal time, a position set at
+ * simulation time zero is also the Earth-fixed one, so position
+ * allocators written for fixed stations keep working. Use the Lazy
+ * evaluation mode unless periodic CourseChange events are wanted.
+ */
+class GroundStationMobilityModel : public OrbitMobilityModel
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  GroundStationMobilityModel ();
+  virtual ~GroundStationMobilityModel ();
+
+  /**
+   * \param position the Earth-fixed position in m
+   */
+  void SetEcefPosition (const Vector &position);
+
+  /**
+   * \return the Earth-fixed position in m
+   */
+  Vector GetEcefPosition (void) const;
+
+  /**
+   * Place the station on the spherical Earth of radius satcom::EARTH_RADIUS.
+   * \param latitude geocentric latitude in degrees
+   * \param longitude longitude in degrees, east positive
+   * \param altitude height above the sphere in m
+   */
+  void SetGeographicPosition (double latitude, double longitude, double altitude = 0);
+
+private:
+  virtual void DoGetStateAt (double t, Vector &position, Vector &velocity) const;
+  virtual void DoSetPosition (const Vector &position);
+
+  /// \return the rotation in use
+  const EarthRotation *GetRotation (void) const;
+
+  Ptr<EarthRotation> m_rotation;  //!< Rotation, null for the default one
+  Vector m_ecef;                  //!< Earth-fixed position
+};
+
+} // namespace ns3
+
+#endif /* GROUND_STATION_MOBILITY_MODEL_H */
@@ -0,0 +1,399 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+
+#include "j2-orbit-mobility-model.h"
+#include "satcom-constants.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("J2OrbitMobilityModel");
+
+NS_OBJECT_ENSURE_REGISTERED (J2OrbitMobilityModel);
+
+/// Node drift of a sun-synchronous orbit: one turn per tropical year, in rad/s
+static const double SUN_SYNCHRONOUS_RATE = 2 * M_PI / (365.2422 * 86400.0);
+
+TypeId
+J2OrbitMobilityModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::J2OrbitMobilityModel")
+    .SetParent<OrbitMobilityModel> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<J2OrbitMobilityModel> ()
+    .AddAttribute ("Altitude",
+                   "Altitude of the semi-major axis above the mean Earth radius, in m.",
+                   DoubleValue (693000.0),
+                   MakeDoubleAccessor (&J2OrbitMobilityModel::SetAltitude),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("Eccentricity",
+                   "Orbit eccentricity.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&J2OrbitMobilityModel::SetEccentricity),
+                   MakeDoubleChecker<double> (0.0, 0.99))
+    .AddAttribute ("Inclination",
+                   "Inclination in degrees, ignored if SunSynchronous is set.",
+                   DoubleValue (98.18),
+                   MakeDoubleAccessor (&J2OrbitMobilityModel::SetInclination),
+                   MakeDoubleChecker<double> (0.0, 180.0))
+    .AddAttribute ("Raan",
+                   "Right ascension of the ascending node at the epoch, in degrees.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&J2OrbitMobilityModel::SetRaan),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("ArgumentOfPerigee",
+                   "Argument of perigee at the epoch, in degrees.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&J2OrbitMobilityModel::SetArgumentOfPerigee),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("MeanAnomaly",
+                   "Mean anomaly at the epoch, in degrees.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&J2OrbitMobilityModel::SetMeanAnomaly),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("SunSynchronous",
+                   "Derive the inclination so that the ascending node turns "
+                   "once per tropical year.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&J2OrbitMobilityModel::SetSunSynchronous),
+                   MakeBooleanChecker ())
+    .AddAttribute ("RepeatOrbits",
+                   "Number of orbits of the ground track repeat cycle; if "
+                   "non-zero the altitude is derived from it and RepeatDays.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&J2OrbitMobilityModel::SetRepeatOrbits),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("RepeatDays",
+                   "Number of days of the ground track repeat cycle.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&J2OrbitMobilityModel::SetRepeatDays),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("EarthFixed",
+                   "Report positions in the Earth-fixed frame instead of the "
+                   "inertial one.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&J2OrbitMobilityModel::SetEarthFixed),
+                   MakeBooleanChecker ())
+    .AddAttribute ("EarthRotation",
+                   "The Earth rotation of the Earth-fixed frame and of the "
+                   "repeat cycle, the shared default one if unset.",
+                   PointerValue (),
+                   MakePointerAccessor (&J2OrbitMobilityModel::SetEarthRotation),
+                   MakePointerChecker<EarthRotation> ())
+  ;
+  return tid;
+}
+
+J2OrbitMobilityModel::J2OrbitMobilityModel ()
+  : m_altitude (693000.0),
+    m_eccentricity (0),
+    m_inclination (98.18),
+    m_raan (0),
+    m_argPerigee (0),
+    m_meanAnomaly (0),
+    m_sunSynchronous (false),
+    m_repeatOrbits (0),
+    m_repeatDays (1),
+    m_earthFixed (false),
+    m_prepared (false),
+    m_a (0),
+    m_cosI (1),
+    m_sinI (0),
+    m_raanRate (0),
+    m_perigeeRate (0),
+    m_meanMotion (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+J2OrbitMobilityModel::~J2OrbitMobilityModel ()
+{
+}
+
+const EarthRotation *
+J2OrbitMobilityModel::GetRotation (void) const
+{
+  return m_rotation != 0 ? PeekPointer (m_rotation) : PeekPointer (EarthRotation::GetDefault ());
+}
+
+void
+J2OrbitMobilityModel::Reset (void)
+{
+  m_prepared = false;
+  ResetState ();
+}
+
+void
+J2OrbitMobilityModel::SetAltitude (double altitude)
+{
+  m_altitude = altitude;
+  Reset ();
+}
+
+void
+J2OrbitMobilityModel::SetEccentricity (double eccentricity)
+{
+  m_eccentricity = eccentricity;
+  Reset ();
+}
+
+void
+J2OrbitMobilityModel::SetInclination (double inclination)
+{
+  m_inclination = inclination;
+  Reset ();
+}
+
+void
+J2OrbitMobilityModel::SetRaan (double raan)
+{
+  m_raan = raan;
+  Reset ();
+}
+
+void
+J2OrbitMobilityModel::SetArgumentOfPerigee (double argPerigee)
+{
+  m_argPerigee = argPerigee;
+  Reset ();
+}
+
+void
+J2OrbitMobilityModel::SetMeanAnomaly (double meanAnomaly)
+{
+  m_meanAnomaly = meanAnomaly;
+  Reset ();
+}
+
+void
+J2OrbitMobilityModel::SetSunSynchronous (bool sunSynchronous)
+{
+  m_sunSynchronous = sunSynchronous;
+  Reset ();
+}
+
+void
+J2OrbitMobilityModel::SetRepeatOrbits (uint32_t orbits)
+{
+  m_repeatOrbits = orbits;
+  Reset ();
+}
+
+void
+J2OrbitMobilityModel::SetRepeatDays (uint32_t days)
+{
+  m_repeatDays = days;
+  Reset ();
+}
+
+void
+J2OrbitMobilityModel::SetEarthFixed (bool earthFixed)
+{
+  m_earthFixed = earthFixed;
+  Reset ();
+}
+
+void
+J2OrbitMobilityModel::SetEarthRotation (Ptr<EarthRotation> rotation)
+{
+  m_rotation = rotation;
+  Reset ();
+}
+
+void
+J2OrbitMobilityModel::GetRates (double a, double e, double cosI,
+                                double &raanRate, double &perigeeRate, double &meanMotion)
+{
+  double n = std::sqrt (satcom::EARTH_MU / (a * a * a));
+  double p = a * (1 - e * e);
+  double k = satcom::EARTH_J2 * (satcom::EARTH_EQUATORIAL_RADIUS / p) * (satcom::EARTH_EQUATORIAL_RADIUS / p);
+  raanRate = -1.5 * n * k * cosI;
+  perigeeRate = 0.75 * n * k * (5 * cosI * cosI - 1);
+  meanMotion = n * (1 + 0.75 * k * std::sqrt (1 - e * e) * (3 * cosI * cosI - 1));
+}
+
+double
+J2OrbitMobilityModel::GetSunSynchronousInclination (double semiMajorAxis, double eccentricity)
+{
+  double raanRate, perigeeRate, meanMotion;
+  GetRates (semiMajorAxis, eccentricity, 1.0, raanRate, perigeeRate, meanMotion);
+  // The node drift is proportional to cos i, raanRate is its value at i = 0
+  double cosI = SUN_SYNCHRONOUS_RATE / raanRate;
+  if (cosI < -1)
+    {
+      return -1;
+    }
+  return std::acos (cosI) * 180.0 / M_PI;
+}
+
+void
+J2OrbitMobilityModel::Prepare (void) const
+{
+  if (m_prepared)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  double e = m_eccentricity;
+  double a = satcom::EARTH_RADIUS + m_altitude;
+  if (m_repeatOrbits > 0)
+    {
+      // The ground track repeats when the satellite completes RepeatOrbits
+      // nodal periods while the Earth turns RepeatDays times with respect
+      // to the drifting node. The nodal rate decreases with the altitude,
+      // faster than the node drift changes, so bisect on the altitude.
+      double ratio = double (m_repeatOrbits) / m_repeatDays;
+      double earthRate = GetRotation ()->GetRate ();
+      double low = satcom::EARTH_RADIUS + 100e3;
+      double high = satcom::EARTH_RADIUS + 5000e3;
+      for (uint32_t i = 0; i < 100; i++)
+        {
+          a = (low + high) / 2;
+          double cosI = std::cos (m_inclination * M_PI / 180.0);
+          if (m_sunSynchronous)
+            {
+              double inclination = GetSunSynchronousInclination (a, e);
+              NS_ABORT_MSG_IF (inclination < 0, "No sun-synchronous orbit repeats "
+                               << m_repeatOrbits << " times in " << m_repeatDays << " days");
+              cosI = std::cos (inclination * M_PI / 180.0);
+            }
+          double raanRate, perigeeRate, meanMotion;
+          GetRates (a, e, cosI, raanRate, perigeeRate, meanMotion);
+          if (meanMotion + perigeeRate > ratio * (earthRate - raanRate))
+            {
+              low = a;
+            }
+          else
+            {
+              high = a;
+            }
+        }
+      NS_ABORT_MSG_IF (a < satcom::EARTH_RADIUS + 101e3 || a > satcom::EARTH_RADIUS + 4999e3,
+                       "No orbit repeats " << m_repeatOrbits << " times in " << m_repeatDays << " days");
+    }
+  double inclination = m_inclination;
+  if (m_sunSynchronous)
+    {
+      inclination = GetSunSynchronousInclination (a, e);
+      NS_ABORT_MSG_IF (inclination < 0, "No sun-synchronous orbit at a semi-major axis of " << a << " m");
+    }
+  m_a = a;
+  m_cosI = std::cos (inclination * M_PI / 180.0);
+  m_sinI = std::sin (inclination * M_PI / 180.0);
+  GetRates (m_a, e, m_cosI, m_raanRate, m_perigeeRate, m_meanMotion);
+  NS_LOG_DEBUG ("a " << m_a << " i " << inclination << " raan rate " << m_raanRate
+                << " perigee rate " << m_perigeeRate << " mean motion " << m_meanMotion);
+  m_prepared = true;
+}
+
+double
+J2OrbitMobilityModel::GetSemiMajorAxis (void) const
+{
+  Prepare ();
+  return m_a;
+}
+
+double
+J2OrbitMobilityModel::GetInclination (void) const
+{
+  Prepare ();
+  return std::atan2 (m_sinI, m_cosI) * 180.0 / M_PI;
+}
+
+double
+J2OrbitMobilityModel::GetRaanRate (void) const
+{
+  Prepare ();
+  return m_raanRate;
+}
+
+double
+J2OrbitMobilityModel::GetNodalPeriod (void) const
+{
+  Prepare ();
+  return 2 * M_PI / (m_meanMotion + m_perigeeRate);
+}
+
+void
+J2OrbitMobilityModel::DoGetStateAt (double t, Vector &position, Vector &velocity) const
+{
+  Prepare ();
+  double e = m_eccentricity;
+  double meanAnomaly = std::fmod (m_meanAnomaly * M_PI / 180.0 + m_meanMotion * t, 2 * M_PI);
+  double perigee = m_argPerigee * M_PI / 180.0 + m_perigeeRate * t;
+  double raan = m_raan * M_PI / 180.0 + m_raanRate * t;
+
+  // Kepler equation, by Newton iteration from a start that converges for
+  // every eccentricity below one
+  double E = e < 0.8 ? meanAnomaly : M_PI;
+  for (uint32_t i = 0; e > 0 && i < 20; i++)
+    {
+      double delta = (E - e * std::sin (E) - meanAnomaly) / (1 - e * std::cos (E));
+      E -= delta;
+      if (std::fabs (delta) < 1e-12)
+        {
+          break;
+        }
+    }
+  double cosE = std::cos (E);
+  double sinE = std::sin (E);
+  double root = std::sqrt (1 - e * e);
+
+  // Perifocal position, and its derivative: the mean anomaly and the
+  // perigee advance at their secular rates
+  double x = m_a * (cosE - e);
+  double y = m_a * root * sinE;
+  double dE = m_meanMotion / (1 - e * cosE);
+  double vx = -m_a * sinE * dE - m_perigeeRate * y;
+  double vy = m_a * root * cosE * dE + m_perigeeRate * x;
+
+  double cosO = std::cos (raan);
+  double sinO = std::sin (raan);
+  double cosW = std::cos (perigee);
+  double sinW = std::sin (perigee);
+  Vector p (cosO * cosW - sinO * sinW * m_cosI,
+            sinO * cosW + cosO * sinW * m_cosI,
+            sinW * m_sinI);
+  Vector q (-cosO * sinW - sinO * cosW * m_cosI,
+            -sinO * sinW + cosO * cosW * m_cosI,
+            cosW * m_sinI);
+  position = Vector (x * p.x + y * q.x, x * p.y + y * q.y, x * p.z + y * q.z);
+  // The node drift turns the whole orbit about the z axis
+  velocity = Vector (vx * p.x + vy * q.x - m_raanRate * position.y,
+                     vx * p.y + vy * q.y + m_raanRate * position.x,
+                     vx * p.z + vy * q.z);
+
+  if (m_earthFixed)
+    {
+      const EarthRotation *rotation = GetRotation ();
+      double gmst = rotation->GetGmst (GetEpoch ().GetSeconds () + t);
+      double c = std::cos (gmst);
+      double s = std::sin (gmst);
+      Vector surface = rotation->GetSurfaceVelocity (position);
+      Vector v = velocity - surface;
+      position = Vector (c * position.x + s * position.y, -s * position.x + c * position.y, position.z);
+      velocity = Vector (c * v.x + s * v.y, -s * v.x + c * v.y, v.z);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef J2_ORBIT_MOBILITY_MODEL_H
+#define J2_ORBIT_MOBILITY_MODEL_H
+
+#include "ns3/orbit-mobility-model.h"
+#include "ns3/earth-rotation.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Keplerian orbit with the secular drift caused by the Earth
+ * oblateness (J2).
+ *
+ * The right ascension of the ascending node, the argument of perigee and
+ * the mean anomaly advance at the constant first-order J2 secular rates,
+ * so every query is a closed-form evaluation at the requested time: one
+ * Kepler equation solve and a rotation, whatever the time span. Short
+ * periodic terms are ignored, and so is drag.
+ *
+ * With "SunSynchronous" the inclination is derived from the semi-major
+ * axis and the eccentricity so that the orbital plane turns once per
+ * tropical year and keeps its local solar time. With "RepeatOrbits" and
+ * "RepeatDays" the altitude is derived instead so that the ground track
+ * repeats after that many orbits in that many days, e.g. 175 orbits in 12
+ * days for a Sentinel-1 like SAR orbit at about 693 km.
+ *
+ * Positions are in the inertial frame of GroundStationMobilityModel,
+ * unless "EarthFixed" is set, in which case they are rotated into the
+ * Earth-fixed frame of the EarthRotation and can be used with ground
+ * stations that do not move.
+ *
+ * The derived orbit is computed on first use and again after any
+ * attribute is set, so the attributes may change at any time. They are
+ * write-only; GetSemiMajorAxis () and GetInclination () report the
+ * derived values.
+ */
+class J2OrbitMobilityModel : public OrbitMobilityModel
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  J2OrbitMobilityModel ();
+  virtual ~J2OrbitMobilityModel ();
+
+  /**
+   * \brief Derive the orbit shape and the secular rates from the attributes
+   *
+   * Called on first use; call it explicitly to move the cost to setup.
+   */
+  void Prepare (void) const;
+
+  /**
+   * \returns the semi-major axis in m
+   */
+  double GetSemiMajorAxis (void) const;
+
+  /**
+   * \returns the inclination in degrees
+   */
+  double GetInclination (void) const;
+
+  /**
+   * \returns the drift rate of the ascending node in rad/s
+   */
+  double GetRaanRate (void) const;
+
+  /**
+   * \returns the nodal period, between two ascending node crossings, in s
+   */
+  double GetNodalPeriod (void) const;
+
+  /**
+   * \param semiMajorAxis the semi-major axis in m
+   * \param eccentricity the eccentricity
+   * \returns the sun-synchronous inclination in degrees, or a negative
+   * value if the orbit is too high to be sun-synchronous
+   */
+  static double GetSunSynchronousInclination (double semiMajorAxis, double eccentricity);
+
+private:
+  virtual void DoGetStateAt (double t, Vector &position, Vector &velocity) const;
+
+  /**
+   * \brief Compute the secular rates for a given orbit shape
+   * \param a the semi-major axis in m
+   * \param e the eccentricity
+   * \param cosI the cosine of the inclination
+   * \param raanRate the node drift in rad/s
+   * \param perigeeRate the perigee drift in rad/s
+   * \param meanMotion the mean anomaly rate in rad/s
+   */
+  static void GetRates (double a, double e, double cosI,
+                        double &raanRate, double &perigeeRate, double &meanMotion);
+
+  /**
+   * \returns the Earth rotation of the Earth-fixed frame
+   */
+  const EarthRotation *GetRotation (void) const;
+
+  /**
+   * \param altitude the altitude of the semi-major axis in m
+   */
+  void SetAltitude (double altitude);
+  /**
+   * \param eccentricity the eccentricity
+   */
+  void SetEccentricity (double eccentricity);
+  /**
+   * \param inclination the inclination in degrees
+   */
+  void SetInclination (double inclination);
+  /**
+   * \param raan the ascending node at the epoch in degrees
+   */
+  void SetRaan (double raan);
+  /**
+   * \param argPerigee the argument of perigee at the epoch in degrees
+   */
+  void SetArgumentOfPerigee (double argPerigee);
+  /**
+   * \param meanAnomaly the mean anomaly at the epoch in degrees
+   */
+  void SetMeanAnomaly (double meanAnomaly);
+  /**
+   * \param sunSynchronous whether to derive the inclination
+   */
+  void SetSunSynchronous (bool sunSynchronous);
+  /**
+   * \param orbits the orbits per repeat cycle, 0 to use the altitude
+   */
+  void SetRepeatOrbits (uint32_t orbits);
+  /**
+   * \param days the days per repeat cycle
+   */
+  void SetRepeatDays (uint32_t days);
+  /**
+   * \param earthFixed whether to report Earth-fixed positions
+   */
+  void SetEarthFixed (bool earthFixed);
+  /**
+   * \param rotation the rotation of the Earth-fixed frame
+   */
+  void SetEarthRotation (Ptr<EarthRotation> rotation);
+  /// Forget the derived orbit and the cached state after an attribute change
+  void Reset (void);
+
+  double m_altitude;            //!< Altitude of the semi-major axis above EARTH_RADIUS in m
+  double m_eccentricity;        //!< Eccentricity
+  double m_inclination;         //!< Inclination in degrees
+  double m_raan;                //!< Ascending node at the epoch in degrees
+  double m_argPerigee;          //!< Argument of perigee at the epoch in degrees
+  double m_meanAnomaly;         //!< Mean anomaly at the epoch in degrees
+  bool m_sunSynchronous;        //!< Derive the inclination
+  uint32_t m_repeatOrbits;      //!< Orbits per repeat cycle, 0 to use m_altitude
+  uint32_t m_repeatDays;        //!< Days per repeat cycle
+  bool m_earthFixed;            //!< Report Earth-fixed positions
+  Ptr<EarthRotation> m_rotation; //!< Rotation of the Earth-fixed frame, default if null
+
+  mutable bool m_prepared;      //!< Whether Prepare () ran
+  mutable double m_a;           //!< Semi-major axis in m
+  mutable double m_cosI;        //!< Cosine of the inclination
+  mutable double m_sinI;        //!< Sine of the inclination
+  mutable double m_raanRate;    //!< Node drift in rad/s
+  mutable double m_perigeeRate; //!< Perigee drift in rad/s
+  mutable double m_meanMotion;  //!< Mean anomaly rate in rad/s
+};
+
+} // namespace ns3
+
+#endif /* J2_ORBIT_MOBILITY_MODEL_H */
@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped-file.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MappedFile");
+
+MappedFile::MappedFile ()
+  : m_data (0),
+    m_size (0)
+{
+}
+
+MappedFile::~MappedFile ()
+{
+  Close ();
+}
+
+bool
+MappedFile::Open (const std::string &filename, std::size_t minSize)
+{
+  NS_LOG_FUNCTION (this << filename << minSize);
+  Close ();
+  int fd = open (filename.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      return false;
+    }
+  struct stat st;
+  if (fstat (fd, &st) != 0 || static_cast<std::size_t> (st.st_size) < minSize)
+    {
+      close (fd);
+      return false;
+    }
+  std::size_t size = st.st_size;
+  void *data = mmap (0, size, PROT_READ, MAP_SHARED, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED)
+    {
+      NS_LOG_WARN ("Cannot map " << filename);
+      return false;
+    }
+  m_data = data;
+  m_size = size;
+  return true;
+}
+
+bool
+MappedFile::Create (const std::string &filename, std::size_t size)
+{
+  NS_LOG_FUNCTION (this << filename << size);
+  Close ();
+  int fd = open (filename.c_str (), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    {
+      NS_LOG_WARN ("Cannot create " << filename);
+      return false;
+    }
+  if (ftruncate (fd, size) != 0)
+    {
+      NS_LOG_WARN ("Cannot allocate " << size << " bytes for " << filename);
+      close (fd);
+      return false;
+    }
+  void *data = mmap (0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (data == MAP_FAILED)
+    {
+      NS_LOG_WARN ("Cannot map " << filename);
+      return false;
+    }
+  m_data = data;
+  m_size = size;
+  return true;
+}
+
+void
+MappedFile::Close (void)
+{
+  if (m_data != 0)
+    {
+      munmap (m_data, m_size);
+      m_data = 0;
+      m_size = 0;
+    }
+}
+
+bool
+MappedFile::IsOpen (void) const
+{
+  return m_data != 0;
+}
+
+void *
+MappedFile::GetData (void) const
+{
+  return m_data;
+}
+
+std::size_t
+MappedFile::GetSize (void) const
+{
+  return m_size;
+}
+
+void
+MappedFile::Swap (MappedFile &other)
+{
+  std::swap (m_data, other.m_data);
+  std::swap (m_size, other.m_size);
+}
+
+} // namespace ns3
@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief A whole file mapped into memory with mmap.
+ *
+ * The binary records of the module (EphemerisTable, WeatherAttenuation,
+ * LinkGeometryTrace) are read and written in place through such a
+ * mapping. A file is either mapped read-only as it is, or created at a
+ * given size and mapped read-write; the mapping is released by Close ()
+ * or on destruction. Readers map a file into a local MappedFile, check
+ * its header and only then Swap () it into place, so a rejected file
+ * leaves the previous mapping untouched.
+ */
+class MappedFile
+{
+public:
+  MappedFile ();
+  ~MappedFile ();
+
+  /**
+   * \param filename the file to map read-only
+   * \param minSize the smallest acceptable file size in bytes
+   * \return true if the file exists, holds at least minSize bytes and
+   *         could be mapped
+   */
+  bool Open (const std::string &filename, std::size_t minSize);
+
+  /**
+   * \param filename the file to create, or truncate if it exists
+   * \param size the size to allocate in bytes
+   * \return true if the file could be allocated and mapped read-write
+   */
+  bool Create (const std::string &filename, std::size_t size);
+
+  /// \brief Release the mapping, if any
+  void Close (void);
+
+  /// \return whether a file is mapped
+  bool IsOpen (void) const;
+
+  /// \return the start of the mapping, or 0
+  void *GetData (void) const;
+
+  /// \return the size of the mapping in bytes
+  std::size_t GetSize (void) const;
+
+  /**
+   * \brief Exchange the mappings of two objects
+   * \param other the other mapping
+   */
+  void Swap (MappedFile &other);
+
+private:
+  /// Not copyable, the mapping has a single owner
+  MappedFile (const MappedFile &);
+  /// Not copyable, the mapping has a single owner
+  MappedFile & operator = (const MappedFile &);
+
+  void *m_data;                   //!< Mapped file, or 0
+  std::size_t m_size;             //!< Size of the mapping
+};
+
+} // namespace ns3
+
+#endif /* MAPPED_FILE_H */
@@ -0,0 +1,209 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "orbit-mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/enum.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("OrbitMobilityModel");
+
+NS_OBJECT_ENSURE_REGISTERED (OrbitMobilityModel);
+
+TypeId
+OrbitMobilityModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::OrbitMobilityModel")
+    .SetParent<MobilityModel> ()
+    .SetGroupName ("Mobility")
+    .AddAttribute ("EvaluationMode",
+                   "Whether the state is recomputed periodically or on demand.",
+                   EnumValue (OrbitMobilityModel::PERIODIC),
+                   MakeEnumAccessor (&OrbitMobilityModel::m_mode),
+                   MakeEnumChecker (OrbitMobilityModel::PERIODIC, "Periodic",
+                                    OrbitMobilityModel::LAZY, "Lazy"))
+    .AddAttribute ("Timestep",
+                   "Update position and velocity after moving for this delay (Periodic mode).",
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&OrbitMobilityModel::m_timeStep),
+                   MakeTimeChecker ())
+    .AddAttribute ("NotificationInterval",
+                   "Period of CourseChange notifications in Lazy mode, "
+                   "zero disables them.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&OrbitMobilityModel::m_notifyInterval),
+                   MakeTimeChecker (Seconds (0)))
+  ;
+  return tid;
+}
+
+OrbitMobilityModel::OrbitMobilityModel ()
+  : m_mode (PERIODIC),
+    m_started (false),
+    m_memoValid (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+OrbitMobilityModel::~OrbitMobilityModel ()
+{
+}
+
+void
+OrbitMobilityModel::DoInitialize (void)
+{
+  NS_LOG_FUNCTION (this);
+  Start ();
+  if (m_mode == PERIODIC)
+    {
+      Update ();
+    }
+  else if (!m_notifyInterval.IsZero ())
+    {
+      m_event.Cancel ();
+      m_event = Simulator::ScheduleNow (&OrbitMobilityModel::Notify, this);
+    }
+  MobilityModel::DoInitialize ();
+}
+
+void
+OrbitMobilityModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  MobilityModel::DoDispose ();
+}
+
+void
+OrbitMobilityModel::Start (void)
+{
+  if (!m_started)
+    {
+      m_baseTime = Simulator::Now ();
+      m_started = true;
+      m_memoValid = false;
+    }
+}
+
+Time
+OrbitMobilityModel::GetEpoch (void) const
+{
+  return m_baseTime;
+}
+
+Vector
+OrbitMobilityModel::GetPositionAt (Time t) const
+{
+  Vector position;
+  Vector velocity;
+  DoGetStateAt ((t - m_baseTime).GetSeconds (), position, velocity);
+  return position;
+}
+
+Vector
+OrbitMobilityModel::GetVelocityAt (Time t) const
+{
+  Vector position;
+  Vector velocity;
+  DoGetStateAt ((t - m_baseTime).GetSeconds (), position, velocity);
+  return velocity;
+}
+
+void
+OrbitMobilityModel::Evaluate (void) const
+{
+  Time now = Simulator::Now ();
+  if (m_memoValid && now == m_memoTime)
+    {
+      return;
+    }
+  DoGetStateAt ((now - m_baseTime).GetSeconds (), m_position, m_velocity);
+  m_memoTime = now;
+  m_memoValid = true;
+}
+
+Vector
+OrbitMobilityModel::DoGetPosition (void) const
+{
+  if (m_mode == LAZY)
+    {
+      Evaluate ();
+    }
+  return m_position;
+}
+
+Vector
+OrbitMobilityModel::DoGetVelocity (void) const
+{
+  if (m_mode == LAZY)
+    {
+      Evaluate ();
+    }
+  return m_velocity;
+}
+
+void
+OrbitMobilityModel::DoSetPosition (const Vector &position)
+{
+  NS_LOG_FUNCTION (this << position);
+  // The orbit is analytic, so the requested position only fixes the epoch.
+  Start ();
+  m_position = position;
+
+  if (m_mode == PERIODIC)
+    {
+      m_event.Cancel ();
+      m_event = Simulator::ScheduleNow (&OrbitMobilityModel::Update, this);
+    }
+  else
+    {
+      m_memoValid = false;
+      NotifyCourseChange ();
+    }
+}
+
+void
+OrbitMobilityModel::ResetState (void)
+{
+  m_memoValid = false;
+  if (m_mode == PERIODIC && m_started)
+    {
+      DoGetStateAt ((Simulator::Now () - m_baseTime).GetSeconds (), m_position, m_velocity);
+    }
+}
+
+void
+OrbitMobilityModel::Update (void)
+{
+  Start ();
+  DoGetStateAt ((Simulator::Now () - m_baseTime).GetSeconds (), m_position, m_velocity);
+
+  m_event.Cancel ();
+  m_event = Simulator::Schedule (m_timeStep, &OrbitMobilityModel::Update, this);
+
+  NotifyCourseChange ();
+}
+
+void
+OrbitMobilityModel::Notify (void)
+{
+  m_event = Simulator::Schedule (m_notifyInterval, &OrbitMobilityModel::Notify, this);
+  NotifyCourseChange ();
+}
+
+} // namespace ns3
@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ORBIT_MOBILITY_MODEL_H
+#define ORBIT_MOBILITY_MODEL_H
+
+#include "ns3/mobility-model.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Base class for mobility models whose state is an analytic
+ * function of time.
+ *
+ * Subclasses only implement DoGetStateAt (); this class decides when the
+ * state is evaluated.  Two evaluation modes are supported:
+ *
+ *  - PERIODIC: the state is recomputed and CourseChange is fired every
+ *    "Timestep".  Positions are only as fresh as the last update.
+ *  - LAZY: the state is computed on demand from Simulator::Now () and
+ *    memoized for the current timestamp.  No periodic event is needed to
+ *    keep positions exact; CourseChange fires every "NotificationInterval"
+ *    if that is non-zero, and never otherwise.
+ */
+class OrbitMobilityModel : public MobilityModel
+{
+public:
+  /// How the orbital state is evaluated
+  enum EvaluationMode
+  {
+    PERIODIC,  //!< Recompute every Timestep and cache
+    LAZY       //!< Compute on demand for the current time
+  };
+
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  OrbitMobilityModel ();
+  virtual ~OrbitMobilityModel ();
+
+  /**
+   * \param t an absolute simulation time
+   * \returns the position at time t, regardless of the evaluation mode
+   */
+  Vector GetPositionAt (Time t) const;
+
+  /**
+   * \param t an absolute simulation time
+   * \returns the velocity at time t, regardless of the evaluation mode
+   */
+  Vector GetVelocityAt (Time t) const;
+
+  /**
+   * \returns the simulation time the orbit is referenced to
+   */
+  Time GetEpoch (void) const;
+
+protected:
+  /**
+   * \brief Compute the orbital state.
+   *
+   * Must be a pure function of its argument: it is called from const
+   * accessors and may be called for any time.
+   *
+   * \param t seconds elapsed since the epoch
+   * \param position the position at that time
+   * \param velocity the velocity at that time
+   */
+  virtual void DoGetStateAt (double t, Vector &position, Vector &velocity) const = 0;
+
+  virtual void DoInitialize (void);
+  virtual void DoDispose (void);
+  /**
+   * Fix the epoch and notify the position change. Subclasses that give
+   * SetPosition () a meaning chain up to this.
+   * \param position the requested position
+   */
+  virtual void DoSetPosition (const Vector &position);
+  /**
+   * Forget the cached state. Subclasses call this when a change of
+   * their attributes moves the orbit.
+   */
+  void ResetState (void);
+
+private:
+  virtual Vector DoGetPosition (void) const;
+  virtual Vector DoGetVelocity (void) const;
+
+  /// Fix the epoch on first use
+  void Start (void);
+  /// Periodic mode: recompute the cached state and reschedule
+  void Update (void);
+  /// Lazy mode: fire CourseChange and reschedule
+  void Notify (void);
+  /// Lazy mode: refresh the memo if the simulation time moved on
+  void Evaluate (void) const;
+
+  EvaluationMode m_mode;       //!< Evaluation mode
+  Time m_timeStep;             //!< Update period in PERIODIC mode
+  Time m_notifyInterval;       //!< CourseChange period in LAZY mode
+  bool m_started;              //!< Whether the epoch has been fixed
+  Time m_baseTime;             //!< Epoch of the orbit
+  EventId m_event;             //!< Pending update or notification
+
+  mutable Time m_memoTime;     //!< Time the cached state refers to
+  mutable bool m_memoValid;    //!< Whether the cached state may be used
+  mutable Vector m_position;   //!< Cached position
+  mutable Vector m_velocity;   //!< Cached velocity
+};
+
+} // namespace ns3
+
+#endif /* ORBIT_MOBILITY_MODEL_H */
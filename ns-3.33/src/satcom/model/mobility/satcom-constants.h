@@ -0,0 +1,47 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SATCOM_CONSTANTS_H
+#define SATCOM_CONSTANTS_H
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ * Physical constants shared by the satcom models, in SI units.
+ */
+namespace satcom {
+
+/// Mean Earth radius in m, the ground stations of the examples sit on it
+const double EARTH_RADIUS = 6371000.0;
+
+/// Earth gravitational parameter in m^3/s^2
+const double EARTH_MU = 3.986004418e14;
+
+/// Equatorial Earth radius in m, the reference radius of EARTH_J2
+const double EARTH_EQUATORIAL_RADIUS = 6378137.0;
+
+/// Second zonal harmonic of the Earth gravity field (oblateness)
+const double EARTH_J2 = 1.08262668e-3;
+
+/// Speed of light in vacuum in m/s
+const double SPEED_OF_LIGHT = 299792458.0;
+
+} // namespace satcom
+
+} // namespace ns3
+
+#endif /* SATCOM_CONSTANTS_H */
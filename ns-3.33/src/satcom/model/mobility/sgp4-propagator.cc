@@ -0,0 +1,329 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <cstdlib>
+
+#include "sgp4-propagator.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Sgp4Propagator");
+
+namespace {
+
+// WGS-72 constants of Spacetrack Report #3, distances in Earth radii and
+// times in minutes.
+const double XKE = 0.0743669161;          // sqrt(GM) in er^1.5/min
+const double XKMPER = 6378.135;           // Earth radius in km
+const double AE = 1.0;                    // distance units per Earth radius
+const double CK2 = 5.413080e-4;           // J2 / 2
+const double CK4 = 0.62098875e-6;         // -3 J4 / 8
+const double XJ3 = -0.253881e-5;          // J3
+const double QOMS2T = 1.88027916e-9;      // ((q0 - s) / ae)^4
+const double S = 1.01222928;              // ae (1 + 78 km / XKMPER)
+const double TOTHRD = 2.0 / 3.0;
+const double TWOPI = 2.0 * M_PI;
+const double DEG2RAD = M_PI / 180.0;
+
+/**
+ * \param line a TLE line
+ * \param start 0-based first column
+ * \param length number of columns
+ * \returns the field, as a double
+ */
+double
+Field (const std::string &line, std::size_t start, std::size_t length)
+{
+  if (line.size () < start + length)
+    {
+      NS_FATAL_ERROR ("TLE line too short: \"" << line << "\"");
+    }
+  return std::atof (line.substr (start, length).c_str ());
+}
+
+/**
+ * \brief Parse a TLE field with an assumed leading decimal point and an
+ * optional exponent, such as " 12345-3" for 0.12345e-3
+ */
+double
+ExponentField (const std::string &line, std::size_t start)
+{
+  double mantissa = Field (line, start, 6) * 1e-5;
+  double exponent = Field (line, start + 6, 2);
+  return mantissa * std::pow (10.0, exponent);
+}
+
+} // anonymous namespace
+
+TwoLineElements
+TwoLineElements::Parse (const std::string &line1, const std::string &line2)
+{
+  if (line1.size () < 61 || line2.size () < 63 || line1[0] != '1' || line2[0] != '2')
+    {
+      NS_FATAL_ERROR ("Malformed TLE:\n" << line1 << "\n" << line2);
+    }
+  TwoLineElements tle;
+  int year = static_cast<int> (Field (line1, 18, 2));
+  tle.epochYear = year < 57 ? 2000 + year : 1900 + year;
+  tle.epochDay = Field (line1, 20, 12);
+  tle.bstar = ExponentField (line1, 53);
+
+  tle.inclination = Field (line2, 8, 8) * DEG2RAD;
+  tle.raan = Field (line2, 17, 8) * DEG2RAD;
+  tle.eccentricity = std::atof (("0." + line2.substr (26, 7)).c_str ());
+  tle.argPerigee = Field (line2, 34, 8) * DEG2RAD;
+  tle.meanAnomaly = Field (line2, 43, 8) * DEG2RAD;
+  tle.meanMotion = Field (line2, 52, 11);
+  return tle;
+}
+
+Sgp4Propagator::Sgp4Propagator ()
+{
+}
+
+void
+Sgp4Propagator::Initialize (const TwoLineElements &tle)
+{
+  NS_LOG_FUNCTION (this);
+  m_tle = tle;
+
+  double xno = tle.meanMotion * TWOPI / 1440.0;
+  double eo = tle.eccentricity;
+  double xincl = tle.inclination;
+  double bstar = tle.bstar;
+
+  if (TWOPI / xno >= 225.0)
+    {
+      NS_FATAL_ERROR ("Deep-space elements (period >= 225 min) are not supported");
+    }
+
+  // Recover the original mean motion and semi-major axis
+  double a1 = std::pow (XKE / xno, TOTHRD);
+  m_cosio = std::cos (xincl);
+  double theta2 = m_cosio * m_cosio;
+  m_x3thm1 = 3.0 * theta2 - 1.0;
+  double eosq = eo * eo;
+  double betao2 = 1.0 - eosq;
+  double betao = std::sqrt (betao2);
+  double del1 = 1.5 * CK2 * m_x3thm1 / (a1 * a1 * betao * betao2);
+  double ao = a1 * (1.0 - del1 * (0.5 * TOTHRD + del1 * (1.0 + 134.0 / 81.0 * del1)));
+  double delo = 1.5 * CK2 * m_x3thm1 / (ao * ao * betao * betao2);
+  m_xnodp = xno / (1.0 + delo);
+  m_aodp = ao / (1.0 - delo);
+
+  // Below 220 km of perigee the drag model is truncated
+  m_simple = (m_aodp * (1.0 - eo) / AE) < (220.0 / XKMPER + AE);
+
+  // Adjust the atmosphere parameter for perigees below 156 km
+  double s4 = S;
+  double qoms24 = QOMS2T;
+  double perige = (m_aodp * (1.0 - eo) - AE) * XKMPER;
+  if (perige < 156.0)
+    {
+      s4 = perige <= 98.0 ? 20.0 : perige - 78.0;
+      qoms24 = std::pow ((120.0 - s4) * AE / XKMPER, 4);
+      s4 = s4 / XKMPER + AE;
+    }
+
+  double pinvsq = 1.0 / (m_aodp * m_aodp * betao2 * betao2);
+  double tsi = 1.0 / (m_aodp - s4);
+  m_eta = m_aodp * eo * tsi;
+  double etasq = m_eta * m_eta;
+  double eeta = eo * m_eta;
+  double psisq = std::fabs (1.0 - etasq);
+  double coef = qoms24 * std::pow (tsi, 4);
+  double coef1 = coef / std::pow (psisq, 3.5);
+  double c2 = coef1 * m_xnodp * (m_aodp * (1.0 + 1.5 * etasq + eeta * (4.0 + etasq))
+                                 + 0.75 * CK2 * tsi / psisq * m_x3thm1 * (8.0 + 3.0 * etasq * (8.0 + etasq)));
+  m_c1 = bstar * c2;
+  m_sinio = std::sin (xincl);
+  double a3ovk2 = -XJ3 / CK2 * AE * AE * AE;
+  double c3 = eo > 1e-4 ? coef * tsi * a3ovk2 * m_xnodp * AE * m_sinio / eo : 0.0;
+  m_x1mth2 = 1.0 - theta2;
+  m_c4 = 2.0 * m_xnodp * coef1 * m_aodp * betao2
+    * (m_eta * (2.0 + 0.5 * etasq) + eo * (0.5 + 2.0 * etasq)
+       - 2.0 * CK2 * tsi / (m_aodp * psisq)
+       * (-3.0 * m_x3thm1 * (1.0 - 2.0 * eeta + etasq * (1.5 - 0.5 * eeta))
+          + 0.75 * m_x1mth2 * (2.0 * etasq - eeta * (1.0 + etasq)) * std::cos (2.0 * tle.argPerigee)));
+  m_c5 = 2.0 * coef1 * m_aodp * betao2 * (1.0 + 2.75 * (etasq + eeta) + eeta * etasq);
+
+  double theta4 = theta2 * theta2;
+  double temp1 = 3.0 * CK2 * pinvsq * m_xnodp;
+  double temp2 = temp1 * CK2 * pinvsq;
+  double temp3 = 1.25 * CK4 * pinvsq * pinvsq * m_xnodp;
+  m_xmdot = m_xnodp + 0.5 * temp1 * betao * m_x3thm1
+    + 0.0625 * temp2 * betao * (13.0 - 78.0 * theta2 + 137.0 * theta4);
+  double x1m5th = 1.0 - 5.0 * theta2;
+  m_omgdot = -0.5 * temp1 * x1m5th + 0.0625 * temp2 * (7.0 - 114.0 * theta2 + 395.0 * theta4)
+    + temp3 * (3.0 - 36.0 * theta2 + 49.0 * theta4);
+  double xhdot1 = -temp1 * m_cosio;
+  m_xnodot = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * theta2) + 2.0 * temp3 * (3.0 - 7.0 * theta2)) * m_cosio;
+  m_omgcof = bstar * c3 * std::cos (tle.argPerigee);
+  m_xmcof = eo > 1e-4 ? -TOTHRD * coef * bstar * AE / eeta : 0.0;
+  m_xnodcf = 3.5 * betao2 * xhdot1 * m_c1;
+  m_t2cof = 1.5 * m_c1;
+  m_xlcof = 0.125 * a3ovk2 * m_sinio * (3.0 + 5.0 * m_cosio) / (1.0 + m_cosio);
+  m_aycof = 0.25 * a3ovk2 * m_sinio;
+  m_delmo = std::pow (1.0 + m_eta * std::cos (tle.meanAnomaly), 3);
+  m_sinmo = std::sin (tle.meanAnomaly);
+  m_x7thm1 = 7.0 * theta2 - 1.0;
+
+  m_d2 = m_d3 = m_d4 = 0.0;
+  m_t3cof = m_t4cof = m_t5cof = 0.0;
+  if (!m_simple)
+    {
+      double c1sq = m_c1 * m_c1;
+      m_d2 = 4.0 * m_aodp * tsi * c1sq;
+      double temp = m_d2 * tsi * m_c1 / 3.0;
+      m_d3 = (17.0 * m_aodp + s4) * temp;
+      m_d4 = 0.5 * temp * m_aodp * tsi * (221.0 * m_aodp + 31.0 * s4) * m_c1;
+      m_t3cof = m_d2 + 2.0 * c1sq;
+      m_t4cof = 0.25 * (3.0 * m_d3 + m_c1 * (12.0 * m_d2 + 10.0 * c1sq));
+      m_t5cof = 0.2 * (3.0 * m_d4 + 12.0 * m_c1 * m_d3 + 6.0 * m_d2 * m_d2
+                       + 15.0 * c1sq * (2.0 * m_d2 + c1sq));
+    }
+}
+
+void
+Sgp4Propagator::Propagate (double tsince, Vector &position, Vector &velocity) const
+{
+  // Secular gravity and atmospheric drag
+  double xmdf = m_tle.meanAnomaly + m_xmdot * tsince;
+  double omgadf = m_tle.argPerigee + m_omgdot * tsince;
+  double xnoddf = m_tle.raan + m_xnodot * tsince;
+  double omega = omgadf;
+  double xmp = xmdf;
+  double tsq = tsince * tsince;
+  double xnode = xnoddf + m_xnodcf * tsq;
+  double tempa = 1.0 - m_c1 * tsince;
+  double tempe = m_tle.bstar * m_c4 * tsince;
+  double templ = m_t2cof * tsq;
+  if (!m_simple)
+    {
+      double delomg = m_omgcof * tsince;
+      double delm = m_xmcof * (std::pow (1.0 + m_eta * std::cos (xmdf), 3) - m_delmo);
+      double temp = delomg + delm;
+      xmp = xmdf + temp;
+      omega = omgadf - temp;
+      double tcube = tsq * tsince;
+      double tfour = tsince * tcube;
+      tempa = tempa - m_d2 * tsq - m_d3 * tcube - m_d4 * tfour;
+      tempe = tempe + m_tle.bstar * m_c5 * (std::sin (xmp) - m_sinmo);
+      templ = templ + m_t3cof * tcube + tfour * (m_t4cof + tsince * m_t5cof);
+    }
+  double a = m_aodp * tempa * tempa;
+  double e = m_tle.eccentricity - tempe;
+  if (e < 1e-6)
+    {
+      e = 1e-6;
+    }
+  double xl = xmp + omega + xnode + m_xnodp * templ;
+  double beta = std::sqrt (1.0 - e * e);
+  double xn = XKE / std::pow (a, 1.5);
+
+  // Long-period periodics
+  double axn = e * std::cos (omega);
+  double temp = 1.0 / (a * beta * beta);
+  double xll = temp * m_xlcof * axn;
+  double aynl = temp * m_aycof;
+  double xlt = xl + xll;
+  double ayn = e * std::sin (omega) + aynl;
+
+  // Kepler's equation
+  double capu = std::fmod (xlt - xnode, TWOPI);
+  double epw = capu;
+  double sinepw = 0;
+  double cosepw = 0;
+  double temp3 = 0;
+  double temp4 = 0;
+  double temp5 = 0;
+  double temp6 = 0;
+  for (int i = 0; i < 10; ++i)
+    {
+      sinepw = std::sin (epw);
+      cosepw = std::cos (epw);
+      temp3 = axn * sinepw;
+      temp4 = ayn * cosepw;
+      temp5 = axn * cosepw;
+      temp6 = ayn * sinepw;
+      double next = (capu - temp4 + temp3 - epw) / (1.0 - temp5 - temp6) + epw;
+      if (std::fabs (next - epw) <= 1e-12)
+        {
+          epw = next;
+          break;
+        }
+      epw = next;
+    }
+
+  // Short-period preliminary quantities
+  double ecose = temp5 + temp6;
+  double esine = temp3 - temp4;
+  double elsq = axn * axn + ayn * ayn;
+  temp = 1.0 - elsq;
+  double pl = a * temp;
+  double r = a * (1.0 - ecose);
+  double temp1 = 1.0 / r;
+  double rdot = XKE * std::sqrt (a) * esine * temp1;
+  double rfdot = XKE * std::sqrt (pl) * temp1;
+  double temp2 = a * temp1;
+  double betal = std::sqrt (temp);
+  temp3 = 1.0 / (1.0 + betal);
+  double cosu = temp2 * (cosepw - axn + ayn * esine * temp3);
+  double sinu = temp2 * (sinepw - ayn - axn * esine * temp3);
+  double u = std::atan2 (sinu, cosu);
+  double sin2u = 2.0 * sinu * cosu;
+  double cos2u = 2.0 * cosu * cosu - 1.0;
+  temp = 1.0 / pl;
+  temp1 = CK2 * temp;
+  temp2 = temp1 * temp;
+
+  // Short-period periodics
+  double rk = r * (1.0 - 1.5 * temp2 * betal * m_x3thm1) + 0.5 * temp1 * m_x1mth2 * cos2u;
+  double uk = u - 0.25 * temp2 * m_x7thm1 * sin2u;
+  double xnodek = xnode + 1.5 * temp2 * m_cosio * sin2u;
+  double xinck = m_tle.inclination + 1.5 * temp2 * m_cosio * m_sinio * cos2u;
+  double rdotk = rdot - xn * temp1 * m_x1mth2 * sin2u;
+  double rfdotk = rfdot + xn * temp1 * (m_x1mth2 * cos2u + 1.5 * m_x3thm1);
+
+  // Orientation vectors
+  double sinuk = std::sin (uk);
+  double cosuk = std::cos (uk);
+  double sinik = std::sin (xinck);
+  double cosik = std::cos (xinck);
+  double sinnok = std::sin (xnodek);
+  double cosnok = std::cos (xnodek);
+  double xmx = -sinnok * cosik;
+  double xmy = cosnok * cosik;
+  double ux = xmx * sinuk + cosnok * cosuk;
+  double uy = xmy * sinuk + sinnok * cosuk;
+  double uz = sinik * sinuk;
+  double vx = xmx * cosuk - cosnok * sinuk;
+  double vy = xmy * cosuk - sinnok * sinuk;
+  double vz = sinik * cosuk;
+
+  // Earth radii and Earth radii per minute to m and m/s
+  const double toMeters = XKMPER * 1000.0;
+  const double toMetersPerSecond = XKMPER * 1000.0 / 60.0;
+  position = Vector (rk * ux * toMeters, rk * uy * toMeters, rk * uz * toMeters);
+  velocity = Vector ((rdotk * ux + rfdotk * vx) * toMetersPerSecond,
+                     (rdotk * uy + rfdotk * vy) * toMetersPerSecond,
+                     (rdotk * uz + rfdotk * vz) * toMetersPerSecond);
+}
+
+} // namespace ns3
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SGP4_PROPAGATOR_H
+#define SGP4_PROPAGATOR_H
+
+#include <string>
+
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Mean elements of a NORAD two-line element set.
+ */
+struct TwoLineElements
+{
+  int epochYear;          //!< Four-digit epoch year
+  double epochDay;        //!< Fractional day of year of the epoch
+  double bstar;           //!< Drag term in 1/Earth radii
+  double inclination;     //!< Inclination in rad
+  double raan;            //!< Right ascension of the ascending node in rad
+  double eccentricity;    //!< Eccentricity
+  double argPerigee;      //!< Argument of perigee in rad
+  double meanAnomaly;     //!< Mean anomaly in rad
+  double meanMotion;      //!< Mean motion in rev/day
+
+  /**
+   * \brief Parse the two data lines of a TLE
+   *
+   * Aborts with NS_FATAL_ERROR on malformed input.
+   *
+   * \param line1 the first line
+   * \param line2 the second line
+   * \returns the elements
+   */
+  static TwoLineElements Parse (const std::string &line1, const std::string &line2);
+};
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Near-Earth SGP4 propagator (Spacetrack Report #3, WGS-72).
+ *
+ * Only near-Earth orbits (period below 225 minutes) are supported, which
+ * covers every SAR mission; deep-space elements are rejected.  Positions
+ * and velocities are expressed in the TEME inertial frame, in m and m/s.
+ */
+class Sgp4Propagator
+{
+public:
+  Sgp4Propagator ();
+
+  /**
+   * \brief Initialize the propagator from a set of elements
+   * \param tle the elements
+   */
+  void Initialize (const TwoLineElements &tle);
+
+  /**
+   * \param minutes time since the TLE epoch in minutes
+   * \param position the position in m
+   * \param velocity the velocity in m/s
+   */
+  void Propagate (double minutes, Vector &position, Vector &velocity) const;
+
+private:
+  TwoLineElements m_tle;  //!< The elements
+
+  bool m_simple;          //!< Perigee below 220 km: truncated drag terms
+  double m_aodp;          //!< Original semi-major axis
+  double m_xnodp;         //!< Original mean motion
+  double m_cosio;         //!< cos of the inclination
+  double m_sinio;         //!< sin of the inclination
+  double m_eta;           //!< Drag parameter
+  double m_x3thm1;        //!< 3 cos^2(i) - 1
+  double m_x1mth2;        //!< 1 - cos^2(i)
+  double m_x7thm1;        //!< 7 cos^2(i) - 1
+  double m_c1;            //!< Drag coefficient C1
+  double m_c4;            //!< Drag coefficient C4
+  double m_c5;            //!< Drag coefficient C5
+  double m_xmdot;         //!< Secular rate of the mean anomaly
+  double m_omgdot;        //!< Secular rate of the argument of perigee
+  double m_xnodot;        //!< Secular rate of the node
+  double m_omgcof;        //!< Drag term of the argument of perigee
+  double m_xmcof;         //!< Drag term of the mean anomaly
+  double m_xnodcf;        //!< Drag term of the node
+  double m_t2cof;         //!< Coefficient of t^2 in the mean longitude
+  double m_t3cof;         //!< Coefficient of t^3 in the mean longitude
+  double m_t4cof;         //!< Coefficient of t^4 in the mean longitude
+  double m_t5cof;         //!< Coefficient of t^5 in the mean longitude
+  double m_xlcof;         //!< Long-period coefficient
+  double m_aycof;         //!< Long-period coefficient
+  double m_delmo;         //!< (1 + eta cos(M0))^3
+  double m_sinmo;         //!< sin(M0)
+  double m_d2;            //!< Drag coefficient D2
+  double m_d3;            //!< Drag coefficient D3
+  double m_d4;            //!< Drag coefficient D4
+};
+
+} // namespace ns3
+
+#endif /* SGP4_PROPAGATOR_H */
@@ -0,0 +1,207 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include "tle-mobility-model.h"
+#include "ns3/string.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TleMobilityModel");
+
+NS_OBJECT_ENSURE_REGISTERED (TleMobilityModel);
+
+TypeId
+TleMobilityModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TleMobilityModel")
+    .SetParent<OrbitMobilityModel> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<TleMobilityModel> ()
+    .AddAttribute ("Line1",
+                   "First line of the two-line element set.",
+                   StringValue (""),
+                   MakeStringAccessor (&TleMobilityModel::SetLine1),
+                   MakeStringChecker ())
+    .AddAttribute ("Line2",
+                   "Second line of the two-line element set.",
+                   StringValue (""),
+                   MakeStringAccessor (&TleMobilityModel::SetLine2),
+                   MakeStringChecker ())
+    .AddAttribute ("EpochOffset",
+                   "Time elapsed since the TLE epoch at the model epoch.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&TleMobilityModel::SetEpochOffset),
+                   MakeTimeChecker ())
+    .AddAttribute ("EphemerisStep",
+                   "Sampling step of the interpolated ephemeris.",
+                   TimeValue (Seconds (30)),
+                   MakeTimeAccessor (&TleMobilityModel::SetEphemerisStep),
+                   MakeTimeChecker (MilliSeconds (1)))
+    .AddAttribute ("EphemerisDuration",
+                   "Time span covered by the interpolated ephemeris.",
+                   TimeValue (Days (1)),
+                   MakeTimeAccessor (&TleMobilityModel::SetEphemerisDuration),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("CacheFile",
+                   "Binary file the ephemeris is mapped from or saved to, "
+                   "empty to keep it in memory only.",
+                   StringValue (""),
+                   MakeStringAccessor (&TleMobilityModel::SetCacheFile),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+TleMobilityModel::TleMobilityModel ()
+  : m_prepared (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TleMobilityModel::~TleMobilityModel ()
+{
+}
+
+void
+TleMobilityModel::Reset (void)
+{
+  m_prepared = false;
+  ResetState ();
+}
+
+void
+TleMobilityModel::SetLine1 (std::string line1)
+{
+  m_line1 = line1;
+  Reset ();
+}
+
+void
+TleMobilityModel::SetLine2 (std::string line2)
+{
+  m_line2 = line2;
+  Reset ();
+}
+
+void
+TleMobilityModel::SetEpochOffset (Time offset)
+{
+  m_epochOffset = offset;
+  Reset ();
+}
+
+void
+TleMobilityModel::SetEphemerisStep (Time step)
+{
+  m_step = step;
+  Reset ();
+}
+
+void
+TleMobilityModel::SetEphemerisDuration (Time duration)
+{
+  m_duration = duration;
+  Reset ();
+}
+
+void
+TleMobilityModel::SetCacheFile (std::string cacheFile)
+{
+  m_cacheFile = cacheFile;
+  Reset ();
+}
+
+uint64_t
+TleMobilityModel::GetCacheKey (void) const
+{
+  std::ostringstream oss;
+  oss << m_line1 << '\n' << m_line2 << '\n'
+      << m_epochOffset.GetNanoSeconds () << ' '
+      << m_step.GetNanoSeconds () << ' '
+      << m_duration.GetNanoSeconds ();
+  std::string s = oss.str ();
+
+  // 64-bit FNV-1a
+  uint64_t hash = 14695981039346656037ULL;
+  for (std::string::const_iterator it = s.begin (); it != s.end (); ++it)
+    {
+      hash ^= static_cast<unsigned char> (*it);
+      hash *= 1099511628211ULL;
+    }
+  return hash;
+}
+
+void
+TleMobilityModel::Prepare (void) const
+{
+  if (m_prepared)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  m_sgp4.Initialize (TwoLineElements::Parse (m_line1, m_line2));
+  m_prepared = true;
+
+  uint64_t key = GetCacheKey ();
+  if (!m_cacheFile.empty () && m_table.Load (m_cacheFile, key))
+    {
+      NS_LOG_INFO ("Mapped ephemeris from " << m_cacheFile);
+      return;
+    }
+
+  double step = m_step.GetSeconds ();
+  uint64_t count = static_cast<uint64_t> (std::ceil (m_duration.GetSeconds () / step)) + 1;
+  if (count < 2)
+    {
+      count = 2;
+    }
+  double offset = m_epochOffset.GetSeconds ();
+  m_table.Reset (0.0, step, count);
+  for (uint64_t i = 0; i < count; ++i)
+    {
+      Vector position;
+      Vector velocity;
+      m_sgp4.Propagate ((offset + i * step) / 60.0, position, velocity);
+      m_table.Set (i, position, velocity);
+    }
+  NS_LOG_INFO ("Propagated " << count << " ephemeris samples");
+
+  if (!m_cacheFile.empty () && !m_table.Save (m_cacheFile, key))
+    {
+      NS_LOG_WARN ("Could not save the ephemeris to " << m_cacheFile);
+    }
+}
+
+void
+TleMobilityModel::DoGetStateAt (double t, Vector &position, Vector &velocity) const
+{
+  Prepare ();
+  if (m_table.Contains (t))
+    {
+      m_table.Interpolate (t, position, velocity);
+    }
+  else
+    {
+      m_sgp4.Propagate ((m_epochOffset.GetSeconds () + t) / 60.0, position, velocity);
+    }
+}
+
+} // namespace ns3
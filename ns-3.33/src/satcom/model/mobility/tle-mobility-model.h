@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TLE_MOBILITY_MODEL_H
+#define TLE_MOBILITY_MODEL_H
+
+#include <string>
+
+#include "ns3/orbit-mobility-model.h"
+#include "ns3/sgp4-propagator.h"
+#include "ns3/ephemeris-table.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Mobility of a satellite described by a two-line element set.
+ *
+ * The orbit is propagated with SGP4 once, at "EphemerisStep" intervals
+ * over "EphemerisDuration", and positions are then served by Hermite
+ * interpolation from the resulting EphemerisTable.  If "CacheFile" is
+ * set, the table is mapped from that file when it matches the elements
+ * and sampling, and written there otherwise, so repeated runs of the same
+ * constellation skip propagation entirely.  Queries outside the table
+ * fall back to SGP4.
+ *
+ * Simulation time zero (more precisely the model epoch) corresponds to
+ * the TLE epoch plus "EpochOffset".  Positions are in the TEME frame.
+ *
+ * The ephemeris is built on first use and again after any attribute is
+ * set, so the attributes may change at any time. They are write-only.
+ */
+class TleMobilityModel : public OrbitMobilityModel
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  TleMobilityModel ();
+  virtual ~TleMobilityModel ();
+
+  /**
+   * \brief Parse the elements and build or map the ephemeris
+   *
+   * Called on first use; call it explicitly to move the cost to setup.
+   */
+  void Prepare (void) const;
+
+private:
+  virtual void DoGetStateAt (double t, Vector &position, Vector &velocity) const;
+
+  /**
+   * \returns a hash identifying the elements and the sampling
+   */
+  uint64_t GetCacheKey (void) const;
+
+  /**
+   * \param line1 the first TLE line
+   */
+  void SetLine1 (std::string line1);
+  /**
+   * \param line2 the second TLE line
+   */
+  void SetLine2 (std::string line2);
+  /**
+   * \param offset the time elapsed since the TLE epoch at the model epoch
+   */
+  void SetEpochOffset (Time offset);
+  /**
+   * \param step the sampling step of the ephemeris
+   */
+  void SetEphemerisStep (Time step);
+  /**
+   * \param duration the time span of the ephemeris
+   */
+  void SetEphemerisDuration (Time duration);
+  /**
+   * \param cacheFile the ephemeris file, empty for none
+   */
+  void SetCacheFile (std::string cacheFile);
+  /// Forget the ephemeris and the cached state after an attribute change
+  void Reset (void);
+
+  std::string m_line1;        //!< First TLE line
+  std::string m_line2;        //!< Second TLE line
+  Time m_epochOffset;         //!< TLE epoch to model epoch
+  Time m_step;                //!< Ephemeris sampling step
+  Time m_duration;            //!< Ephemeris span
+  std::string m_cacheFile;    //!< Ephemeris file, empty for none
+
+  mutable bool m_prepared;          //!< Whether Prepare () ran
+  mutable Sgp4Propagator m_sgp4;    //!< Propagator for the table and fallback
+  mutable EphemerisTable m_table;   //!< Interpolation table
+};
+
+} // namespace ns3
+
+#endif /* TLE_MOBILITY_MODEL_H */
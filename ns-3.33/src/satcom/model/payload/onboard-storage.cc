@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "onboard-storage.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("OnboardStorage");
+
+NS_OBJECT_ENSURE_REGISTERED (OnboardStorage);
+
+TypeId
+OnboardStorage::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::OnboardStorage")
+    .SetParent<Object> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<OnboardStorage> ()
+    .AddAttribute ("Capacity", "Capacity of the memory in bytes.",
+                   UintegerValue (512000000000ULL),
+                   MakeUintegerAccessor (&OnboardStorage::m_capacity),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("Classes", "Number of priority classes, 0 being the highest.",
+                   UintegerValue (3),
+                   MakeUintegerAccessor (&OnboardStorage::m_nClasses),
+                   MakeUintegerChecker<uint8_t> (1))
+    .AddAttribute ("Overwrite", "Whether a full memory evicts lower priority data.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&OnboardStorage::m_overwrite),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("Occupancy", "Bytes stored.",
+                     MakeTraceSourceAccessor (&OnboardStorage::m_used),
+                     "ns3::TracedValueCallback::Uint64")
+    .AddTraceSource ("Drop", "Data was dropped or evicted.",
+                     MakeTraceSourceAccessor (&OnboardStorage::m_dropTrace),
+                     "ns3::OnboardStorage::DropCallback")
+  ;
+  return tid;
+}
+
+OnboardStorage::OnboardStorage ()
+  : m_capacity (0),
+    m_nClasses (3),
+    m_overwrite (true),
+    m_used (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+OnboardStorage::~OnboardStorage ()
+{
+}
+
+void
+OnboardStorage::Prepare (void)
+{
+  if (m_classes.size () != m_nClasses)
+    {
+      NS_ASSERT_MSG (m_used.Get () == 0, "The number of classes cannot change while data is stored");
+      m_classes.assign (m_nClasses, std::deque<Segment> ());
+      m_classBytes.assign (m_nClasses, 0);
+    }
+}
+
+uint64_t
+OnboardStorage::Evict (uint8_t priority, uint64_t bytes)
+{
+  uint64_t freed = 0;
+  for (int32_t c = m_nClasses - 1; c > priority && freed < bytes; --c)
+    {
+      std::deque<Segment> &queue = m_classes[c];
+      while (!queue.empty () && freed < bytes)
+        {
+          Segment &oldest = queue.front ();
+          uint64_t take = std::min (oldest.bytes, bytes - freed);
+          oldest.bytes -= take;
+          if (oldest.bytes == 0)
+            {
+              queue.pop_front ();
+            }
+          m_classBytes[c] -= take;
+          freed += take;
+          m_dropTrace (c, take);
+        }
+    }
+  m_used -= freed;
+  return freed;
+}
+
+uint64_t
+OnboardStorage::Write (uint32_t acquisition, uint8_t priority, uint64_t bytes)
+{
+  NS_LOG_FUNCTION (this << acquisition << +priority << bytes);
+  Prepare ();
+  NS_ASSERT (priority < m_nClasses);
+  uint64_t room = m_capacity - m_used;
+  if (bytes > room && m_overwrite)
+    {
+      room += Evict (priority, bytes - room);
+    }
+  uint64_t stored = std::min (bytes, room);
+  if (stored < bytes)
+    {
+      m_dropTrace (priority, bytes - stored);
+    }
+  if (stored == 0)
+    {
+      return 0;
+    }
+  std::deque<Segment> &queue = m_classes[priority];
+  if (!queue.empty () && queue.back ().acquisition == acquisition)
+    {
+      // Consecutive writes of one acquisition extend its segment
+      queue.back ().bytes += stored;
+    }
+  else
+    {
+      Segment s;
+      s.acquisition = acquisition;
+      s.priority = priority;
+      s.acquired = Simulator::Now ();
+      s.bytes = stored;
+      queue.push_back (s);
+    }
+  m_classBytes[priority] += stored;
+  m_used += stored;
+  return stored;
+}
+
+bool
+OnboardStorage::Read (uint64_t maxBytes, Segment &segment)
+{
+  Prepare ();
+  for (uint8_t c = 0; c < m_nClasses; ++c)
+    {
+      std::deque<Segment> &queue = m_classes[c];
+      if (queue.empty ())
+        {
+          continue;
+        }
+      Segment &front = queue.front ();
+      segment = front;
+      segment.bytes = std::min (front.bytes, maxBytes);
+      front.bytes -= segment.bytes;
+      if (front.bytes == 0)
+        {
+          queue.pop_front ();
+        }
+      m_classBytes[c] -= segment.bytes;
+      m_used -= segment.bytes;
+      return true;
+    }
+  return false;
+}
+
+uint64_t
+OnboardStorage::GetUsed (void) const
+{
+  return m_used;
+}
+
+uint64_t
+OnboardStorage::GetUsed (uint8_t priority) const
+{
+  return priority < m_classBytes.size () ? m_classBytes[priority] : 0;
+}
+
+uint64_t
+OnboardStorage::GetCapacity (void) const
+{
+  return m_capacity;
+}
+
+uint8_t
+OnboardStorage::GetNClasses (void) const
+{
+  return m_nClasses;
+}
+
+} // namespace ns3
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ONBOARD_STORAGE_H
+#define ONBOARD_STORAGE_H
+
+#include <deque>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-value.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Onboard mass memory of a payload, with priority classes.
+ *
+ * The memory only accounts for bytes: data is written as segments
+ * tagged with an acquisition id, a priority class and the acquisition
+ * time, and read back highest priority first, oldest first within a
+ * class. Class 0 is the highest priority. When the memory is full a
+ * write evicts the oldest data of lower priority classes if Overwrite
+ * is set; what still does not fit is dropped.
+ */
+class OnboardStorage : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  OnboardStorage ();
+  virtual ~OnboardStorage ();
+
+  /**
+   * TracedCallback signature for lost data.
+   * \param priority the priority class of the data
+   * \param bytes the number of bytes lost
+   */
+  typedef void (* DropCallback) (uint8_t priority, uint64_t bytes);
+
+  /// A contiguous piece of stored data
+  struct Segment
+  {
+    uint32_t acquisition;  //!< Acquisition id
+    uint8_t priority;      //!< Priority class
+    Time acquired;         //!< Acquisition time
+    uint64_t bytes;        //!< Size
+  };
+
+  /**
+   * \param acquisition the acquisition id
+   * \param priority the priority class
+   * \param bytes the number of bytes to store
+   * \return the number of bytes stored
+   */
+  uint64_t Write (uint32_t acquisition, uint8_t priority, uint64_t bytes);
+
+  /**
+   * Take up to \p maxBytes from the front of the highest priority class
+   * holding data; a read never spans two segments.
+   * \param maxBytes the largest read
+   * \param segment the data read, with its size in bytes
+   * \return false if the memory is empty
+   */
+  bool Read (uint64_t maxBytes, Segment &segment);
+
+  /// \return the bytes stored
+  uint64_t GetUsed (void) const;
+
+  /**
+   * \param priority a priority class
+   * \return the bytes stored in that class
+   */
+  uint64_t GetUsed (uint8_t priority) const;
+
+  /// \return the capacity in bytes
+  uint64_t GetCapacity (void) const;
+
+  /// \return the number of priority classes
+  uint8_t GetNClasses (void) const;
+
+private:
+  /// Size the class queues on first use
+  void Prepare (void);
+  /// Evict lower priority data to make room, return the bytes freed
+  uint64_t Evict (uint8_t priority, uint64_t bytes);
+
+  uint64_t m_capacity;                          //!< Capacity in bytes
+  uint8_t m_nClasses;                           //!< Number of priority classes
+  bool m_overwrite;                             //!< Whether to evict lower classes
+  std::vector<std::deque<Segment> > m_classes;  //!< Segments of each class
+  std::vector<uint64_t> m_classBytes;           //!< Bytes of each class
+  TracedValue<uint64_t> m_used;                 //!< Bytes stored
+  TracedCallback<uint8_t, uint64_t> m_dropTrace; //!< Lost data
+};
+
+} // namespace ns3
+
+#endif /* ONBOARD_STORAGE_H */
@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "sar-data-tag.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (SarDataTag);
+
+SarDataTag::SarDataTag ()
+  : m_acquisition (0),
+    m_priority (0),
+    m_acquired (0)
+{
+}
+
+TypeId
+SarDataTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SarDataTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<SarDataTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+SarDataTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+SarDataTag::GetSerializedSize (void) const
+{
+  return 4 + 1 + 8;
+}
+
+void
+SarDataTag::Serialize (TagBuffer i) const
+{
+  i.WriteU32 (m_acquisition);
+  i.WriteU8 (m_priority);
+  i.WriteU64 (m_acquired);
+}
+
+void
+SarDataTag::Deserialize (TagBuffer i)
+{
+  m_acquisition = i.ReadU32 ();
+  m_priority = i.ReadU8 ();
+  m_acquired = i.ReadU64 ();
+}
+
+void
+SarDataTag::Print (std::ostream &os) const
+{
+  os << "acquisition=" << m_acquisition << " priority=" << +m_priority
+     << " acquired=" << GetAcquired ().As (Time::S);
+}
+
+void
+SarDataTag::SetAcquisition (uint32_t acquisition)
+{
+  m_acquisition = acquisition;
+}
+
+uint32_t
+SarDataTag::GetAcquisition (void) const
+{
+  return m_acquisition;
+}
+
+void
+SarDataTag::SetPriority (uint8_t priority)
+{
+  m_priority = priority;
+}
+
+uint8_t
+SarDataTag::GetPriority (void) const
+{
+  return m_priority;
+}
+
+void
+SarDataTag::SetAcquired (Time acquired)
+{
+  m_acquired = acquired.GetNanoSeconds ();
+}
+
+Time
+SarDataTag::GetAcquired (void) const
+{
+  return NanoSeconds (m_acquired);
+}
+
+} // namespace ns3
@@ -0,0 +1,70 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SAR_DATA_TAG_H
+#define SAR_DATA_TAG_H
+
+#include "ns3/tag.h"
+#include "ns3/nstime.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Packet tag identifying the SAR acquisition a packet carries
+ * data of, so that receivers can account for it per priority class.
+ */
+class SarDataTag : public Tag
+{
+public:
+  SarDataTag ();
+
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual void Print (std::ostream &os) const;
+
+  /// \param acquisition the acquisition id
+  void SetAcquisition (uint32_t acquisition);
+  /// \return the acquisition id
+  uint32_t GetAcquisition (void) const;
+
+  /// \param priority the priority class
+  void SetPriority (uint8_t priority);
+  /// \return the priority class
+  uint8_t GetPriority (void) const;
+
+  /// \param acquired the acquisition time
+  void SetAcquired (Time acquired);
+  /// \return the acquisition time
+  Time GetAcquired (void) const;
+
+private:
+  uint32_t m_acquisition;  //!< Acquisition id
+  uint8_t m_priority;      //!< Priority class
+  int64_t m_acquired;      //!< Acquisition time in ns
+};
+
+} // namespace ns3
+
+#endif /* SAR_DATA_TAG_H */
@@ -0,0 +1,222 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+
+#include "sar-payload-application.h"
+#include "sar-data-tag.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SarPayloadApplication");
+
+NS_OBJECT_ENSURE_REGISTERED (SarPayloadApplication);
+
+TypeId
+SarPayloadApplication::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SarPayloadApplication")
+    .SetParent<Application> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<SarPayloadApplication> ()
+    .AddAttribute ("Storage", "The onboard storage, a default one is created if unset.",
+                   PointerValue (),
+                   MakePointerAccessor (&SarPayloadApplication::m_storage),
+                   MakePointerChecker<OnboardStorage> ())
+    .AddAttribute ("AcquisitionRate", "Data rate of the instrument while acquiring.",
+                   DataRateValue (DataRate ("400Mbps")),
+                   MakeDataRateAccessor (&SarPayloadApplication::m_acquisitionRate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("AcquisitionDuration", "Length of an acquisition in seconds.",
+                   StringValue ("ns3::ConstantRandomVariable[Constant=10.0]"),
+                   MakePointerAccessor (&SarPayloadApplication::m_duration),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("AcquisitionGap", "Idle time between acquisitions in seconds.",
+                   StringValue ("ns3::ExponentialRandomVariable[Mean=300.0]"),
+                   MakePointerAccessor (&SarPayloadApplication::m_gap),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("Priority", "Priority class of an acquisition, rounded down.",
+                   StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=3.0]"),
+                   MakePointerAccessor (&SarPayloadApplication::m_priority),
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("WriteInterval", "Period of the writes to the storage during an acquisition.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&SarPayloadApplication::m_writeInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("PacketSize", "Payload size of the downlink packets.",
+                   UintegerValue (1400),
+                   MakeUintegerAccessor (&SarPayloadApplication::m_packetSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("QueueTarget", "Packets kept in the device of an open downlink, queued or in transmission.",
+                   UintegerValue (2),
+                   MakeUintegerAccessor (&SarPayloadApplication::m_queueTarget),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddTraceSource ("Acquisition", "An acquisition started.",
+                     MakeTraceSourceAccessor (&SarPayloadApplication::m_acquisitionTrace),
+                     "ns3::SarPayloadApplication::AcquisitionCallback")
+    .AddTraceSource ("Tx", "A packet was sent on a downlink.",
+                     MakeTraceSourceAccessor (&SarPayloadApplication::m_txTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+SarPayloadApplication::SarPayloadApplication ()
+  : m_packetSize (1400),
+    m_queueTarget (2),
+    m_acquisition (0),
+    m_class (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SarPayloadApplication::~SarPayloadApplication ()
+{
+}
+
+void
+SarPayloadApplication::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_storage = 0;
+  m_downlinks.clear ();
+  Application::DoDispose ();
+}
+
+void
+SarPayloadApplication::AddDownlink (Ptr<NetDevice> device, Address remote)
+{
+  NS_LOG_FUNCTION (this << device << remote);
+  Downlink d;
+  d.device = device;
+  d.remote = remote;
+  m_downlinks.push_back (d);
+}
+
+Ptr<OnboardStorage>
+SarPayloadApplication::GetStorage (void) const
+{
+  return m_storage;
+}
+
+void
+SarPayloadApplication::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_storage == 0)
+    {
+      m_storage = CreateObject<OnboardStorage> ();
+    }
+  for (uint32_t i = 0; i < m_downlinks.size (); ++i)
+    {
+      Downlink &d = m_downlinks[i];
+      d.socket = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId ());
+      d.socket->Bind ();
+      d.socket->Connect (d.remote);
+      d.feeder = CreateObject<DeviceQueueFeeder> ();
+      d.feeder->Setup (d.device, m_queueTarget, MakeCallback (&SarPayloadApplication::SendSegment, this).Bind (i));
+    }
+  m_event = Simulator::ScheduleNow (&SarPayloadApplication::StartAcquisition, this);
+}
+
+void
+SarPayloadApplication::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  for (std::vector<Downlink>::iterator it = m_downlinks.begin (); it != m_downlinks.end (); ++it)
+    {
+      if (it->socket != 0)
+        {
+          it->socket->Close ();
+          it->socket = 0;
+        }
+    }
+}
+
+void
+SarPayloadApplication::StartAcquisition (void)
+{
+  m_acquisition++;
+  double priority = std::floor (m_priority->GetValue ());
+  m_class = std::min<double> (std::max (priority, 0.0), m_storage->GetNClasses () - 1);
+  uint64_t bytes = m_acquisitionRate.GetBitRate () * std::max (m_duration->GetValue (), 0.0) / 8;
+  NS_LOG_INFO ("Acquisition " << m_acquisition << ", class " << +m_class << ", " << bytes << " bytes");
+  m_acquisitionTrace (m_acquisition, m_class, bytes);
+  Acquire (bytes);
+}
+
+void
+SarPayloadApplication::Acquire (uint64_t remaining)
+{
+  uint64_t slice = std::min<uint64_t> (remaining, m_acquisitionRate.GetBitRate () * m_writeInterval.GetSeconds () / 8);
+  if (slice == 0)
+    {
+      slice = remaining;
+    }
+  m_storage->Write (m_acquisition, m_class, slice);
+  remaining -= slice;
+  Drain ();
+  if (remaining > 0)
+    {
+      m_event = Simulator::Schedule (m_writeInterval, &SarPayloadApplication::Acquire, this, remaining);
+    }
+  else
+    {
+      m_event = Simulator::Schedule (m_writeInterval + Seconds (std::max (m_gap->GetValue (), 0.0)),
+                                     &SarPayloadApplication::StartAcquisition, this);
+    }
+}
+
+void
+SarPayloadApplication::Drain (void)
+{
+  for (std::vector<Downlink>::iterator it = m_downlinks.begin (); it != m_downlinks.end (); ++it)
+    {
+      if (it->feeder != 0)
+        {
+          it->feeder->Feed ();
+        }
+    }
+}
+
+bool
+SarPayloadApplication::SendSegment (uint32_t downlink)
+{
+  Downlink &d = m_downlinks[downlink];
+  OnboardStorage::Segment segment;
+  if (d.socket == 0 || !m_storage->Read (m_packetSize, segment))
+    {
+      return false;
+    }
+  Ptr<Packet> packet = Create<Packet> (segment.bytes);
+  SarDataTag tag;
+  tag.SetAcquisition (segment.acquisition);
+  tag.SetPriority (segment.priority);
+  tag.SetAcquired (segment.acquired);
+  packet->AddPacketTag (tag);
+  m_txTrace (packet);
+  d.socket->Send (packet);
+  return true;
+}
+
+} // namespace ns3
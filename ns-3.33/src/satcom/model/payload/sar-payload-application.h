@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SAR_PAYLOAD_APPLICATION_H
+#define SAR_PAYLOAD_APPLICATION_H
+
+#include <vector>
+
+#include "ns3/application.h"
+#include "ns3/address.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/socket.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
+#include "ns3/onboard-storage.h"
+#include "ns3/device-queue-feeder.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Data source of a SAR satellite.
+ *
+ * The payload alternates bursty acquisitions, written to an
+ * OnboardStorage at AcquisitionRate, with idle gaps. Each acquisition
+ * gets a priority class. The storage drains over UDP through every
+ * downlink registered with AddDownlink () whose link is up, highest
+ * priority first, with a DeviceQueueFeeder per downlink keeping the
+ * device fed so that the downlink runs at line rate. Downlinks over an
+ * OrbitPointToPointChannel follow its LinkState and Outage traces, so a
+ * ContactPlan decides when data flows and nothing is read from the
+ * storage while the link is in outage.
+ *
+ * Packets are created with the zero-filled virtual payload of Packet,
+ * so no data buffer is allocated per packet; a SarDataTag tells the
+ * receiver which acquisition and class the data belongs to.
+ */
+class SarPayloadApplication : public Application
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  SarPayloadApplication ();
+  virtual ~SarPayloadApplication ();
+
+  /**
+   * TracedCallback signature for acquisitions.
+   * \param acquisition the acquisition id
+   * \param priority its priority class
+   * \param bytes the amount of data acquired
+   */
+  typedef void (* AcquisitionCallback) (uint32_t acquisition, uint8_t priority, uint64_t bytes);
+
+  /**
+   * \param device the satellite device of a downlink
+   * \param remote the address and port of the receiver on that link
+   */
+  void AddDownlink (Ptr<NetDevice> device, Address remote);
+
+  /// \return the onboard storage
+  Ptr<OnboardStorage> GetStorage (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /// A downlink and its state
+  struct Downlink
+  {
+    Ptr<NetDevice> device;  //!< Satellite device
+    Address remote;         //!< Receiver
+    Ptr<Socket> socket;     //!< UDP socket
+    Ptr<DeviceQueueFeeder> feeder; //!< Keeps the device busy
+  };
+
+  /// Start an acquisition
+  void StartAcquisition (void);
+  /// Write the next slice of the acquisition
+  void Acquire (uint64_t remaining);
+  /// Feed the devices of the open downlinks
+  void Drain (void);
+  /**
+   * \brief Send the next packet from the storage over a downlink
+   * \param downlink the downlink index
+   * \return false if the storage is empty
+   */
+  bool SendSegment (uint32_t downlink);
+
+  Ptr<OnboardStorage> m_storage;               //!< Mass memory
+  DataRate m_acquisitionRate;                  //!< Instrument data rate
+  Ptr<RandomVariableStream> m_duration;        //!< Acquisition length in s
+  Ptr<RandomVariableStream> m_gap;             //!< Idle time between acquisitions in s
+  Ptr<RandomVariableStream> m_priority;        //!< Priority class of an acquisition
+  Time m_writeInterval;                        //!< Granularity of storage writes
+  uint32_t m_packetSize;                       //!< Downlink packet payload size
+  uint32_t m_queueTarget;                      //!< Packets kept in the device
+  std::vector<Downlink> m_downlinks;           //!< Downlinks
+  uint32_t m_acquisition;                      //!< Current acquisition id
+  uint8_t m_class;                             //!< Class of the current acquisition
+  EventId m_event;                             //!< Pending acquisition event
+  TracedCallback<uint32_t, uint8_t, uint64_t> m_acquisitionTrace; //!< Acquisitions
+  TracedCallback<Ptr<const Packet> > m_txTrace; //!< Downlinked packets
+};
+
+} // namespace ns3
+
+#endif /* SAR_PAYLOAD_APPLICATION_H */
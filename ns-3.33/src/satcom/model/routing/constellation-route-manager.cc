@@ -0,0 +1,380 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <limits>
+#include <queue>
+
+#include "constellation-route-manager.h"
+#include "ns3/ipv4.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ConstellationRouteManager");
+
+NS_OBJECT_ENSURE_REGISTERED (ConstellationRouteManager);
+
+TypeId
+ConstellationRouteManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ConstellationRouteManager")
+    .SetParent<SatcomRouteManager> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<ConstellationRouteManager> ()
+    .AddTraceSource ("Update",
+                     "A link toggled or changed cost and the affected trees were recomputed.",
+                     MakeTraceSourceAccessor (&ConstellationRouteManager::m_updateTrace),
+                     "ns3::ConstellationRouteManager::UpdateCallback")
+  ;
+  return tid;
+}
+
+ConstellationRouteManager::ConstellationRouteManager ()
+  : m_valid (false),
+    m_fullComputations (0),
+    m_treeUpdates (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ConstellationRouteManager::~ConstellationRouteManager ()
+{
+}
+
+void
+ConstellationRouteManager::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_nodes.clear ();
+  m_links.clear ();
+  Object::DoDispose ();
+}
+
+int32_t
+ConstellationRouteManager::GetVertex (uint32_t node) const
+{
+  return node < m_vertexOfNode.size () ? m_vertexOfNode[node] : -1;
+}
+
+uint32_t
+ConstellationRouteManager::AddNode (Ptr<Node> node)
+{
+  NS_LOG_FUNCTION (this << node);
+  int32_t vertex = GetVertex (node->GetId ());
+  if (vertex >= 0)
+    {
+      return vertex;
+    }
+  if (node->GetId () >= m_vertexOfNode.size ())
+    {
+      m_vertexOfNode.resize (node->GetId () + 1, -1);
+    }
+  m_vertexOfNode[node->GetId ()] = m_nodes.size ();
+  m_nodes.push_back (node);
+  m_adjacent.push_back (std::vector<uint32_t> ());
+  m_valid = false;
+  return m_nodes.size () - 1;
+}
+
+uint32_t
+ConstellationRouteManager::AddLink (Ptr<OrbitPointToPointChannel> channel, double cost)
+{
+  NS_LOG_FUNCTION (this << channel << cost);
+  NS_ASSERT_MSG (channel->GetNDevices () == 2, "The link needs both devices attached");
+  NS_ASSERT (cost > 0);
+  Link link;
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      link.end[i].device = channel->GetDevice (i);
+      int32_t vertex = GetVertex (link.end[i].device->GetNode ()->GetId ());
+      NS_ASSERT_MSG (vertex >= 0, "Add the nodes before their links");
+      link.end[i].vertex = vertex;
+      link.end[i].interface = 0;
+    }
+  link.cost = cost;
+  link.up = channel->IsLinkUp ();
+  uint32_t index = m_links.size ();
+  m_links.push_back (link);
+  m_adjacent[link.end[0].vertex].push_back (index);
+  m_adjacent[link.end[1].vertex].push_back (index);
+  channel->TraceConnectWithoutContext (
+    "LinkState", MakeCallback (&ConstellationRouteManager::LinkStateChanged, this).Bind (index));
+  m_valid = false;
+  return index;
+}
+
+void
+ConstellationRouteManager::LinkStateChanged (uint32_t link, bool up)
+{
+  SetLinkUp (link, up);
+}
+
+void
+ConstellationRouteManager::SetLinkUp (uint32_t link, bool up)
+{
+  NS_LOG_FUNCTION (this << link << up);
+  NS_ASSERT (link < m_links.size ());
+  Link &l = m_links[link];
+  if (l.up == up)
+    {
+      return;
+    }
+  bool wasUp = l.up;
+  l.up = up;
+  if (m_valid)
+    {
+      UpdateLink (link, wasUp, l.cost);
+    }
+}
+
+void
+ConstellationRouteManager::SetLinkCost (uint32_t link, double cost)
+{
+  NS_LOG_FUNCTION (this << link << cost);
+  NS_ASSERT (link < m_links.size ());
+  NS_ASSERT (cost > 0);
+  Link &l = m_links[link];
+  if (l.cost == cost)
+    {
+      return;
+    }
+  double oldCost = l.cost;
+  l.cost = cost;
+  if (m_valid)
+    {
+      UpdateLink (link, l.up, oldCost);
+    }
+}
+
+bool
+ConstellationRouteManager::IsLinkUp (uint32_t link) const
+{
+  NS_ASSERT (link < m_links.size ());
+  return m_links[link].up;
+}
+
+uint32_t
+ConstellationRouteManager::GetNLinks (void) const
+{
+  return m_links.size ();
+}
+
+uint32_t
+ConstellationRouteManager::GetNNodes (void) const
+{
+  return m_nodes.size ();
+}
+
+uint32_t
+ConstellationRouteManager::GetNFullComputations (void) const
+{
+  return m_fullComputations;
+}
+
+uint64_t
+ConstellationRouteManager::GetNTreeUpdates (void) const
+{
+  return m_treeUpdates;
+}
+
+void
+ConstellationRouteManager::ResolveAddresses (void)
+{
+  m_addressToVertex.clear ();
+  for (uint32_t v = 0; v < m_nodes.size (); ++v)
+    {
+      Ptr<Ipv4> ipv4 = m_nodes[v]->GetObject<Ipv4> ();
+      NS_ASSERT_MSG (ipv4 != 0, "Install the internet stack before routing");
+      for (uint32_t i = 0; i < ipv4->GetNInterfaces (); ++i)
+        {
+          for (uint32_t j = 0; j < ipv4->GetNAddresses (i); ++j)
+            {
+              Ipv4Address address = ipv4->GetAddress (i, j).GetLocal ();
+              if (!address.IsLocalhost ())
+                {
+                  m_addressToVertex[address.Get ()] = v;
+                }
+            }
+        }
+    }
+  for (std::vector<Link>::iterator it = m_links.begin (); it != m_links.end (); ++it)
+    {
+      for (uint32_t i = 0; i < 2; ++i)
+        {
+          End &end = it->end[i];
+          Ptr<Ipv4> ipv4 = m_nodes[end.vertex]->GetObject<Ipv4> ();
+          int32_t interface = ipv4->GetInterfaceForDevice (end.device);
+          NS_ASSERT_MSG (interface >= 0 && ipv4->GetNAddresses (interface) > 0,
+                         "Every routed link needs an address on both ends");
+          end.interface = interface;
+          end.address = ipv4->GetAddress (interface, 0).GetLocal ();
+        }
+    }
+}
+
+void
+ConstellationRouteManager::Compute (void)
+{
+  NS_LOG_FUNCTION (this);
+  ResolveAddresses ();
+  uint32_t n = m_nodes.size ();
+  m_distance.assign (n * n, std::numeric_limits<double>::infinity ());
+  m_via.assign (n * n, -1);
+  for (uint32_t d = 0; d < n; ++d)
+    {
+      ComputeTree (d);
+    }
+  m_valid = true;
+  m_fullComputations++;
+}
+
+void
+ConstellationRouteManager::ComputeTree (uint32_t destination)
+{
+  uint32_t n = m_nodes.size ();
+  double *distance = &m_distance[destination * n];
+  int32_t *via = &m_via[destination * n];
+  std::fill (distance, distance + n, std::numeric_limits<double>::infinity ());
+  std::fill (via, via + n, -1);
+
+  typedef std::pair<double, uint32_t> Entry;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+  distance[destination] = 0;
+  queue.push (Entry (0, destination));
+  while (!queue.empty ())
+    {
+      Entry top = queue.top ();
+      queue.pop ();
+      uint32_t u = top.second;
+      if (top.first > distance[u])
+        {
+          continue;
+        }
+      const std::vector<uint32_t> &adjacent = m_adjacent[u];
+      for (std::vector<uint32_t>::const_iterator it = adjacent.begin (); it != adjacent.end (); ++it)
+        {
+          const Link &l = m_links[*it];
+          if (!l.up)
+            {
+              continue;
+            }
+          uint32_t v = l.end[0].vertex == u ? l.end[1].vertex : l.end[0].vertex;
+          double d = top.first + l.cost;
+          if (d < distance[v])
+            {
+              distance[v] = d;
+              via[v] = *it;
+              queue.push (Entry (d, v));
+            }
+        }
+    }
+}
+
+void
+ConstellationRouteManager::UpdateLink (uint32_t link, bool wasUp, double oldCost)
+{
+  const Link &l = m_links[link];
+  uint32_t n = m_nodes.size ();
+  uint32_t a = l.end[0].vertex;
+  uint32_t b = l.end[1].vertex;
+  // A worse link only matters to the trees routing over it, a better one
+  // only to the trees in which it shortens the path of an endpoint.
+  bool worse = wasUp && (!l.up || l.cost > oldCost);
+  bool better = l.up && (!wasUp || l.cost < oldCost);
+  uint32_t trees = 0;
+  for (uint32_t d = 0; d < n; ++d)
+    {
+      const double *distance = &m_distance[d * n];
+      const int32_t *via = &m_via[d * n];
+      bool affected = false;
+      if (worse)
+        {
+          affected = via[a] == static_cast<int32_t> (link) || via[b] == static_cast<int32_t> (link);
+        }
+      else if (better)
+        {
+          affected = distance[a] + l.cost < distance[b] || distance[b] + l.cost < distance[a];
+        }
+      if (affected)
+        {
+          ComputeTree (d);
+          trees++;
+        }
+    }
+  m_treeUpdates += trees;
+  NS_LOG_LOGIC ("link " << link << (l.up ? " up" : " down") << ", " << trees << " of " << n << " trees recomputed");
+  m_updateTrace (link, l.up, trees);
+}
+
+Ptr<Ipv4Route>
+ConstellationRouteManager::Lookup (uint32_t node, Ipv4Address destination, Ptr<NetDevice> oif)
+{
+  if (!m_valid)
+    {
+      Compute ();
+    }
+  int32_t v = GetVertex (node);
+  std::unordered_map<uint32_t, uint32_t>::const_iterator it = m_addressToVertex.find (destination.Get ());
+  if (v < 0 || it == m_addressToVertex.end () || it->second == static_cast<uint32_t> (v))
+    {
+      return 0;
+    }
+  int32_t via = m_via[it->second * m_nodes.size () + v];
+  if (via < 0)
+    {
+      return 0;
+    }
+  const Link &l = m_links[via];
+  uint32_t side = l.end[0].vertex == static_cast<uint32_t> (v) ? 0 : 1;
+  if (oif != 0 && oif != l.end[side].device)
+    {
+      return 0;
+    }
+  Ptr<Ipv4Route> route = Create<Ipv4Route> ();
+  route->SetDestination (destination);
+  route->SetSource (l.end[side].address);
+  route->SetGateway (l.end[1 - side].address);
+  route->SetOutputDevice (l.end[side].device);
+  return route;
+}
+
+int32_t
+ConstellationRouteManager::GetHopCount (uint32_t node, uint32_t destination)
+{
+  if (!m_valid)
+    {
+      Compute ();
+    }
+  int32_t v = GetVertex (node);
+  int32_t d = GetVertex (destination);
+  NS_ASSERT (v >= 0 && d >= 0);
+  uint32_t n = m_nodes.size ();
+  int32_t hops = 0;
+  while (v != d)
+    {
+      int32_t via = m_via[d * n + v];
+      if (via < 0 || hops >= static_cast<int32_t> (n))
+        {
+          return -1;
+        }
+      const Link &l = m_links[via];
+      v = l.end[0].vertex == static_cast<uint32_t> (v) ? l.end[1].vertex : l.end[0].vertex;
+      hops++;
+    }
+  return hops;
+}
+
+} // namespace ns3
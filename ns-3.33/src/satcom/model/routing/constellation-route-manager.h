@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CONSTELLATION_ROUTE_MANAGER_H
+#define CONSTELLATION_ROUTE_MANAGER_H
+
+#include <vector>
+#include <unordered_map>
+
+#include "ns3/satcom-route-manager.h"
+#include "ns3/ptr.h"
+#include "ns3/node.h"
+#include "ns3/net-device.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/traced-callback.h"
+#include "ns3/orbit-point-to-point-channel.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Central shortest-path state for a network whose links come and
+ * go, such as a constellation with inter-satellite and ground links.
+ *
+ * The manager keeps one shortest-path tree per destination node. When a
+ * link toggles or changes cost, only the trees it can affect are
+ * recomputed: on a failure or cost increase those that route over the
+ * link, on a recovery or cost decrease those in which the link would
+ * shorten the path of one of its endpoints. The others are provably
+ * unchanged. Ipv4ConstellationRouting reads the next hop of its node
+ * from here, so an update costs no routing table rewrite.
+ *
+ * Links added from an OrbitPointToPointChannel follow its LinkState
+ * trace, so a ContactPlan driving the channel also drives the routes.
+ */
+class ConstellationRouteManager : public SatcomRouteManager
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  ConstellationRouteManager ();
+  virtual ~ConstellationRouteManager ();
+
+  /**
+   * TracedCallback signature for route updates.
+   * \param link the link that changed
+   * \param up whether it is now up
+   * \param trees the number of shortest-path trees recomputed
+   */
+  typedef void (* UpdateCallback) (uint32_t link, bool up, uint32_t trees);
+
+  /**
+   * \param node a node to route for
+   * \return its vertex index; adding a node twice returns the same index
+   */
+  uint32_t AddNode (Ptr<Node> node);
+
+  /**
+   * Add a point-to-point link between two added nodes and follow its
+   * LinkState trace.
+   * \param channel the channel, its two devices must be attached
+   * \param cost the routing cost of the link, positive
+   * \return the link index
+   */
+  uint32_t AddLink (Ptr<OrbitPointToPointChannel> channel, double cost = 1.0);
+
+  /**
+   * \param link a link index
+   * \param up whether the link may carry traffic
+   */
+  void SetLinkUp (uint32_t link, bool up);
+
+  /**
+   * \param link a link index
+   * \param cost the new routing cost, positive
+   */
+  void SetLinkCost (uint32_t link, double cost);
+
+  /**
+   * \param link a link index
+   * \return whether the link is up
+   */
+  bool IsLinkUp (uint32_t link) const;
+
+  /// \return the number of links
+  uint32_t GetNLinks (void) const;
+
+  /// \return the number of nodes
+  uint32_t GetNNodes (void) const;
+
+  /**
+   * Recompute every tree from scratch. Called automatically on first
+   * use; call it again after assigning new addresses.
+   */
+  void Compute (void);
+
+  /**
+   * \param node a node id
+   * \param destination a destination address
+   * \param oif the required output device, or null for any
+   * \return the route out of the node, or null if unreachable
+   */
+  virtual Ptr<Ipv4Route> Lookup (uint32_t node, Ipv4Address destination, Ptr<NetDevice> oif = 0);
+
+  /**
+   * \param node a node id
+   * \param destination a node id
+   * \return the number of hops on the current route, or -1 if none
+   */
+  int32_t GetHopCount (uint32_t node, uint32_t destination);
+
+  /// \return the number of full computations so far
+  uint32_t GetNFullComputations (void) const;
+
+  /// \return the number of trees recomputed by incremental updates so far
+  uint64_t GetNTreeUpdates (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /// One end of a link
+  struct End
+  {
+    uint32_t vertex;           //!< Vertex of the node
+    Ptr<NetDevice> device;     //!< Device on the link
+    uint32_t interface;        //!< IPv4 interface of the device
+    Ipv4Address address;       //!< Address of the interface
+  };
+
+  /// A point-to-point link
+  struct Link
+  {
+    End end[2];                //!< The two ends
+    double cost;               //!< Routing cost
+    bool up;                   //!< Whether the link is up
+  };
+
+  /// LinkState trace sink
+  void LinkStateChanged (uint32_t link, bool up);
+  /// Refresh interface indices, addresses and the address map
+  void ResolveAddresses (void);
+  /// Rebuild the tree of one destination with Dijkstra
+  void ComputeTree (uint32_t destination);
+  /// Recompute the trees the link can affect, given its old cost
+  void UpdateLink (uint32_t link, bool wasUp, double oldCost);
+  /// \return the vertex of a node id, or -1
+  int32_t GetVertex (uint32_t node) const;
+
+  std::vector<Ptr<Node> > m_nodes;              //!< Node of each vertex
+  std::vector<int32_t> m_vertexOfNode;          //!< Vertex of each node id
+  std::vector<Link> m_links;                    //!< Links
+  std::vector<std::vector<uint32_t> > m_adjacent; //!< Links of each vertex
+  std::unordered_map<uint32_t, uint32_t> m_addressToVertex; //!< Owner of each address
+
+  bool m_valid;                                 //!< Whether the trees are built
+  std::vector<double> m_distance;               //!< [destination * n + vertex] distance
+  std::vector<int32_t> m_via;                   //!< [destination * n + vertex] first link, -1 if none
+
+  uint32_t m_fullComputations;                  //!< Statistics
+  uint64_t m_treeUpdates;                       //!< Statistics
+  TracedCallback<uint32_t, bool, uint32_t> m_updateTrace; //!< Update trace
+};
+
+} // namespace ns3
+
+#endif /* CONSTELLATION_ROUTE_MANAGER_H */
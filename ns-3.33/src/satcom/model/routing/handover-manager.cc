@@ -0,0 +1,559 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "handover-manager.h"
+#include "ipv4-constellation-routing.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-list-routing.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node-list.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/enum.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("HandoverManager");
+
+NS_OBJECT_ENSURE_REGISTERED (HandoverManager);
+
+TypeId
+HandoverManager::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::HandoverManager")
+    .SetParent<SatcomRouteManager> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<HandoverManager> ()
+    .AddAttribute ("Policy",
+                   "How the serving station of a satellite is chosen.",
+                   EnumValue (HandoverManager::ELEVATION),
+                   MakeEnumAccessor (&HandoverManager::m_policy),
+                   MakeEnumChecker (HandoverManager::ELEVATION, "Elevation",
+                                    HandoverManager::LOAD, "Load"))
+    .AddAttribute ("Hysteresis",
+                   "Elevation gain in degrees needed to leave a serving station "
+                   "that is still usable, with the Elevation policy.",
+                   DoubleValue (5.0),
+                   MakeDoubleAccessor (&HandoverManager::m_hysteresis),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("Interval",
+                   "Period of the choice while a satellite sees several stations, "
+                   "zero to choose only when a link toggles.",
+                   TimeValue (Seconds (10)),
+                   MakeTimeAccessor (&HandoverManager::m_interval),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("Lead",
+                   "Time before the end of a contact window at which its link "
+                   "stops serving, if a ContactPlan is set.",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&HandoverManager::m_lead),
+                   MakeTimeChecker (Seconds (0)))
+    .AddTraceSource ("Handover",
+                     "The serving station of a satellite changed.",
+                     MakeTraceSourceAccessor (&HandoverManager::m_handoverTrace),
+                     "ns3::HandoverManager::HandoverCallback")
+  ;
+  return tid;
+}
+
+HandoverManager::HandoverManager ()
+  : m_policy (ELEVATION),
+    m_hysteresis (5.0),
+    m_started (false),
+    m_handovers (0),
+    m_breaks (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+HandoverManager::~HandoverManager ()
+{
+}
+
+void
+HandoverManager::DoDispose (void)
+{
+  m_start.Cancel ();
+  for (std::vector<Satellite>::iterator it = m_satellites.begin (); it != m_satellites.end (); ++it)
+    {
+      it->reevaluate.Cancel ();
+    }
+  for (std::vector<Access>::iterator it = m_accesses.begin (); it != m_accesses.end (); ++it)
+    {
+      it->leave.Cancel ();
+    }
+  m_satellites.clear ();
+  m_stations.clear ();
+  m_accesses.clear ();
+  m_groundRoutes.clear ();
+  m_plan = 0;
+  Object::DoDispose ();
+}
+
+void
+HandoverManager::SetContactPlan (Ptr<ContactPlan> plan)
+{
+  m_plan = plan;
+}
+
+uint32_t
+HandoverManager::AddSatellite (Ptr<Node> satellite, uint32_t contactIndex)
+{
+  NS_LOG_FUNCTION (this << satellite << contactIndex);
+  NS_ASSERT (m_satelliteOfNode.find (satellite->GetId ()) == m_satelliteOfNode.end ());
+  Satellite s;
+  s.node = satellite;
+  s.contactIndex = contactIndex;
+  s.serving = -1;
+  uint32_t index = m_satellites.size ();
+  m_satellites.push_back (s);
+  m_satelliteOfNode[satellite->GetId ()] = index;
+  Install (satellite);
+  return index;
+}
+
+uint32_t
+HandoverManager::AddGroundStation (Ptr<Node> station, uint32_t contactIndex)
+{
+  NS_LOG_FUNCTION (this << station << contactIndex);
+  NS_ASSERT (m_stationOfNode.find (station->GetId ()) == m_stationOfNode.end ());
+  Station s;
+  s.node = station;
+  s.contactIndex = contactIndex;
+  s.load = 0;
+  uint32_t index = m_stations.size ();
+  m_stations.push_back (s);
+  m_stationOfNode[station->GetId ()] = index;
+  Install (station);
+  return index;
+}
+
+uint32_t
+HandoverManager::AddAccessLink (Ptr<OrbitPointToPointChannel> channel)
+{
+  NS_LOG_FUNCTION (this << channel);
+  NS_ASSERT_MSG (channel->GetNDevices () == 2, "The link needs both devices attached");
+  Access access;
+  bool found = false;
+  for (uint32_t i = 0; i < 2 && !found; ++i)
+    {
+      std::unordered_map<uint32_t, uint32_t>::const_iterator sat =
+        m_satelliteOfNode.find (channel->GetDevice (i)->GetNode ()->GetId ());
+      std::unordered_map<uint32_t, uint32_t>::const_iterator st =
+        m_stationOfNode.find (channel->GetDevice (1 - i)->GetNode ()->GetId ());
+      if (sat != m_satelliteOfNode.end () && st != m_stationOfNode.end ())
+        {
+          access.satellite = sat->second;
+          access.station = st->second;
+          access.satelliteDevice = channel->GetDevice (i);
+          access.stationDevice = channel->GetDevice (1 - i);
+          found = true;
+        }
+    }
+  NS_ASSERT_MSG (found, "An access link joins an added satellite and an added station");
+  access.up = channel->IsLinkUp ();
+  access.leaving = false;
+  uint32_t index = m_accesses.size ();
+  m_accesses.push_back (access);
+  m_satellites[access.satellite].accesses.push_back (index);
+  m_accessOfPair[std::make_pair (access.station, access.satellite)] = index;
+  channel->TraceConnectWithoutContext (
+    "LinkState", MakeCallback (&HandoverManager::LinkStateChanged, this).Bind (index));
+  if (!m_start.IsRunning () && !m_started)
+    {
+      m_start = Simulator::ScheduleNow (&HandoverManager::Start, this);
+    }
+  return index;
+}
+
+void
+HandoverManager::Install (Ptr<Node> node)
+{
+  NS_LOG_FUNCTION (this << node);
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (ipv4 != 0, "Install the internet stack before the handover routing");
+  Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting> (ipv4->GetRoutingProtocol ());
+  NS_ASSERT_MSG (list != 0, "The handover routing needs a list routing");
+  for (uint32_t i = 0; i < list->GetNRoutingProtocols (); ++i)
+    {
+      int16_t priority;
+      Ptr<Ipv4ConstellationRouting> routing =
+        DynamicCast<Ipv4ConstellationRouting> (list->GetRoutingProtocol (i, priority));
+      if (routing != 0 && routing->GetRouteManager () == this)
+        {
+          return;
+        }
+    }
+  Ptr<Ipv4ConstellationRouting> routing = CreateObject<Ipv4ConstellationRouting> ();
+  routing->SetRouteManager (this);
+  list->AddRoutingProtocol (routing, 10);
+}
+
+void
+HandoverManager::Start (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_started = true;
+  for (std::vector<Access>::iterator it = m_accesses.begin (); it != m_accesses.end (); ++it)
+    {
+      Ptr<Ipv4> ipv4 = m_satellites[it->satellite].node->GetObject<Ipv4> ();
+      int32_t interface = ipv4->GetInterfaceForDevice (it->satelliteDevice);
+      NS_ASSERT_MSG (interface >= 0 && ipv4->GetNAddresses (interface) > 0,
+                     "Every access link needs an address on both ends");
+      it->satelliteAddress = ipv4->GetAddress (interface, 0).GetLocal ();
+      ipv4 = m_stations[it->station].node->GetObject<Ipv4> ();
+      interface = ipv4->GetInterfaceForDevice (it->stationDevice);
+      NS_ASSERT_MSG (interface >= 0 && ipv4->GetNAddresses (interface) > 0,
+                     "Every access link needs an address on both ends");
+      it->stationAddress = ipv4->GetAddress (interface, 0).GetLocal ();
+      m_accessOfAddress[it->stationAddress.Get ()] = it - m_accesses.begin ();
+      it->up = it->satelliteDevice->GetChannel ()->GetObject<OrbitPointToPointChannel> ()->IsLinkUp ();
+    }
+  for (uint32_t s = 0; s < m_satellites.size (); ++s)
+    {
+      Ptr<Ipv4> ipv4 = m_satellites[s].node->GetObject<Ipv4> ();
+      for (uint32_t i = 0; i < ipv4->GetNInterfaces (); ++i)
+        {
+          for (uint32_t j = 0; j < ipv4->GetNAddresses (i); ++j)
+            {
+              Ipv4Address address = ipv4->GetAddress (i, j).GetLocal ();
+              if (!address.IsLocalhost ())
+                {
+                  m_satelliteOfAddress[address.Get ()] = s;
+                }
+            }
+        }
+    }
+  // A station is reached from the ground over its first address that is
+  // not on an access link
+  for (std::vector<Station>::iterator it = m_stations.begin (); it != m_stations.end (); ++it)
+    {
+      Ptr<Ipv4> ipv4 = it->node->GetObject<Ipv4> ();
+      for (uint32_t i = 0; i < ipv4->GetNInterfaces () && it->groundAddress == Ipv4Address (); ++i)
+        {
+          if (ipv4->GetNAddresses (i) == 0 || ipv4->GetAddress (i, 0).GetLocal ().IsLocalhost ()
+              || m_accessOfAddress.find (ipv4->GetAddress (i, 0).GetLocal ().Get ()) != m_accessOfAddress.end ())
+            {
+              continue;
+            }
+          it->groundAddress = ipv4->GetAddress (i, 0).GetLocal ();
+        }
+    }
+  for (uint32_t a = 0; a < m_accesses.size (); ++a)
+    {
+      if (m_accesses[a].up)
+        {
+          ScheduleLeave (a);
+        }
+    }
+  for (uint32_t s = 0; s < m_satellites.size (); ++s)
+    {
+      Reevaluate (s);
+    }
+}
+
+void
+HandoverManager::LinkStateChanged (uint32_t access, bool up)
+{
+  NS_LOG_FUNCTION (this << access << up);
+  Access &a = m_accesses[access];
+  if (a.up == up)
+    {
+      return;
+    }
+  a.up = up;
+  a.leaving = false;
+  a.leave.Cancel ();
+  if (!m_started)
+    {
+      return;
+    }
+  Satellite &s = m_satellites[a.satellite];
+  if (up)
+    {
+      ScheduleLeave (access);
+      if (s.serving < 0)
+        {
+          Select (a.satellite);
+        }
+      if (!s.reevaluate.IsRunning ())
+        {
+          Reevaluate (a.satellite);
+        }
+    }
+  else if (s.serving == static_cast<int32_t> (access))
+    {
+      NS_LOG_LOGIC ("serving link of satellite " << a.satellite << " dropped");
+      Select (a.satellite);
+      m_breaks += s.serving >= 0;
+    }
+}
+
+void
+HandoverManager::ScheduleLeave (uint32_t access)
+{
+  if (m_plan == 0)
+    {
+      return;
+    }
+  Access &a = m_accesses[access];
+  std::vector<ContactWindow> windows = m_plan->GetWindows (m_satellites[a.satellite].contactIndex,
+                                                          m_stations[a.station].contactIndex);
+  Time now = Simulator::Now ();
+  for (std::vector<ContactWindow>::const_iterator it = windows.begin (); it != windows.end (); ++it)
+    {
+      if (it->end > now && it->start <= now + MilliSeconds (1))
+        {
+          a.leave = Simulator::Schedule (Max (it->end - m_lead - now, Seconds (0)),
+                                         &HandoverManager::Leave, this, access);
+          return;
+        }
+    }
+}
+
+void
+HandoverManager::Leave (uint32_t access)
+{
+  NS_LOG_FUNCTION (this << access);
+  Access &a = m_accesses[access];
+  a.leaving = true;
+  if (m_satellites[a.satellite].serving == static_cast<int32_t> (access))
+    {
+      Select (a.satellite);
+    }
+}
+
+void
+HandoverManager::Reevaluate (uint32_t satellite)
+{
+  Satellite &s = m_satellites[satellite];
+  Select (satellite);
+  uint32_t visible = 0;
+  for (std::vector<uint32_t>::const_iterator it = s.accesses.begin (); it != s.accesses.end (); ++it)
+    {
+      visible += m_accesses[*it].up && !m_accesses[*it].leaving;
+    }
+  if (visible > 1 && m_interval > Seconds (0))
+    {
+      s.reevaluate = Simulator::Schedule (m_interval, &HandoverManager::Reevaluate, this, satellite);
+    }
+}
+
+double
+HandoverManager::GetElevation (const Access &access) const
+{
+  Time now = Simulator::Now ();
+  Vector station = ContactPlan::GetPositionAt (m_stations[access.station].node->GetObject<MobilityModel> (), now);
+  Vector satellite = ContactPlan::GetPositionAt (m_satellites[access.satellite].node->GetObject<MobilityModel> (), now);
+  return ContactPlan::GetElevation (station, satellite);
+}
+
+void
+HandoverManager::Select (uint32_t satellite)
+{
+  Satellite &s = m_satellites[satellite];
+  int32_t best = -1;
+  double bestElevation = 0;
+  uint32_t bestLoad = 0;
+  for (std::vector<uint32_t>::const_iterator it = s.accesses.begin (); it != s.accesses.end (); ++it)
+    {
+      const Access &a = m_accesses[*it];
+      if (!a.up || a.leaving)
+        {
+          continue;
+        }
+      double elevation = GetElevation (a);
+      // A station counts the satellite it already serves out of its load
+      uint32_t load = m_stations[a.station].load - (s.serving == static_cast<int32_t> (*it));
+      if (s.serving == static_cast<int32_t> (*it) && m_policy == ELEVATION)
+        {
+          elevation += m_hysteresis;
+        }
+      bool better = best < 0
+        || (m_policy == LOAD && load < bestLoad)
+        || ((m_policy == ELEVATION || load == bestLoad) && elevation > bestElevation);
+      if (better)
+        {
+          best = *it;
+          bestElevation = elevation;
+          bestLoad = load;
+        }
+    }
+  if (m_policy == LOAD && s.serving >= 0 && m_accesses[s.serving].up && !m_accesses[s.serving].leaving)
+    {
+      // Only hand over when the serving link is lost
+      best = s.serving;
+    }
+  if (best < 0 && s.serving >= 0 && m_accesses[s.serving].up)
+    {
+      // Nothing else is visible, keep the leaving link until it drops
+      best = s.serving;
+    }
+  if (best != s.serving)
+    {
+      Switch (satellite, best);
+    }
+}
+
+void
+HandoverManager::Switch (uint32_t satellite, int32_t access)
+{
+  Satellite &s = m_satellites[satellite];
+  int32_t from = s.serving >= 0 ? static_cast<int32_t> (m_accesses[s.serving].station) : -1;
+  int32_t to = access >= 0 ? static_cast<int32_t> (m_accesses[access].station) : -1;
+  NS_LOG_INFO ("satellite " << satellite << " hands over from station " << from << " to " << to
+               << " at " << Simulator::Now ().As (Time::S));
+  if (from >= 0)
+    {
+      m_stations[from].load--;
+    }
+  if (to >= 0)
+    {
+      m_stations[to].load++;
+    }
+  s.serving = access;
+  m_handovers++;
+  m_handoverTrace (satellite, from, to);
+}
+
+int32_t
+HandoverManager::GetServingStation (uint32_t satellite) const
+{
+  NS_ASSERT (satellite < m_satellites.size ());
+  int32_t serving = m_satellites[satellite].serving;
+  return serving >= 0 ? static_cast<int32_t> (m_accesses[serving].station) : -1;
+}
+
+Ptr<Ipv4Route>
+HandoverManager::MakeRoute (const Access &access, bool fromSatellite, Ipv4Address destination) const
+{
+  Ptr<Ipv4Route> route = Create<Ipv4Route> ();
+  route->SetDestination (destination);
+  route->SetSource (fromSatellite ? access.satelliteAddress : access.stationAddress);
+  route->SetGateway (fromSatellite ? access.stationAddress : access.satelliteAddress);
+  route->SetOutputDevice (fromSatellite ? access.satelliteDevice : access.stationDevice);
+  return route;
+}
+
+Ptr<Ipv4Route>
+HandoverManager::GetGroundRoute (uint32_t node, uint32_t station)
+{
+  std::pair<uint32_t, uint32_t> key (node, station);
+  std::map<std::pair<uint32_t, uint32_t>, Ptr<Ipv4Route> >::const_iterator it = m_groundRoutes.find (key);
+  if (it != m_groundRoutes.end ())
+    {
+      return it->second;
+    }
+  // The ground network does not change: ask the other protocols once
+  Ptr<Ipv4Route> route;
+  Ptr<Ipv4> ipv4 = NodeList::GetNode (node)->GetObject<Ipv4> ();
+  if (m_stations[station].groundAddress != Ipv4Address ())
+    {
+      Ipv4Header header;
+      header.SetDestination (m_stations[station].groundAddress);
+      Socket::SocketErrno sockerr;
+      route = ipv4->GetRoutingProtocol ()->RouteOutput (0, header, 0, sockerr);
+    }
+  NS_LOG_LOGIC ("ground route from node " << node << " to station " << station << ": " << route);
+  m_groundRoutes[key] = route;
+  return route;
+}
+
+Ptr<Ipv4Route>
+HandoverManager::Lookup (uint32_t node, Ipv4Address destination, Ptr<NetDevice> oif)
+{
+  if (!m_started)
+    {
+      return 0;
+    }
+  Ptr<Ipv4Route> route;
+  std::unordered_map<uint32_t, uint32_t>::const_iterator sat = m_satelliteOfNode.find (node);
+  if (sat != m_satelliteOfNode.end ())
+    {
+      // From a satellite: straight to a visible station it is addressed
+      // to, through the serving station otherwise
+      if (m_satelliteOfAddress.find (destination.Get ()) != m_satelliteOfAddress.end ())
+        {
+          return 0;
+        }
+      std::unordered_map<uint32_t, uint32_t>::const_iterator direct = m_accessOfAddress.find (destination.Get ());
+      if (direct != m_accessOfAddress.end () && m_accesses[direct->second].satellite == sat->second
+          && m_accesses[direct->second].up)
+        {
+          route = MakeRoute (m_accesses[direct->second], true, destination);
+        }
+      else if (m_satellites[sat->second].serving >= 0)
+        {
+          route = MakeRoute (m_accesses[m_satellites[sat->second].serving], true, destination);
+        }
+    }
+  else
+    {
+      // From the ground: over the own access link while it is up, which
+      // lets a station deliver what reaches it after a handover, through
+      // the serving station otherwise
+      std::unordered_map<uint32_t, uint32_t>::const_iterator target = m_satelliteOfAddress.find (destination.Get ());
+      if (target == m_satelliteOfAddress.end ())
+        {
+          return 0;
+        }
+      std::unordered_map<uint32_t, uint32_t>::const_iterator st = m_stationOfNode.find (node);
+      if (st != m_stationOfNode.end ())
+        {
+          std::map<std::pair<uint32_t, uint32_t>, uint32_t>::const_iterator own =
+            m_accessOfPair.find (std::make_pair (st->second, target->second));
+          if (own != m_accessOfPair.end () && m_accesses[own->second].up)
+            {
+              route = MakeRoute (m_accesses[own->second], false, destination);
+            }
+        }
+      int32_t serving = m_satellites[target->second].serving;
+      if (route == 0 && serving >= 0)
+        {
+          Ptr<Ipv4Route> ground = GetGroundRoute (node, m_accesses[serving].station);
+          if (ground != 0)
+            {
+              route = Create<Ipv4Route> ();
+              route->SetDestination (destination);
+              route->SetSource (ground->GetSource ());
+              route->SetGateway (ground->GetGateway ());
+              route->SetOutputDevice (ground->GetOutputDevice ());
+            }
+        }
+    }
+  if (route != 0 && oif != 0 && oif != route->GetOutputDevice ())
+    {
+      return 0;
+    }
+  return route;
+}
+
+uint32_t
+HandoverManager::GetNHandovers (void) const
+{
+  return m_handovers;
+}
+
+uint32_t
+HandoverManager::GetNBreaks (void) const
+{
+  return m_breaks;
+}
+
+} // namespace ns3
@@ -0,0 +1,232 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef HANDOVER_MANAGER_H
+#define HANDOVER_MANAGER_H
+
+#include <vector>
+#include <map>
+#include <unordered_map>
+
+#include "ns3/satcom-route-manager.h"
+#include "ns3/ptr.h"
+#include "ns3/node.h"
+#include "ns3/net-device.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+#include "ns3/orbit-point-to-point-channel.h"
+#include "ns3/contact-plan.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Chooses the ground station serving each satellite and routes
+ * the traffic between satellites and the ground network through it.
+ *
+ * Satellites reach the ground over access links, OrbitPointToPointChannel
+ * links whose LinkState tells which stations are visible. Among the
+ * visible stations of a satellite, the manager picks the serving one by
+ * "Policy": the highest elevation, switching only for a gain of more than
+ * "Hysteresis", or the fewest satellites already served. The choice is
+ * revisited when an access link toggles and every "Interval" while more
+ * than one station is visible.
+ *
+ * If a ContactPlan is given, the handover is made before the break: the
+ * serving link is given up "Lead" before its window closes, while it still
+ * carries the packets already queued on it and in flight, instead of when
+ * it drops.
+ *
+ * Ipv4ConstellationRouting reads the serving station from here: a satellite
+ * sends everything through its serving station, and a ground node sends
+ * the traffic for a satellite over its own access link if that is up, and
+ * towards the serving station over the ground network otherwise. The
+ * ground routes to each station are taken once from the other routing
+ * protocols of the node, so a handover only changes the serving station
+ * index and rewrites no route.
+ */
+class HandoverManager : public SatcomRouteManager
+{
+public:
+  /// How the serving station is chosen
+  enum Policy
+  {
+    ELEVATION,  //!< Highest elevation, with hysteresis
+    LOAD        //!< Fewest satellites served, then highest elevation
+  };
+
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  HandoverManager ();
+  virtual ~HandoverManager ();
+
+  /**
+   * TracedCallback signature for handovers.
+   * \param satellite the satellite index
+   * \param from the previous serving station index, -1 for none
+   * \param to the new serving station index, -1 for none
+   */
+  typedef void (* HandoverCallback) (uint32_t satellite, int32_t from, int32_t to);
+
+  /**
+   * \param plan the contact plan giving the window ends, or null to hand
+   * over only when the serving link drops
+   */
+  void SetContactPlan (Ptr<ContactPlan> plan);
+
+  /**
+   * Add a satellite and install Ipv4ConstellationRouting on it.
+   * \param satellite the satellite node, with an internet stack
+   * \param contactIndex its satellite index in the ContactPlan, if any
+   * \return the satellite index
+   */
+  uint32_t AddSatellite (Ptr<Node> satellite, uint32_t contactIndex = 0);
+
+  /**
+   * Add a ground station and install Ipv4ConstellationRouting on it.
+   * \param station the station node, with an internet stack
+   * \param contactIndex its ground station index in the ContactPlan, if any
+   * \return the ground station index
+   */
+  uint32_t AddGroundStation (Ptr<Node> station, uint32_t contactIndex = 0);
+
+  /**
+   * Add an access link between an added satellite and an added station
+   * and follow its LinkState trace.
+   * \param channel the channel, its two devices must be attached
+   * \return the access link index
+   */
+  uint32_t AddAccessLink (Ptr<OrbitPointToPointChannel> channel);
+
+  /**
+   * Install Ipv4ConstellationRouting on another ground node, e.g. a mission
+   * control center reaching the stations over a ground network. Its list
+   * routing must know routes to the stations.
+   * \param node the node, with an internet stack
+   */
+  void Install (Ptr<Node> node);
+
+  /**
+   * \param satellite a satellite index
+   * \return the serving ground station index, -1 for none
+   */
+  int32_t GetServingStation (uint32_t satellite) const;
+
+  /**
+   * \param node a node id
+   * \param destination a destination address
+   * \param oif the required output device, or null for any
+   * \return the route out of the node, or null if the manager has none
+   */
+  virtual Ptr<Ipv4Route> Lookup (uint32_t node, Ipv4Address destination, Ptr<NetDevice> oif = 0);
+
+  /// \return the number of handovers so far, acquisitions and losses included
+  uint32_t GetNHandovers (void) const;
+
+  /// \return the number of handovers to another station forced by the serving link dropping
+  uint32_t GetNBreaks (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// An access link
+  struct Access
+  {
+    uint32_t satellite;            //!< Satellite index
+    uint32_t station;              //!< Station index
+    Ptr<NetDevice> satelliteDevice; //!< Device on the satellite
+    Ptr<NetDevice> stationDevice;  //!< Device on the station
+    Ipv4Address satelliteAddress;  //!< Address of the satellite device
+    Ipv4Address stationAddress;    //!< Address of the station device
+    bool up;                       //!< Whether the link is up
+    bool leaving;                  //!< Whether its window is about to close
+    EventId leave;                 //!< Pending end of window event
+  };
+
+  /// A satellite
+  struct Satellite
+  {
+    Ptr<Node> node;                //!< Node
+    uint32_t contactIndex;         //!< Index in the ContactPlan
+    int32_t serving;               //!< Serving access link, -1 for none
+    std::vector<uint32_t> accesses; //!< Access links
+    EventId reevaluate;            //!< Pending periodic choice
+  };
+
+  /// A ground station
+  struct Station
+  {
+    Ptr<Node> node;                //!< Node
+    uint32_t contactIndex;         //!< Index in the ContactPlan
+    uint32_t load;                 //!< Number of satellites served
+    Ipv4Address groundAddress;     //!< Address reached over the ground network
+  };
+
+  /// Resolve addresses and take the initial link states
+  void Start (void);
+  /// LinkState trace sink
+  void LinkStateChanged (uint32_t access, bool up);
+  /// Schedule the end of the window of an access link that came up
+  void ScheduleLeave (uint32_t access);
+  /// End of window event
+  void Leave (uint32_t access);
+  /// Periodic choice event
+  void Reevaluate (uint32_t satellite);
+  /// Choose the serving station of a satellite again
+  void Select (uint32_t satellite);
+  /// Make an access link, or none, the serving one
+  void Switch (uint32_t satellite, int32_t access);
+  /// \return the elevation of the satellite seen from the station, in degrees
+  double GetElevation (const Access &access) const;
+  /// \return a route out of the device of one end of an access link
+  Ptr<Ipv4Route> MakeRoute (const Access &access, bool fromSatellite, Ipv4Address destination) const;
+  /// \return the route from a ground node towards a station, cached
+  Ptr<Ipv4Route> GetGroundRoute (uint32_t node, uint32_t station);
+
+  Policy m_policy;                 //!< Selection policy
+  double m_hysteresis;             //!< Elevation gain needed to switch, degrees
+  Time m_interval;                 //!< Period of the choice while several stations are visible
+  Time m_lead;                     //!< Handover time before the window closes
+  Ptr<ContactPlan> m_plan;         //!< Window ends, may be null
+
+  std::vector<Satellite> m_satellites;           //!< Satellites
+  std::vector<Station> m_stations;               //!< Stations
+  std::vector<Access> m_accesses;                //!< Access links
+  std::unordered_map<uint32_t, uint32_t> m_satelliteOfNode; //!< Satellite of each node id
+  std::unordered_map<uint32_t, uint32_t> m_stationOfNode;   //!< Station of each node id
+  std::unordered_map<uint32_t, uint32_t> m_satelliteOfAddress; //!< Satellite owning each address
+  std::unordered_map<uint32_t, uint32_t> m_accessOfAddress;  //!< Access link of each station-side address
+  std::map<std::pair<uint32_t, uint32_t>, uint32_t> m_accessOfPair; //!< Access link of (station, satellite)
+  std::map<std::pair<uint32_t, uint32_t>, Ptr<Ipv4Route> > m_groundRoutes; //!< Route of (node, station)
+
+  bool m_started;                  //!< Whether Start () ran
+  EventId m_start;                 //!< Pending Start () event
+  uint32_t m_handovers;            //!< Statistics
+  uint32_t m_breaks;               //!< Statistics
+  TracedCallback<uint32_t, int32_t, int32_t> m_handoverTrace; //!< Handover trace
+};
+
+} // namespace ns3
+
+#endif /* HANDOVER_MANAGER_H */
@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv4-constellation-routing.h"
+#include "ns3/ipv4.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4ConstellationRouting");
+
+NS_OBJECT_ENSURE_REGISTERED (Ipv4ConstellationRouting);
+
+TypeId
+Ipv4ConstellationRouting::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::Ipv4ConstellationRouting")
+    .SetParent<Ipv4RoutingProtocol> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<Ipv4ConstellationRouting> ()
+  ;
+  return tid;
+}
+
+Ipv4ConstellationRouting::Ipv4ConstellationRouting ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ipv4ConstellationRouting::~Ipv4ConstellationRouting ()
+{
+}
+
+void
+Ipv4ConstellationRouting::DoDispose (void)
+{
+  m_ipv4 = 0;
+  m_manager = 0;
+  Ipv4RoutingProtocol::DoDispose ();
+}
+
+void
+Ipv4ConstellationRouting::SetRouteManager (Ptr<SatcomRouteManager> manager)
+{
+  m_manager = manager;
+}
+
+Ptr<SatcomRouteManager>
+Ipv4ConstellationRouting::GetRouteManager (void) const
+{
+  return m_manager;
+}
+
+Ptr<Ipv4Route>
+Ipv4ConstellationRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif,
+                                       Socket::SocketErrno &sockerr)
+{
+  NS_LOG_FUNCTION (this << p << &header << oif << &sockerr);
+  Ptr<Ipv4Route> route;
+  if (!header.GetDestination ().IsMulticast () && m_manager != 0)
+    {
+      route = m_manager->Lookup (m_ipv4->GetObject<Node> ()->GetId (), header.GetDestination (), oif);
+    }
+  sockerr = route != 0 ? Socket::ERROR_NOTERROR : Socket::ERROR_NOROUTETOHOST;
+  return route;
+}
+
+bool
+Ipv4ConstellationRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                                      UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                                      LocalDeliverCallback lcb, ErrorCallback ecb)
+{
+  NS_LOG_FUNCTION (this << p << header << idev);
+  NS_ASSERT (m_ipv4->GetInterfaceForDevice (idev) >= 0);
+  uint32_t iif = m_ipv4->GetInterfaceForDevice (idev);
+
+  if (m_ipv4->IsDestinationAddress (header.GetDestination (), iif))
+    {
+      if (!lcb.IsNull ())
+        {
+          lcb (p, header, iif);
+          return true;
+        }
+      return false;
+    }
+  if (header.GetDestination ().IsMulticast () || m_manager == 0)
+    {
+      return false;
+    }
+  // Destinations the manager does not route are left to the next protocol
+  Ptr<Ipv4Route> route = m_manager->Lookup (m_ipv4->GetObject<Node> ()->GetId (), header.GetDestination ());
+  if (route == 0)
+    {
+      NS_LOG_LOGIC ("No route to " << header.GetDestination ());
+      return false;
+    }
+  if (!m_ipv4->IsForwarding (iif))
+    {
+      ecb (p, header, Socket::ERROR_NOROUTETOHOST);
+      return true;
+    }
+  ucb (route, p, header);
+  return true;
+}
+
+void
+Ipv4ConstellationRouting::NotifyInterfaceUp (uint32_t interface)
+{
+}
+
+void
+Ipv4ConstellationRouting::NotifyInterfaceDown (uint32_t interface)
+{
+}
+
+void
+Ipv4ConstellationRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+}
+
+void
+Ipv4ConstellationRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+}
+
+void
+Ipv4ConstellationRouting::SetIpv4 (Ptr<Ipv4> ipv4)
+{
+  NS_LOG_FUNCTION (this << ipv4);
+  NS_ASSERT (m_ipv4 == 0 && ipv4 != 0);
+  m_ipv4 = ipv4;
+}
+
+void
+Ipv4ConstellationRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
+{
+  std::ostream *os = stream->GetStream ();
+  *os << "Node: " << m_ipv4->GetObject<Node> ()->GetId ()
+      << ", Time: " << Now ().As (unit)
+      << ", Ipv4ConstellationRouting table" << std::endl;
+  if (m_manager == 0)
+    {
+      return;
+    }
+  *os << "  routes follow the " << m_manager->GetInstanceTypeId ().GetName () << std::endl;
+}
+
+} // namespace ns3
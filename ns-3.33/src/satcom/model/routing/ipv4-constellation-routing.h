@@ -0,0 +1,79 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_CONSTELLATION_ROUTING_H
+#define IPV4_CONSTELLATION_ROUTING_H
+
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/satcom-route-manager.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Unicast routing that follows a SatcomRouteManager.
+ *
+ * The protocol holds no table of its own: every lookup asks the
+ * manager, e.g. the shared shortest-path trees of a
+ * ConstellationRouteManager or the serving stations of a
+ * HandoverManager, so route changes take effect as soon as the manager
+ * has updated them. Destinations the manager does not route, multicast
+ * and broadcast are left to other protocols of a list routing.
+ */
+class Ipv4ConstellationRouting : public Ipv4RoutingProtocol
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  Ipv4ConstellationRouting ();
+  virtual ~Ipv4ConstellationRouting ();
+
+  /**
+   * \param manager the manager holding the routes
+   */
+  void SetRouteManager (Ptr<SatcomRouteManager> manager);
+
+  /// \return the manager holding the routes
+  Ptr<SatcomRouteManager> GetRouteManager (void) const;
+
+  // Inherited from Ipv4RoutingProtocol
+  virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif,
+                                      Socket::SocketErrno &sockerr);
+  virtual bool RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                           UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                           LocalDeliverCallback lcb, ErrorCallback ecb);
+  virtual void NotifyInterfaceUp (uint32_t interface);
+  virtual void NotifyInterfaceDown (uint32_t interface);
+  virtual void NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void SetIpv4 (Ptr<Ipv4> ipv4);
+  virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  Ptr<Ipv4> m_ipv4;                          //!< The IPv4 of the node
+  Ptr<SatcomRouteManager> m_manager;         //!< The route manager
+};
+
+} // namespace ns3
+
+#endif /* IPV4_CONSTELLATION_ROUTING_H */
@@ -0,0 +1,59 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SATCOM_ROUTE_MANAGER_H
+#define SATCOM_ROUTE_MANAGER_H
+
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/net-device.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-route.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Central route state that Ipv4ConstellationRouting asks for
+ * every packet.
+ *
+ * A manager holds the routes of all the nodes it serves, so a topology
+ * change is one update of the manager rather than a rewrite of per-node
+ * tables. ConstellationRouteManager and HandoverManager implement it.
+ */
+class SatcomRouteManager : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual ~SatcomRouteManager ();
+
+  /**
+   * \param node a node id
+   * \param destination a destination address
+   * \param oif the required output device, or null for any
+   * \return the route out of the node, or null if the manager has none
+   */
+  virtual Ptr<Ipv4Route> Lookup (uint32_t node, Ipv4Address destination, Ptr<NetDevice> oif = 0) = 0;
+};
+
+} // namespace ns3
+
+#endif /* SATCOM_ROUTE_MANAGER_H */
@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "file-delivery-header.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (FileDeliveryHeader);
+
+FileDeliveryHeader::FileDeliveryHeader ()
+  : m_type (DATA),
+    m_transaction (0),
+    m_fileSize (0),
+    m_segmentSize (0),
+    m_offset (0)
+{
+}
+
+TypeId
+FileDeliveryHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FileDeliveryHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<FileDeliveryHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+FileDeliveryHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+FileDeliveryHeader::GetSerializedSize (void) const
+{
+  uint32_t size = 25;
+  if (m_type == NAK)
+    {
+      size += 2 + 16 * m_ranges.size ();
+    }
+  return size;
+}
+
+void
+FileDeliveryHeader::Serialize (Buffer::Iterator start) const
+{
+  start.WriteU8 (m_type);
+  start.WriteHtonU32 (m_transaction);
+  start.WriteHtonU64 (m_fileSize);
+  start.WriteHtonU32 (m_segmentSize);
+  start.WriteHtonU64 (m_offset);
+  if (m_type == NAK)
+    {
+      start.WriteHtonU16 (m_ranges.size ());
+      for (std::vector<std::pair<uint64_t, uint64_t> >::const_iterator it = m_ranges.begin (); it != m_ranges.end (); ++it)
+        {
+          start.WriteHtonU64 (it->first);
+          start.WriteHtonU64 (it->second);
+        }
+    }
+}
+
+uint32_t
+FileDeliveryHeader::Deserialize (Buffer::Iterator start)
+{
+  m_type = start.ReadU8 ();
+  m_transaction = start.ReadNtohU32 ();
+  m_fileSize = start.ReadNtohU64 ();
+  m_segmentSize = start.ReadNtohU32 ();
+  m_offset = start.ReadNtohU64 ();
+  m_ranges.clear ();
+  if (m_type == NAK)
+    {
+      uint16_t n = start.ReadNtohU16 ();
+      for (uint16_t i = 0; i < n; i++)
+        {
+          uint64_t first = start.ReadNtohU64 ();
+          uint64_t second = start.ReadNtohU64 ();
+          m_ranges.push_back (std::make_pair (first, second));
+        }
+    }
+  return GetSerializedSize ();
+}
+
+void
+FileDeliveryHeader::Print (std::ostream &os) const
+{
+  static const char *names[] = { "DATA", "EOF", "NAK", "FIN" };
+  os << (m_type <= FINISHED ? names[m_type] : "?")
+     << " transaction " << m_transaction << " size " << m_fileSize
+     << " segment " << m_segmentSize << " offset " << m_offset;
+  for (std::vector<std::pair<uint64_t, uint64_t> >::const_iterator it = m_ranges.begin (); it != m_ranges.end (); ++it)
+    {
+      os << " [" << it->first << "," << it->second << ")";
+    }
+}
+
+void
+FileDeliveryHeader::SetType (Type type)
+{
+  m_type = type;
+}
+
+FileDeliveryHeader::Type
+FileDeliveryHeader::GetType (void) const
+{
+  return static_cast<Type> (m_type);
+}
+
+void
+FileDeliveryHeader::SetTransaction (uint32_t transaction)
+{
+  m_transaction = transaction;
+}
+
+uint32_t
+FileDeliveryHeader::GetTransaction (void) const
+{
+  return m_transaction;
+}
+
+void
+FileDeliveryHeader::SetFileSize (uint64_t fileSize)
+{
+  m_fileSize = fileSize;
+}
+
+uint64_t
+FileDeliveryHeader::GetFileSize (void) const
+{
+  return m_fileSize;
+}
+
+void
+FileDeliveryHeader::SetSegmentSize (uint32_t segmentSize)
+{
+  m_segmentSize = segmentSize;
+}
+
+uint32_t
+FileDeliveryHeader::GetSegmentSize (void) const
+{
+  return m_segmentSize;
+}
+
+void
+FileDeliveryHeader::SetOffset (uint64_t offset)
+{
+  m_offset = offset;
+}
+
+uint64_t
+FileDeliveryHeader::GetOffset (void) const
+{
+  return m_offset;
+}
+
+void
+FileDeliveryHeader::AddRange (uint64_t start, uint64_t end)
+{
+  NS_ASSERT (m_ranges.size () < 0xffff);
+  m_ranges.push_back (std::make_pair (start, end));
+}
+
+uint32_t
+FileDeliveryHeader::GetNRanges (void) const
+{
+  return m_ranges.size ();
+}
+
+std::pair<uint64_t, uint64_t>
+FileDeliveryHeader::GetRange (uint32_t i) const
+{
+  NS_ASSERT (i < m_ranges.size ());
+  return m_ranges[i];
+}
+
+} // namespace ns3
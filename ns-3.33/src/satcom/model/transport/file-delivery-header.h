@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FILE_DELIVERY_HEADER_H
+#define FILE_DELIVERY_HEADER_H
+
+#include <utility>
+#include <vector>
+
+#include "ns3/header.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Protocol data unit of the file delivery protocol.
+ *
+ * A fixed part shared by every PDU (type, transaction, file size,
+ * segment size and byte offset) in the spirit of the CCSDS File
+ * Delivery Protocol, followed for NAK PDUs by a list of missing byte
+ * ranges. File data itself is the packet payload after the header.
+ */
+class FileDeliveryHeader : public Header
+{
+public:
+  /// PDU types
+  enum Type
+  {
+    DATA = 0,         //!< File data at the offset
+    END_OF_FILE = 1,  //!< Every segment has been sent at least once
+    NAK = 2,          //!< Byte ranges the receiver is missing
+    FINISHED = 3      //!< The receiver holds the whole file
+  };
+
+  FileDeliveryHeader ();
+
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+  virtual void Print (std::ostream &os) const;
+
+  /// \param type the PDU type
+  void SetType (Type type);
+  /// \return the PDU type
+  Type GetType (void) const;
+
+  /// \param transaction the transaction id given by the sender
+  void SetTransaction (uint32_t transaction);
+  /// \return the transaction id
+  uint32_t GetTransaction (void) const;
+
+  /// \param fileSize the size of the file in bytes
+  void SetFileSize (uint64_t fileSize);
+  /// \return the size of the file in bytes
+  uint64_t GetFileSize (void) const;
+
+  /// \param segmentSize the size of every segment but the last, in bytes
+  void SetSegmentSize (uint32_t segmentSize);
+  /// \return the segment size in bytes
+  uint32_t GetSegmentSize (void) const;
+
+  /// \param offset the offset of the data in the file
+  void SetOffset (uint64_t offset);
+  /// \return the offset of the data in the file
+  uint64_t GetOffset (void) const;
+
+  /**
+   * \brief Add a missing range to a NAK
+   * \param start the offset of the first missing byte
+   * \param end the offset after the last missing byte
+   */
+  void AddRange (uint64_t start, uint64_t end);
+
+  /// \return the number of missing ranges
+  uint32_t GetNRanges (void) const;
+
+  /**
+   * \param i the index of a missing range
+   * \return its start and end offsets
+   */
+  std::pair<uint64_t, uint64_t> GetRange (uint32_t i) const;
+
+private:
+  uint8_t m_type;            //!< PDU type
+  uint32_t m_transaction;    //!< Transaction id
+  uint64_t m_fileSize;       //!< File size in bytes
+  uint32_t m_segmentSize;    //!< Segment size in bytes
+  uint64_t m_offset;         //!< Offset of the data in the file
+  std::vector<std::pair<uint64_t, uint64_t> > m_ranges;  //!< Missing ranges of a NAK
+};
+
+} // namespace ns3
+
+#endif /* FILE_DELIVERY_HEADER_H */
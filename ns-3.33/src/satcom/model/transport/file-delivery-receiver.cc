@@ -0,0 +1,248 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+
+#include "file-delivery-receiver.h"
+#include "file-delivery-header.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FileDeliveryReceiver");
+
+NS_OBJECT_ENSURE_REGISTERED (FileDeliveryReceiver);
+
+TypeId
+FileDeliveryReceiver::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FileDeliveryReceiver")
+    .SetParent<Application> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<FileDeliveryReceiver> ()
+    .AddAttribute ("Port", "Port to listen on.",
+                   UintegerValue (9200),
+                   MakeUintegerAccessor (&FileDeliveryReceiver::m_port),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("MaxNakRanges", "Missing byte ranges listed in one NAK.",
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&FileDeliveryReceiver::m_maxNakRanges),
+                   MakeUintegerChecker<uint32_t> (1, 0xffff))
+    .AddTraceSource ("Rx", "A new data segment was received.",
+                     MakeTraceSourceAccessor (&FileDeliveryReceiver::m_rxTrace),
+                     "ns3::Packet::AddressTracedCallback")
+    .AddTraceSource ("Complete", "Every segment of a file was received.",
+                     MakeTraceSourceAccessor (&FileDeliveryReceiver::m_completeTrace),
+                     "ns3::FileDeliveryReceiver::CompleteCallback")
+  ;
+  return tid;
+}
+
+FileDeliveryReceiver::FileDeliveryReceiver ()
+  : m_port (9200),
+    m_maxNakRanges (64),
+    m_bytes (0),
+    m_completed (0),
+    m_duplicates (0),
+    m_naks (0),
+    m_malformed (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FileDeliveryReceiver::~FileDeliveryReceiver ()
+{
+}
+
+void
+FileDeliveryReceiver::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_transactions.clear ();
+  Application::DoDispose ();
+}
+
+uint64_t
+FileDeliveryReceiver::GetReceivedBytes (void) const
+{
+  return m_bytes;
+}
+
+uint32_t
+FileDeliveryReceiver::GetNCompleted (void) const
+{
+  return m_completed;
+}
+
+uint64_t
+FileDeliveryReceiver::GetDuplicateSegments (void) const
+{
+  return m_duplicates;
+}
+
+uint64_t
+FileDeliveryReceiver::GetNaks (void) const
+{
+  return m_naks;
+}
+
+uint64_t
+FileDeliveryReceiver::GetMalformed (void) const
+{
+  return m_malformed;
+}
+
+void
+FileDeliveryReceiver::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_socket = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId ());
+  m_socket->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_port));
+  m_socket->SetRecvCallback (MakeCallback (&FileDeliveryReceiver::Receive, this));
+}
+
+void
+FileDeliveryReceiver::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_socket != 0)
+    {
+      m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+      m_socket->Close ();
+      m_socket = 0;
+    }
+}
+
+void
+FileDeliveryReceiver::Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  Address from;
+  while ((packet = socket->RecvFrom (from)))
+    {
+      FileDeliveryHeader header;
+      if (packet->GetSize () < header.GetSerializedSize ())
+        {
+          m_malformed++;
+          continue;
+        }
+      packet->RemoveHeader (header);
+      if (header.GetType () != FileDeliveryHeader::DATA
+          && header.GetType () != FileDeliveryHeader::END_OF_FILE)
+        {
+          continue;
+        }
+      if (header.GetSegmentSize () == 0)
+        {
+          m_malformed++;
+          continue;
+        }
+      Key key (from, header.GetTransaction ());
+      std::map<Key, Transaction>::iterator it = m_transactions.find (key);
+      if (it == m_transactions.end ())
+        {
+          NS_LOG_LOGIC ("New transaction " << header.GetTransaction () << " from " << from
+                        << ", " << header.GetFileSize () << " bytes");
+          Transaction &t = m_transactions[key];
+          t.fileSize = header.GetFileSize ();
+          t.segmentSize = header.GetSegmentSize ();
+          t.received.Reset ((t.fileSize + t.segmentSize - 1) / t.segmentSize, false);
+          t.finished = false;
+          t.first = Simulator::Now ();
+          it = m_transactions.find (key);
+        }
+      Transaction &t = it->second;
+      if (header.GetFileSize () != t.fileSize || header.GetSegmentSize () != t.segmentSize)
+        {
+          NS_LOG_LOGIC ("Transaction " << header.GetTransaction () << " PDU does not match its sizes");
+          m_malformed++;
+          continue;
+        }
+      if (header.GetType () == FileDeliveryHeader::DATA)
+        {
+          uint64_t segment = header.GetOffset () / t.segmentSize;
+          if (header.GetOffset () % t.segmentSize != 0)
+            {
+              NS_LOG_LOGIC ("Transaction " << header.GetTransaction () << " data not on a segment boundary");
+              m_malformed++;
+              continue;
+            }
+          if (!t.finished && segment >= t.received.GetSize ())
+            {
+              NS_LOG_LOGIC ("Transaction " << header.GetTransaction () << " data beyond the end of the file");
+              m_malformed++;
+              continue;
+            }
+          if (t.finished || !t.received.Set (segment))
+            {
+              m_duplicates++;
+              continue;
+            }
+          m_bytes += packet->GetSize ();
+          m_rxTrace (packet, from);
+          if (t.received.GetCount () < t.received.GetSize ())
+            {
+              continue;
+            }
+        }
+      if (!t.finished && t.received.GetCount () == t.received.GetSize ())
+        {
+          NS_LOG_INFO ("Transaction " << header.GetTransaction () << " complete, "
+                       << t.fileSize << " bytes");
+          t.finished = true;
+          t.received.Reset (0, false);
+          m_completed++;
+          m_completeTrace (header.GetTransaction (), t.fileSize, Simulator::Now () - t.first);
+        }
+      Reply (key, t);
+    }
+}
+
+void
+FileDeliveryReceiver::Reply (const Key &key, const Transaction &t)
+{
+  FileDeliveryHeader header;
+  header.SetTransaction (key.second);
+  header.SetFileSize (t.fileSize);
+  header.SetSegmentSize (t.segmentSize);
+  if (t.finished)
+    {
+      header.SetType (FileDeliveryHeader::FINISHED);
+    }
+  else
+    {
+      header.SetType (FileDeliveryHeader::NAK);
+      uint64_t begin = t.received.FindNextClear (0);
+      while (begin < t.received.GetSize () && header.GetNRanges () < m_maxNakRanges)
+        {
+          uint64_t end = t.received.FindNextSet (begin);
+          header.AddRange (begin * t.segmentSize, std::min (end * t.segmentSize, t.fileSize));
+          begin = t.received.FindNextClear (end);
+        }
+      m_naks++;
+      NS_LOG_LOGIC ("NAK for transaction " << key.second << " with "
+                    << header.GetNRanges () << " ranges");
+    }
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (header);
+  m_socket->SendTo (packet, 0, key.first);
+}
+
+} // namespace ns3
@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FILE_DELIVERY_RECEIVER_H
+#define FILE_DELIVERY_RECEIVER_H
+
+#include <map>
+#include <utility>
+
+#include "ns3/application.h"
+#include "ns3/address.h"
+#include "ns3/nstime.h"
+#include "ns3/socket.h"
+#include "ns3/traced-callback.h"
+#include "segment-bitmap.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Receiving side of the file delivery protocol of FileDeliverySender.
+ *
+ * Keeps a bitmap of the segments received per transaction. Missing
+ * data is reported only when an END_OF_FILE arrives, as a NAK listing
+ * up to MaxNakRanges missing byte ranges (deferred NAK mode), so the
+ * link back stays quiet while data flows. A complete file is answered
+ * with a FINISHED PDU, also on every later EOF in case it got lost.
+ * The bitmap of a finished transaction is released but the
+ * transaction is remembered, so late duplicates are recognised.
+ * PDUs that are too short, have no segment size, or do not match the
+ * file and segment size their transaction started with, and data off
+ * a segment boundary or beyond the end of the file, are dropped and
+ * counted.
+ */
+class FileDeliveryReceiver : public Application
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  FileDeliveryReceiver ();
+  virtual ~FileDeliveryReceiver ();
+
+  /**
+   * TracedCallback signature for completed files.
+   * \param transaction the transaction id
+   * \param bytes the file size
+   * \param duration the time from the first PDU of the transaction
+   */
+  typedef void (* CompleteCallback) (uint32_t transaction, uint64_t bytes, Time duration);
+
+  /// \return the number of new file data bytes received
+  uint64_t GetReceivedBytes (void) const;
+
+  /// \return the number of files completed
+  uint32_t GetNCompleted (void) const;
+
+  /// \return the number of data segments received twice
+  uint64_t GetDuplicateSegments (void) const;
+
+  /// \return the number of NAKs sent
+  uint64_t GetNaks (void) const;
+
+  /// \return the number of malformed PDUs dropped
+  uint64_t GetMalformed (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /// State of a transaction
+  struct Transaction
+  {
+    uint64_t fileSize;       //!< File size in bytes
+    uint32_t segmentSize;    //!< Segment size in bytes
+    SegmentBitmap received;  //!< Segments received
+    bool finished;           //!< Whether every segment arrived
+    Time first;              //!< Time of the first PDU
+  };
+
+  /// Transactions are identified by their sender and id
+  typedef std::pair<Address, uint32_t> Key;
+
+  /// Socket receive callback
+  void Receive (Ptr<Socket> socket);
+  /**
+   * \brief Send a FINISHED or NAK to the sender
+   * \param key the transaction
+   * \param t its state
+   */
+  void Reply (const Key &key, const Transaction &t);
+
+  uint16_t m_port;                            //!< Listening port
+  uint32_t m_maxNakRanges;                    //!< Missing ranges per NAK
+  Ptr<Socket> m_socket;                       //!< UDP socket
+  std::map<Key, Transaction> m_transactions;  //!< Transactions by sender and id
+  uint64_t m_bytes;                           //!< New data bytes received
+  uint32_t m_completed;                       //!< Files completed
+  uint64_t m_duplicates;                      //!< Segments received twice
+  uint64_t m_naks;                            //!< NAKs sent
+  uint64_t m_malformed;                       //!< Malformed PDUs dropped
+  TracedCallback<Ptr<const Packet>, const Address &> m_rxTrace; //!< New data segments
+  TracedCallback<uint32_t, uint64_t, Time> m_completeTrace;     //!< Completed files
+};
+
+} // namespace ns3
+
+#endif /* FILE_DELIVERY_RECEIVER_H */
@@ -0,0 +1,355 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+
+#include "file-delivery-sender.h"
+#include "file-delivery-header.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FileDeliverySender");
+
+NS_OBJECT_ENSURE_REGISTERED (FileDeliverySender);
+
+TypeId
+FileDeliverySender::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FileDeliverySender")
+    .SetParent<Application> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<FileDeliverySender> ()
+    .AddAttribute ("Remote", "The address and port of the receiver.",
+                   AddressValue (),
+                   MakeAddressAccessor (&FileDeliverySender::m_remote),
+                   MakeAddressChecker ())
+    .AddAttribute ("SegmentSize", "File data bytes per packet.",
+                   UintegerValue (1400),
+                   MakeUintegerAccessor (&FileDeliverySender::m_segmentSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("DataRate", "Pacing rate of the data when no downlink device is set.",
+                   DataRateValue (DataRate ("10Mbps")),
+                   MakeDataRateAccessor (&FileDeliverySender::m_rate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("EofTimeout", "Time after which an unanswered END_OF_FILE is sent again, "
+                   "longer than the round trip time.",
+                   TimeValue (Seconds (5)),
+                   MakeTimeAccessor (&FileDeliverySender::m_eofTimeout),
+                   MakeTimeChecker ())
+    .AddAttribute ("QueueTarget", "Packets kept in the downlink device, queued or in transmission.",
+                   UintegerValue (2),
+                   MakeUintegerAccessor (&FileDeliverySender::m_queueTarget),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddTraceSource ("Tx", "A PDU was sent.",
+                     MakeTraceSourceAccessor (&FileDeliverySender::m_txTrace),
+                     "ns3::Packet::TracedCallback")
+    .AddTraceSource ("Complete", "The receiver finished a transaction.",
+                     MakeTraceSourceAccessor (&FileDeliverySender::m_completeTrace),
+                     "ns3::FileDeliverySender::CompleteCallback")
+  ;
+  return tid;
+}
+
+FileDeliverySender::FileDeliverySender ()
+  : m_segmentSize (1400),
+    m_queueTarget (2),
+    m_nextId (1),
+    m_sent (0),
+    m_retransmitted (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FileDeliverySender::~FileDeliverySender ()
+{
+}
+
+void
+FileDeliverySender::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_device = 0;
+  m_feeder = 0;
+  m_transactions.clear ();
+  Application::DoDispose ();
+}
+
+uint32_t
+FileDeliverySender::AddFile (uint64_t bytes)
+{
+  uint32_t id = m_nextId++;
+  NS_LOG_FUNCTION (this << id << bytes);
+  Transaction &t = m_transactions[id];
+  t.fileSize = bytes;
+  t.pending.Reset ((bytes + m_segmentSize - 1) / m_segmentSize, true);
+  t.cursor = 0;
+  t.waiting = false;
+  t.added = Simulator::Now ();
+  if (m_socket != 0)
+    {
+      if (t.pending.GetCount () == 0)
+        {
+          SendEof (id);
+        }
+      Kick ();
+    }
+  return id;
+}
+
+void
+FileDeliverySender::SetDownlink (Ptr<NetDevice> device)
+{
+  m_device = device;
+}
+
+uint32_t
+FileDeliverySender::GetNPending (void) const
+{
+  return m_transactions.size ();
+}
+
+uint64_t
+FileDeliverySender::GetPendingBytes (void) const
+{
+  uint64_t bytes = 0;
+  for (std::map<uint32_t, Transaction>::const_iterator it = m_transactions.begin (); it != m_transactions.end (); ++it)
+    {
+      bytes += it->second.fileSize;
+    }
+  return bytes;
+}
+
+uint64_t
+FileDeliverySender::GetSentSegments (void) const
+{
+  return m_sent;
+}
+
+uint64_t
+FileDeliverySender::GetRetransmittedSegments (void) const
+{
+  return m_retransmitted;
+}
+
+void
+FileDeliverySender::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_socket = Socket::CreateSocket (GetNode (), UdpSocketFactory::GetTypeId ());
+  m_socket->Bind ();
+  m_socket->Connect (m_remote);
+  m_socket->SetRecvCallback (MakeCallback (&FileDeliverySender::Receive, this));
+  if (m_device != 0)
+    {
+      m_feeder = CreateObject<DeviceQueueFeeder> ();
+      m_feeder->Setup (m_device, m_queueTarget, MakeCallback (&FileDeliverySender::SendNext, this));
+      m_feeder->SetLinkCallback (MakeCallback (&FileDeliverySender::LinkChanged, this));
+    }
+  for (std::map<uint32_t, Transaction>::iterator it = m_transactions.begin (); it != m_transactions.end (); ++it)
+    {
+      if (it->second.pending.GetCount () == 0)
+        {
+          SendEof (it->first);
+        }
+    }
+  Kick ();
+}
+
+void
+FileDeliverySender::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sendEvent.Cancel ();
+  for (std::map<uint32_t, Transaction>::iterator it = m_transactions.begin (); it != m_transactions.end (); ++it)
+    {
+      it->second.eofTimer.Cancel ();
+    }
+  if (m_socket != 0)
+    {
+      m_socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+      m_socket->Close ();
+      m_socket = 0;
+    }
+}
+
+bool
+FileDeliverySender::SendNext (void)
+{
+  if (m_socket == 0)
+    {
+      return false;
+    }
+  for (std::map<uint32_t, Transaction>::iterator it = m_transactions.begin (); it != m_transactions.end (); ++it)
+    {
+      Transaction &t = it->second;
+      if (t.pending.GetCount () == 0)
+        {
+          continue;
+        }
+      uint64_t segment = t.pending.FindNextSet (t.cursor);
+      t.pending.Clear (segment);
+      t.cursor = segment + 1;
+      uint64_t offset = segment * m_segmentSize;
+      Ptr<Packet> packet = Create<Packet> (std::min<uint64_t> (m_segmentSize, t.fileSize - offset));
+      FileDeliveryHeader header;
+      header.SetType (FileDeliveryHeader::DATA);
+      header.SetTransaction (it->first);
+      header.SetFileSize (t.fileSize);
+      header.SetSegmentSize (m_segmentSize);
+      header.SetOffset (offset);
+      packet->AddHeader (header);
+      m_txTrace (packet);
+      m_socket->Send (packet);
+      m_sent++;
+      if (t.pending.GetCount () == 0)
+        {
+          SendEof (it->first);
+        }
+      return true;
+    }
+  return false;
+}
+
+void
+FileDeliverySender::Kick (void)
+{
+  if (m_socket == 0)
+    {
+      return;
+    }
+  if (m_feeder != 0)
+    {
+      m_feeder->Feed ();
+    }
+  else if (!m_sendEvent.IsRunning ())
+    {
+      m_sendEvent = Simulator::ScheduleNow (&FileDeliverySender::Transmit, this);
+    }
+}
+
+void
+FileDeliverySender::Transmit (void)
+{
+  if (SendNext ())
+    {
+      // Account for the PDU, UDP and IPv4 headers
+      m_sendEvent = Simulator::Schedule (m_rate.CalculateBytesTxTime (m_segmentSize + 25 + 28),
+                                         &FileDeliverySender::Transmit, this);
+    }
+}
+
+void
+FileDeliverySender::SendEof (uint32_t id)
+{
+  std::map<uint32_t, Transaction>::iterator it = m_transactions.find (id);
+  if (it == m_transactions.end ())
+    {
+      return;
+    }
+  Transaction &t = it->second;
+  t.waiting = true;
+  t.eofTimer.Cancel ();
+  if ((m_feeder != 0 && !m_feeder->IsUp ()) || m_socket == 0)
+    {
+      // Sent again when the link comes back
+      return;
+    }
+  NS_LOG_LOGIC ("EOF of transaction " << id);
+  FileDeliveryHeader header;
+  header.SetType (FileDeliveryHeader::END_OF_FILE);
+  header.SetTransaction (id);
+  header.SetFileSize (t.fileSize);
+  header.SetSegmentSize (m_segmentSize);
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (header);
+  m_txTrace (packet);
+  m_socket->Send (packet);
+  t.eofTimer = Simulator::Schedule (m_eofTimeout, &FileDeliverySender::SendEof, this, id);
+}
+
+void
+FileDeliverySender::Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      FileDeliveryHeader header;
+      packet->RemoveHeader (header);
+      std::map<uint32_t, Transaction>::iterator it = m_transactions.find (header.GetTransaction ());
+      if (it == m_transactions.end ())
+        {
+          continue;
+        }
+      Transaction &t = it->second;
+      if (header.GetType () == FileDeliveryHeader::NAK)
+        {
+          // Further NAKs answer EOFs sent before this one, drop them
+          if (!t.waiting)
+            {
+              continue;
+            }
+          t.waiting = false;
+          t.eofTimer.Cancel ();
+          for (uint32_t i = 0; i < header.GetNRanges (); ++i)
+            {
+              std::pair<uint64_t, uint64_t> range = header.GetRange (i);
+              uint64_t begin = range.first / m_segmentSize;
+              uint64_t end = (range.second + m_segmentSize - 1) / m_segmentSize;
+              m_retransmitted += t.pending.SetRange (begin, end);
+              t.cursor = std::min (t.cursor, begin);
+            }
+          NS_LOG_LOGIC ("NAK for transaction " << it->first << ", "
+                        << t.pending.GetCount () << " segments to resend");
+          if (t.pending.GetCount () == 0)
+            {
+              SendEof (it->first);
+            }
+          Kick ();
+        }
+      else if (header.GetType () == FileDeliveryHeader::FINISHED)
+        {
+          NS_LOG_INFO ("Transaction " << it->first << " finished, " << t.fileSize << " bytes");
+          t.eofTimer.Cancel ();
+          Time latency = Simulator::Now () - t.added;
+          uint64_t bytes = t.fileSize;
+          uint32_t id = it->first;
+          m_transactions.erase (it);
+          m_completeTrace (id, bytes, latency);
+        }
+    }
+}
+
+void
+FileDeliverySender::LinkChanged (bool up)
+{
+  NS_LOG_FUNCTION (this << up);
+  if (up)
+    {
+      for (std::map<uint32_t, Transaction>::iterator it = m_transactions.begin (); it != m_transactions.end (); ++it)
+        {
+          if (it->second.waiting)
+            {
+              SendEof (it->first);
+            }
+        }
+    }
+}
+
+} // namespace ns3
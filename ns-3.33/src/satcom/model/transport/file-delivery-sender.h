@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FILE_DELIVERY_SENDER_H
+#define FILE_DELIVERY_SENDER_H
+
+#include <map>
+
+#include "ns3/application.h"
+#include "ns3/address.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/socket.h"
+#include "ns3/traced-callback.h"
+#include "ns3/device-queue-feeder.h"
+#include "segment-bitmap.h"
+
+namespace ns3 {
+
+class NetDevice;
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Sending side of a NAK-based file delivery protocol over UDP.
+ *
+ * A CFDP class 2 style sender for large products over long-delay,
+ * intermittent links. Each file added with AddFile () becomes a
+ * transaction; transactions are served oldest first. Every segment is
+ * sent once, then an END_OF_FILE PDU asks the FileDeliveryReceiver for
+ * the ranges it misses, which come back in a NAK and are sent again.
+ * A FINISHED PDU ends the transaction. Only a bitmap of the segments
+ * still to send is kept, so multi-GB files cost little memory and no
+ * acknowledgement traffic flows while the data does.
+ *
+ * With a downlink device set, a DeviceQueueFeeder keeps the device fed
+ * so that the link runs at line rate, and over an
+ * OrbitPointToPointChannel the sender follows the LinkState and Outage
+ * traces: nothing is sent and no EOF timer runs while the link is down
+ * or in outage, and transactions waiting for a reply send their EOF
+ * again when it comes back, so delivery resumes where it stopped in the
+ * next contact. Without a device, data is paced at DataRate.
+ *
+ * Packets are created with the zero-filled virtual payload of Packet.
+ */
+class FileDeliverySender : public Application
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  FileDeliverySender ();
+  virtual ~FileDeliverySender ();
+
+  /**
+   * TracedCallback signature for completed transactions.
+   * \param transaction the transaction id
+   * \param bytes the file size
+   * \param latency the time from AddFile () to the FINISHED PDU
+   */
+  typedef void (* CompleteCallback) (uint32_t transaction, uint64_t bytes, Time latency);
+
+  /**
+   * \brief Queue a file for delivery
+   * \param bytes the size of the file
+   * \return the transaction id
+   */
+  uint32_t AddFile (uint64_t bytes);
+
+  /// \param device the device of the link to keep busy, or 0 to pace at DataRate
+  void SetDownlink (Ptr<NetDevice> device);
+
+  /// \return the number of transactions not finished yet
+  uint32_t GetNPending (void) const;
+
+  /// \return the number of bytes of the unfinished transactions
+  uint64_t GetPendingBytes (void) const;
+
+  /// \return the number of data segments sent, retransmissions included
+  uint64_t GetSentSegments (void) const;
+
+  /// \return the number of segments sent again after a NAK
+  uint64_t GetRetransmittedSegments (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /// State of a transaction
+  struct Transaction
+  {
+    uint64_t fileSize;      //!< File size in bytes
+    SegmentBitmap pending;  //!< Segments still to send
+    uint64_t cursor;        //!< No pending segment before this one
+    bool waiting;           //!< EOF sent, waiting for a NAK or FINISHED
+    Time added;             //!< Time of AddFile ()
+    EventId eofTimer;       //!< EOF retransmission
+  };
+
+  /**
+   * \brief Send the next data segment, oldest transaction first
+   * \return false if no segment is pending
+   */
+  bool SendNext (void);
+  /// Send data if the link is idle
+  void Kick (void);
+  /// Send the next paced segment
+  void Transmit (void);
+  /**
+   * \brief Send the EOF of a transaction and arm its timer
+   * \param id the transaction id
+   */
+  void SendEof (uint32_t id);
+  /// Socket receive callback
+  void Receive (Ptr<Socket> socket);
+  /**
+   * \brief Send the EOFs that wait for a reply again when the link comes back
+   * \param up whether the link is up
+   */
+  void LinkChanged (bool up);
+
+  Address m_remote;                              //!< Receiver
+  uint32_t m_segmentSize;                        //!< Data bytes per segment
+  DataRate m_rate;                               //!< Pacing rate without a device
+  Time m_eofTimeout;                             //!< EOF retransmission interval
+  uint32_t m_queueTarget;                        //!< Packets kept in the device
+  Ptr<NetDevice> m_device;                       //!< Downlink device
+  Ptr<DeviceQueueFeeder> m_feeder;               //!< Keeps the downlink device busy
+  Ptr<Socket> m_socket;                          //!< UDP socket
+  std::map<uint32_t, Transaction> m_transactions; //!< Unfinished transactions by id
+  uint32_t m_nextId;                             //!< Id of the next transaction
+  uint64_t m_sent;                               //!< Data segments sent
+  uint64_t m_retransmitted;                      //!< Segments sent again after a NAK
+  EventId m_sendEvent;                           //!< Next paced segment
+  TracedCallback<Ptr<const Packet> > m_txTrace;  //!< Sent PDUs
+  TracedCallback<uint32_t, uint64_t, Time> m_completeTrace; //!< Finished transactions
+};
+
+} // namespace ns3
+
+#endif /* FILE_DELIVERY_SENDER_H */
@@ -0,0 +1,334 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+
+#include "pep-application.h"
+#include "pep-tcp-socket.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PepApplication");
+
+NS_OBJECT_ENSURE_REGISTERED (PepApplication);
+
+TypeId
+PepApplication::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PepApplication")
+    .SetParent<Application> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<PepApplication> ()
+    .AddAttribute ("Port", "Port the proxy accepts connections on.",
+                   UintegerValue (5001),
+                   MakeUintegerAccessor (&PepApplication::m_port),
+                   MakeUintegerChecker<uint16_t> ())
+    .AddAttribute ("Remote", "Address and port of the peer proxy or of the server.",
+                   AddressValue (),
+                   MakeAddressAccessor (&PepApplication::m_remote),
+                   MakeAddressChecker ())
+    .AddAttribute ("SpaceLeg", "Legs of a proxied connection that cross the space segment.",
+                   EnumValue (PepApplication::CONNECTED),
+                   MakeEnumAccessor (&PepApplication::m_spaceLeg),
+                   MakeEnumChecker (PepApplication::NONE, "None",
+                                    PepApplication::ACCEPTED, "Accepted",
+                                    PepApplication::CONNECTED, "Connected",
+                                    PepApplication::BOTH, "Both"))
+    .AddAttribute ("SpaceCongestionControl",
+                   "Congestion control of the space legs, with its attributes, "
+                   "e.g. ns3::TcpFixedRate[Rate=100Mbps].",
+                   StringValue ("ns3::TcpHybla"),
+                   MakeObjectFactoryAccessor (&PepApplication::m_spaceCongestion),
+                   MakeObjectFactoryChecker ())
+    .AddAttribute ("SpaceBufferSize", "Send and receive buffer size of the space legs.",
+                   UintegerValue (16 << 20),
+                   MakeUintegerAccessor (&PepApplication::m_spaceBufferSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("SpaceInitialCwnd", "Initial window of the space legs, in segments.",
+                   UintegerValue (10),
+                   MakeUintegerAccessor (&PepApplication::m_spaceInitialCwnd),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("SpacePacing", "Whether the space legs are paced.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&PepApplication::m_spacePacing),
+                   MakeBooleanChecker ())
+    .AddAttribute ("BufferSize", "Bytes the relay holds per direction before it stops reading.",
+                   UintegerValue (1 << 20),
+                   MakeUintegerAccessor (&PepApplication::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddTraceSource ("Relay", "A packet was handed from one leg to the other.",
+                     MakeTraceSourceAccessor (&PepApplication::m_relayTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+PepApplication::PepApplication ()
+  : m_port (5001),
+    m_spaceLeg (CONNECTED),
+    m_spaceBufferSize (16 << 20),
+    m_spaceInitialCwnd (10),
+    m_spacePacing (true),
+    m_bufferSize (1 << 20),
+    m_relayed (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PepApplication::~PepApplication ()
+{
+}
+
+void
+PepApplication::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_listener = 0;
+  m_legs.clear ();
+  Application::DoDispose ();
+}
+
+uint32_t
+PepApplication::GetNConnections (void) const
+{
+  return m_legs.size () / 2;
+}
+
+uint64_t
+PepApplication::GetRelayedBytes (void) const
+{
+  return m_relayed;
+}
+
+void
+PepApplication::ConfigureSpace (Ptr<Socket> socket) const
+{
+  Ptr<TcpSocketBase> tcp = DynamicCast<TcpSocketBase> (socket);
+  tcp->SetAttribute ("SndBufSize", UintegerValue (m_spaceBufferSize));
+  tcp->SetAttribute ("RcvBufSize", UintegerValue (m_spaceBufferSize));
+  tcp->SetAttribute ("WindowScaling", BooleanValue (true));
+  tcp->SetAttribute ("InitialCwnd", UintegerValue (m_spaceInitialCwnd));
+  tcp->SetCongestionControlAlgorithm (m_spaceCongestion.Create<TcpCongestionOps> ());
+  tcp->SetPacingStatus (m_spacePacing);
+}
+
+void
+PepApplication::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_remote.IsInvalid (), "PepApplication needs a Remote");
+  m_listener = PepTcpSocket::CreateSocket (GetNode ());
+  // Accepted sockets are forks of the listener and inherit its transport
+  if (m_spaceLeg == ACCEPTED || m_spaceLeg == BOTH)
+    {
+      ConfigureSpace (m_listener);
+    }
+  if (m_listener->Bind (InetSocketAddress (Ipv4Address::GetAny (), m_port)) == -1)
+    {
+      NS_FATAL_ERROR ("PepApplication failed to bind port " << m_port);
+    }
+  m_listener->Listen ();
+  m_listener->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                                 MakeCallback (&PepApplication::HandleAccept, this));
+}
+
+void
+PepApplication::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_listener != 0)
+    {
+      m_listener->Close ();
+      m_listener = 0;
+    }
+  for (uint32_t i = 0; i < m_legs.size (); ++i)
+    {
+      CloseLeg (i);
+    }
+}
+
+void
+PepApplication::HandleAccept (Ptr<Socket> socket, const Address &from)
+{
+  NS_LOG_FUNCTION (this << socket << from);
+  uint32_t accepted = m_legs.size ();
+  Leg leg;
+  leg.pendingBytes = 0;
+  leg.segmentSize = 0;
+  leg.ready = true;
+  leg.eof = false;
+  leg.closed = false;
+  leg.socket = socket;
+  m_legs.push_back (leg);
+  leg.ready = false;
+  leg.socket = PepTcpSocket::CreateSocket (GetNode ());
+  if (m_spaceLeg == CONNECTED || m_spaceLeg == BOTH)
+    {
+      ConfigureSpace (leg.socket);
+    }
+  m_legs.push_back (leg);
+
+  for (uint32_t i = accepted; i < accepted + 2; ++i)
+    {
+      Ptr<Socket> s = m_legs[i].socket;
+      UintegerValue segmentSize;
+      s->GetAttribute ("SegmentSize", segmentSize);
+      m_legs[i].segmentSize = segmentSize.Get ();
+      s->SetRecvCallback (MakeCallback (&PepApplication::Receive, this).Bind (i));
+      s->SetSendCallback (MakeCallback (&PepApplication::Sent, this).Bind (i));
+      s->SetCloseCallbacks (MakeCallback (&PepApplication::PeerClosed, this).Bind (i),
+                            MakeCallback (&PepApplication::Aborted, this).Bind (i));
+    }
+  Ptr<Socket> connected = m_legs[accepted + 1].socket;
+  connected->SetConnectCallback (MakeCallback (&PepApplication::ConnectionSucceeded, this).Bind (accepted + 1),
+                                 MakeCallback (&PepApplication::ConnectionFailed, this).Bind (accepted + 1));
+  connected->Bind ();
+  connected->Connect (m_remote);
+  NS_LOG_INFO ("Connection " << accepted / 2 << " from " << InetSocketAddress::ConvertFrom (from).GetIpv4 ());
+}
+
+void
+PepApplication::ConnectionSucceeded (uint32_t leg, Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << leg);
+  m_legs[leg].ready = true;
+  // Data accepted before the connection came up is waiting
+  Pull (leg ^ 1);
+}
+
+void
+PepApplication::ConnectionFailed (uint32_t leg, Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << leg);
+  m_legs[leg].closed = true;
+  CloseLeg (leg ^ 1);
+}
+
+void
+PepApplication::Receive (uint32_t leg, Ptr<Socket> socket)
+{
+  Pull (leg);
+}
+
+void
+PepApplication::Sent (uint32_t leg, Ptr<Socket> socket, uint32_t available)
+{
+  // Room on this leg, which may let the peer leg be read again
+  Pull (leg ^ 1);
+}
+
+void
+PepApplication::PeerClosed (uint32_t leg, Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << leg);
+  m_legs[leg].eof = true;
+  Pull (leg);
+}
+
+void
+PepApplication::Aborted (uint32_t leg, Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << leg);
+  m_legs[leg].closed = true;
+  CloseLeg (leg ^ 1);
+}
+
+void
+PepApplication::Pull (uint32_t leg)
+{
+  Leg &from = m_legs[leg];
+  Leg &to = m_legs[leg ^ 1];
+  while (!from.closed && to.pendingBytes < m_bufferSize)
+    {
+      // One segment at a time, so that the transmit buffer never splits a packet
+      Ptr<Packet> packet = from.socket->Recv (std::min (m_bufferSize - to.pendingBytes, to.segmentSize), 0);
+      if (packet == 0 || packet->GetSize () == 0)
+        {
+          break;
+        }
+      to.pending.push_back (packet);
+      to.pendingBytes += packet->GetSize ();
+    }
+  Push (leg ^ 1);
+}
+
+void
+PepApplication::Push (uint32_t leg)
+{
+  Leg &to = m_legs[leg];
+  if (!to.ready || to.closed)
+    {
+      return;
+    }
+  while (!to.pending.empty ())
+    {
+      uint32_t available = to.socket->GetTxAvailable ();
+      if (available == 0)
+        {
+          break;
+        }
+      Ptr<Packet> packet = to.pending.front ();
+      if (packet->GetSize () > available)
+        {
+          // The fragment shares the buffer of the packet
+          Ptr<Packet> fragment = packet->CreateFragment (0, available);
+          packet->RemoveAtStart (available);
+          packet = fragment;
+        }
+      else
+        {
+          to.pending.pop_front ();
+        }
+      if (to.socket->Send (packet, 0) < 0)
+        {
+          NS_LOG_WARN ("Leg " << leg << " refused " << packet->GetSize () << " bytes");
+          to.pending.push_front (packet);
+          break;
+        }
+      to.pendingBytes -= packet->GetSize ();
+      m_relayed += packet->GetSize ();
+      m_relayTrace (packet);
+    }
+  const Leg &from = m_legs[leg ^ 1];
+  if (to.pending.empty () && from.eof && (from.closed || from.socket->GetRxAvailable () == 0))
+    {
+      CloseLeg (leg);
+    }
+}
+
+void
+PepApplication::CloseLeg (uint32_t leg)
+{
+  Leg &l = m_legs[leg];
+  if (l.closed)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << leg);
+  l.closed = true;
+  l.socket->Close ();
+}
+
+} // namespace ns3
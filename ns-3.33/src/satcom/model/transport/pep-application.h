@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PEP_APPLICATION_H
+#define PEP_APPLICATION_H
+
+#include <deque>
+#include <vector>
+
+#include "ns3/application.h"
+#include "ns3/address.h"
+#include "ns3/object-factory.h"
+#include "ns3/socket.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Split-TCP performance-enhancing proxy.
+ *
+ * The proxy accepts TCP connections on Port and opens, for each, a
+ * connection to Remote: the peer proxy across the space segment, or
+ * the server. Each end-to-end connection is thus split in legs that
+ * run their own control loops, and the long RTT of the space segment
+ * no longer throttles the terrestrial legs. The legs named by SpaceLeg
+ * cross the space segment and get the space transport: the
+ * SpaceCongestionControl algorithm (a large-window algorithm such as
+ * TcpHybla, or the rate-based TcpFixedRate), SpaceBufferSize socket
+ * buffers with window scaling, SpaceInitialCwnd and pacing.
+ *
+ * The relay is zero-copy: the packets read from one socket, a segment
+ * of the other at a time, are queued and handed as they are to the
+ * other, splitting a packet with Packet::CreateFragment () when the
+ * transmit buffer has less room, so payload buffers are shared and
+ * never copied. At most BufferSize
+ * bytes wait per direction; beyond that the proxy stops reading and
+ * the receive window of the sending leg closes, so backpressure
+ * propagates end to end; the PepTcpSocket legs announce the window
+ * again as soon as the relay drains. A close is relayed once the data
+ * before it left the proxy.
+ */
+class PepApplication : public Application
+{
+public:
+  /// Legs of a proxied connection that cross the space segment
+  enum SpaceLeg
+  {
+    NONE,       //!< Both legs are terrestrial
+    ACCEPTED,   //!< The accepted connections
+    CONNECTED,  //!< The connections to Remote
+    BOTH        //!< Both legs
+  };
+
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  PepApplication ();
+  virtual ~PepApplication ();
+
+  /// \return the number of connections accepted so far
+  uint32_t GetNConnections (void) const;
+
+  /// \return the bytes relayed so far, in both directions
+  uint64_t GetRelayedBytes (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /**
+   * One side of a proxied connection. Legs come in pairs, leg 2 i is
+   * the accepted socket of connection i and leg 2 i + 1 the one to
+   * Remote, so the peer of leg l is leg l ^ 1.
+   */
+  struct Leg
+  {
+    Ptr<Socket> socket;                //!< TCP socket
+    std::deque<Ptr<Packet> > pending;  //!< Data waiting to be sent on this leg
+    uint32_t pendingBytes;             //!< Bytes in pending
+    uint32_t segmentSize;              //!< Segment size of the socket
+    bool ready;                        //!< Whether the socket is connected
+    bool eof;                          //!< Whether the peer closed its sending side
+    bool closed;                       //!< Whether Close () was called
+  };
+
+  /**
+   * \brief Apply the space transport to a socket
+   * \param socket a socket not connected yet
+   */
+  void ConfigureSpace (Ptr<Socket> socket) const;
+
+  /**
+   * \brief Accept callback of the listening socket
+   * \param socket the accepted socket
+   * \param from the client address
+   */
+  void HandleAccept (Ptr<Socket> socket, const Address &from);
+
+  /// \param leg the leg whose connection succeeded
+  void ConnectionSucceeded (uint32_t leg, Ptr<Socket> socket);
+  /// \param leg the leg whose connection failed
+  void ConnectionFailed (uint32_t leg, Ptr<Socket> socket);
+  /// \param leg the leg with data to read
+  void Receive (uint32_t leg, Ptr<Socket> socket);
+  /// \param leg the leg with room in its transmit buffer
+  void Sent (uint32_t leg, Ptr<Socket> socket, uint32_t available);
+  /// \param leg the leg whose peer closed its sending side
+  void PeerClosed (uint32_t leg, Ptr<Socket> socket);
+  /// \param leg the leg that was reset
+  void Aborted (uint32_t leg, Ptr<Socket> socket);
+
+  /**
+   * \brief Read a leg into the queue of its peer, then flush that queue
+   * \param leg the leg to read from
+   */
+  void Pull (uint32_t leg);
+
+  /**
+   * \brief Hand the queue of a leg to its socket, as far as it has room
+   * \param leg the leg to write to
+   */
+  void Push (uint32_t leg);
+
+  /**
+   * \brief Close a leg, once
+   * \param leg the leg
+   */
+  void CloseLeg (uint32_t leg);
+
+  uint16_t m_port;                   //!< Listening port
+  Address m_remote;                  //!< Peer proxy or server
+  SpaceLeg m_spaceLeg;               //!< Legs that cross the space segment
+  ObjectFactory m_spaceCongestion;   //!< Congestion control of the space legs
+  uint32_t m_spaceBufferSize;        //!< Socket buffers of the space legs
+  uint32_t m_spaceInitialCwnd;       //!< Initial window of the space legs, in segments
+  bool m_spacePacing;                //!< Whether the space legs are paced
+  uint32_t m_bufferSize;             //!< Relay buffer per direction
+  Ptr<Socket> m_listener;            //!< Listening socket
+  std::vector<Leg> m_legs;           //!< Legs of the proxied connections
+  uint64_t m_relayed;                //!< Bytes relayed
+  TracedCallback<Ptr<const Packet> > m_relayTrace; //!< Relayed packets
+};
+
+} // namespace ns3
+
+#endif /* PEP_APPLICATION_H */
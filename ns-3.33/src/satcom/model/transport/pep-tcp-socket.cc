@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "pep-tcp-socket.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/tcp-recovery-ops.h"
+#include "ns3/rtt-estimator.h"
+#include "ns3/object-factory.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PepTcpSocket");
+
+NS_OBJECT_ENSURE_REGISTERED (PepTcpSocket);
+
+TypeId
+PepTcpSocket::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PepTcpSocket")
+    .SetParent<TcpSocketBase> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<PepTcpSocket> ()
+  ;
+  return tid;
+}
+
+PepTcpSocket::PepTcpSocket ()
+  : TcpSocketBase ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PepTcpSocket::PepTcpSocket (const PepTcpSocket &sock)
+  : TcpSocketBase (sock)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PepTcpSocket::~PepTcpSocket ()
+{
+}
+
+Ptr<PepTcpSocket>
+PepTcpSocket::CreateSocket (Ptr<Node> node)
+{
+  Ptr<TcpL4Protocol> tcp = node->GetObject<TcpL4Protocol> ();
+  NS_ASSERT_MSG (tcp != 0, "node " << node->GetId () << " has no TCP stack");
+  TypeIdValue rtt;
+  TypeIdValue congestion;
+  TypeIdValue recovery;
+  tcp->GetAttribute ("RttEstimatorType", rtt);
+  tcp->GetAttribute ("SocketType", congestion);
+  tcp->GetAttribute ("RecoveryType", recovery);
+  ObjectFactory factory;
+
+  Ptr<PepTcpSocket> socket = CreateObject<PepTcpSocket> ();
+  socket->SetNode (node);
+  socket->SetTcp (tcp);
+  factory.SetTypeId (rtt.Get ());
+  socket->SetRtt (factory.Create<RttEstimator> ());
+  factory.SetTypeId (congestion.Get ());
+  socket->SetCongestionControlAlgorithm (factory.Create<TcpCongestionOps> ());
+  factory.SetTypeId (recovery.Get ());
+  socket->SetRecoveryAlgorithm (factory.Create<TcpRecoveryOps> ());
+  tcp->AddSocket (socket);
+  return socket;
+}
+
+Ptr<Packet>
+PepTcpSocket::Recv (uint32_t maxSize, uint32_t flags)
+{
+  uint32_t capacity = m_tcb->m_rxBuffer->MaxBufferSize ();
+  uint32_t before = m_tcb->m_rxBuffer->Size ();
+  Ptr<Packet> packet = TcpSocketBase::Recv (maxSize, flags);
+  uint32_t after = m_tcb->m_rxBuffer->Size ();
+  if ((m_state == ESTABLISHED || m_state == FIN_WAIT_1 || m_state == FIN_WAIT_2)
+      && capacity - before < capacity / 2 && capacity - after >= capacity / 2)
+    {
+      NS_LOG_LOGIC (this << " window update, " << capacity - after << " bytes free");
+      SendEmptyPacket (TcpHeader::ACK);
+    }
+  return packet;
+}
+
+Ptr<TcpSocketBase>
+PepTcpSocket::Fork (void)
+{
+  return CopyObject<PepTcpSocket> (this);
+}
+
+} // namespace ns3
@@ -0,0 +1,69 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PEP_TCP_SOCKET_H
+#define PEP_TCP_SOCKET_H
+
+#include "ns3/tcp-socket-base.h"
+
+namespace ns3 {
+
+class Node;
+
+/**
+ * \ingroup satcom
+ *
+ * \brief TCP socket of a PepApplication.
+ *
+ * TcpSocketBase only announces a window when it acknowledges data, so
+ * once a relay stops reading and the window closes, the peer waits for
+ * its persist timer before it sends again. This socket sends a window
+ * update when a read frees half of the receive buffer after less than
+ * half of it was free, so that a relay applying backpressure resumes
+ * within one RTT.
+ */
+class PepTcpSocket : public TcpSocketBase
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  PepTcpSocket ();
+  /**
+   * \param sock the socket to copy
+   */
+  PepTcpSocket (const PepTcpSocket &sock);
+  virtual ~PepTcpSocket ();
+
+  /**
+   * \brief Create a socket on the TCP stack of a node, with its default
+   *        RTT estimator, congestion control and recovery
+   * \param node a node with an internet stack
+   * \return the socket
+   */
+  static Ptr<PepTcpSocket> CreateSocket (Ptr<Node> node);
+
+  virtual Ptr<Packet> Recv (uint32_t maxSize, uint32_t flags);
+
+protected:
+  virtual Ptr<TcpSocketBase> Fork (void);
+};
+
+} // namespace ns3
+
+#endif /* PEP_TCP_SOCKET_H */
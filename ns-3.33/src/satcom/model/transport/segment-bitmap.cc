@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+
+#include "segment-bitmap.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+SegmentBitmap::SegmentBitmap ()
+  : m_size (0),
+    m_count (0)
+{
+}
+
+void
+SegmentBitmap::Reset (uint64_t size, bool value)
+{
+  m_size = size;
+  m_count = value ? size : 0;
+  m_words.assign ((size + 63) / 64, value ? ~uint64_t (0) : 0);
+  if (value && size % 64 != 0)
+    {
+      // Bits past the end stay clear so that the searches stop at the size
+      m_words.back () = (uint64_t (1) << (size % 64)) - 1;
+    }
+  std::vector<uint64_t> (m_words).swap (m_words);
+}
+
+uint64_t
+SegmentBitmap::GetSize (void) const
+{
+  return m_size;
+}
+
+uint64_t
+SegmentBitmap::GetCount (void) const
+{
+  return m_count;
+}
+
+bool
+SegmentBitmap::Test (uint64_t i) const
+{
+  NS_ASSERT (i < m_size);
+  return (m_words[i / 64] >> (i % 64)) & 1;
+}
+
+bool
+SegmentBitmap::Set (uint64_t i)
+{
+  NS_ASSERT (i < m_size);
+  uint64_t mask = uint64_t (1) << (i % 64);
+  if (m_words[i / 64] & mask)
+    {
+      return false;
+    }
+  m_words[i / 64] |= mask;
+  m_count++;
+  return true;
+}
+
+bool
+SegmentBitmap::Clear (uint64_t i)
+{
+  NS_ASSERT (i < m_size);
+  uint64_t mask = uint64_t (1) << (i % 64);
+  if (!(m_words[i / 64] & mask))
+    {
+      return false;
+    }
+  m_words[i / 64] &= ~mask;
+  m_count--;
+  return true;
+}
+
+uint64_t
+SegmentBitmap::SetRange (uint64_t begin, uint64_t end)
+{
+  end = std::min (end, m_size);
+  uint64_t before = m_count;
+  while (begin < end)
+    {
+      uint64_t word = begin / 64;
+      uint64_t last = std::min (end, (word + 1) * 64);
+      uint64_t bits = last - begin;
+      uint64_t mask = (bits == 64 ? ~uint64_t (0) : ((uint64_t (1) << bits) - 1)) << (begin % 64);
+      m_count += __builtin_popcountll (mask & ~m_words[word]);
+      m_words[word] |= mask;
+      begin = last;
+    }
+  return m_count - before;
+}
+
+uint64_t
+SegmentBitmap::FindNextSet (uint64_t from) const
+{
+  return FindNext (from, false);
+}
+
+uint64_t
+SegmentBitmap::FindNextClear (uint64_t from) const
+{
+  return FindNext (from, true);
+}
+
+uint64_t
+SegmentBitmap::FindNext (uint64_t from, bool invert) const
+{
+  if (from >= m_size)
+    {
+      return m_size;
+    }
+  uint64_t word = from / 64;
+  uint64_t bits = (invert ? ~m_words[word] : m_words[word]) & (~uint64_t (0) << (from % 64));
+  while (bits == 0)
+    {
+      if (++word == m_words.size ())
+        {
+          return m_size;
+        }
+      bits = invert ? ~m_words[word] : m_words[word];
+    }
+  return std::min (word * 64 + __builtin_ctzll (bits), m_size);
+}
+
+} // namespace ns3
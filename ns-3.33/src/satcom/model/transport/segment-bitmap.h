@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SEGMENT_BITMAP_H
+#define SEGMENT_BITMAP_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief One bit per segment of a file, with a running count.
+ *
+ * Packed in 64-bit words, so a 10 GB product cut in 1400-byte
+ * segments takes under 1 MB, and the next set or clear bit is found a
+ * word at a time.
+ */
+class SegmentBitmap
+{
+public:
+  SegmentBitmap ();
+
+  /**
+   * \brief Resize the bitmap and give every bit a value
+   * \param size the number of segments
+   * \param value the value of every bit
+   */
+  void Reset (uint64_t size, bool value);
+
+  /// \return the number of segments
+  uint64_t GetSize (void) const;
+
+  /// \return the number of set bits
+  uint64_t GetCount (void) const;
+
+  /**
+   * \param i a segment index
+   * \return whether its bit is set
+   */
+  bool Test (uint64_t i) const;
+
+  /**
+   * \param i a segment index
+   * \return true if the bit was clear
+   */
+  bool Set (uint64_t i);
+
+  /**
+   * \param i a segment index
+   * \return true if the bit was set
+   */
+  bool Clear (uint64_t i);
+
+  /**
+   * \brief Set the bits of a range of segments
+   * \param begin the first segment
+   * \param end the segment after the last one, clamped to the size
+   * \return the number of bits that were clear
+   */
+  uint64_t SetRange (uint64_t begin, uint64_t end);
+
+  /**
+   * \param from a segment index
+   * \return the first set bit at or after \p from, or GetSize () if none
+   */
+  uint64_t FindNextSet (uint64_t from) const;
+
+  /**
+   * \param from a segment index
+   * \return the first clear bit at or after \p from, or GetSize () if none
+   */
+  uint64_t FindNextClear (uint64_t from) const;
+
+private:
+  /**
+   * \param from a segment index
+   * \param invert whether to look for a clear bit
+   * \return the first matching bit at or after \p from, or GetSize () if none
+   */
+  uint64_t FindNext (uint64_t from, bool invert) const;
+
+  std::vector<uint64_t> m_words;  //!< Bits, segment i in bit i % 64 of word i / 64
+  uint64_t m_size;                //!< Number of segments
+  uint64_t m_count;               //!< Number of set bits
+};
+
+} // namespace ns3
+
+#endif /* SEGMENT_BITMAP_H */
@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+
+#include "tcp-fixed-rate.h"
+#include "ns3/tcp-socket-state.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TcpFixedRate");
+
+NS_OBJECT_ENSURE_REGISTERED (TcpFixedRate);
+
+TypeId
+TcpFixedRate::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpFixedRate")
+    .SetParent<TcpCongestionOps> ()
+    .SetGroupName ("Satcom")
+    .AddConstructor<TcpFixedRate> ()
+    .AddAttribute ("Rate", "Sending rate on the space link.",
+                   DataRateValue (DataRate ("10Mbps")),
+                   MakeDataRateAccessor (&TcpFixedRate::m_rate),
+                   MakeDataRateChecker ())
+  ;
+  return tid;
+}
+
+TcpFixedRate::TcpFixedRate ()
+  : TcpCongestionOps ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpFixedRate::TcpFixedRate (const TcpFixedRate &sock)
+  : TcpCongestionOps (sock),
+    m_rate (sock.m_rate)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TcpFixedRate::~TcpFixedRate ()
+{
+}
+
+std::string
+TcpFixedRate::GetName () const
+{
+  return "TcpFixedRate";
+}
+
+uint32_t
+TcpFixedRate::GetWindow (Ptr<const TcpSocketState> tcb) const
+{
+  if (tcb->m_minRtt == Time::Max ())
+    {
+      return 0;
+    }
+  double bdp = m_rate.GetBitRate () * tcb->m_minRtt.GetSeconds () / 8.0;
+  return static_cast<uint32_t> (std::min (bdp, 2.0e9));
+}
+
+void
+TcpFixedRate::IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
+  uint32_t window = GetWindow (tcb);
+  if (window == 0)
+    {
+      // No RTT sample yet: grow as in slow start
+      tcb->m_cWnd += segmentsAcked * tcb->m_segmentSize;
+      return;
+    }
+  tcb->m_cWnd = std::max (window, 2 * tcb->m_segmentSize);
+}
+
+uint32_t
+TcpFixedRate::GetSsThresh (Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight)
+{
+  NS_LOG_FUNCTION (this << tcb << bytesInFlight);
+  uint32_t window = GetWindow (tcb);
+  if (window == 0)
+    {
+      window = tcb->m_cWnd;
+    }
+  return std::max (window, 2 * tcb->m_segmentSize);
+}
+
+Ptr<TcpCongestionOps>
+TcpFixedRate::Fork ()
+{
+  return CopyObject<TcpFixedRate> (this);
+}
+
+} // namespace ns3
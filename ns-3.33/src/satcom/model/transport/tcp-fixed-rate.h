@@ -0,0 +1,71 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_FIXED_RATE_H
+#define TCP_FIXED_RATE_H
+
+#include "ns3/tcp-congestion-ops.h"
+#include "ns3/data-rate.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satcom
+ *
+ * \brief Rate-based congestion control for a provisioned space link.
+ *
+ * The space segment between two PepApplication instances is a
+ * dedicated link of known capacity, so there is nothing to probe and
+ * a loss is a link error, not congestion. The window is held at Rate
+ * times the minimum RTT, the bandwidth-delay product, from the first
+ * RTT sample on, and losses are repaired without shrinking it. With
+ * pacing enabled on the socket the segments leave at about Rate. Rate
+ * must not exceed the capacity of the space link, as nothing backs
+ * off when a queue builds.
+ */
+class TcpFixedRate : public TcpCongestionOps
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  TcpFixedRate ();
+  /**
+   * \param sock the object to copy
+   */
+  TcpFixedRate (const TcpFixedRate &sock);
+  virtual ~TcpFixedRate ();
+
+  virtual std::string GetName () const;
+  virtual void IncreaseWindow (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked);
+  virtual uint32_t GetSsThresh (Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight);
+  virtual Ptr<TcpCongestionOps> Fork ();
+
+private:
+  /**
+   * \param tcb the socket state
+   * \return the bandwidth-delay product in bytes, or 0 before the first RTT sample
+   */
+  uint32_t GetWindow (Ptr<const TcpSocketState> tcb) const;
+
+  DataRate m_rate;  //!< Sending rate on the space link
+};
+
+} // namespace ns3
+
+#endif /* TCP_FIXED_RATE_H */